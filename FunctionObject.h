@@ -42,6 +42,13 @@ All rights reserved.
 #include <Entry.h>
 #include <Node.h>
 
+#include "SharedMessage.h"
+
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 
 // parameter binders serve to store a copy of a struct and
 // pass it in and out by pointers, allowing struct parameters to share
@@ -57,17 +64,39 @@ namespace BPrivate {
 
 template<class P>
 class ParameterBinder {
-// primitive default binder for scalars
+// primitive default binder for scalars and anything else that is copied or
+// moved in; a non-const reference is kept as a reference. The value is
+// passed out as a copy, unless the function takes an rvalue reference or
+// a type that can only be moved, which it then gets moved out
 public:
+	typedef typename std::remove_reference<P>::type value_type;
+	typedef typename std::conditional<std::is_lvalue_reference<P>::value
+			&& !std::is_const<value_type>::value,
+		std::reference_wrapper<value_type>,
+		typename std::decay<P>::type>::type stored_type;
+
 	ParameterBinder() {}
-	ParameterBinder(P p)
-		:	p(p)
+
+	template<class Argument, class = typename std::enable_if<
+		!std::is_same<typename std::decay<Argument>::type,
+			ParameterBinder>::value>::type>
+	ParameterBinder(Argument&& argument)
+		:	p(std::forward<Argument>(argument))
 		{}
 
-	P Pass() const
-		{ return p; }
+	P Pass()
+		{ return Pass(std::integral_constant<bool,
+			std::is_rvalue_reference<P>::value
+				|| (!std::is_reference<P>::value
+					&& !std::is_copy_constructible<stored_type>::value)>()); }
+
 private:
-	P p;
+	P Pass(std::true_type)
+		{ return std::move(p); }
+	P Pass(std::false_type)
+		{ return p; }
+
+	stored_type p;
 };
 
 
@@ -129,29 +158,31 @@ private:
 
 template<>
 class ParameterBinder<const BMessage*> {
+// the message is copied once and shared from there on: copies of the
+// binder, and binders made from the same SharedMessage, all pass the
+// same message
 public:
 	ParameterBinder() {}
 	ParameterBinder(const BMessage* p)
-		:	p(p ? new BMessage(*p) : NULL)
+		:	p(p)
 		{}
 
-	~ParameterBinder()
-		{
-			delete p;
-		}
+	ParameterBinder(const SharedMessage& message)
+		:	p(message)
+		{}
 
 	ParameterBinder &operator=(const BMessage* newp)
 		{
-			delete p;
-			p = (newp ? new BMessage(*newp) : NULL);
+			if (newp != p.Message())
+				p = SharedMessage(newp);
 			return *this;
 		}
 
 	const BMessage* Pass() const
-		{ return p; }
+		{ return p.Message(); }
 
 private:
-	BMessage* p;
+	SharedMessage p;
 };
 
 
@@ -172,318 +203,175 @@ protected:
 };
 
 
-template <class Param1>
-class SingleParamFunctionObject : public FunctionObject {
-public:
-	SingleParamFunctionObject(void (*callThis)(Param1),
-		Param1 p1)
-		:	function(callThis),
-			p1(p1)
-		{
-		}
-
-	virtual void operator()() { (function)(p1.Pass()); }
-
-private:
-	void (*function)(Param1);
-	ParameterBinder<Param1> p1;
-};
-
-
-template <class Result, class Param1>
-class SingleParamFunctionObjectWithResult : public
-	FunctionObjectWithResult<Result> {
+template<class T>
+class PlainLockingMemberFunctionObject : public FunctionObject {
 public:
-	SingleParamFunctionObjectWithResult(Result (*function)(Param1), Param1 p1)
+	PlainLockingMemberFunctionObject(void (T::*function)(), T* target)
 		:	function(function),
-			p1(p1)
+			messenger(target)
 		{
 		}
 
 	virtual void operator()()
-		{ FunctionObjectWithResult<Result>::result = (function)(p1.Pass()); }
-
-private:
-	Result (*function)(Param1);
-	ParameterBinder<Param1> p1;
-};
-
-
-template <class Param1, class Param2>
-class TwoParamFunctionObject : public FunctionObject {
-public:
-	TwoParamFunctionObject(void (*callThis)(Param1, Param2),
-		Param1 p1, Param2 p2)
-		:	function(callThis),
-			p1(p1),
-			p2(p2)
 		{
+			T* target = dynamic_cast<T*>(messenger.Target(NULL));
+			if (!target || !messenger.LockTarget())
+				return;
+			(target->*function)();
+			target->Looper()->Unlock();
 		}
 
-	virtual void operator()() { (function)(p1.Pass(), p2.Pass()); }
-
 private:
-	void (*function)(Param1, Param2);
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
+	void (T::*function)();
+	BMessenger messenger;
 };
 
 
-template <class Param1, class Param2, class Param3>
-class ThreeParamFunctionObject : public FunctionObject {
-public:
-	ThreeParamFunctionObject(void (*callThis)(Param1, Param2, Param3),
-		Param1 p1, Param2 p2, Param3 p3)
-		:	function(callThis),
-			p1(p1),
-			p2(p2),
-			p3(p3)
-		{
-		}
-
-	virtual void operator()() { (function)(p1.Pass(), p2.Pass(), p3.Pass()); }
-
-private:
-	void (*function)(Param1, Param2, Param3);
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
-	ParameterBinder<Param3> p3;
+// make_parameter_indices<N>::type is parameter_indices<0, ..., N - 1>,
+// for unpacking the bound parameters into a call
+template<int... Indices>
+struct parameter_indices {
 };
 
 
-template <class Result, class Param1, class Param2, class Param3>
-class ThreeParamFunctionObjectWithResult : public
-	FunctionObjectWithResult<Result> {
-public:
-	ThreeParamFunctionObjectWithResult(
-		Result (*callThis)(Param1, Param2, Param3),
-		Param1 p1, Param2 p2, Param3 p3)
-		:	function(callThis),
-			p1(p1),
-			p2(p2),
-			p3(p3)
-		{
-		}
-
-	virtual void operator()()
-		{ FunctionObjectWithResult<Result>::result
-			= (function)(p1.Pass(), p2.Pass(), p3.Pass()); }
-
-private:
-	Result (*function)(Param1, Param2, Param3);
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
-	ParameterBinder<Param3> p3;
+template<int N, int... Indices>
+struct make_parameter_indices
+	: make_parameter_indices<N - 1, N - 1, Indices...> {
 };
 
 
-template <class Param1, class Param2, class Param3, class Param4>
-class FourParamFunctionObject : public FunctionObject {
-public:
-	FourParamFunctionObject(void (*callThis)(Param1, Param2, Param3, Param4),
-		Param1 p1, Param2 p2, Param3 p3, Param4 p4)
-		:	function(callThis),
-			p1(p1),
-			p2(p2),
-			p3(p3),
-			p4(p4)
-		{
-		}
-
-	virtual void operator()()
-		{ (function)(p1.Pass(), p2.Pass(), p3.Pass(), p4.Pass()); }
-
-private:
-	void (*function)(Param1, Param2, Param3, Param4);
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
-	ParameterBinder<Param3> p3;
-	ParameterBinder<Param4> p4;
+template<int... Indices>
+struct make_parameter_indices<0, Indices...> {
+	typedef parameter_indices<Indices...> type;
 };
 
 
-template <class Result, class Param1, class Param2, class Param3,
-	class Param4>
-class FourParamFunctionObjectWithResult : public
-	FunctionObjectWithResult<Result>  {
-public:
-	FourParamFunctionObjectWithResult(
-		Result (*callThis)(Param1, Param2, Param3, Param4),
-		Param1 p1, Param2 p2, Param3 p3, Param4 p4)
-		:	function(callThis),
-			p1(p1),
-			p2(p2),
-			p3(p3),
-			p4(p4)
-		{
-		}
+template<class Result>
+struct bound_function_base {
+	typedef FunctionObjectWithResult<Result> type;
+};
 
-	virtual void operator()()
-		{ FunctionObjectWithResult<Result>::result
-			= (function)(p1.Pass(), p2.Pass(), p3.Pass(), p4.Pass()); }
 
-private:
-	Result (*function)(Param1, Param2, Param3, Param4);
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
-	ParameterBinder<Param3> p3;
-	ParameterBinder<Param4> p4;
+template<>
+struct bound_function_base<void> {
+	typedef FunctionObject type;
 };
 
 
-template<class T>
-class PlainMemberFunctionObject : public FunctionObject {
+template<class Result, class... Params>
+class BoundFunctionObject : public bound_function_base<Result>::type {
+	// calls a function with the parameters it was created with, which are
+	// forwarded into their binders; a non-void result is kept
 public:
-	PlainMemberFunctionObject(void (T::*function)(), T* onThis)
+	template<class... Arguments>
+	BoundFunctionObject(Result (*function)(Params...),
+		Arguments&&... arguments)
 		:	function(function),
-			target(onThis)
+			parameters(std::forward<Arguments>(arguments)...)
 		{
 		}
 
 	virtual void operator()()
-		{ (target->*function)(); }
+		{ Call(typename make_parameter_indices<sizeof...(Params)>::type(),
+			std::is_void<Result>()); }
 
 private:
-	void (T::*function)();
-	T* target;
-};
-
+	template<int... Indices>
+	void Call(parameter_indices<Indices...>, std::true_type)
+		{ (function)(std::get<Indices>(parameters).Pass()...); }
 
-template<class T>
-class PlainLockingMemberFunctionObject : public FunctionObject {
-public:
-	PlainLockingMemberFunctionObject(void (T::*function)(), T* target)
-		:	function(function),
-			messenger(target)
-		{
-		}
-
-	virtual void operator()()
-		{
-			T* target = dynamic_cast<T*>(messenger.Target(NULL));
-			if (!target || !messenger.LockTarget())
-				return;
-			(target->*function)();
-			target->Looper()->Unlock();
-		}
+	template<int... Indices>
+	void Call(parameter_indices<Indices...>, std::false_type)
+		{ this->result = (function)(std::get<Indices>(parameters).Pass()...); }
 
-private:
-	void (T::*function)();
-	BMessenger messenger;
+	Result (*function)(Params...);
+	std::tuple<ParameterBinder<Params>...> parameters;
 };
 
 
-template<class T, class R>
-class PlainMemberFunctionObjectWithResult : public
-	FunctionObjectWithResult<R> {
+template<class T, class Result, class... Params>
+class BoundMemberFunctionObject : public bound_function_base<Result>::type {
+	// the same for a member function and the object to call it on
 public:
-	PlainMemberFunctionObjectWithResult(R (T::*function)(), T* onThis)
+	template<class... Arguments>
+	BoundMemberFunctionObject(Result (T::*function)(Params...), T* onThis,
+		Arguments&&... arguments)
 		:	function(function),
-			target(onThis)
+			target(onThis),
+			parameters(std::forward<Arguments>(arguments)...)
 		{
 		}
 
 	virtual void operator()()
-		{ FunctionObjectWithResult<R>::result = (target->*function)(); }
-
+		{ Call(typename make_parameter_indices<sizeof...(Params)>::type(),
+			std::is_void<Result>()); }
 
 private:
-	R (T::*function)();
+	template<int... Indices>
+	void Call(parameter_indices<Indices...>, std::true_type)
+		{ (target->*function)(std::get<Indices>(parameters).Pass()...); }
+
+	template<int... Indices>
+	void Call(parameter_indices<Indices...>, std::false_type)
+		{ this->result
+			= (target->*function)(std::get<Indices>(parameters).Pass()...); }
+
+	Result (T::*function)(Params...);
 	T* target;
+	std::tuple<ParameterBinder<Params>...> parameters;
 };
 
 
-template<class T, class Param1>
-class SingleParamMemberFunctionObject : public FunctionObject {
-public:
-	SingleParamMemberFunctionObject(void (T::*function)(Param1),
-		T* onThis, Param1 p1)
-		:	function(function),
-			target(onThis),
-			p1(p1)
-		{
-		}
+// the names the classes had when each number of parameters needed one
 
-	virtual void operator()()
-		{ (target->*function)(p1.Pass()); }
+template<class Param1>
+using SingleParamFunctionObject = BoundFunctionObject<void, Param1>;
 
-private:
-	void (T::*function)(Param1);
-	T* target;
-	ParameterBinder<Param1> p1;
-};
+template<class Result, class Param1>
+using SingleParamFunctionObjectWithResult
+	= BoundFunctionObject<Result, Param1>;
 
+template<class Param1, class Param2>
+using TwoParamFunctionObject = BoundFunctionObject<void, Param1, Param2>;
 
-template<class T, class Param1, class Param2>
-class TwoParamMemberFunctionObject : public FunctionObject {
-public:
-	TwoParamMemberFunctionObject(void (T::*function)(Param1, Param2),
-		T* onThis, Param1 p1, Param2 p2)
-		:	function(function),
-			target(onThis),
-			p1(p1),
-			p2(p2)
-		{
-		}
+template<class Param1, class Param2, class Param3>
+using ThreeParamFunctionObject
+	= BoundFunctionObject<void, Param1, Param2, Param3>;
 
-	virtual void operator()()
-		{ (target->*function)(p1.Pass(), p2.Pass()); }
+template<class Result, class Param1, class Param2, class Param3>
+using ThreeParamFunctionObjectWithResult
+	= BoundFunctionObject<Result, Param1, Param2, Param3>;
 
+template<class Param1, class Param2, class Param3, class Param4>
+using FourParamFunctionObject
+	= BoundFunctionObject<void, Param1, Param2, Param3, Param4>;
 
-protected:
-	void (T::*function)(Param1, Param2);
-	T* target;
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
-};
+template<class Result, class Param1, class Param2, class Param3,
+	class Param4>
+using FourParamFunctionObjectWithResult
+	= BoundFunctionObject<Result, Param1, Param2, Param3, Param4>;
 
+template<class T>
+using PlainMemberFunctionObject = BoundMemberFunctionObject<T, void>;
 
-template<class T, class R, class Param1>
-class SingleParamMemberFunctionObjectWithResult : public
-	FunctionObjectWithResult<R> {
-public:
-	SingleParamMemberFunctionObjectWithResult(R (T::*function)(Param1),
-		T* onThis, Param1 p1)
-		:	function(function),
-			target(onThis),
-			p1(p1)
-		{
-		}
+template<class T, class R>
+using PlainMemberFunctionObjectWithResult = BoundMemberFunctionObject<T, R>;
 
-	virtual void operator()()
-		{ FunctionObjectWithResult<R>::result
-			= (target->*function)(p1.Pass()); }
+template<class T, class Param1>
+using SingleParamMemberFunctionObject
+	= BoundMemberFunctionObject<T, void, Param1>;
 
-protected:
-	R (T::*function)(Param1);
-	T* target;
-	ParameterBinder<Param1> p1;
-};
+template<class T, class Param1, class Param2>
+using TwoParamMemberFunctionObject
+	= BoundMemberFunctionObject<T, void, Param1, Param2>;
 
+template<class T, class R, class Param1>
+using SingleParamMemberFunctionObjectWithResult
+	= BoundMemberFunctionObject<T, R, Param1>;
 
 template<class T, class R, class Param1, class Param2>
-class TwoParamMemberFunctionObjectWithResult : public
-	FunctionObjectWithResult<R> {
-public:
-	TwoParamMemberFunctionObjectWithResult(R (T::*function)(Param1, Param2),
-		T* onThis, Param1 p1, Param2 p2)
-		:	function(function),
-			target(onThis),
-			p1(p1),
-			p2(p2)
-		{
-		}
-
-	virtual void operator()()
-		{ FunctionObjectWithResult<R>::result
-			= (target->*function)(p1.Pass(), p2.Pass()); }
-
-protected:
-	R (T::*function)(Param1, Param2);
-	T* target;
-	ParameterBinder<Param1> p1;
-	ParameterBinder<Param2> p2;
-};
+using TwoParamMemberFunctionObjectWithResult
+	= BoundMemberFunctionObject<T, R, Param1, Param2>;
 
 
 // convenience factory functions
@@ -492,68 +380,35 @@ protected:
 // NewMemberFunctionObjectWithResult
 // NewLockingMemberFunctionObject
 //
-// ... add the missing ones as needed
+// These take any number of parameters and forward them into the binders,
+// so temporaries and move-only values are moved rather than copied.
 
-template<class Param1>
-SingleParamFunctionObject<Param1>*
-NewFunctionObject(void (*function)(Param1), Param1 p1)
+template<class Result, class... Params, class... Arguments>
+BoundFunctionObject<Result, Params...>*
+NewFunctionObject(Result (*function)(Params...), Arguments&&... arguments)
 {
-	return new SingleParamFunctionObject<Param1>(function, p1);
+	return new BoundFunctionObject<Result, Params...>(function,
+		std::forward<Arguments>(arguments)...);
 }
 
 
-template<class Param1, class Param2>
-TwoParamFunctionObject<Param1, Param2>*
-NewFunctionObject(void (*function)(Param1, Param2), Param1 p1, Param2 p2)
+template<class T, class... Params, class... Arguments>
+BoundMemberFunctionObject<T, void, Params...>*
+NewMemberFunctionObject(void (T::*function)(Params...), T* onThis,
+	Arguments&&... arguments)
 {
-	return new TwoParamFunctionObject<Param1, Param2>(function, p1, p2);
+	return new BoundMemberFunctionObject<T, void, Params...>(function, onThis,
+		std::forward<Arguments>(arguments)...);
 }
 
 
-template<class Param1, class Param2, class Param3>
-ThreeParamFunctionObject<Param1, Param2, Param3>*
-NewFunctionObject(void (*function)(Param1, Param2, Param3),
-	Param1 p1, Param2 p2, Param3 p3)
-{
-	return new ThreeParamFunctionObject<Param1, Param2, Param3>
-		(function, p1, p2, p3);
-}
-
-
-template<class T>
-PlainMemberFunctionObject<T>*
-NewMemberFunctionObject(void (T::*function)(), T* onThis)
-{
-	return new PlainMemberFunctionObject<T>(function, onThis);
-}
-
-
-template<class T, class Param1>
-SingleParamMemberFunctionObject<T, Param1>*
-NewMemberFunctionObject(void (T::*function)(Param1), T* onThis, Param1 p1)
-{
-	return new SingleParamMemberFunctionObject<T, Param1>
-		(function, onThis, p1);
-}
-
-
-template<class T, class Param1, class Param2>
-TwoParamMemberFunctionObject<T, Param1, Param2>*
-NewMemberFunctionObject(void (T::*function)(Param1, Param2), T* onThis,
-		Param1 p1, Param2 p2)
-{
-	return new TwoParamMemberFunctionObject<T, Param1, Param2>
-		(function, onThis, p1, p2);
-}
-
-
-template<class T, class R, class Param1, class Param2>
-TwoParamMemberFunctionObjectWithResult<T, R, Param1, Param2>*
-NewMemberFunctionObjectWithResult(R (T::*function)(Param1, Param2),
-	T* onThis, Param1 p1, Param2 p2)
+template<class T, class R, class... Params, class... Arguments>
+BoundMemberFunctionObject<T, R, Params...>*
+NewMemberFunctionObjectWithResult(R (T::*function)(Params...), T* onThis,
+	Arguments&&... arguments)
 {
-	return new TwoParamMemberFunctionObjectWithResult<T, R, Param1, Param2>
-		(function, onThis, p1, p2);
+	return new BoundMemberFunctionObject<T, R, Params...>(function, onThis,
+		std::forward<Arguments>(arguments)...);
 }
 
 
@@ -0,0 +1,144 @@
+/*
+	InlineFunction.cpp: A callable stored without a heap allocation.
+	Released under the MIT license.
+*/
+#include "InlineFunction.h"
+
+#include <Autolock.h>
+#include <Locker.h>
+#include <OS.h>
+
+#include <stddef.h>
+
+namespace {
+
+// Objects too big to be stored inline but no bigger than this share a
+// free list of blocks. When it runs dry, a slab of kSlabBlocks blocks is
+// allocated at once and added to it. Released blocks always go back to
+// the list, so a queue of medium sized jobs stops allocating once the
+// list has grown to the most that were ever queued at the same time.
+const size_t kBlockSize = 256;
+const int32 kSlabBlocks = 32;
+
+struct free_block {
+	free_block*		next;
+};
+
+union slab_header {
+	// keeps the blocks after it aligned like operator new memory
+	max_align_t		align;
+	void*			next;
+};
+
+free_block* sFreeBlocks = NULL;
+void* sSlabs = NULL;
+	// kept so that the slabs stay reachable; they are never freed
+
+BLocker sBlockLock("inline function blocks");
+
+
+// Called with sBlockLock held
+void
+add_slab()
+{
+	slab_header* slab = (slab_header*)::operator new(sizeof(slab_header)
+		+ kSlabBlocks * kBlockSize);
+	slab->next = sSlabs;
+	sSlabs = slab;
+
+	char* blocks = (char*)(slab + 1);
+	for (int32 i = kSlabBlocks - 1; i >= 0; i--) {
+		free_block* block = (free_block*)(blocks + i * kBlockSize);
+		block->next = sFreeBlocks;
+		sFreeBlocks = block;
+	}
+}
+
+}	// namespace
+
+
+void
+InlineFunction::Clear()
+{
+	if (fOps == NULL)
+		return;
+
+	fOps->destroy(_Object());
+	if (fHeap != NULL)
+		_Free(fHeap, fOps->size);
+	fOps = NULL;
+	fHeap = NULL;
+}
+
+
+void
+InlineFunction::TakeOver(InlineFunction &other)
+{
+	if (&other == this)
+		return;
+
+	Clear();
+	if (other.fOps == NULL)
+		return;
+
+	if (other.fHeap != NULL) {
+		fOps = other.fOps;
+		fHeap = other.fHeap;
+		other.fOps = NULL;
+		other.fHeap = NULL;
+	} else {
+		other.fOps->move(_Object(), other._Object());
+		fOps = other.fOps;
+		other.Clear();
+	}
+}
+
+
+void
+InlineFunction::_CopyFrom(const InlineFunction &other)
+{
+	if (other.fOps == NULL)
+		return;
+	if (other.fOps->copy == NULL) {
+		debugger("InlineFunction: the object can only be moved");
+		return;
+	}
+
+	if (other.fHeap != NULL)
+		fHeap = _Allocate(other.fOps->size);
+	other.fOps->copy(_Object(), other._Object());
+	fOps = other.fOps;
+}
+
+
+void*
+InlineFunction::_Allocate(size_t size)
+{
+	if (size <= kBlockSize) {
+		BAutolock locker(sBlockLock);
+		if (sFreeBlocks == NULL)
+			add_slab();
+
+		free_block* block = sFreeBlocks;
+		sFreeBlocks = block->next;
+		return block;
+	}
+
+	// operator new memory is aligned for any object
+	return ::operator new(size);
+}
+
+
+void
+InlineFunction::_Free(void *block, size_t size)
+{
+	if (size <= kBlockSize) {
+		BAutolock locker(sBlockLock);
+		free_block* freed = (free_block*)block;
+		freed->next = sFreeBlocks;
+		sFreeBlocks = freed;
+		return;
+	}
+
+	::operator delete(block);
+}
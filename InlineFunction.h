@@ -0,0 +1,212 @@
+/*
+	InlineFunction.h: A callable stored without a heap allocation.
+	Released under the MIT license.
+*/
+#ifndef INLINE_FUNCTION_H_
+#define INLINE_FUNCTION_H_
+
+#include <SupportDefs.h>
+
+#include <stddef.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+	Every NewFunctionObject() is a new, and a delete once the functor ran.
+	InlineFunction holds any object with an operator()() - a plain struct,
+	or one of the FunctionObject classes by value - in kInlineSize bytes
+	of its own, so that handing a small job to a ThreadPool does not touch
+	the heap at all.
+
+	The object only has to be movable. One that can't be copied, say
+	because it binds a std::unique_ptr, may still be moved from one
+	InlineFunction to another and launched as a temporary, but copying
+	the InlineFunction that holds it drops into the debugger and leaves
+	the copy empty.
+
+	Objects that are bigger, or need stricter alignment than a pointer or
+	an int64, go into a block from a process-wide free list instead, and
+	only the ones that don't fit a block either are allocated one by one.
+	Objects aligned beyond max_align_t are refused at compile time, since
+	neither the blocks nor operator new guarantee more.
+*/
+
+class InlineFunction
+{
+public:
+	enum {
+		kInlineSize = 48
+	};
+
+								InlineFunction();
+								InlineFunction(const InlineFunction &other);
+								InlineFunction(InlineFunction &&other);
+	// A temporary is moved in rather than copied.
+	template<class Function, class = typename std::enable_if<
+		!std::is_same<typename std::decay<Function>::type,
+			InlineFunction>::value>::type>
+								InlineFunction(Function &&function);
+								~InlineFunction();
+
+			InlineFunction&		operator=(const InlineFunction &other);
+
+	// Calls the stored object; does nothing when there is none.
+			void				operator()() const;
+
+			bool				IsEmpty() const { return fOps == NULL; }
+			bool				IsInline() const
+									{ return fOps != NULL && fHeap == NULL; }
+			void				Clear();
+
+	// Moves other's object over, leaving other empty. Unlike a copy, this
+	// never allocates, and an inline object is moved rather than copied.
+			void				TakeOver(InlineFunction &other);
+
+private:
+	typedef void (*copy_function)(void *to, const void *from);
+
+	struct ops {
+		void	(*invoke)(void *object);
+		copy_function copy;
+		void	(*move)(void *to, void *from);
+		void	(*destroy)(void *object);
+		size_t	size;
+	};
+
+	// The copy of an object that can only be moved is NULL, rather than a
+	// function that would not compile
+	template<class Function, bool Copyable
+		= std::is_copy_constructible<Function>::value>
+	struct copy_op {
+		static	void			Copy(void *to, const void *from)
+									{ new(to) Function(*(const Function*)from); }
+		static	constexpr copy_function Get() { return &Copy; }
+	};
+
+	template<class Function>
+	struct copy_op<Function, false> {
+		static	constexpr copy_function Get() { return NULL; }
+	};
+
+	template<class Function>
+	struct typed_ops {
+		static	void			Invoke(void *object)
+									{ (*(Function*)object)(); }
+		static	void			Move(void *to, void *from)
+									{ new(to) Function(std::move(*(Function*)from)); }
+		static	void			Destroy(void *object)
+									{ ((Function*)object)->~Function(); }
+
+		static	const ops		kOps;
+	};
+
+			void*				_Object() const;
+			void				_CopyFrom(const InlineFunction &other);
+
+	static	void*				_Allocate(size_t size);
+	static	void				_Free(void *block, size_t size);
+
+			union storage {
+				char			bytes[kInlineSize];
+				int64			alignInt;
+				double			alignDouble;
+				void*			alignPointer;
+			};
+
+			const ops*			fOps;
+			void*				fHeap;
+				// NULL while the object is stored inline
+			storage				fInline;
+};
+
+
+template<class Function>
+const InlineFunction::ops InlineFunction::typed_ops<Function>::kOps = {
+	&InlineFunction::typed_ops<Function>::Invoke,
+	InlineFunction::copy_op<Function>::Get(),
+	&InlineFunction::typed_ops<Function>::Move,
+	&InlineFunction::typed_ops<Function>::Destroy,
+	sizeof(Function)
+};
+
+
+inline
+InlineFunction::InlineFunction()
+	:
+	fOps(NULL),
+	fHeap(NULL)
+{
+}
+
+
+inline
+InlineFunction::InlineFunction(const InlineFunction &other)
+	:
+	fOps(NULL),
+	fHeap(NULL)
+{
+	_CopyFrom(other);
+}
+
+
+inline
+InlineFunction::InlineFunction(InlineFunction &&other)
+	:
+	fOps(NULL),
+	fHeap(NULL)
+{
+	TakeOver(other);
+}
+
+
+template<class Function, class>
+InlineFunction::InlineFunction(Function &&function)
+	:
+	fOps(&typed_ops<typename std::decay<Function>::type>::kOps),
+	fHeap(NULL)
+{
+	typedef typename std::decay<Function>::type stored_type;
+	static_assert(__alignof__(stored_type) <= __alignof__(max_align_t),
+		"InlineFunction can't store over-aligned objects");
+	if (sizeof(stored_type) > kInlineSize
+		|| __alignof__(stored_type) > __alignof__(storage))
+		fHeap = _Allocate(sizeof(stored_type));
+	new(_Object()) stored_type(std::forward<Function>(function));
+}
+
+
+inline
+InlineFunction::~InlineFunction()
+{
+	Clear();
+}
+
+
+inline InlineFunction&
+InlineFunction::operator=(const InlineFunction &other)
+{
+	if (&other != this) {
+		Clear();
+		_CopyFrom(other);
+	}
+	return *this;
+}
+
+
+inline void
+InlineFunction::operator()() const
+{
+	if (fOps != NULL)
+		fOps->invoke(_Object());
+}
+
+
+inline void*
+InlineFunction::_Object() const
+{
+	return fHeap != NULL ? fHeap : (void*)fInline.bytes;
+}
+
+#endif
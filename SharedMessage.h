@@ -0,0 +1,169 @@
+/*
+	SharedMessage.h: A reference counted, copy-on-write BMessage handle.
+	Released under the MIT license.
+*/
+#ifndef SHARED_MESSAGE_H_
+#define SHARED_MESSAGE_H_
+
+#include <Message.h>
+#include <SupportDefs.h>
+
+/*
+	Binding a BMessage to a functor copies it, since the caller's message
+	may be gone by the time the functor runs. Handing the same message to
+	a hundred functors used to mean a hundred deep copies.
+
+	A SharedMessage copies the message once. Copies of the handle share
+	that one message and only count references, so they are cheap to pass
+	around and safe to hand to other threads: the message is never
+	changed while it is shared. EditMessage() is the one way to change it,
+	and gives the handle a copy of its own first if anybody else still
+	holds the message.
+*/
+
+class SharedMessage
+{
+public:
+								SharedMessage();
+	// Copies message, which may be NULL.
+	explicit					SharedMessage(const BMessage *message);
+								SharedMessage(const SharedMessage &other);
+								SharedMessage(SharedMessage &&other);
+								~SharedMessage();
+
+			SharedMessage&		operator=(const SharedMessage &other);
+			SharedMessage&		operator=(SharedMessage &&other);
+
+	// NULL for an empty handle.
+			const BMessage*		Message() const;
+	// The message to change, copied first if it is shared; NULL for an
+	// empty handle.
+			BMessage*			EditMessage();
+
+			bool				IsShared() const;
+			void				Unset();
+
+private:
+	struct shared_message {
+		shared_message(const BMessage &message)
+			:
+			references(1),
+			message(message)
+		{
+		}
+
+		int32		references;
+		BMessage	message;
+	};
+
+			shared_message*		fShared;
+};
+
+
+inline
+SharedMessage::SharedMessage()
+	:
+	fShared(NULL)
+{
+}
+
+
+inline
+SharedMessage::SharedMessage(const BMessage *message)
+	:
+	fShared(message != NULL ? new shared_message(*message) : NULL)
+{
+}
+
+
+inline
+SharedMessage::SharedMessage(const SharedMessage &other)
+	:
+	fShared(other.fShared)
+{
+	if (fShared != NULL)
+		atomic_add(&fShared->references, 1);
+}
+
+
+inline
+SharedMessage::SharedMessage(SharedMessage &&other)
+	:
+	fShared(other.fShared)
+{
+	other.fShared = NULL;
+}
+
+
+inline
+SharedMessage::~SharedMessage()
+{
+	Unset();
+}
+
+
+inline SharedMessage&
+SharedMessage::operator=(const SharedMessage &other)
+{
+	if (other.fShared != fShared) {
+		Unset();
+		fShared = other.fShared;
+		if (fShared != NULL)
+			atomic_add(&fShared->references, 1);
+	}
+	return *this;
+}
+
+
+inline SharedMessage&
+SharedMessage::operator=(SharedMessage &&other)
+{
+	if (&other != this) {
+		Unset();
+		fShared = other.fShared;
+		other.fShared = NULL;
+	}
+	return *this;
+}
+
+
+inline const BMessage*
+SharedMessage::Message() const
+{
+	return fShared != NULL ? &fShared->message : NULL;
+}
+
+
+inline BMessage*
+SharedMessage::EditMessage()
+{
+	if (fShared == NULL)
+		return NULL;
+
+	// Only this handle could add a reference, so once it is the last one
+	// nobody else can see the message change.
+	if (atomic_get(&fShared->references) > 1) {
+		shared_message *copy = new shared_message(fShared->message);
+		Unset();
+		fShared = copy;
+	}
+	return &fShared->message;
+}
+
+
+inline bool
+SharedMessage::IsShared() const
+{
+	return fShared != NULL && atomic_get(&fShared->references) > 1;
+}
+
+
+inline void
+SharedMessage::Unset()
+{
+	if (fShared != NULL && atomic_add(&fShared->references, -1) == 1)
+		delete fShared;
+	fShared = NULL;
+}
+
+#endif
@@ -14,57 +14,86 @@
 #include <ScrollBar.h>
 #include <Window.h>
 #include <stdio.h>
+#include <string.h>
 #include <Font.h>
 #include <Box.h>
+#include <Clipboard.h>
 #include <MessageFilter.h>
+#include <MessageRunner.h>
 #include <PropertyInfo.h>
 
 #include <algorithm>
 
-#include "Thread.h"
+#include "SpinnerArrowCache.h"
+#include "SpinnerInputValidator.h"
+#include "SpinnerRepeatScheduler.h"
+#include "SpinnerStyle.h"
+#include "SpinnerWidthCache.h"
 
 #include <math.h>
 
+// The value properties are reported in the native type of the value core:
+// B_INT32_TYPE by default, B_INT64_TYPE for int64 and fixed point cores and
+// B_UINT64_TYPE for uint64 cores. They can be set with any of these, or
+// with a string in the spinner's own notation.
+#define SPINNER_GET_TYPES	{ B_INT32_TYPE, B_INT64_TYPE, B_UINT64_TYPE }
+#define SPINNER_SET_TYPES	{ B_INT32_TYPE, B_INT64_TYPE, B_UINT64_TYPE, \
+								B_STRING_TYPE }
+
 static property_info sProperties[] = {
 	{ "MinValue", { B_GET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0 },
-		"Returns the minimum value for the spinner.", 0, { B_INT32_TYPE }
+		"Returns the minimum value for the spinner.", 0, SPINNER_GET_TYPES
 	},
 	
 	{ "MinValue", { B_SET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0},
-		"Sets the minimum value for the spinner.", 0, { B_INT32_TYPE }
+		"Sets the minimum value for the spinner.", 0, SPINNER_SET_TYPES
 	},
 	
 	{ "MaxValue", { B_GET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0 },
-		"Returns the maximum value for the spinner.", 0, { B_INT32_TYPE }
+		"Returns the maximum value for the spinner.", 0, SPINNER_GET_TYPES
 	},
 	
 	{ "MaxValue", { B_SET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0},
-		"Sets the maximum value for the spinner.", 0, { B_INT32_TYPE }
+		"Sets the maximum value for the spinner.", 0, SPINNER_SET_TYPES
 	},
 	
 	{ "Step", { B_GET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0 },
 		"Returns the amount of change when an arrow button is clicked.",
-		0, { B_INT32_TYPE }
+		0, SPINNER_GET_TYPES
 	},
 	
 	{ "Step", { B_SET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0},
 		"Sets the amount of change when an arrow button is clicked.",
-		0, { B_INT32_TYPE }
+		0, SPINNER_SET_TYPES
 	},
 	
 	{ "Value", { B_GET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0 },
-		"Returns the value for the spinner.", 0, { B_INT32_TYPE }
+		"Returns the value for the spinner.", 0, SPINNER_GET_TYPES
 	},
 	
 	{ "Value", { B_SET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0},
-		"Sets the value for the spinner.", 0, { B_INT32_TYPE }
+		"Sets the value for the spinner.", 0, SPINNER_SET_TYPES
+	},
+	
+	{ "RepeatCurve", { B_GET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0 },
+		"Returns how holding an arrow speeds up, as \"held:steps:interval\" "
+		"stages in milliseconds.", 0, { B_STRING_TYPE }
+	},
+	
+	{ "RepeatCurve", { B_SET_PROPERTY, 0 }, { B_DIRECT_SPECIFIER, 0},
+		"Sets how holding an arrow speeds up, for example "
+		"\"0:1:300, 300:1:60, 1500:10:50\".", 0, { B_STRING_TYPE }
 	},
+	
+	{ 0 }
 };
 
 enum {
 	M_UP = 'mmup',
 	M_DOWN,
-	M_TEXT_CHANGED = 'mtch'
+	M_TEXT_CHANGED = 'mtch',
+	M_FLUSH_NOTIFICATION = 'mfln',
+	M_APPLY_INPUT = 'mapi'
 };
 
 
@@ -82,29 +111,112 @@ const char*	const kLabelItemField = "Spinner:textFieldItem";
 const char* const kTextFieldItemField = "Spinner:labelItem";
 
 
+// How far the pointer has to move up or down before a press on an arrow
+// or the label turns into a drag
+const float kScrubSlop = 3;
+const float kDefaultScrubRatio = 4;
+
+const int32 kDefaultPageSteps = 10;
+
+// Wheel deltas are added up for at most this long before they are applied
+const bigtime_t kWheelFrameInterval = 1000000 / 60;
+
+
+// Maps the text views of a window's spinners to the spinners. Lookups hash
+// the text view's address into an open addressing table, so finding the
+// spinner for a key press takes the same time whether a window has one
+// spinner or hundreds.
+class SpinnerTextViewMap
+{
+public:
+							SpinnerTextViewMap(void);
+							~SpinnerTextViewMap(void);
+	
+			void			Put(BTextView *view, Spinner *spinner);
+			void			Remove(BTextView *view);
+			Spinner*		Get(const BHandler *handler) const;
+			int32			CountItems(void) const { return fCount; }
+	
+private:
+	struct entry {
+		BTextView*		view;
+		Spinner*		spinner;
+	};
+	
+			uint32			_Home(const void *view) const;
+			void			_Resize(uint32 capacity);
+	
+			entry*			fEntries;
+			uint32			fCapacity;
+			int32			fCount;
+};
+
+
+class SpinnerPasteFilter;
+
+
+// One filter per window handles the keys of all spinners in it. The
+// spinners register their text views with it while they are attached.
+// Pastes are checked by a second filter that only sees B_PASTE, so that
+// other messages to the window don't pass through either.
 class SpinnerMsgFilter : public BMessageFilter
 {
 public:
+	static	SpinnerMsgFilter* Acquire(BWindow *window);
+			void			Release(BWindow *window);
+	
+			void			Register(BTextView *view, Spinner *spinner);
+			void			Unregister(BTextView *view);
+	
+	virtual filter_result	Filter(BMessage *msg, BHandler **target);
+	
+private:
 							SpinnerMsgFilter(void);
 							~SpinnerMsgFilter(void);
+	
+			Spinner*		_FocusedSpinner(BHandler *target) const;
+			filter_result	_FilterKeyDown(BMessage *msg, BHandler **target);
+			filter_result	_FilterPaste(BMessage *msg, BHandler **target);
+	static	bool			_AcceptsInsertion(Spinner *spinner,
+								const char *text, int32 length);
+	
+			friend class SpinnerPasteFilter;
+	
+			SpinnerTextViewMap fSpinners;
+			SpinnerPasteFilter* fPasteFilter;
+			int32			fReferences;
+};
+
+
+class SpinnerPasteFilter : public BMessageFilter
+{
+public:
+							SpinnerPasteFilter(SpinnerMsgFilter *keys);
+	
 	virtual filter_result	Filter(BMessage *msg, BHandler **target);
+	
+private:
+			SpinnerMsgFilter* fKeys;
 };
 
 
-class SpinnerArrowButton : public BView
+class SpinnerArrowButton : public BView, public SpinnerRepeatClient
 {
 public:
 							SpinnerArrowButton(BPoint location, const char *name, 
 								arrow_direction dir, float height);
 							~SpinnerArrowButton(void);
 					void	AttachedToWindow(void);
-					void	DetachedToWindow(void);
+					void	DetachedFromWindow(void);
 					void	MouseDown(BPoint pt);
 					void	MouseUp(BPoint pt);
 					void	MouseMoved(BPoint pt, uint32 code, const BMessage *msg);
 					void	Draw(BRect update);
+					void	MessageReceived(BMessage *msg);
 					void	SetEnabled(bool value);
 					bool	IsEnabled(void) const { return fEnabled; }
+	virtual			bool	RepeatTick(bigtime_t now);
+					void	CancelTracking(void);
 	
 private:
 		arrow_direction		fDirection;
@@ -113,57 +225,146 @@ private:
 		bool				fMouseDown;
 		bool				fEnabled;
 		bool				fMouseOver;
+		bool				fTracking;
+		SpinnerRepeatScheduler *fScheduler;
 
 private:
 		void				_DoneTracking(BPoint point);
 		void				_Track(BPoint point, uint32);
-		void				_ModifyValue();
+		void				_Repeat(bigtime_t now);
+		spinner_arrow_state	_State(void) const;
+		void				_StateChanged(spinner_arrow_state previous);
+		void				_ModifyValue(int32 count);
+};
+
+
+// The text control of a spinner. Dragging up and down on its label
+// changes the value; everything else is left to BTextControl.
+class SpinnerTextControl : public BTextControl
+{
+public:
+							SpinnerTextControl(Spinner *spinner, BRect frame,
+								const char *label, BMessage *msg);
+	
+	virtual	void			MouseDown(BPoint where);
+	virtual	void			MouseMoved(BPoint where, uint32 transit,
+								const BMessage *msg);
+	virtual	void			MouseUp(BPoint where);
+	
+private:
+			Spinner*		fSpinner;
+			bool			fScrubbing;
+};
+
+// What a width was measured in. Comparing these is cheaper than keeping a
+// whole BFont around per spinner.
+struct spinner_font_key {
+	uint32	familyAndStyle;
+	float	size;
+	uint16	face;
+	uint8	spacing;
+	
+	void Set(const BFont &font)
+	{
+		familyAndStyle = font.FamilyAndStyle();
+		size = font.Size();
+		face = font.Face();
+		spacing = font.Spacing();
+	}
+	
+	bool Matches(const BFont &font) const
+	{
+		return familyAndStyle == font.FamilyAndStyle() && size == font.Size()
+			&& face == font.Face() && spacing == font.Spacing();
+	}
 };
 
+
 class SpinnerPrivateData
 {
 public:
 	SpinnerPrivateData(void)
 	{
-		fThumbFrame.Set(0,0,0,0);
-		fEnabled = true;
-		tracking = false;
-		fMousePoint.Set(0,0);
-		fThumbIncrement = 1.0;
-		fRepeaterID = -1;
-		fExitRepeater = false;
-		fArrowDown = ARROW_NONE;
-		
-		#ifdef TEST_MODE
-			sbinfo.proportional = true;
-			sbinfo.double_arrows = false;
-			sbinfo.knob = 0;
-			sbinfo.min_knob_size = 14;
-		#else
-			get_scroll_bar_info(&fScrollbarInfo);
-		#endif
+		fNotifyInterval = 0;
+		fLastNotify = 0;
+		fNotifyPending = false;
+		fNotifyRunner = NULL;
+		fRepeatCurve = NULL;
+		fTrackingMode = SPINNER_TRACK_EVENTS;
+		fWheelModifiers = 0;
+		fWheelMultiplier = 1;
+		fWheelRemainder = 0;
+		fWheelPending = 0;
+		fWheelFrameStart = -1;
+		fInputPosted = false;
+		fPageSteps = kDefaultPageSteps;
+		fScrubRatio = kDefaultScrubRatio;
+		fScrubAnchor = 0;
+		fScrubPressed = false;
+		fScrubbing = false;
+		fScrubPending = false;
+		fKeyRun = -1;
+		fKeyModifiers = 0;
+		fKeySteps = 0;
+		fLabelWidth = -1;
+		fValueWidth = -1;
+		fMeasuredFont.size = -1;
+		fLazyChildViews = false;
 	}
 	
 	~SpinnerPrivateData(void)
 	{
-		if (fRepeaterID != -1)
-		{
-			fExitRepeater = false;
-			kill_thread(fRepeaterID);
-		}
+		delete fNotifyRunner;
+		delete fRepeatCurve;
 	}
 	
-	static	int32	ButtonRepeaterThread(void *data);
-	
-			thread_id 		fRepeaterID;
-			scroll_bar_info	fScrollbarInfo;
-			BRect			fThumbFrame;
-			bool			fEnabled;
-			bool			tracking;
-			BPoint			fMousePoint;
-			float			fThumbIncrement;
-			bool			fExitRepeater;
-			arrow_direction	fArrowDown;
+			bigtime_t		fNotifyInterval;
+			bigtime_t		fLastNotify;
+			BMessageRunner*	fNotifyRunner;
+			bool			fNotifyPending;
+			
+			// NULL while the spinner uses the default curve
+			SpinnerRepeatCurve* fRepeatCurve;
+			SpinnerAutoRepeat fAutoRepeat;
+			spinner_tracking_mode fTrackingMode;
+			int32			fPageSteps;
+			
+			uint32			fWheelModifiers;
+			int32			fWheelMultiplier;
+			// what a high resolution wheel moved short of a whole notch
+			float			fWheelRemainder;
+			// the deltas of this frame, and when the first of them came,
+			// or -1 if there are none
+			float			fWheelPending;
+			bigtime_t		fWheelFrameStart;
+			
+			// an M_APPLY_INPUT is on its way
+			bool			fInputPosted;
+			
+			// Dragging on the label or an arrow. The anchor is where the
+			// pointer was when the value last followed it, the target
+			// where it went since, if the value is still to follow.
+			float			fScrubRatio;
+			float			fScrubAnchor;
+			BPoint			fScrubTarget;
+			bool			fScrubPressed;
+			bool			fScrubbing;
+			bool			fScrubPending;
+			
+			// The key whose press and repeats are being added up, or -1,
+			// and the steps they make so far
+			int32			fKeyRun;
+			int32			fKeyModifiers;
+			int64			fKeySteps;
+			
+			// widths as measured in fMeasuredFont, or -1 if unknown
+			spinner_font_key fMeasuredFont;
+			float			fLabelWidth;
+			float			fValueWidth;
+			
+			bool			fLazyChildViews;
+			// the value Draw() last showed while there is no text control
+			BString			fDrawnText;
 };
 
 
@@ -228,26 +429,20 @@ struct Spinner::LayoutData {
 		:
 		labelLayoutItem(NULL),
 		textFieldLayoutItem(NULL),
-		previousHeight(-1),
 		valid(false)
 	{
 	}
 	
-	BRect					labelBox;
-	
 	LabelLayoutItem*		labelLayoutItem;
 	TextFieldLayoutItem*	textFieldLayoutItem;
-	float					previousHeight;
 	
-	font_height				fontInfo;
+	// where DoLayout() put the text view while there was none yet
+	BRect					textViewFrame;
+	
 	float					labelWidth;
 	float					labelHeight;
-	BSize					textFieldHeight;
 	BSize					textFieldMin;
-	BSize					minSize;
-	BSize					maxSize;
 	BSize					min;
-	BAlignment				alignment;
 	bool					valid;
 };
 
@@ -436,7 +631,7 @@ Spinner::TextFieldLayoutItem::BaseMinSize()
 
 	BSize size = fParent->fLayoutData->textFieldMin;
 	size.width += B_V_SCROLL_BAR_WIDTH * 2;
-	size.height += fParent->fTextControl->TextView()->LineHeight(0) + 4.0;
+	size.height += fParent->_LineHeight() + 4.0;
 	return size;
 }
 
@@ -485,108 +680,247 @@ Spinner::TextFieldLayoutItem::Instantiate(BMessage* from)
 
 
 Spinner::Spinner(BRect frame, const char *name, const char *label, BMessage *msg,
-				uint32 resize,uint32 flags)
+				uint32 resize,uint32 flags, bool lazyChildViews)
 	:
 	BControl(frame,name,label,msg,resize,flags),
-	fStep(1),
-	fMin(0),
-	fMax(100)
+	fCore(new SpinnerInt32Core(0, 100, 1))
 {
-	_InitObject();
+	_InitObject(lazyChildViews);
 }
 
 
 Spinner::Spinner(BMessage *data)
 	:
-	BControl(data)
+	BControl(data),
+	fCore(SpinnerValueCore::Instantiate(data))
 {
-	if (data->FindInt32("_min",&fMin) != B_OK)
-		fMin = 0;
-	if (data->FindInt32("_max",&fMax) != B_OK)
-		fMin = 100;
-	if (data->FindInt32("_step",&fStep) != B_OK)
-		fMin = 1;
-	_InitObject();
+	bool lazyChildViews;
+	if (data->FindBool("_lazy_child_views", &lazyChildViews) != B_OK)
+		lazyChildViews = false;
+	_InitObject(lazyChildViews);
+	
+	bigtime_t interval;
+	if (data->FindInt64("_notify_interval", &interval) == B_OK)
+		SetNotificationInterval(interval);
+	
+	const char *curve;
+	if (data->FindString("_repeat_curve", &curve) == B_OK) {
+		SpinnerRepeatCurve repeatCurve;
+		if (repeatCurve.Parse(curve) == B_OK)
+			SetRepeatCurve(repeatCurve);
+	}
+	
+	int32 pageSteps;
+	if (data->FindInt32("_page_steps", &pageSteps) == B_OK)
+		SetPageSteps(pageSteps);
+	
+	float ratio;
+	if (data->FindFloat("_scrub_ratio", &ratio) == B_OK)
+		SetScrubRatio(ratio);
+	
+	int32 modifiers;
+	int32 multiplier;
+	if (data->FindInt32("_wheel_modifiers", &modifiers) == B_OK
+		&& data->FindInt32("_wheel_multiplier", &multiplier) == B_OK)
+		SetWheelMultiplier((uint32)modifiers, multiplier);
 }
 
 
 Spinner::Spinner(const char *name, const char *label, BMessage *msg
-	,uint32 resize, uint32 flags)
+	,uint32 resize, uint32 flags, bool lazyChildViews)
 	:
 	BControl(BRect(0,0,100,15),name, label, msg, resize, flags),
-	fStep(1),
-	fMin(0),
-	fMax(100)
+	fCore(new SpinnerInt32Core(0, 100, 1))
 {
-	_InitObject();
+	_InitObject(lazyChildViews);
 }
 
 
 Spinner::~Spinner(void)
 {
 	delete fPrivateData;
-	delete fFilter;
+	delete fLayoutData;
+	delete fCore;
 }
 
 
 void
-Spinner::_InitObject(void)
+Spinner::_InitObject(bool lazyChildViews)
 {
+	fLayoutData = NULL;
+	fDivider = 0;
+	
 	SetViewColor(ui_color(B_PANEL_BACKGROUND_COLOR));
 	BRect r(Bounds());
 	if (r.Height() < B_H_SCROLL_BAR_HEIGHT * 2)
 		r.bottom = r.top + 1 + B_H_SCROLL_BAR_HEIGHT * 2;
 	ResizeTo(r.Width(),r.Height());
 	
-	r.right -= B_V_SCROLL_BAR_WIDTH;
+	fTextControl = NULL;
+	fUpButton = NULL;
+	fDownButton = NULL;
+	fPrivateData = new SpinnerPrivateData;
+	fPrivateData->fLazyChildViews = lazyChildViews;
+	fFilter = NULL;
 	
-	font_height fh;
-	BFont font;
-	font.GetHeight(&fh);
-	float textheight = fh.ascent + fh.descent + fh.leading;
+	if (!lazyChildViews)
+		Materialize();
 	
-	r.top = 0;
-	r.bottom = textheight;
+	_SyncValue();
+}
+
+
+bool
+Spinner::LazyChildViews() const
+{
+	return fPrivateData->fLazyChildViews;
+}
+
+
+// Creates the text control and the arrow buttons where Draw() has been
+// showing them.
+void
+Spinner::Materialize()
+{
+	if (fTextControl != NULL)
+		return;
 	
-	fTextControl = new BTextControl(r,"textcontrol",Label(),"0",
-									new BMessage(M_TEXT_CHANGED), B_FOLLOW_TOP | 
-									B_FOLLOW_LEFT_RIGHT,
-									B_WILL_DRAW | B_NAVIGABLE);
-	AddChild(fTextControl);
-	fTextControl->ResizeTo(r.Width(), MAX(textheight, fTextControl->TextView()->LineHeight(0) + 4.0));
-	fTextControl->MoveTo(0,
-		((B_H_SCROLL_BAR_HEIGHT * 2) - fTextControl->Bounds().Height()) / 2);
-		
-	fTextControl->SetDivider(StringWidth(Label()) + 5);
+	fTextControl = new SpinnerTextControl(this, _TextControlFrame(), Label(),
+		new BMessage(M_TEXT_CHANGED));
+	fPrivateData->fDrawnText.Truncate(0);
+	fTextControl->SetDivider(_LabelWidth() + 5);
 	
 	BTextView *tview = fTextControl->TextView();
 	tview->SetAlignment(B_ALIGN_LEFT);
 	tview->SetWordWrap(false);
+	
+	// a layout or divider set in the meantime already placed the text view
+	if (fLayoutData != NULL && fLayoutData->textViewFrame.IsValid())
+		BLayoutUtils::AlignInFrame(tview, fLayoutData->textViewFrame);
+	else if ((Flags() & B_SUPPORTS_LAYOUT) == 0 && fDivider != 0)
+		tview->MoveTo(_TextFieldOffset(), B_V_SCROLL_BAR_WIDTH);
+	AddChild(fTextControl);
 
-	BString string("QWERTYUIOP[]\\ASDFGHJKL;'ZXCVBNM,/qwertyuiop{}| "
-		"asdfghjkl:\"zxcvbnm<>?!@#$%^&*()-_=+`~\r");
-
-	for (int32 i = 0; i < string.CountChars(); i++) {
-		char c = string.ByteAt(i);
-		tview->DisallowChar(c);
-	}
-
-	r = Bounds();
-	r.left = r.right - B_V_SCROLL_BAR_WIDTH;
-	r.bottom = B_H_SCROLL_BAR_HEIGHT;
+	// What may be typed or pasted is checked by the window's shared
+	// SpinnerMsgFilter, see SpinnerInputValidator.h
 
-	r.OffsetBy(0,r.Height() + 1);
+	BRect r = _ArrowFrame(false);
 	fDownButton = new SpinnerArrowButton(r.LeftTop(),"down",ARROW_DOWN,
-		r.Width()/2 + 1);
+		r.Height());
 	AddChild(fDownButton);
 
-	r.OffsetTo(r.right - B_V_SCROLL_BAR_WIDTH, B_H_SCROLL_BAR_HEIGHT/2 - 1);
+	r = _ArrowFrame(true);
 	fUpButton = new SpinnerArrowButton(r.LeftTop(),"up",ARROW_UP,
-		r.Width()/2 + 1);
+		r.Height());
 	AddChild(fUpButton);
+	
+	if (!IsEnabled()) {
+		fTextControl->SetEnabled(false);
+		fUpButton->SetEnabled(false);
+		fDownButton->SetEnabled(false);
+	}
+	
+	if (fFilter != NULL) {
+		fFilter->Register(tview, this);
+		fTextControl->SetTarget(this);
+	}
+	
+	_SyncValue();
+}
 
-	fPrivateData = new SpinnerPrivateData;
-	fFilter = new SpinnerMsgFilter;
+
+BTextControl*
+Spinner::TextControl(void)
+{
+	Materialize();
+	return fTextControl;
+}
+
+
+void
+Spinner::GetFootprint(spinner_footprint *footprint) const
+{
+	footprint->control = sizeof(*this);
+	footprint->privateData = sizeof(SpinnerPrivateData);
+	if (fPrivateData->fNotifyRunner != NULL)
+		footprint->privateData += sizeof(BMessageRunner);
+	footprint->layoutData = fLayoutData != NULL ? sizeof(LayoutData) : 0;
+	footprint->valueCore = fCore->Footprint();
+	footprint->repeatCurve = fPrivateData->fRepeatCurve != NULL
+		? sizeof(SpinnerRepeatCurve) : 0;
+	footprint->childViews = 0;
+	if (fTextControl != NULL) {
+		footprint->childViews = sizeof(SpinnerTextControl) + sizeof(BTextView)
+			+ 2 * sizeof(SpinnerArrowButton);
+	}
+	
+	footprint->total = footprint->control + footprint->privateData
+		+ footprint->layoutData + footprint->valueCore + footprint->repeatCurve
+		+ footprint->childViews;
+}
+
+
+// The frame the text control has, or is going to have, in the spinner.
+BRect
+Spinner::_TextControlFrame()
+{
+	float width = Bounds().Width() - B_V_SCROLL_BAR_WIDTH;
+	float height = _LineHeight() + 4.0;
+	float top = ((B_H_SCROLL_BAR_HEIGHT * 2) - height) / 2;
+	return BRect(0, top, width, top + height);
+}
+
+
+// The frame of the text view in the spinner's coordinates. Before the
+// text control exists, this is where it is going to put the text view.
+BRect
+Spinner::_TextViewFrame()
+{
+	BRect control = _TextControlFrame();
+	if (fTextControl != NULL)
+		return fTextControl->ConvertToParent(fTextControl->TextView()->Frame());
+	
+	BRect frame;
+	if (fLayoutData != NULL && fLayoutData->textViewFrame.IsValid())
+		frame = fLayoutData->textViewFrame;
+	else {
+		frame = control.OffsetToCopy(0, 0);
+		frame.left = floorf(_LabelWidth() + 5 + 0.5);
+		frame.InsetBy(2, 2);
+		if ((Flags() & B_SUPPORTS_LAYOUT) == 0 && fDivider != 0)
+			frame.OffsetTo(_TextFieldOffset(), B_V_SCROLL_BAR_WIDTH);
+	}
+	return frame.OffsetByCopy(control.LeftTop());
+}
+
+
+// Where the arrow buttons are. Both are twice as wide as they are tall,
+// stacked at the right edge.
+BRect
+Spinner::_ArrowFrame(bool up)
+{
+	const spinner_style &style = SpinnerStyle::Get();
+	BPoint location(Bounds().right - style.arrowInset,
+		up ? style.upArrowTop : style.downArrowTop);
+	return BRect(0, 0, style.arrowWidth, style.arrowHeight)
+		.OffsetToCopy(location);
+}
+
+
+float
+Spinner::_LineHeight()
+{
+	if (fTextControl != NULL)
+		return fTextControl->TextView()->LineHeight(0);
+	
+	BFont font;
+	GetFont(&font);
+	if (font == *be_plain_font)
+		return SpinnerStyle::Get().plainLineHeight;
+	
+	font_height fontHeight;
+	GetFontHeight(&fontHeight);
+	return ceilf(fontHeight.ascent + fontHeight.descent + fontHeight.leading);
 }
 
 
@@ -607,13 +941,28 @@ Spinner::Archive(BMessage *data, bool deep) const
 	data->AddString("class","Spinner");
 	
 	if (status == B_OK)
-		status = data->AddInt32("_min",fMin);
-	
-	if (status == B_OK)
-		status = data->AddInt32("_max",fMax);
-	
-	if (status == B_OK)
-		status = data->AddInt32("_step",fStep);
+		status = fCore->Archive(data);
+	if (status == B_OK && fPrivateData->fNotifyInterval > 0)
+		status = data->AddInt64("_notify_interval",
+			fPrivateData->fNotifyInterval);
+	if (status == B_OK && fPrivateData->fRepeatCurve != NULL) {
+		char curve[SPINNER_REPEAT_CURVE_TEXT_SIZE];
+		fPrivateData->fRepeatCurve->Format(curve, sizeof(curve));
+		status = data->AddString("_repeat_curve", curve);
+	}
+	if (status == B_OK && fPrivateData->fPageSteps != kDefaultPageSteps)
+		status = data->AddInt32("_page_steps", fPrivateData->fPageSteps);
+	if (status == B_OK && fPrivateData->fScrubRatio != kDefaultScrubRatio)
+		status = data->AddFloat("_scrub_ratio", fPrivateData->fScrubRatio);
+	if (status == B_OK && fPrivateData->fWheelModifiers != 0) {
+		status = data->AddInt32("_wheel_modifiers",
+			fPrivateData->fWheelModifiers);
+		if (status == B_OK)
+			status = data->AddInt32("_wheel_multiplier",
+				fPrivateData->fWheelMultiplier);
+	}
+	if (status == B_OK && fPrivateData->fLazyChildViews)
+		status = data->AddBool("_lazy_child_views", true);
 	
 	return status;
 }
@@ -634,6 +983,10 @@ BHandler*
 Spinner::ResolveSpecifier(BMessage *msg, int32 index, BMessage *specifier,
 									int32 form, const char *property)
 {
+	BPropertyInfo propertyInfo(sProperties);
+	if (propertyInfo.FindMatch(msg, index, specifier, form, property) >= 0)
+		return this;
+	
 	return BControl::ResolveSpecifier(msg, index, specifier, form, property);
 }
 
@@ -641,36 +994,48 @@ Spinner::ResolveSpecifier(BMessage *msg, int32 index, BMessage *specifier,
 void
 Spinner::AttachedToWindow(void)
 {
-	Window()->AddCommonFilter(fFilter);
-	fTextControl->SetTarget(this);
+	fFilter = SpinnerMsgFilter::Acquire(Window());
+	if (fTextControl != NULL) {
+		fFilter->Register(fTextControl->TextView(), this);
+		fTextControl->SetTarget(this);
+	}
 }
 
 
 void
 Spinner::DetachedFromWindow(void)
 {
-	Window()->RemoveCommonFilter(fFilter);
+	// neither the flush timer nor a posted M_APPLY_INPUT can reach us
+	// anymore
+	_ApplyInput();
+	fPrivateData->fInputPosted = false;
+	FlushNotification();
+	if (fTextControl != NULL)
+		fFilter->Unregister(fTextControl->TextView());
+	fFilter->Release(Window());
+	fFilter = NULL;
 }
 
 
 void
 Spinner::SetValue(int32 value)
 {
-	if (value > GetMax() || value < GetMin())
+	if (!fCore->Contains(value))
 		return;
 	
-	BControl::SetValue(value);
-	
-	char string[50];
-	sprintf(string,"%ld",value);
-	fTextControl->SetText(string);
+	fCore->SetInt32(SPINNER_VALUE, value);
+	_SyncValue();
 }
 
 
 void
 Spinner::SetLabel(const char *text)
 {
-	fTextControl->SetLabel(text);
+	BControl::SetLabel(text);
+	if (fTextControl != NULL)
+		fTextControl->SetLabel(text);
+	fPrivateData->fLabelWidth = -1;
+	InvalidateLayout();
 }
 
 
@@ -683,185 +1048,830 @@ Spinner::ValueChanged(int32 value)
 void
 Spinner::MessageReceived(BMessage *msg)
 {
-	if (msg->what == M_TEXT_CHANGED) {
-		BString string(fTextControl->Text());
-		int32 newvalue = 0;
+	switch (msg->what) {
+		case M_TEXT_CHANGED:
+			_SetValueFromText(fTextControl->Text());
+			break;
 		
-		sscanf(string.String(),"%ld",&newvalue);
-		if (newvalue >= GetMin() && newvalue <= GetMax()) {
-			// new value is in range, so set it and go
-			SetValue(newvalue);
-			Invoke();
-			Invalidate();
-			ValueChanged(Value());
-		} else {
-			// new value is out of bounds. Clip to range if current value is not
-			// at the end of its range
-			if (newvalue < GetMin() && Value() != GetMin()) {
-				SetValue(GetMin());
-				Invoke();
-				Invalidate();
-				ValueChanged(Value());
-			} else if (newvalue>GetMax() && Value() != GetMax()) {
-				SetValue(GetMax());
-				Invoke();
+		case M_FLUSH_NOTIFICATION:
+			FlushNotification();
+			break;
+		
+		case M_APPLY_INPUT:
+			fPrivateData->fInputPosted = false;
+			_ApplyInput();
+			break;
+		
+		case B_MOUSE_WHEEL_CHANGED:
+			_WheelChanged(msg);
+			break;
+		
+		case B_FONTS_UPDATED:
+			SpinnerStyle::SettingsChanged();
+			BControl::MessageReceived(msg);
+			break;
+		
+		case B_COLORS_UPDATED:
+			SpinnerStyle::SettingsChanged();
+			// the arrow buttons do this once they exist
+			if (fTextControl == NULL) {
+				SpinnerArrowCache::Clear();
 				Invalidate();
-				ValueChanged(Value());
-			} else {
-				char string[100];
-				sprintf(string,"%ld",Value());
-				fTextControl->SetText(string);
 			}
-		}
+			BControl::MessageReceived(msg);
+			break;
+		
+		case B_GET_PROPERTY:
+		case B_SET_PROPERTY:
+			if (!_HandleScriptingMessage(msg))
+				BControl::MessageReceived(msg);
+			break;
+		
+		default:
+			BControl::MessageReceived(msg);
+			break;
 	}
-	else
-		BControl::MessageReceived(msg);
 }
 
 
+// Until the child views exist, the spinner draws what they would show:
+// the label, the framed value and the arrows.
 void
-Spinner::GetPreferredSize(float *width, float *height)
+Spinner::Draw(BRect update)
 {
-	float w, h;
-	
-	// This code shamelessly copied from the Haiku TextControl.cpp and adapted
-	
-	// we need enough space for the label and the child text view
-	font_height fontHeight;
-	fTextControl->GetFontHeight(&fontHeight);
-	float labelHeight = ceil(fontHeight.ascent + fontHeight.descent + fontHeight.leading);
-	float textHeight = fTextControl->TextView()->LineHeight(0) + 4.0;
-
-	h = max_c(labelHeight, textHeight);
+	if (fTextControl != NULL)
+		return;
 	
-	w = 25.0f + ceilf(fTextControl->StringWidth(fTextControl->Label())) + 
-		ceilf(fTextControl->StringWidth(fTextControl->Text()));
+	float tint = IsEnabled() ? B_NO_TINT : B_DISABLED_LABEL_TINT;
+	BRect field = _TextViewFrame();
+	BRect box = field.InsetByCopy(-2, -2);
+	if (!field.Contains(update)) {
+		SetHighColor(ui_color(B_CONTROL_BORDER_COLOR));
+		StrokeRect(box);
+		if (Label() != NULL) {
+			SetHighColor(tint_color(ui_color(B_PANEL_TEXT_COLOR), tint));
+			DrawString(Label(), BPoint(0, box.bottom - 3));
+		}
+	}
 	
-	w += B_V_SCROLL_BAR_WIDTH;
-	if (h < fDownButton->Frame().bottom)
-		h = fDownButton->Frame().bottom;
+	if (field.Intersects(update)) {
+		char string[SPINNER_TEXT_BUFFER_SIZE];
+		fCore->Format(string, sizeof(string));
+		fPrivateData->fDrawnText = string;
+		SetHighColor(ui_color(B_DOCUMENT_BACKGROUND_COLOR));
+		FillRect(field);
+		SetHighColor(tint_color(ui_color(B_DOCUMENT_TEXT_COLOR), tint));
+		DrawString(string, BPoint(field.left + 1, field.bottom - 1));
+	}
 	
-	if (width)
-		*width = w;
-	if (height)
-		*height = h;
+	spinner_arrow_state state = IsEnabled()
+		? SPINNER_ARROW_NORMAL : SPINNER_ARROW_DISABLED;
+	if (_ArrowFrame(true).Intersects(update)) {
+		SpinnerArrowCache::Draw(this, _ArrowFrame(true),
+			BControlLook::B_UP_ARROW, state);
+	}
+	if (_ArrowFrame(false).Intersects(update)) {
+		SpinnerArrowCache::Draw(this, _ArrowFrame(false),
+			BControlLook::B_DOWN_ARROW, state);
+	}
 }
 
 
+// A click on a spinner that is only drawn creates the child views and
+// hands the click on to the one that was hit.
 void
-Spinner::ResizeToPreferred(void)
+Spinner::MouseDown(BPoint where)
 {
-	float w,h;
-	GetPreferredSize(&w,&h);
-	ResizeTo(w,h);
+	if (fTextControl != NULL) {
+		BControl::MouseDown(where);
+		return;
+	}
+	
+	Materialize();
+	if (fUpButton->Frame().Contains(where))
+		fUpButton->MouseDown(fUpButton->ConvertFromParent(where));
+	else if (fDownButton->Frame().Contains(where))
+		fDownButton->MouseDown(fDownButton->ConvertFromParent(where));
+	else if (fTextControl->Frame().Contains(where)
+		&& where.x < _TextViewFrame().left)
+		fTextControl->MouseDown(fTextControl->ConvertFromParent(where));
+	else if (IsEnabled())
+		MakeFocus(true);
 }
 
 
 void
-Spinner::_UpdateFrame()
+Spinner::MouseMoved(BPoint where, uint32 transit, const BMessage *msg)
 {
-	if (fLayoutData->labelLayoutItem == NULL
-		|| fLayoutData->textFieldLayoutItem == NULL)
+	if (fTextControl != NULL || (transit != B_ENTERED_VIEW
+			&& transit != B_INSIDE_VIEW)) {
+		BControl::MouseMoved(where, transit, msg);
 		return;
+	}
+	
+	// the arrow under the mouse shows the hover right away
+	Materialize();
+	for (int32 i = 0; i < CountChildren(); i++) {
+		BView *child = ChildAt(i);
+		if (child->Frame().Contains(where)) {
+			child->MouseMoved(child->ConvertFromParent(where),
+				B_ENTERED_VIEW, msg);
+		}
+	}
+}
 
-	BRect labelFrame = fLayoutData->labelLayoutItem->Frame();
-	BRect textFrame = fLayoutData->textFieldLayoutItem->Frame();
-
-	if (!labelFrame.IsValid() || !textFrame.IsValid())
-		return;
 
-	fDivider = textFrame.left - labelFrame.left;
+bool
+Spinner::_HandleScriptingMessage(BMessage *msg)
+{
+	int32 index;
+	int32 form;
+	const char *property;
+	BMessage specifier;
+	if (msg->GetCurrentSpecifier(&index, &specifier, &form, &property) != B_OK)
+		return false;
 	
-	MoveTo(labelFrame.left, labelFrame.top);
-	BSize oldSize = Bounds().Size();
-	ResizeTo(textFrame.left + textFrame.Width() - labelFrame.left,
-		textFrame.top + textFrame.Height() - labelFrame.top);
-	BSize newSize = Bounds().Size();
+	if (strcmp(property, "RepeatCurve") == 0) {
+		BMessage reply(B_REPLY);
+		status_t status = B_OK;
+		if (msg->what == B_GET_PROPERTY) {
+			char curve[SPINNER_REPEAT_CURVE_TEXT_SIZE];
+			RepeatCurve().Format(curve, sizeof(curve));
+			status = reply.AddString("result", curve);
+		} else {
+			const char *curve;
+			status = msg->FindString("data", &curve);
+			SpinnerRepeatCurve repeatCurve(RepeatCurve());
+			if (status == B_OK)
+				status = repeatCurve.Parse(curve);
+			if (status == B_OK)
+				SetRepeatCurve(repeatCurve);
+		}
+		
+		reply.AddInt32("error", status);
+		msg->SendReply(&reply);
+		return true;
+	}
 	
-	if (newSize != oldSize)
-		Relayout();
+	spinner_field field;
+	if (strcmp(property, "Value") == 0)
+		field = SPINNER_VALUE;
+	else if (strcmp(property, "MinValue") == 0)
+		field = SPINNER_MIN;
+	else if (strcmp(property, "MaxValue") == 0)
+		field = SPINNER_MAX;
+	else if (strcmp(property, "Step") == 0)
+		field = SPINNER_STEP;
+	else
+		return false;
+	
+	BMessage reply(B_REPLY);
+	status_t status;
+	if (msg->what == B_GET_PROPERTY)
+		status = fCore->GetField(field, &reply, "result");
+	else {
+		bool changed = false;
+		status = fCore->SetField(field, msg, "data", &changed);
+		if (field == SPINNER_MIN || field == SPINNER_MAX)
+			fPrivateData->fValueWidth = -1;
+		if (changed && field == SPINNER_VALUE)
+			_CommitValue();
+		else if (changed)
+			_SyncValue();
+	}
+	
+	reply.AddInt32("error", status);
+	msg->SendReply(&reply);
+	return true;
 }
 
 
 void
-Spinner::_ValidateLayoutData()
+Spinner::_SyncValue()
 {
-	if (fLayoutData->valid)
+	// BControl::SetValue() would invalidate the whole control. The text view
+	// redraws its own text when it changes, and only then; nothing else in
+	// the control depends on the value
+	SetValueNoUpdate(fCore->Int32(SPINNER_VALUE));
+	
+	char string[SPINNER_TEXT_BUFFER_SIZE];
+	fCore->Format(string, sizeof(string));
+	if (fTextControl == NULL) {
+		// until the text control exists, the spinner draws the number
+		if (fPrivateData->fDrawnText != string)
+			Invalidate(_TextViewFrame());
 		return;
-	font_height fontHeight = fLayoutData->fontInfo;
-	GetFontHeight(&fontHeight);
-
-	if (Label() != NULL) {
-		fLayoutData->labelWidth = 25.0f + B_V_SCROLL_BAR_WIDTH
-			+ ceilf(fTextControl->StringWidth(fTextControl->Label()));
-		fLayoutData->labelHeight =  ceil(fontHeight.ascent
-			+ fontHeight.descent + fontHeight.leading);
-	} else {
-		fLayoutData->labelWidth = 0;
-		fLayoutData->labelHeight = 0;	
 	}
-
-	float divider = 0;
-	if (fLayoutData->labelWidth > 0)
-		divider = fLayoutData->labelWidth + 5;
-		
-	if ((Flags() & B_SUPPORTS_LAYOUT) == 0)
-		divider = std::max(divider,fDivider);
-	
-	fLayoutData->textFieldHeight = fTextControl->MinSize();
-	BSize min(fLayoutData->textFieldMin);
-	min.height =  fTextControl->TextView()->LineHeight(0) + 4.0;
-	min.width = 25.0f + ceilf(fTextControl->StringWidth(fTextControl->Text()));
 	
-	if (divider > 0)
-		min.width += divider;
-	if (fLayoutData->labelHeight > min.height)
-		min.height = fLayoutData->labelHeight;
-		
-	fLayoutData->min = min;
-	fLayoutData->valid = true;
-	ResetLayoutInvalidation();
+	if (strcmp(string, fTextControl->Text()) != 0)
+		fTextControl->SetText(string);
 }
 
 
 void
-Spinner::SetSteps(int32 stepsize)
+Spinner::_CommitValue()
 {
-	fStep = stepsize;
+	_SyncValue();
+	
+	SpinnerPrivateData *data = fPrivateData;
+	if (data->fNotifyInterval <= 0 || Looper() == NULL) {
+		_Notify();
+		return;
+	}
+	
+	bigtime_t elapsed = system_time() - data->fLastNotify;
+	if (elapsed >= data->fNotifyInterval) {
+		_Notify();
+		return;
+	}
+	
+	// Too soon: remember the change and make sure it goes out at the end
+	// of the interval even if no further step comes along
+	data->fNotifyPending = true;
+	if (data->fNotifyRunner == NULL) {
+		BMessage flush(M_FLUSH_NOTIFICATION);
+		data->fNotifyRunner = new BMessageRunner(BMessenger(this), &flush,
+			data->fNotifyInterval - elapsed, 1);
+	}
 }
 
 
 void
-Spinner::SetRange(int32 min, int32 max)
+Spinner::_Notify()
 {
-	SetMin(min);
-	SetMax(max);
+	SpinnerPrivateData *data = fPrivateData;
+	data->fNotifyPending = false;
+	delete data->fNotifyRunner;
+	data->fNotifyRunner = NULL;
+	data->fLastNotify = system_time();
+	
+	Invoke();
+	ValueChanged(Value());
 }
 
 
 void
-Spinner::GetRange(int32 *min, int32 *max)
+Spinner::SetNotificationInterval(bigtime_t interval)
 {
-	*min = fMin;
-	*max = fMax;
+	fPrivateData->fNotifyInterval = interval > 0 ? interval : 0;
+	if (interval <= 0)
+		FlushNotification();
 }
 
 
-void
+bigtime_t
+Spinner::NotificationInterval() const
+{
+	return fPrivateData->fNotifyInterval;
+}
+
+
+void
+Spinner::SetRepeatCurve(const SpinnerRepeatCurve &curve)
+{
+	// Most spinners keep the default, and share it instead of carrying a
+	// copy of their own
+	if (curve == _DefaultRepeatCurve()) {
+		delete fPrivateData->fRepeatCurve;
+		fPrivateData->fRepeatCurve = NULL;
+	} else if (fPrivateData->fRepeatCurve == NULL)
+		fPrivateData->fRepeatCurve = new SpinnerRepeatCurve(curve);
+	else
+		*fPrivateData->fRepeatCurve = curve;
+}
+
+
+const SpinnerRepeatCurve&
+Spinner::RepeatCurve() const
+{
+	if (fPrivateData->fRepeatCurve == NULL)
+		return _DefaultRepeatCurve();
+	return *fPrivateData->fRepeatCurve;
+}
+
+
+const SpinnerRepeatCurve&
+Spinner::_DefaultRepeatCurve()
+{
+	static const SpinnerRepeatCurve sDefault;
+	return sDefault;
+}
+
+
+void
+Spinner::SetTrackingMode(spinner_tracking_mode mode)
+{
+	fPrivateData->fTrackingMode = mode;
+}
+
+
+spinner_tracking_mode
+Spinner::TrackingMode() const
+{
+	return fPrivateData->fTrackingMode;
+}
+
+
+void
+Spinner::SetPageSteps(int32 steps)
+{
+	fPrivateData->fPageSteps = steps > 0 ? steps : 1;
+}
+
+
+int32
+Spinner::PageSteps() const
+{
+	return fPrivateData->fPageSteps;
+}
+
+
+void
+Spinner::SetScrubRatio(float pixelsPerStep)
+{
+	fPrivateData->fScrubRatio = pixelsPerStep > 0 ? pixelsPerStep : 0;
+}
+
+
+float
+Spinner::ScrubRatio() const
+{
+	return fPrivateData->fScrubRatio;
+}
+
+
+void
+Spinner::SetWheelMultiplier(uint32 modifiers, int32 multiplier)
+{
+	fPrivateData->fWheelModifiers = modifiers;
+	fPrivateData->fWheelMultiplier = multiplier > 0 ? multiplier : 1;
+}
+
+
+int32
+Spinner::WheelMultiplier(uint32 *modifiers) const
+{
+	if (modifiers != NULL)
+		*modifiers = fPrivateData->fWheelModifiers;
+	return fPrivateData->fWheelMultiplier;
+}
+
+
+void
+Spinner::FlushNotification()
+{
+	if (fPrivateData->fNotifyPending)
+		_Notify();
+	else {
+		delete fPrivateData->fNotifyRunner;
+		fPrivateData->fNotifyRunner = NULL;
+	}
+}
+
+
+void
+Spinner::_StepValue(int32 count)
+{
+	if (fCore->StepBy(count))
+		_CommitValue();
+}
+
+
+// Wheeling up raises the value. The deltas are only added up here, and
+// applied by the M_APPLY_INPUT this posts: the wheel messages already
+// queued come before it, so a fast spin is one step of many. A message
+// a frame or more after the first one of the sum starts a new one.
+void
+Spinner::_WheelChanged(BMessage *msg)
+{
+	float delta;
+	if (!IsEnabled() || msg->FindFloat("be:wheel_delta_y", &delta) != B_OK)
+		return;
+	
+	SpinnerPrivateData *data = fPrivateData;
+	bigtime_t when = msg->GetInt64("when", system_time());
+	if (data->fWheelFrameStart >= 0
+		&& when - data->fWheelFrameStart >= kWheelFrameInterval)
+		_ApplyWheel();
+	if (data->fWheelFrameStart < 0)
+		data->fWheelFrameStart = when;
+	data->fWheelPending += delta;
+	_PostInput();
+}
+
+
+void
+Spinner::_ApplyWheel()
+{
+	SpinnerPrivateData *data = fPrivateData;
+	if (data->fWheelFrameStart < 0)
+		return;
+	
+	float delta = data->fWheelPending + data->fWheelRemainder;
+	data->fWheelPending = 0;
+	data->fWheelFrameStart = -1;
+	int64 notches = (int64)delta;
+	data->fWheelRemainder = delta - notches;
+	if (notches == 0 || !IsEnabled())
+		return;
+	
+	uint32 modifiers = fPrivateData->fWheelModifiers;
+	if (modifiers != 0 && (::modifiers() & modifiers) == modifiers)
+		notches *= fPrivateData->fWheelMultiplier;
+	
+	notches = std::max<int64>(std::min<int64>(-notches, INT32_MAX),
+		-INT32_MAX);
+	_StepValue((int32)notches);
+}
+
+
+// Input that was added up is applied by an M_APPLY_INPUT the spinner posts
+// to itself, once per pass over what the looper had queued. Nothing is
+// taken out of the looper's queue, so every handler still gets its own
+// messages.
+void
+Spinner::_PostInput()
+{
+	SpinnerPrivateData *data = fPrivateData;
+	if (data->fInputPosted)
+		return;
+	
+	if (Looper() != NULL && Looper()->PostMessage(M_APPLY_INPUT, this) == B_OK)
+		data->fInputPosted = true;
+	else
+		_ApplyInput();
+}
+
+
+// Also called before any input that changes the value right away, so that
+// what came first is applied first.
+void
+Spinner::_ApplyInput()
+{
+	_ApplyWheel();
+	_ApplyScrub();
+	_ApplyKeySteps();
+}
+
+
+// The press of a key and its repeats are added up, and applied by the
+// M_APPLY_INPUT the press posts: the repeats that piled up behind it while
+// the target was busy make one bigger step, so the value stops moving as
+// soon as the key is let go. A new press, or a repeat of another key or
+// with other modifiers, applies the steps before it first.
+void
+Spinner::_KeyStep(const BMessage *msg, int32 key, int64 steps)
+{
+	SpinnerPrivateData *data = fPrivateData;
+	int32 modifiers = msg->GetInt32("modifiers", 0);
+	if (msg->GetInt32("be:key_repeat", 0) <= 0 || key != data->fKeyRun
+		|| modifiers != data->fKeyModifiers) {
+		_ApplyInput();
+		data->fKeyRun = key;
+		data->fKeyModifiers = modifiers;
+	}
+	
+	data->fKeySteps += steps;
+	_PostInput();
+}
+
+
+void
+Spinner::_ApplyKeySteps()
+{
+	SpinnerPrivateData *data = fPrivateData;
+	if (data->fKeyRun < 0)
+		return;
+	
+	int64 steps = data->fKeySteps;
+	data->fKeyRun = -1;
+	data->fKeySteps = 0;
+	_StepValue((int32)std::max<int64>(std::min<int64>(steps, INT32_MAX),
+		-INT32_MAX));
+}
+
+
+// A press on the label or an arrow may turn into a drag. Positions are in
+// the spinner's coordinates.
+void
+Spinner::_BeginScrub(BPoint where)
+{
+	_ApplyInput();
+	fPrivateData->fScrubPressed = fPrivateData->fScrubRatio > 0;
+	fPrivateData->fScrubbing = false;
+	fPrivateData->fScrubAnchor = where.y;
+}
+
+
+// Once the pointer has moved far enough up or down, the value follows it,
+// one step per fScrubRatio pixels, up for more. Returns whether the press
+// is a drag by now.
+bool
+Spinner::_ScrubTo(BPoint where)
+{
+	SpinnerPrivateData *data = fPrivateData;
+	if (!data->fScrubPressed)
+		return false;
+	
+	float distance = data->fScrubAnchor - where.y;
+	if (!data->fScrubbing) {
+		if (fabsf(distance) < kScrubSlop)
+			return false;
+		data->fScrubbing = true;
+		data->fAutoRepeat.Stop();
+	}
+	
+	int32 steps = (int32)(distance / data->fScrubRatio);
+	if (steps != 0) {
+		data->fScrubAnchor -= steps * data->fScrubRatio;
+		_StepValue(steps);
+	}
+	return true;
+}
+
+
+// Like _ScrubTo(), for a B_MOUSE_MOVED. Whether the press is a drag is
+// decided right away, but the value only follows the pointer from the
+// M_APPLY_INPUT this posts, to where the last of the moves queued before
+// it went. So it changes at most once per pass of the looper.
+bool
+Spinner::_ScrubMoved(BPoint where)
+{
+	SpinnerPrivateData *data = fPrivateData;
+	if (!data->fScrubPressed)
+		return false;
+	
+	if (!data->fScrubbing) {
+		if (fabsf(data->fScrubAnchor - where.y) < kScrubSlop)
+			return false;
+		data->fScrubbing = true;
+		data->fAutoRepeat.Stop();
+	}
+	
+	data->fScrubTarget = where;
+	data->fScrubPending = true;
+	_PostInput();
+	return true;
+}
+
+
+void
+Spinner::_ApplyScrub()
+{
+	if (!fPrivateData->fScrubPending)
+		return;
+	
+	fPrivateData->fScrubPending = false;
+	_ScrubTo(fPrivateData->fScrubTarget);
+}
+
+
+// Returns whether the press was a drag
+bool
+Spinner::_EndScrub()
+{
+	// the value gets to where the pointer was let go
+	_ApplyScrub();
+	
+	bool scrubbed = fPrivateData->fScrubbing;
+	fPrivateData->fScrubPressed = false;
+	fPrivateData->fScrubbing = false;
+	if (scrubbed)
+		FlushNotification();
+	return scrubbed;
+}
+
+
+// Goes through the text so that it works the same for every value core,
+// whatever the type of its limits.
+void
+Spinner::_StepToLimit(spinner_field limit)
+{
+	char text[SPINNER_TEXT_BUFFER_SIZE];
+	fCore->FormatField(limit, text, sizeof(text));
+	if (fCore->SetFromText(text))
+		_CommitValue();
+}
+
+
+void
+Spinner::_SetValueFromText(const char *text)
+{
+	// Out of range input is clipped to the nearest end of the range. If that
+	// leaves the value where it was, just put the text back the way it was.
+	if (fCore->SetFromText(text))
+		_CommitValue();
+	else
+		_SyncValue();
+}
+
+
+void
+Spinner::GetPreferredSize(float *width, float *height)
+{
+	float w, h;
+	
+	// This code shamelessly copied from the Haiku TextControl.cpp and adapted
+	
+	// we need enough space for the label and the child text view
+	font_height fontHeight;
+	if (fTextControl != NULL)
+		fTextControl->GetFontHeight(&fontHeight);
+	else
+		GetFontHeight(&fontHeight);
+	float labelHeight = ceil(fontHeight.ascent + fontHeight.descent + fontHeight.leading);
+	float textHeight = _LineHeight() + 4.0;
+
+	h = max_c(labelHeight, textHeight);
+	
+	w = 25.0f + ceilf(_LabelWidth()) + ceilf(_ValueWidth());
+	
+	w += B_V_SCROLL_BAR_WIDTH;
+	if (h < _ArrowFrame(false).bottom)
+		h = _ArrowFrame(false).bottom;
+	
+	if (width)
+		*width = w;
+	if (height)
+		*height = h;
+}
+
+
+void
+Spinner::ResizeToPreferred(void)
+{
+	float w,h;
+	GetPreferredSize(&w,&h);
+	ResizeTo(w,h);
+}
+
+
+void
+Spinner::_UpdateFrame()
+{
+	if (fLayoutData == NULL || fLayoutData->labelLayoutItem == NULL
+		|| fLayoutData->textFieldLayoutItem == NULL)
+		return;
+
+	BRect labelFrame = fLayoutData->labelLayoutItem->Frame();
+	BRect textFrame = fLayoutData->textFieldLayoutItem->Frame();
+
+	if (!labelFrame.IsValid() || !textFrame.IsValid())
+		return;
+
+	fDivider = textFrame.left - labelFrame.left;
+	
+	MoveTo(labelFrame.left, labelFrame.top);
+	BSize oldSize = Bounds().Size();
+	ResizeTo(textFrame.left + textFrame.Width() - labelFrame.left,
+		textFrame.top + textFrame.Height() - labelFrame.top);
+	BSize newSize = Bounds().Size();
+	
+	if (newSize != oldSize)
+		Relayout();
+}
+
+
+// Spinners that are not part of a layout never need the layout data, so it
+// is only allocated once a layout asks for it.
+Spinner::LayoutData*
+Spinner::_LayoutData()
+{
+	if (fLayoutData == NULL)
+		fLayoutData = new LayoutData;
+	return fLayoutData;
+}
+
+
+void
+Spinner::_ValidateLayoutData()
+{
+	if (_LayoutData()->valid)
+		return;
+	font_height fontHeight;
+	GetFontHeight(&fontHeight);
+
+	if (Label() != NULL) {
+		fLayoutData->labelWidth = 25.0f + B_V_SCROLL_BAR_WIDTH
+			+ ceilf(_LabelWidth());
+		fLayoutData->labelHeight =  ceil(fontHeight.ascent
+			+ fontHeight.descent + fontHeight.leading);
+	} else {
+		fLayoutData->labelWidth = 0;
+		fLayoutData->labelHeight = 0;	
+	}
+
+	float divider = 0;
+	if (fLayoutData->labelWidth > 0)
+		divider = fLayoutData->labelWidth + 5;
+		
+	if ((Flags() & B_SUPPORTS_LAYOUT) == 0)
+		divider = std::max(divider,fDivider);
+	
+	BSize min(fLayoutData->textFieldMin);
+	min.height =  _LineHeight() + 4.0;
+	min.width = 25.0f + ceilf(_ValueWidth());
+	
+	if (divider > 0)
+		min.width += divider;
+	if (fLayoutData->labelHeight > min.height)
+		min.height = fLayoutData->labelHeight;
+		
+	fLayoutData->min = min;
+	fLayoutData->valid = true;
+	ResetLayoutInvalidation();
+}
+
+
+// The widths are measured in the text control's font. Both go through the
+// process wide SpinnerWidthCache, and the value width is that of the widest
+// number in the range, so that the value can change without a re-measure.
+float
+Spinner::_LabelWidth()
+{
+	BFont font;
+	_UpdateMeasuredFont(&font);
+	if (fPrivateData->fLabelWidth < 0) {
+		fPrivateData->fLabelWidth = SpinnerWidthCache::StringWidth(font,
+			Label());
+	}
+	return fPrivateData->fLabelWidth;
+}
+
+
+float
+Spinner::_ValueWidth()
+{
+	BFont font;
+	_UpdateMeasuredFont(&font);
+	if (fPrivateData->fValueWidth < 0) {
+		char min[SPINNER_TEXT_BUFFER_SIZE];
+		char max[SPINNER_TEXT_BUFFER_SIZE];
+		fCore->FormatField(SPINNER_MIN, min, sizeof(min));
+		fCore->FormatField(SPINNER_MAX, max, sizeof(max));
+		fPrivateData->fValueWidth = SpinnerWidthCache::WidestNumberWidth(
+			font, min, max);
+	}
+	return fPrivateData->fValueWidth;
+}
+
+
+// Gets the font the widths are measured in, and forgets them if it changed
+// since they were.
+void
+Spinner::_UpdateMeasuredFont(BFont *font)
+{
+	if (fTextControl != NULL)
+		fTextControl->GetFont(font);
+	else
+		GetFont(font);
+	if (fPrivateData->fMeasuredFont.Matches(*font))
+		return;
+	
+	fPrivateData->fMeasuredFont.Set(*font);
+	fPrivateData->fLabelWidth = -1;
+	fPrivateData->fValueWidth = -1;
+}
+
+
+void
+Spinner::SetSteps(int32 stepsize)
+{
+	fCore->SetInt32(SPINNER_STEP, stepsize);
+}
+
+
+void
+Spinner::SetRange(int32 min, int32 max)
+{
+	SetMin(min);
+	SetMax(max);
+}
+
+
+void
+Spinner::GetRange(int32 *min, int32 *max)
+{
+	*min = GetMin();
+	*max = GetMax();
+}
+
+
+void
 Spinner::SetMax(int32 max)
 {
-	fMax = max;
-	if (Value() > fMax)
-		SetValue(fMax);
+	fPrivateData->fValueWidth = -1;
+	if (fCore->SetInt32(SPINNER_MAX, max))
+		_SyncValue();
 }
 
 
 void
 Spinner::SetMin(int32 min)
 {
-	fMin = min;
-	if (Value() < fMin)
-		SetValue(fMin);
+	fPrivateData->fValueWidth = -1;
+	if (fCore->SetInt32(SPINNER_MIN, min))
+		_SyncValue();
 }
 
 
@@ -872,6 +1882,14 @@ Spinner::SetEnabled(bool value)
 		return;
 	
 	BControl::SetEnabled(value);
+	if (fTextControl == NULL)
+		return;
+	
+	if (!value) {
+		fUpButton->CancelTracking();
+		fDownButton->CancelTracking();
+	}
+	
 	fTextControl->SetEnabled(value);
 	fUpButton->SetEnabled(value);
 	fDownButton->SetEnabled(value);
@@ -888,6 +1906,10 @@ Spinner::SetDivider(float position)
 		return;
 
 	fDivider = position;
+	if (fTextControl == NULL) {
+		Invalidate();
+		return;
+	}
 
 	BRect rect = fTextControl->TextView()->Frame();
 	fTextControl->TextView()->MoveTo(_TextFieldOffset(), B_V_SCROLL_BAR_WIDTH);
@@ -907,7 +1929,10 @@ Spinner::Divider() const
 void
 Spinner::MakeFocus(bool value)
 {
-	fTextControl->MakeFocus(value);
+	if (value)
+		Materialize();
+	if (fTextControl != NULL)
+		fTextControl->MakeFocus(value);
 }
 
 
@@ -947,9 +1972,16 @@ Spinner::DoLayout()
 	} else if (fLayoutData->labelWidth > 0)
 		divider = fLayoutData->labelWidth + 4;
 	
-	BRect rect(fTextControl->TextView()->Frame());
 	BRect textViewFrame(divider + B_V_SCROLL_BAR_WIDTH, B_V_SCROLL_BAR_WIDTH,
 		size.width - B_V_SCROLL_BAR_WIDTH, size.height - B_V_SCROLL_BAR_WIDTH);
+	if (fTextControl == NULL) {
+		fLayoutData->textViewFrame = textViewFrame;
+		fDivider = divider;
+		Invalidate();
+		return;
+	}
+	
+	BRect rect(fTextControl->TextView()->Frame());
 
 	BLayoutUtils::AlignInFrame(fTextControl->TextView(), textViewFrame);
 	fDivider = divider;
@@ -962,87 +1994,98 @@ Spinner::DoLayout()
 BLayoutItem*
 Spinner::CreateLabelLayoutItem()
 {
-	if (fLayoutData->labelLayoutItem == NULL)
-		fLayoutData->labelLayoutItem = new LabelLayoutItem(this);
-	return fLayoutData->labelLayoutItem;
+	LayoutData *layoutData = _LayoutData();
+	if (layoutData->labelLayoutItem == NULL)
+		layoutData->labelLayoutItem = new LabelLayoutItem(this);
+	return layoutData->labelLayoutItem;
 }
 
 
 BLayoutItem*
 Spinner::CreateTextFieldLayoutItem()
 {
-	if (fLayoutData->textFieldLayoutItem == NULL)
-		fLayoutData->textFieldLayoutItem = new TextFieldLayoutItem(this);
-	return fLayoutData->textFieldLayoutItem;
+	LayoutData *layoutData = _LayoutData();
+	if (layoutData->textFieldLayoutItem == NULL)
+		layoutData->textFieldLayoutItem = new TextFieldLayoutItem(this);
+	return layoutData->textFieldLayoutItem;
 }
 
 
-int32
-SpinnerPrivateData::ButtonRepeaterThread(void *data)
+void
+Spinner::SetValueCore(SpinnerValueCore *core)
 {
-	Spinner *sp = (Spinner *)data;
-	
-	snooze(250000);
-	
-	bool exitval = false;
+	if (core == NULL || core == fCore)
+		return;
 	
-	sp->Window()->Lock();
-	exitval = sp->fPrivateData->fExitRepeater;
+	delete fCore;
+	fCore = core;
+	ValueCoreChanged();
+}
+
+
+void
+Spinner::ValueCoreChanged()
+{
+	fPrivateData->fValueWidth = -1;
+	_SyncValue();
+	InvalidateLayout();
+}
+
+
+SpinnerTextControl::SpinnerTextControl(Spinner *spinner, BRect frame,
+	const char *label, BMessage *msg)
+	:
+	BTextControl(frame, "textcontrol", label, "0", msg,
+		B_FOLLOW_TOP | B_FOLLOW_LEFT_RIGHT, B_WILL_DRAW | B_NAVIGABLE),
+	fSpinner(spinner),
+	fScrubbing(false)
+{
+}
+
+
+void
+SpinnerTextControl::MouseDown(BPoint where)
+{
+	if (where.x >= TextView()->Frame().left || !fSpinner->IsEnabled()
+		|| fSpinner->ScrubRatio() <= 0) {
+		BTextControl::MouseDown(where);
+		return;
+	}
 	
-	int32 scrollvalue = 0;
-	if (sp->fPrivateData->fArrowDown == ARROW_UP)
-		scrollvalue = sp->fStep;
-	else if (sp->fPrivateData->fArrowDown != ARROW_NONE)
-		scrollvalue = -sp->fStep;
+	// a press on the label may be the start of a drag
+	SetMouseEventMask(B_POINTER_EVENTS, B_NO_POINTER_HISTORY);
+	fScrubbing = true;
+	fSpinner->_BeginScrub(ConvertToParent(where));
+}
+
+
+void
+SpinnerTextControl::MouseMoved(BPoint where, uint32 transit,
+	const BMessage *msg)
+{
+	if (fScrubbing)
+		fSpinner->_ScrubMoved(ConvertToParent(where));
 	else
-		exitval = true;
-	
-	sp->Window()->Unlock();
-	
-	while (!exitval) {
-		sp->Window()->Lock();
-		
-		int32 newvalue = sp->Value() + scrollvalue;
-		if (newvalue >= sp->GetMin() && newvalue <= sp->GetMax()) {
-			// new value is in range, so set it and go
-			sp->SetValue(newvalue);
-			sp->Invoke();
-			sp->Invalidate();
-			sp->ValueChanged(sp->Value());
-		} else {
-			// new value is out of bounds. Clip to range if current value is not
-			// at the end of its range
-			if (newvalue<sp->GetMin() && sp->Value() != sp->GetMin()) {
-				sp->SetValue(sp->GetMin());
-				sp->Invoke();
-				sp->Invalidate();
-				sp->ValueChanged(sp->Value());
-			} else  if (newvalue>sp->GetMax() && sp->Value() != sp->GetMax())
-			{
-				sp->SetValue(sp->GetMax());
-				sp->Invoke();
-				sp->Invalidate();
-				sp->ValueChanged(sp->Value());
-			}
-		}
-		sp->Window()->Unlock();
-		
-		snooze(50000);
-		
-		sp->Window()->Lock();
-		exitval = sp->fPrivateData->fExitRepeater;
-		sp->Window()->Unlock();
+		BTextControl::MouseMoved(where, transit, msg);
+}
+
+
+void
+SpinnerTextControl::MouseUp(BPoint where)
+{
+	if (!fScrubbing) {
+		BTextControl::MouseUp(where);
+		return;
 	}
 	
-	sp->Window()->Lock();
-	sp->fPrivateData->fExitRepeater = false;
-	sp->fPrivateData->fRepeaterID = -1;
-	sp->Window()->Unlock();
-	return 0;
-	exit_thread(0);
+	// a click on the label that never became a drag focuses the value
+	fScrubbing = false;
+	if (!fSpinner->_EndScrub())
+		fSpinner->MakeFocus(true);
 }
 
 
+
 SpinnerArrowButton::SpinnerArrowButton(BPoint location, const char *name,
 										arrow_direction dir, float height)
  :BView(BRect(0,0,height*2,height).OffsetToCopy(location),
@@ -1053,7 +2096,11 @@ SpinnerArrowButton::SpinnerArrowButton(BPoint location, const char *name,
 	fHeight = height;
 	fMouseDown = false;
 	fMouseOver = false;
-	SetViewColor(ui_color(B_PANEL_BACKGROUND_COLOR));
+	fTracking = false;
+	fScheduler = NULL;
+	
+	// the cached bitmap covers the whole button
+	SetViewColor(B_TRANSPARENT_COLOR);
 }
 
 
@@ -1068,71 +2115,124 @@ SpinnerArrowButton::MouseDown(BPoint pt)
 	if (fEnabled == false)
 		return;
 	fParent->MakeFocus(true);
-	MouseDownThread<SpinnerArrowButton>::TrackMouse(this, 
-		&SpinnerArrowButton::_DoneTracking, &SpinnerArrowButton::_Track);
+	fParent->_BeginScrub(ConvertToParent(pt));
+	
+	// The press steps right away; after that the window's repeat scheduler
+	// keeps calling RepeatTick() until the button is let go
+	bigtime_t now = system_time();
+	fParent->fPrivateData->fAutoRepeat.Start(now);
+	
+	if (fParent->TrackingMode() == SPINNER_TRACK_EVENTS) {
+		// All mouse events come to us until the button is released, even
+		// from outside the view, so we learn about the release as soon as
+		// it happens instead of on the next poll
+		SetMouseEventMask(B_POINTER_EVENTS, B_NO_POINTER_HISTORY);
+		spinner_arrow_state previous = _State();
+		fTracking = true;
+		fMouseDown = true;
+		_Repeat(now);
+		_StateChanged(previous);
+		if (fScheduler != NULL)
+			fScheduler->Schedule(this);
+		return;
+	}
+	
+	if (RepeatTick(now) && fScheduler != NULL)
+		fScheduler->Schedule(this);
+}
+
+
+bool
+SpinnerArrowButton::RepeatTick(bigtime_t now)
+{
+	if (fParent == NULL)
+		return false;
+	
+	if (fTracking) {
+		// MouseMoved() keeps fMouseDown up to date
+		if (fMouseDown)
+			_Repeat(now);
+		return true;
+	}
+	
+	BPoint point;
+	uint32 buttons;
+	GetMouse(&point, &buttons, false);
+	if (buttons == 0) {
+		_DoneTracking(point);
+		return false;
+	}
+	
+	_Track(point, buttons);
+	return true;
+}
+
+
+void
+SpinnerArrowButton::CancelTracking(void)
+{
+	if (fScheduler != NULL)
+		fScheduler->Unschedule(this);
+	if (fParent != NULL) {
+		fParent->fPrivateData->fAutoRepeat.Stop();
+		fParent->_EndScrub();
+	}
+	
+	spinner_arrow_state previous = _State();
+	fTracking = false;
+	fMouseDown = false;
+	_StateChanged(previous);
 }
 
 
 void
-SpinnerArrowButton::_ModifyValue()
+SpinnerArrowButton::_Repeat(bigtime_t now)
 {
-	int32 step = fParent->GetSteps();
-	int32 newvalue = fParent->Value();
+	// the repeat curve decides whether this tick steps, and how far
+	int32 count = fParent->fPrivateData->fAutoRepeat.Poll(
+		fParent->RepeatCurve(), now);
+	if (count > 0)
+		_ModifyValue(count);
+}
 
+
+void
+SpinnerArrowButton::_ModifyValue(int32 count)
+{
 	if (fDirection == ARROW_UP) {
-		fParent->fPrivateData->fArrowDown = ARROW_UP;
-		newvalue += step;
-	} else {
-		fParent->fPrivateData->fArrowDown = ARROW_DOWN;
-		newvalue -= step;
-	}	
-
-	if (newvalue >= fParent->GetMin() && newvalue <= fParent->GetMax()) {
-		// new value is in range, so set it and go
-		fParent->SetValue(newvalue);
-		fParent->Invoke();
-		fParent->ValueChanged(fParent->Value());
+		fParent->_StepValue(count);
 	} else {
-		// new value is out of bounds. Clip to range if current value is not
-		// at the end of its range
-		if (newvalue < fParent->GetMin() && 
-			fParent->Value() != fParent->GetMin()) {
-			fParent->SetValue(fParent->GetMin());
-			fParent->Invoke();
-			fParent->ValueChanged(fParent->Value());
-		} else if (newvalue>fParent->GetMax() && 
-			fParent->Value() != fParent->GetMax()) {
-			fParent->SetValue(fParent->GetMax());
-			fParent->Invoke();
-			fParent->ValueChanged(fParent->Value());
-		} else {
-			// cases which go here are if new value is <minimum and value already at
-			// minimum or if > maximum and value already at maximum
-			return;
-		}
+		fParent->_StepValue(-count);
 	}
 }
 
 void
 SpinnerArrowButton::_DoneTracking(BPoint point)
 {
-	if (!Bounds().Contains(point) || fMouseDown) {
-		fMouseDown = false;
-		return;
-	}
+	// the button was released, so whatever the last step was, it is final
+	fParent->fPrivateData->fAutoRepeat.Stop();
+	fParent->_EndScrub();
+	fParent->FlushNotification();
+	
+	spinner_arrow_state previous = _State();
+	fMouseDown = false;
+	_StateChanged(previous);
 }
 
 
 void
 SpinnerArrowButton::_Track(BPoint point, uint32)
 {
-	if (Bounds().Contains(point)) {
+	spinner_arrow_state previous = _State();
+	if (fParent->_ScrubTo(ConvertToParent(point)))
+		fMouseDown = false;
+	else if (Bounds().Contains(point)) {
 		fMouseDown = true;
-		_ModifyValue();
+		_Repeat(system_time());
 	} else
 		fMouseDown = false;
 
-	Invalidate();
+	_StateChanged(previous);
 }
 
 
@@ -1140,15 +2240,20 @@ void
 SpinnerArrowButton::MouseUp(BPoint pt)
 {
 	fParent->MakeFocus(false);
+	fTracking = false;
 
 	if (fEnabled) {
+		spinner_arrow_state previous = _State();
 		fMouseDown = false;
 
+		if (fScheduler != NULL)
+			fScheduler->Unschedule(this);
 		if (fParent) {
-			fParent->fPrivateData->fArrowDown = ARROW_NONE;
-			fParent->fPrivateData->fExitRepeater = true;
+			fParent->fPrivateData->fAutoRepeat.Stop();
+			fParent->_EndScrub();
+			fParent->FlushNotification();
 		}
-		Invalidate();
+		_StateChanged(previous);
 	}
 }
 
@@ -1159,16 +2264,36 @@ SpinnerArrowButton::MouseMoved(BPoint pt, uint32 transit, const BMessage *msg)
 	if (fEnabled == false)
 		return;
 
+	if (fTracking) {
+		// Dragging up or down far enough turns the press into a drag that
+		// the value follows, and the repeat stops for good
+		if (fParent->_ScrubMoved(ConvertToParent(pt))) {
+			if (fScheduler != NULL)
+				fScheduler->Unschedule(this);
+			if (fMouseDown) {
+				fMouseDown = false;
+				Invalidate();
+			}
+			return;
+		}
+		
+		// Leaving the view while the button is held only pauses the repeat,
+		// coming back resumes it
+		bool inside = Bounds().Contains(pt);
+		if (inside != fMouseDown) {
+			fMouseDown = inside;
+			Invalidate();
+		}
+		return;
+	}
+
 	if (transit == B_ENTERED_VIEW || transit == B_INSIDE_VIEW) {
 		BPoint point;
 		uint32 buttons;
 		GetMouse(&point,&buttons);
-		if (buttons == 0 && Bounds().Contains(point))
-			fMouseOver = true;
-		else
-			fMouseOver = false;
-		if(!fMouseDown)
-			Invalidate();
+		spinner_arrow_state previous = _State();
+		fMouseOver = buttons == 0 && Bounds().Contains(point);
+		_StateChanged(previous);
 	}
 
 	if (transit == B_EXITED_VIEW || transit == B_OUTSIDE_VIEW) {
@@ -1181,33 +2306,51 @@ SpinnerArrowButton::MouseMoved(BPoint pt, uint32 transit, const BMessage *msg)
 void
 SpinnerArrowButton::Draw(BRect update)
 {
-	PushState();
-	rgb_color c = ui_color(B_PANEL_BACKGROUND_COLOR);
-	BRect r(Bounds());
-	r.OffsetBy(-1,0);
+	SpinnerArrowCache::Draw(this, Bounds(),
+		fDirection == ARROW_UP
+			? BControlLook::B_UP_ARROW : BControlLook::B_DOWN_ARROW,
+		_State());
+}
 
-	float tint;
 
+spinner_arrow_state
+SpinnerArrowButton::_State(void) const
+{
 	if (!fEnabled)
-		tint = B_DARKEN_1_TINT;
-	else if (fMouseDown)
-		tint = B_DARKEN_MAX_TINT;	
-	else if (fMouseOver)
-		tint = B_DARKEN_3_TINT;
-	else
-		tint = B_DARKEN_2_TINT;
+		return SPINNER_ARROW_DISABLED;
+	if (fMouseDown)
+		return SPINNER_ARROW_PRESSED;
+	if (fMouseOver)
+		return SPINNER_ARROW_HOVER;
+	return SPINNER_ARROW_NORMAL;
+}
 
-	SetHighColor(tint_color(c, tint));
-	StrokeRect(r);
 
-	if (fDirection == ARROW_UP) {
-		be_control_look->DrawArrowShape(this,r,update,c,
-			BControlLook::B_UP_ARROW,0,tint);
-	} else {
-		be_control_look->DrawArrowShape(this,r,update,c,
-			BControlLook::B_DOWN_ARROW,0,tint);
+// Each look of the button is a cached bitmap, so a redraw is only needed
+// when the button switches to a different one.
+void
+SpinnerArrowButton::_StateChanged(spinner_arrow_state previous)
+{
+	if (_State() != previous)
+		Invalidate();
+}
+
+
+void
+SpinnerArrowButton::MessageReceived(BMessage *msg)
+{
+	switch (msg->what) {
+		case B_COLORS_UPDATED:
+			// the cached arrows were drawn in the old colors
+			SpinnerArrowCache::Clear();
+			Invalidate();
+			BView::MessageReceived(msg);
+			break;
+		
+		default:
+			BView::MessageReceived(msg);
+			break;
 	}
-	PopState();
 }
 
 
@@ -1215,12 +2358,18 @@ void
 SpinnerArrowButton::AttachedToWindow(void)
 {
 	fParent = (Spinner*)Parent();
+	fScheduler = SpinnerRepeatScheduler::Acquire(Looper());
 }
 
 
 void
-SpinnerArrowButton::DetachedToWindow(void)
+SpinnerArrowButton::DetachedFromWindow(void)
 {
+	if (fScheduler != NULL) {
+		fScheduler->Unschedule(this);
+		fScheduler->Release();
+		fScheduler = NULL;
+	}
 	fParent = NULL;
 }
 
@@ -1228,13 +2377,126 @@ SpinnerArrowButton::DetachedToWindow(void)
 void
 SpinnerArrowButton::SetEnabled(bool value)
 {
+	spinner_arrow_state previous = _State();
 	fEnabled = value;
-	Invalidate();
+	_StateChanged(previous);
+}
+
+
+SpinnerTextViewMap::SpinnerTextViewMap(void)
+	:
+	fEntries(NULL),
+	fCapacity(0),
+	fCount(0)
+{
+}
+
+
+SpinnerTextViewMap::~SpinnerTextViewMap(void)
+{
+	delete[] fEntries;
+}
+
+
+void
+SpinnerTextViewMap::Put(BTextView *view, Spinner *spinner)
+{
+	// keep the table at most half full so that probe runs stay short
+	if ((uint32)(fCount + 1) * 2 > fCapacity)
+		_Resize(fCapacity == 0 ? 16 : fCapacity * 2);
+	
+	uint32 mask = fCapacity - 1;
+	uint32 i = _Home(view);
+	while (fEntries[i].view != NULL && fEntries[i].view != view)
+		i = (i + 1) & mask;
+	
+	if (fEntries[i].view == NULL)
+		fCount++;
+	fEntries[i].view = view;
+	fEntries[i].spinner = spinner;
+}
+
+
+void
+SpinnerTextViewMap::Remove(BTextView *view)
+{
+	if (fCount == 0)
+		return;
+	
+	uint32 mask = fCapacity - 1;
+	uint32 i = _Home(view);
+	while (fEntries[i].view != view) {
+		if (fEntries[i].view == NULL)
+			return;
+		i = (i + 1) & mask;
+	}
+	
+	fEntries[i].view = NULL;
+	fCount--;
+	
+	// Move following entries of the same probe run back into the hole, so
+	// that lookups never stop at it too early
+	for (uint32 j = (i + 1) & mask; fEntries[j].view != NULL;
+			j = (j + 1) & mask) {
+		uint32 home = _Home(fEntries[j].view);
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			fEntries[i] = fEntries[j];
+			fEntries[j].view = NULL;
+			i = j;
+		}
+	}
+}
+
+
+Spinner*
+SpinnerTextViewMap::Get(const BHandler *handler) const
+{
+	if (fCount == 0 || handler == NULL)
+		return NULL;
+	
+	uint32 mask = fCapacity - 1;
+	for (uint32 i = _Home(handler); fEntries[i].view != NULL;
+			i = (i + 1) & mask) {
+		if (static_cast<const BHandler*>(fEntries[i].view) == handler)
+			return fEntries[i].spinner;
+	}
+	return NULL;
+}
+
+
+uint32
+SpinnerTextViewMap::_Home(const void *view) const
+{
+	// Fibonacci hashing of the address; the low bits are mostly alignment
+	uint32 bits = (uint32)((uintptr_t)view >> 4);
+	return (bits * 2654435761U) & (fCapacity - 1);
+}
+
+
+void
+SpinnerTextViewMap::_Resize(uint32 capacity)
+{
+	entry *old = fEntries;
+	uint32 oldCapacity = fCapacity;
+	
+	fEntries = new entry[capacity];
+	fCapacity = capacity;
+	fCount = 0;
+	for (uint32 i = 0; i < capacity; i++)
+		fEntries[i].view = NULL;
+	
+	for (uint32 i = 0; i < oldCapacity; i++) {
+		if (old[i].view != NULL)
+			Put(old[i].view, old[i].spinner);
+	}
+	delete[] old;
 }
 
 
 SpinnerMsgFilter::SpinnerMsgFilter(void)
- : BMessageFilter(B_PROGRAMMED_DELIVERY, B_ANY_SOURCE,B_KEY_DOWN)
+ : BMessageFilter(B_PROGRAMMED_DELIVERY, B_ANY_SOURCE,B_KEY_DOWN),
+ fPasteFilter(new SpinnerPasteFilter(this)),
+ fReferences(0)
 {
 }
 
@@ -1244,33 +2506,89 @@ SpinnerMsgFilter::~SpinnerMsgFilter(void)
 }
 
 
+SpinnerMsgFilter*
+SpinnerMsgFilter::Acquire(BWindow *window)
+{
+	SpinnerMsgFilter *filter = NULL;
+	BList *filters = window->CommonFilterList();
+	for (int32 i = 0; filters != NULL && i < filters->CountItems(); i++) {
+		filter = dynamic_cast<SpinnerMsgFilter*>(
+			(BMessageFilter*)filters->ItemAt(i));
+		if (filter != NULL)
+			break;
+	}
+	
+	if (filter == NULL) {
+		filter = new SpinnerMsgFilter;
+		window->AddCommonFilter(filter);
+		window->AddCommonFilter(filter->fPasteFilter);
+	}
+	
+	filter->fReferences++;
+	return filter;
+}
+
+
+void
+SpinnerMsgFilter::Release(BWindow *window)
+{
+	if (--fReferences > 0)
+		return;
+	
+	window->RemoveCommonFilter(fPasteFilter);
+	window->RemoveCommonFilter(this);
+	delete fPasteFilter;
+	delete this;
+}
+
+
+void
+SpinnerMsgFilter::Register(BTextView *view, Spinner *spinner)
+{
+	fSpinners.Put(view, spinner);
+}
+
+
+void
+SpinnerMsgFilter::Unregister(BTextView *view)
+{
+	fSpinners.Remove(view);
+}
+
+
+Spinner*
+SpinnerMsgFilter::_FocusedSpinner(BHandler *target) const
+{
+	Spinner *spinner = fSpinners.Get(target);
+	if (spinner == NULL || !spinner->fTextControl->TextView()->IsFocus())
+		return NULL;
+	return spinner;
+}
+
+
 filter_result
 SpinnerMsgFilter::Filter(BMessage *msg, BHandler **target)
+{
+	return _FilterKeyDown(msg, target);
+}
+
+
+filter_result
+SpinnerMsgFilter::_FilterKeyDown(BMessage *msg, BHandler **target)
 {
 	int32 c;
-	msg->FindInt32("raw_char",&c);
+	if (msg->FindInt32("raw_char",&c) != B_OK)
+		return B_DISPATCH_MESSAGE;
+	
 	switch (c) {
 		case B_ENTER: {
-			BTextView *text = dynamic_cast<BTextView*>(*target);
-			if (text && text->IsFocus()) {
-				BView *view = text->Parent();
-				while (view) {					
-					Spinner *spin = dynamic_cast<Spinner*>(view);
-					if (spin) {
-						BString string(text->Text());
-						int32 newvalue = 0;
-						
-						sscanf(string.String(),"%ld",&newvalue);
-						if (newvalue != spin->Value()) {
-							spin->SetValue(newvalue);
-							spin->Invoke();
-						}
-						return B_SKIP_MESSAGE;
-					}
-					view = view->Parent();
-				}
-			}
-			return B_DISPATCH_MESSAGE;
+			Spinner *spin = _FocusedSpinner(*target);
+			if (spin == NULL)
+				return B_DISPATCH_MESSAGE;
+			
+			spin->_ApplyInput();
+			spin->_SetValueFromText(spin->fTextControl->Text());
+			return B_SKIP_MESSAGE;
 		}
 		case B_TAB: {
 			// Cause Tab characters to perform keybaord navigation
@@ -1289,38 +2607,128 @@ SpinnerMsgFilter::Filter(BMessage *msg, BHandler **target)
 			return B_SKIP_MESSAGE;
 		}
 		case B_UP_ARROW:
-		case B_DOWN_ARROW: {
-			BTextView *text = dynamic_cast<BTextView*>(*target);
-			if (text && text->IsFocus()) {
-				// We have a text view. See if it currently has the focus and belongs
-				// to a Spinner control. If so, change the value of the spinner
-				
-				// TextViews are complicated beasts which are actually multiple views.
-				// Travel up the hierarchy to see if any of the target's ancestors are
-				// a Spinner.
-				
-				BView *view = text->Parent();
-				while (view) {					
-					Spinner *spin = dynamic_cast<Spinner*>(view);
-					if (spin) {
-						int32 step = spin->GetSteps();
-						if (c == B_DOWN_ARROW)
-							step = 0 - step;
-						
-						spin->SetValue(spin->Value() + step);
-						spin->Invoke();
-						return B_SKIP_MESSAGE;
-					}
-					view = view->Parent();
-				}
-			}
+		case B_DOWN_ARROW:
+		case B_PAGE_UP:
+		case B_PAGE_DOWN: {
+			// Only the text views of our spinners are registered, so one
+			// lookup tells whether the key is meant for a spinner
+			Spinner *spin = _FocusedSpinner(*target);
+			if (spin == NULL)
+				return B_DISPATCH_MESSAGE;
+			
+			int64 count = 1;
+			if (c == B_PAGE_UP || c == B_PAGE_DOWN)
+				count = spin->PageSteps();
+			if (c == B_DOWN_ARROW || c == B_PAGE_DOWN)
+				count = -count;
 			
-			return B_DISPATCH_MESSAGE;
+			spin->_KeyStep(msg, c, count);
+			return B_SKIP_MESSAGE;
+		}
+		case B_HOME:
+		case B_END: {
+			Spinner *spin = _FocusedSpinner(*target);
+			if (spin == NULL)
+				return B_DISPATCH_MESSAGE;
+			
+			// the press got the value to the limit already
+			if (msg->GetInt32("be:key_repeat", 0) > 0)
+				return B_SKIP_MESSAGE;
+			
+			spin->_ApplyInput();
+			spin->_StepToLimit(c == B_HOME ? SPINNER_MIN : SPINNER_MAX);
+			return B_SKIP_MESSAGE;
+		}
+		default: {
+			Spinner *spin = fSpinners.Get(*target);
+			if (spin == NULL)
+				return B_DISPATCH_MESSAGE;
+			
+			// steps still to come belong before what is typed now
+			spin->_ApplyInput();
+			
+			// shortcuts are the window's business
+			int32 modifiers;
+			if (msg->FindInt32("modifiers", &modifiers) == B_OK
+				&& (modifiers & B_COMMAND_KEY) != 0)
+				return B_DISPATCH_MESSAGE;
+			
+			const char *bytes;
+			if (msg->FindString("bytes", &bytes) != B_OK)
+				return B_DISPATCH_MESSAGE;
+			if (spinner_char_class_of(bytes[0]) == SPINNER_CHAR_EDIT)
+				return B_DISPATCH_MESSAGE;
+			
+			return _AcceptsInsertion(spin, bytes, strlen(bytes))
+				? B_DISPATCH_MESSAGE : B_SKIP_MESSAGE;
 		}
-		default:
-			return B_DISPATCH_MESSAGE;
 	}
 	
 	// shut the stupid compiler up
 	return B_SKIP_MESSAGE;
 }
+
+
+filter_result
+SpinnerMsgFilter::_FilterPaste(BMessage *msg, BHandler **target)
+{
+	Spinner *spin = fSpinners.Get(*target);
+	if (spin == NULL || be_clipboard == NULL || !be_clipboard->Lock())
+		return B_DISPATCH_MESSAGE;
+	
+	const char *text = NULL;
+	ssize_t length = 0;
+	BMessage *clip = be_clipboard->Data();
+	bool accepted = clip != NULL
+		&& clip->FindData("text/plain", B_MIME_TYPE, (const void**)&text,
+			&length) == B_OK
+		&& _AcceptsInsertion(spin, text, length);
+	be_clipboard->Unlock();
+	
+	return accepted ? B_DISPATCH_MESSAGE : B_SKIP_MESSAGE;
+}
+
+
+SpinnerPasteFilter::SpinnerPasteFilter(SpinnerMsgFilter *keys)
+ : BMessageFilter(B_PROGRAMMED_DELIVERY, B_ANY_SOURCE, B_PASTE),
+ fKeys(keys)
+{
+}
+
+
+filter_result
+SpinnerPasteFilter::Filter(BMessage *msg, BHandler **target)
+{
+	return fKeys->_FilterPaste(msg, target);
+}
+
+
+// Decides whether text may replace the selection of the spinner's text
+// field, so that the result still reads as a number.
+bool
+SpinnerMsgFilter::_AcceptsInsertion(Spinner *spinner, const char *text,
+	int32 length)
+{
+	BTextView *view = spinner->fTextControl->TextView();
+	const char *current = view->Text();
+	int32 currentLength = view->TextLength();
+	int32 start;
+	int32 end;
+	view->GetSelection(&start, &end);
+	
+	// nothing goes in front of a sign that stays
+	if (current[0] == '-' && end == 0)
+		return false;
+	
+	bool allowMinus = start == 0 && spinner->GetMin() < 0;
+	
+	bool allowPoint = spinner->fCore->Scale() > 1;
+	for (int32 i = 0; allowPoint && i < currentLength; i++) {
+		if (current[i] == '.' && (i < start || i >= end))
+			allowPoint = false;
+	}
+	
+	int32 room = SPINNER_TEXT_BUFFER_SIZE - 1 - (currentLength - (end - start));
+	return spinner_validate_insertion(text, length, room, allowMinus,
+		allowPoint);
+}
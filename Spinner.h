@@ -14,6 +14,30 @@
 #include <StringView.h>
 #include <TextControl.h>
 
+#include "SpinnerRepeatCurve.h"
+#include "SpinnerValueCore.h"
+
+enum spinner_tracking_mode {
+	// the arrows follow the mouse through MouseMoved() and MouseUp()
+	SPINNER_TRACK_EVENTS = 0,
+	// the arrows ask for the mouse state with GetMouse() on every repeat
+	SPINNER_TRACK_POLLING
+};
+
+// What one spinner costs, in bytes, as reported by Spinner::GetFootprint().
+// Parts that are not allocated count as 0. childViews is an estimate: the
+// size of the objects themselves, not of what the app_server or the text
+// view's buffers keep for them.
+struct spinner_footprint {
+	size_t	control;
+	size_t	privateData;
+	size_t	layoutData;
+	size_t	valueCore;
+	size_t	repeatCurve;
+	size_t	childViews;
+	size_t	total;
+};
+
 class SpinnerPrivateData;
 class SpinnerArrowButton;
 class SpinnerMsgFilter;
@@ -22,6 +46,18 @@ class SpinnerMsgFilter;
 	The Spinner control provides a numeric input which can be nudged by way of two
 	small arrow buttons at the right side. The API is quite similar to that of
 	BScrollBar.
+	
+	By default the value is an int32. SetValueCore() switches the spinner to
+	another value type, such as SpinnerInt64Core or
+	TypedSpinnerValueCore<SpinnerFixedTraits<100> > for two decimal places.
+	The int32 API then works in the stored units of that core, while
+	TypedModel() gives full access to the native values.
+	
+	A spinner is made of a BTextControl and two arrow buttons. Constructed
+	with lazyChildViews, it draws a picture of them itself until it is
+	focused, hovered or clicked for the first time, and only then creates
+	them. Panels with many spinners that are mostly left alone
+	save the construction time and memory of the views.
 */
 
 class Spinner : public BControl
@@ -30,11 +66,13 @@ public:
 							Spinner(BRect frame, const char *name,
 									const char *label, BMessage *msg,
 									uint32 resize = B_FOLLOW_LEFT | B_FOLLOW_TOP,
-									uint32 flags = B_WILL_DRAW | B_NAVIGABLE);
+									uint32 flags = B_WILL_DRAW | B_NAVIGABLE,
+									bool lazyChildViews = false);
 							Spinner(BMessage *data);
 							Spinner(const char *name, const char *label, BMessage *msg,
 									uint32 resize = B_FOLLOW_LEFT | B_FOLLOW_TOP, 
-									uint32 flags = B_WILL_DRAW | B_NAVIGABLE);
+									uint32 flags = B_WILL_DRAW | B_NAVIGABLE,
+									bool lazyChildViews = false);
 	virtual					~Spinner(void);
 	
 	static	BArchivable*	Instantiate(BMessage *data);
@@ -49,26 +87,37 @@ public:
 	virtual void			DetachedFromWindow(void);
 	virtual void			ValueChanged(int32 value);
 	virtual void			MessageReceived(BMessage *msg);
+	virtual	void			Draw(BRect update);
+	virtual	void			MouseDown(BPoint where);
+	virtual	void			MouseMoved(BPoint where, uint32 transit,
+								const BMessage *msg);
 	
 	virtual	void			GetPreferredSize(float *width, float *height);
 	virtual void			ResizeToPreferred(void);
 	
 	virtual void			SetSteps(int32 stepsize);
-			int32			GetSteps(void) const { return fStep; }
+			int32			GetSteps(void) const
+								{ return fCore->Int32(SPINNER_STEP); }
 	
 	virtual void			SetRange(int32 min, int32 max);
 			void			GetRange(int32 *min, int32 *max);
 	
 	virtual	void			SetMax(int32 max);
-			int32			GetMax(void) const { return fMax; }
+			int32			GetMax(void) const
+								{ return fCore->Int32(SPINNER_MAX); }
 	virtual	void			SetMin(int32 min);
-			int32			GetMin(void) const { return fMin; }
+			int32			GetMin(void) const
+								{ return fCore->Int32(SPINNER_MIN); }
 	
 	virtual	void			MakeFocus(bool value = true);
 	
 	virtual	void			SetValue(int32 value);
 	virtual	void			SetLabel(const char *text);
-			BTextControl*	TextControl(void) const { return fTextControl; }
+	// Creates the child views first if they are still only drawn. The
+	// const version does not, and returns NULL until they exist.
+			BTextControl*	TextControl(void);
+			BTextControl*	TextControl(void) const
+								{ return fTextControl; }
 	
 	virtual	void			SetEnabled(bool value);
 	virtual	void			SetDivider(float position);
@@ -76,18 +125,103 @@ public:
 			void			DoLayout();
 			BLayoutItem*	CreateLabelLayoutItem();
 			BLayoutItem*	CreateTextFieldLayoutItem();
+	
+	// Takes ownership of core, which replaces the current value storage.
+			void			SetValueCore(SpinnerValueCore *core);
+			SpinnerValueCore* ValueCore() const { return fCore; }
+			
+	// The model of the value core if it is of the given type, else NULL.
+	// Call ValueCoreChanged() after changing the model directly.
+	template<class Traits>
+			BasicSpinnerModel<Traits>* TypedModel() const;
+			void			ValueCoreChanged();
+	
+	// With a notification interval, Invoke() and ValueChanged() run at most
+	// once per interval while the value keeps changing; the text still
+	// follows every step. A change left over at the end of a burst is
+	// delivered when the interval is up, or right away when the arrow is
+	// released. An interval of 0, the default, notifies on every change.
+			void			SetNotificationInterval(bigtime_t interval);
+			bigtime_t		NotificationInterval() const;
+			void			FlushNotification();
+	
+	// How holding an arrow speeds up; see SpinnerRepeatCurve.h
+			void			SetRepeatCurve(const SpinnerRepeatCurve &curve);
+			const SpinnerRepeatCurve& RepeatCurve() const;
+	
+			void			SetTrackingMode(spinner_tracking_mode mode);
+			spinner_tracking_mode TrackingMode() const;
+	
+	// Page Up and Page Down move the value this many steps, Home and End
+	// to the ends of the range. Held keys move as far as all their
+	// repeats would have, however many of them piled up.
+			void			SetPageSteps(int32 steps);
+			int32			PageSteps() const;
+	
+	// Dragging up or down on the label or an arrow changes the value by a
+	// step every pixelsPerStep pixels; 0 turns dragging off. Moves that
+	// queue up during a drag cost one change between them.
+			void			SetScrubRatio(float pixelsPerStep);
+			float			ScrubRatio() const;
+	
+	// Each notch of the mouse wheel moves the value one step, or multiplier
+	// steps while all of the given modifier keys are held. Wheel events
+	// that arrive within the same frame are added up and cost one change.
+			void			SetWheelMultiplier(uint32 modifiers,
+								int32 multiplier);
+			int32			WheelMultiplier(uint32 *modifiers = NULL) const;
+	
+	// Whether the spinner was constructed to put off creating its child
+	// views. An archive keeps this, but not whether they were created.
+			bool			LazyChildViews() const;
+	
+			bool			IsMaterialized() const
+								{ return fTextControl != NULL; }
+			void			Materialize();
+	
+			void			GetFootprint(spinner_footprint *footprint) const;
 
 private:
 			class			LabelLayoutItem;
 			class			TextFieldLayoutItem;
 			struct			LayoutData;
-			void			_InitObject(void);
+			void			_InitObject(bool lazyChildViews);
+			LayoutData*		_LayoutData();
+	static	const SpinnerRepeatCurve& _DefaultRepeatCurve();
+			BRect			_TextControlFrame();
+			BRect			_TextViewFrame();
+			BRect			_ArrowFrame(bool up);
+			float			_LineHeight();
 			void			_UpdateFrame();
 			void			_ValidateLayoutData();
 			float			_TextFieldOffset();
+			float			_LabelWidth();
+			float			_ValueWidth();
+			void			_UpdateMeasuredFont(BFont *font);
+			void			_SyncValue();
+			void			_CommitValue();
+			void			_Notify();
+			void			_StepValue(int32 count);
+			void			_StepToLimit(spinner_field limit);
+			void			_WheelChanged(BMessage *msg);
+			void			_ApplyWheel();
+			void			_PostInput();
+			void			_ApplyInput();
+			void			_KeyStep(const BMessage *msg, int32 key,
+								int64 steps);
+			void			_ApplyKeySteps();
+			void			_BeginScrub(BPoint where);
+			bool			_ScrubTo(BPoint where);
+			bool			_ScrubMoved(BPoint where);
+			void			_ApplyScrub();
+			bool			_EndScrub();
+			void			_SetValueFromText(const char *text);
+			bool			_HandleScriptingMessage(BMessage *msg);
 			
 	friend	class			SpinnerArrowButton;
+	friend	class			SpinnerTextControl;
 	friend	class			SpinnerPrivateData;
+	friend	class			SpinnerMsgFilter;
 	friend	class			LabelLayoutItem;
 	friend	class			TextFieldLayoutItem;
 	friend	struct			LayoutData;
@@ -97,12 +231,20 @@ private:
 	SpinnerArrowButton*		fDownButton;
 	SpinnerPrivateData*		fPrivateData;
 	LayoutData*				fLayoutData;
-	int32					fStep;
-	int32					fMin;
-	int32					fMax;
+	SpinnerValueCore*		fCore;
 	float					fDivider;
 	SpinnerMsgFilter		*fFilter;
 			Spinner&			operator=(const Spinner& other);
 };
 
+
+template<class Traits>
+BasicSpinnerModel<Traits>*
+Spinner::TypedModel() const
+{
+	TypedSpinnerValueCore<Traits> *core
+		= dynamic_cast<TypedSpinnerValueCore<Traits>*>(fCore);
+	return core != NULL ? &core->Model() : NULL;
+}
+
 #endif
@@ -0,0 +1,169 @@
+/*
+	SpinnerArrowCache.cpp: Pre-rendered spinner arrow buttons.
+	Released under the MIT license.
+*/
+#include "SpinnerArrowCache.h"
+
+#include <Autolock.h>
+#include <Bitmap.h>
+#include <ControlLook.h>
+#include <InterfaceDefs.h>
+#include <Locker.h>
+#include <View.h>
+
+#include <map>
+
+namespace {
+
+struct arrow_key {
+	uint32				direction;
+	spinner_arrow_state	state;
+	int32				width;
+	int32				height;
+	uint32				color;
+	const BControlLook*	look;
+
+	bool operator<(const arrow_key &other) const
+	{
+		if (direction != other.direction)
+			return direction < other.direction;
+		if (state != other.state)
+			return state < other.state;
+		if (width != other.width)
+			return width < other.width;
+		if (height != other.height)
+			return height < other.height;
+		if (color != other.color)
+			return color < other.color;
+		return look < other.look;
+	}
+};
+
+typedef std::map<arrow_key, BBitmap*> arrow_map;
+
+// Two directions times four states for a few button sizes; anything
+// beyond that means the colors or sizes keep changing
+const size_t kMaxBitmaps = 64;
+
+BLocker sLock("spinner arrow cache");
+arrow_map sBitmaps;
+
+
+uint32
+pack_color(rgb_color color)
+{
+	return ((uint32)color.red << 24) | ((uint32)color.green << 16)
+		| ((uint32)color.blue << 8) | color.alpha;
+}
+
+
+void
+clear_bitmaps()
+{
+	for (arrow_map::iterator i = sBitmaps.begin(); i != sBitmaps.end(); i++)
+		delete i->second;
+	sBitmaps.clear();
+}
+
+
+BBitmap*
+create_bitmap(const arrow_key &key)
+{
+	BRect bounds(0, 0, key.width - 1, key.height - 1);
+	BBitmap *bitmap = new BBitmap(bounds, B_BITMAP_ACCEPTS_VIEWS, B_RGBA32);
+	if (bitmap->InitCheck() != B_OK) {
+		delete bitmap;
+		return NULL;
+	}
+
+	BView *view = new BView(bounds, "spinner arrow", 0, B_WILL_DRAW);
+	bitmap->AddChild(view);
+	if (bitmap->Lock()) {
+		SpinnerArrowCache::Render(view, bounds, bounds, key.direction,
+			key.state);
+		view->Sync();
+		bitmap->RemoveChild(view);
+		bitmap->Unlock();
+	}
+	delete view;
+	return bitmap;
+}
+
+}	// namespace
+
+
+void
+SpinnerArrowCache::Draw(BView *view, BRect frame, uint32 direction,
+	spinner_arrow_state state)
+{
+	arrow_key key;
+	key.direction = direction;
+	key.state = state;
+	key.width = frame.IntegerWidth() + 1;
+	key.height = frame.IntegerHeight() + 1;
+	key.color = pack_color(ui_color(B_PANEL_BACKGROUND_COLOR));
+	key.look = be_control_look;
+
+	BAutolock locker(sLock);
+	BBitmap *bitmap = NULL;
+	arrow_map::iterator found = sBitmaps.find(key);
+	if (found != sBitmaps.end())
+		bitmap = found->second;
+	else {
+		if (sBitmaps.size() >= kMaxBitmaps)
+			clear_bitmaps();
+		bitmap = create_bitmap(key);
+		if (bitmap != NULL)
+			sBitmaps.insert(arrow_map::value_type(key, bitmap));
+	}
+
+	if (bitmap != NULL)
+		view->DrawBitmap(bitmap, frame.LeftTop());
+	else
+		Render(view, frame, frame, direction, state);
+}
+
+
+void
+SpinnerArrowCache::Render(BView *view, BRect bounds, const BRect &update,
+	uint32 direction, spinner_arrow_state state)
+{
+	view->PushState();
+	rgb_color c = ui_color(B_PANEL_BACKGROUND_COLOR);
+
+	view->SetHighColor(c);
+	view->FillRect(bounds);
+
+	BRect r(bounds);
+	r.OffsetBy(-1,0);
+
+	float tint;
+	switch (state) {
+		case SPINNER_ARROW_DISABLED:
+			tint = B_DARKEN_1_TINT;
+			break;
+		case SPINNER_ARROW_PRESSED:
+			tint = B_DARKEN_MAX_TINT;
+			break;
+		case SPINNER_ARROW_HOVER:
+			tint = B_DARKEN_3_TINT;
+			break;
+		default:
+			tint = B_DARKEN_2_TINT;
+			break;
+	}
+
+	view->SetHighColor(tint_color(c, tint));
+	view->StrokeRect(r);
+
+	be_control_look->DrawArrowShape(view, r, update, c, direction, 0, tint);
+	view->PopState();
+}
+
+
+void
+SpinnerArrowCache::Clear(void)
+{
+	BAutolock locker(sLock);
+	clear_bitmaps();
+}
@@ -0,0 +1,50 @@
+/*
+	SpinnerArrowCache.h: Pre-rendered spinner arrow buttons.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_ARROW_CACHE_H_
+#define SPINNER_ARROW_CACHE_H_
+
+#include <Rect.h>
+
+class BView;
+
+/*
+	Drawing an arrow button takes a state push, a stroked frame and an
+	arrow shape from the control look, and the buttons are redrawn on every
+	hover and press. SpinnerArrowCache renders each look of a button into
+	an offscreen bitmap the first time it is needed. After that, drawing
+	is a single blit, for every spinner in the process.
+
+	A bitmap is identified by the arrow's direction and state and the
+	button's size. The panel color and the control look it was drawn with
+	are remembered as well, so a change to either never brings back an old
+	rendering. Clear() drops everything; the buttons call it when the UI
+	colors change.
+*/
+
+enum spinner_arrow_state {
+	SPINNER_ARROW_NORMAL = 0,
+	SPINNER_ARROW_HOVER,
+	SPINNER_ARROW_PRESSED,
+	SPINNER_ARROW_DISABLED
+};
+
+
+class SpinnerArrowCache
+{
+public:
+	// Draws the arrow button filling frame of view. direction is one of the
+	// BControlLook arrow directions.
+	static	void			Draw(BView *view, BRect frame, uint32 direction,
+								spinner_arrow_state state);
+
+	// Renders a button directly, which is how the cached bitmaps are made
+	static	void			Render(BView *view, BRect bounds,
+								const BRect &update, uint32 direction,
+								spinner_arrow_state state);
+
+	static	void			Clear(void);
+};
+
+#endif
@@ -0,0 +1,1167 @@
+/*
+	SpinnerGrid.cpp: A column of number spinners drawn by a single view.
+	Released under the MIT license.
+*/
+#include "SpinnerGrid.h"
+
+#include <Clipboard.h>
+#include <ControlLook.h>
+#include <Font.h>
+#include <ScrollBar.h>
+#include <TextView.h>
+#include <Window.h>
+
+#include <algorithm>
+
+#include <math.h>
+#include <string.h>
+
+#include "SpinnerArrowCache.h"
+#include "SpinnerInputValidator.h"
+#include "SpinnerModel.h"
+#include "SpinnerWidthCache.h"
+
+// space between the widest label and the numbers
+static const float kLabelSpacing = 5.0f;
+static const float kLabelInset = 2.0f;
+
+// wheel deltas are added up for at most this long before they scroll
+static const bigtime_t kWheelFrameInterval = 1000000 / 60;
+
+enum {
+	M_SCROLL_WHEEL = 'sgsw'
+};
+
+
+// The text view of the row being edited. Typing and pasting are checked
+// the same way as in a Spinner's text field; Enter, losing the focus and
+// leaving with Tab keep the text, Escape drops it.
+class SpinnerGridEditor : public BTextView
+{
+public:
+							SpinnerGridEditor(SpinnerGrid *grid);
+
+	virtual	void			KeyDown(const char *bytes, int32 numBytes);
+	virtual	void			MakeFocus(bool focus = true);
+	virtual	void			Paste(BClipboard *clipboard);
+
+private:
+			bool			_AcceptsInsertion(const char *text,
+								int32 length) const;
+
+			SpinnerGrid*	fGrid;
+};
+
+
+SpinnerGridEditor::SpinnerGridEditor(SpinnerGrid *grid)
+	:
+	BTextView(BRect(0, 0, 10, 10), "editor", BRect(0, 0, 10, 10),
+		B_FOLLOW_NONE, B_WILL_DRAW),
+	fGrid(grid)
+{
+	SetAlignment(B_ALIGN_LEFT);
+	SetWordWrap(false);
+	SetMaxBytes(SPINNER_TEXT_BUFFER_SIZE - 1);
+}
+
+
+void
+SpinnerGridEditor::KeyDown(const char *bytes, int32 numBytes)
+{
+	switch (bytes[0]) {
+		case B_ENTER:
+			fGrid->EndEditing(true);
+			return;
+
+		case B_ESCAPE:
+			fGrid->EndEditing(false);
+			return;
+
+		case B_TAB:
+			// keyboard navigation leaves the row, so the edit is over
+			fGrid->EndEditing(true);
+			BView::KeyDown(bytes, numBytes);
+			return;
+
+		case B_UP_ARROW:
+		case B_DOWN_ARROW:
+		{
+			// steps from what was typed so far, like a Spinner does, and
+			// tells the target once about both
+			int32 row = fGrid->EditedRow();
+			int32 before = fGrid->RowValue(row);
+			fGrid->_SetRowFromText(row, Text(), false);
+			fGrid->_StepRow(row, bytes[0] == B_UP_ARROW ? 1 : -1, false);
+			if (fGrid->RowValue(row) != before)
+				fGrid->_NotifyRow(row);
+			return;
+		}
+	}
+
+	if ((modifiers() & B_COMMAND_KEY) != 0
+		|| spinner_char_class_of(bytes[0]) == SPINNER_CHAR_EDIT
+		|| _AcceptsInsertion(bytes, numBytes))
+		BTextView::KeyDown(bytes, numBytes);
+}
+
+
+void
+SpinnerGridEditor::MakeFocus(bool focus)
+{
+	BTextView::MakeFocus(focus);
+	if (!focus)
+		fGrid->EndEditing(true);
+}
+
+
+void
+SpinnerGridEditor::Paste(BClipboard *clipboard)
+{
+	if (clipboard == NULL || !clipboard->Lock())
+		return;
+
+	const char *text = NULL;
+	ssize_t length = 0;
+	BMessage *clip = clipboard->Data();
+	bool accepted = clip != NULL
+		&& clip->FindData("text/plain", B_MIME_TYPE, (const void**)&text,
+			&length) == B_OK
+		&& _AcceptsInsertion(text, length);
+	clipboard->Unlock();
+
+	if (accepted)
+		BTextView::Paste(clipboard);
+}
+
+
+// The row's values are int32, so unlike a Spinner's field there is never
+// a decimal point to allow for.
+bool
+SpinnerGridEditor::_AcceptsInsertion(const char *text, int32 length) const
+{
+	int32 start;
+	int32 end;
+	GetSelection(&start, &end);
+
+	const char *current = Text();
+	if (current[0] == '-' && end == 0)
+		return false;
+
+	int32 min;
+	int32 max;
+	fGrid->GetRowRange(fGrid->EditedRow(), &min, &max);
+
+	int32 room = SPINNER_TEXT_BUFFER_SIZE - 1
+		- (TextLength() - (end - start));
+	return spinner_validate_insertion(text, length, room,
+		start == 0 && min < 0, false);
+}
+
+
+//	#pragma mark - SpinnerGrid
+
+
+SpinnerGrid::SpinnerGrid(BRect frame, const char *name, BMessage *msg,
+	uint32 resize, uint32 flags)
+	:
+	BControl(frame, name, NULL, msg, resize, flags),
+	fDivider(-1)
+{
+	_InitObject();
+}
+
+
+SpinnerGrid::SpinnerGrid(BMessage *data)
+	:
+	BControl(data),
+	fDivider(-1)
+{
+	_InitObject();
+
+	// A row whose range or step makes no sense is dropped, along with its
+	// label; a value outside the range is pulled into it.
+	row entry;
+	for (int32 i = 0; data->FindInt32("_value", i, &entry.value) == B_OK
+			&& data->FindInt32("_min", i, &entry.min) == B_OK
+			&& data->FindInt32("_max", i, &entry.max) == B_OK
+			&& data->FindInt32("_step", i, &entry.step) == B_OK; i++) {
+		if (entry.min > entry.max || entry.step <= 0)
+			continue;
+
+		entry.value = std::max(entry.min, std::min(entry.value, entry.max));
+		fRows.push_back(entry);
+
+		const char *label;
+		if (data->FindString("_labels", i, &label) != B_OK)
+			label = NULL;
+		fLabels.push_back(BString(label));
+	}
+
+	float divider;
+	if (data->FindFloat("_divider", &divider) == B_OK)
+		fDivider = divider;
+
+	const char *curve;
+	if (data->FindString("_repeat_curve", &curve) == B_OK)
+		fRepeatCurve.Parse(curve);
+}
+
+
+SpinnerGrid::~SpinnerGrid(void)
+{
+}
+
+
+void
+SpinnerGrid::_InitObject(void)
+{
+	fRowHeight = 0;
+	fBaseline = 0;
+	fLabelWidth = -1;
+	fSelected = -1;
+	fEditor = NULL;
+	fEditedRow = -1;
+	fArrowRow = -1;
+	fArrowPart = HIT_NONE;
+	fArrowPressed = false;
+	fTracking = false;
+	fScheduler = NULL;
+	fWheelPending = 0;
+	fWheelFrameStart = -1;
+	fWheelPosted = false;
+
+	SetViewColor(ui_color(B_PANEL_BACKGROUND_COLOR));
+	SetLowColor(ViewColor());
+	_UpdateRowHeight();
+}
+
+
+BArchivable*
+SpinnerGrid::Instantiate(BMessage *data)
+{
+	if (validate_instantiation(data, "SpinnerGrid"))
+		return new SpinnerGrid(data);
+
+	return NULL;
+}
+
+
+status_t
+SpinnerGrid::Archive(BMessage *data, bool deep) const
+{
+	status_t status = BControl::Archive(data, deep);
+	data->AddString("class", "SpinnerGrid");
+
+	// one array per field, so that the archive does not depend on how a
+	// row is laid out in memory
+	for (size_t i = 0; status == B_OK && i < fRows.size(); i++) {
+		const row &entry = fRows[i];
+		status = data->AddInt32("_value", entry.value);
+		if (status == B_OK)
+			status = data->AddInt32("_min", entry.min);
+		if (status == B_OK)
+			status = data->AddInt32("_max", entry.max);
+		if (status == B_OK)
+			status = data->AddInt32("_step", entry.step);
+		if (status == B_OK)
+			status = data->AddString("_labels", fLabels[i]);
+	}
+
+	if (status == B_OK && fDivider >= 0)
+		status = data->AddFloat("_divider", fDivider);
+	if (status == B_OK && fRepeatCurve != SpinnerRepeatCurve()) {
+		char curve[SPINNER_REPEAT_CURVE_TEXT_SIZE];
+		fRepeatCurve.Format(curve, sizeof(curve));
+		status = data->AddString("_repeat_curve", curve);
+	}
+
+	return status;
+}
+
+
+void
+SpinnerGrid::AttachedToWindow(void)
+{
+	BControl::AttachedToWindow();
+	fScheduler = SpinnerRepeatScheduler::Acquire(Looper());
+	_UpdateRowHeight();
+}
+
+
+void
+SpinnerGrid::DetachedFromWindow(void)
+{
+	EndEditing(true);
+	_StopTracking();
+
+	// a posted M_SCROLL_WHEEL cannot reach us anymore
+	fWheelPending = 0;
+	fWheelFrameStart = -1;
+	fWheelPosted = false;
+
+	if (fScheduler != NULL) {
+		fScheduler->Release();
+		fScheduler = NULL;
+	}
+}
+
+
+// Only the rows that intersect update are looked at, and each of them is
+// drawn from its entry in the arrays; no row has any drawing state of its
+// own.
+void
+SpinnerGrid::Draw(BRect update)
+{
+	if (fRows.empty())
+		return;
+
+	int32 first = std::max((int32)floorf(update.top / fRowHeight), (int32)0);
+	int32 last = std::min((int32)floorf(update.bottom / fRowHeight),
+		CountRows() - 1);
+	for (int32 i = first; i <= last; i++)
+		_DrawRow(i, update);
+}
+
+
+void
+SpinnerGrid::_DrawRow(int32 index, BRect update)
+{
+	BRect frame = RowFrame(index);
+	float baseline = frame.top + fBaseline;
+	float tint = IsEnabled() ? B_NO_TINT : B_DISABLED_LABEL_TINT;
+
+	const BString &label = fLabels[index];
+	if (!label.IsEmpty() && update.left < Divider()) {
+		SetHighColor(tint_color(ui_color(B_PANEL_TEXT_COLOR), tint));
+		DrawString(label.String(), BPoint(frame.left + kLabelInset,
+			baseline));
+	}
+
+	BRect box = _ValueFrame(index);
+	if (box.Intersects(update)) {
+		SetHighColor(ui_color(B_DOCUMENT_BACKGROUND_COLOR));
+		FillRect(box.InsetByCopy(1, 1));
+
+		bool focused = index == fSelected && IsFocus();
+		SetHighColor(ui_color(focused
+			? B_KEYBOARD_NAVIGATION_COLOR : B_CONTROL_BORDER_COLOR));
+		StrokeRect(box);
+
+		// the editor shows the number of the row being edited
+		if (index != fEditedRow) {
+			char text[SPINNER_TEXT_BUFFER_SIZE];
+			SpinnerInt32Traits::Format(fRows[index].value, text,
+				sizeof(text));
+			SetHighColor(tint_color(ui_color(B_DOCUMENT_TEXT_COLOR), tint));
+			DrawString(text, BPoint(box.left + 3, baseline));
+		}
+	}
+
+	for (int32 part = HIT_UP; part <= HIT_DOWN; part++) {
+		BRect arrow = _ArrowFrame(index, (hit_part)part);
+		if (!arrow.Intersects(update))
+			continue;
+
+		spinner_arrow_state state = SPINNER_ARROW_NORMAL;
+		if (!IsEnabled())
+			state = SPINNER_ARROW_DISABLED;
+		else if (index == fArrowRow && part == fArrowPart) {
+			state = fArrowPressed
+				? SPINNER_ARROW_PRESSED : SPINNER_ARROW_HOVER;
+		}
+		SpinnerArrowCache::Draw(this, arrow, part == HIT_UP
+			? BControlLook::B_UP_ARROW : BControlLook::B_DOWN_ARROW, state);
+	}
+}
+
+
+void
+SpinnerGrid::MouseDown(BPoint where)
+{
+	if (!IsEnabled())
+		return;
+
+	int32 index;
+	hit_part part = _HitTest(where, &index);
+	if (part == HIT_NONE)
+		return;
+
+	if (part == HIT_VALUE) {
+		EditRow(index);
+		return;
+	}
+
+	EndEditing(true);
+	Select(index);
+	MakeFocus(true);
+	if (part == HIT_LABEL)
+		return;
+
+	// The press steps right away; after that the window's repeat scheduler
+	// keeps calling RepeatTick() until the button is let go
+	SetMouseEventMask(B_POINTER_EVENTS, B_NO_POINTER_HISTORY);
+	fTracking = true;
+	_SetArrowState(index, part, true);
+
+	bigtime_t now = system_time();
+	fAutoRepeat.Start(now);
+	_Repeat(now);
+	if (fScheduler != NULL)
+		fScheduler->Schedule(this);
+}
+
+
+void
+SpinnerGrid::MouseUp(BPoint where)
+{
+	if (!fTracking)
+		return;
+
+	_StopTracking();
+
+	int32 index;
+	hit_part part = _HitTest(where, &index);
+	if (part != HIT_UP && part != HIT_DOWN)
+		part = HIT_NONE;
+	_SetArrowState(index, part, false);
+}
+
+
+void
+SpinnerGrid::MouseMoved(BPoint where, uint32 transit, const BMessage *msg)
+{
+	if (!IsEnabled())
+		return;
+
+	int32 index = -1;
+	hit_part part = HIT_NONE;
+	if (transit != B_EXITED_VIEW && transit != B_OUTSIDE_VIEW)
+		part = _HitTest(where, &index);
+
+	if (fTracking) {
+		// Leaving the arrow while the button is held only pauses the
+		// repeat, coming back resumes it
+		_SetArrowState(fArrowRow, fArrowPart,
+			index == fArrowRow && part == fArrowPart);
+		return;
+	}
+
+	if (part != HIT_UP && part != HIT_DOWN)
+		part = HIT_NONE;
+	_SetArrowState(index, part, false);
+}
+
+
+void
+SpinnerGrid::KeyDown(const char *bytes, int32 numBytes)
+{
+	if (!IsEnabled() || fRows.empty()) {
+		BView::KeyDown(bytes, numBytes);
+		return;
+	}
+
+	int32 selected = std::max(fSelected, (int32)0);
+	int32 page = std::max((int32)(Bounds().Height() / fRowHeight),
+		(int32)1);
+
+	switch (bytes[0]) {
+		case B_UP_ARROW:
+			Select(fSelected < 0 ? 0 : selected - 1);
+			break;
+		case B_DOWN_ARROW:
+			Select(fSelected < 0 ? 0 : selected + 1);
+			break;
+		case B_PAGE_UP:
+			Select(selected - page);
+			break;
+		case B_PAGE_DOWN:
+			Select(selected + page);
+			break;
+		case B_HOME:
+			Select(0);
+			break;
+		case B_END:
+			Select(CountRows() - 1);
+			break;
+		case B_LEFT_ARROW:
+		case B_RIGHT_ARROW:
+			Select(selected);
+			_StepRow(selected, bytes[0] == B_RIGHT_ARROW ? 1 : -1, true);
+			break;
+		case B_ENTER:
+			EditRow(selected);
+			break;
+
+		default:
+		{
+			// typing a number replaces the value of the selected row
+			spinner_char_class charClass = spinner_char_class_of(bytes[0]);
+			if ((modifiers() & B_COMMAND_KEY) != 0
+				|| (charClass != SPINNER_CHAR_DIGIT
+					&& charClass != SPINNER_CHAR_MINUS)) {
+				BView::KeyDown(bytes, numBytes);
+				break;
+			}
+
+			EditRow(selected);
+			if (fEditor != NULL && fEditedRow == selected) {
+				fEditor->SelectAll();
+				fEditor->KeyDown(bytes, numBytes);
+			}
+			break;
+		}
+	}
+}
+
+
+void
+SpinnerGrid::MessageReceived(BMessage *msg)
+{
+	switch (msg->what) {
+		case B_MOUSE_WHEEL_CHANGED:
+			_WheelChanged(msg);
+			break;
+
+		case M_SCROLL_WHEEL:
+			fWheelPosted = false;
+			_ScrollWheel();
+			break;
+
+		case B_COLORS_UPDATED:
+			// the cached arrows were drawn in the old colors
+			SpinnerArrowCache::Clear();
+			Invalidate();
+			BControl::MessageReceived(msg);
+			break;
+
+		default:
+			BControl::MessageReceived(msg);
+			break;
+	}
+}
+
+
+// One scroll for all the notches of a frame: the deltas are added up, and
+// the M_SCROLL_WHEEL posted for the first of them comes after the wheel
+// messages that were queued with it. A message a frame or more after the
+// first one scrolls by what came before it right away.
+void
+SpinnerGrid::_WheelChanged(BMessage *msg)
+{
+	float delta;
+	if (msg->FindFloat("be:wheel_delta_y", &delta) != B_OK)
+		return;
+
+	bigtime_t when = msg->GetInt64("when", system_time());
+	if (fWheelFrameStart >= 0 && when - fWheelFrameStart >= kWheelFrameInterval)
+		_ScrollWheel();
+	if (fWheelFrameStart < 0)
+		fWheelFrameStart = when;
+	fWheelPending += delta;
+
+	if (fWheelPosted)
+		return;
+	if (Looper() != NULL && Looper()->PostMessage(M_SCROLL_WHEEL, this) == B_OK)
+		fWheelPosted = true;
+	else
+		_ScrollWheel();
+}
+
+
+void
+SpinnerGrid::_ScrollWheel(void)
+{
+	if (fWheelFrameStart < 0)
+		return;
+
+	float delta = fWheelPending;
+	fWheelPending = 0;
+	fWheelFrameStart = -1;
+	ScrollBy(0, roundf(delta * fRowHeight));
+}
+
+
+// BControl::MakeFocus() would redraw every visible row; only the
+// selected one shows the focus.
+void
+SpinnerGrid::MakeFocus(bool focus)
+{
+	if (focus && fSelected < 0 && !fRows.empty())
+		fSelected = 0;
+
+	BView::MakeFocus(focus);
+	if (fSelected >= 0)
+		Invalidate(_ValueFrame(fSelected));
+}
+
+
+void
+SpinnerGrid::FrameResized(float width, float height)
+{
+	// a taller view may not be scrolled as far down
+	ScrollTo(Bounds().LeftTop());
+	_PlaceEditor();
+}
+
+
+void
+SpinnerGrid::ScrollTo(BPoint where)
+{
+	where.x = 0;
+	where.y = std::max(0.0f, std::min(roundf(where.y), _MaxScroll()));
+	BControl::ScrollTo(where);
+}
+
+
+void
+SpinnerGrid::SetEnabled(bool enabled)
+{
+	if (enabled == IsEnabled())
+		return;
+
+	if (!enabled) {
+		EndEditing(true);
+		_StopTracking();
+		fArrowRow = -1;
+		fArrowPart = HIT_NONE;
+		fArrowPressed = false;
+	}
+	BControl::SetEnabled(enabled);
+}
+
+
+bool
+SpinnerGrid::RepeatTick(bigtime_t now)
+{
+	if (!fTracking)
+		return false;
+
+	// MouseMoved() keeps fArrowPressed up to date
+	if (fArrowPressed)
+		_Repeat(now);
+	return true;
+}
+
+
+void
+SpinnerGrid::RowValueChanged(int32 index, int32 value)
+{
+}
+
+
+int32
+SpinnerGrid::AddRow(const char *label, int32 value, int32 min, int32 max,
+	int32 step)
+{
+	SpinnerModel model(min, max, step > 0 ? step : 1);
+	model.SetValue(value);
+
+	row entry = { model.Value(), model.Min(), model.Max(), model.Step() };
+	fRows.push_back(entry);
+	fLabels.push_back(BString(label));
+
+	int32 index = CountRows() - 1;
+
+	// A label wider than all others moves the numbers of every row. The
+	// widest label is kept up to date here, so it never has to be found
+	// by going through all of them again.
+	if (fLabelWidth >= 0 && label != NULL && label[0] != '\0') {
+		BFont font;
+		GetFont(&font);
+		float width = SpinnerWidthCache::StringWidth(font, label);
+		if (width > fLabelWidth) {
+			fLabelWidth = width;
+			if (fDivider < 0) {
+				_PlaceEditor();
+				Invalidate();
+				return index;
+			}
+		}
+	}
+
+	Invalidate(RowFrame(index));
+	return index;
+}
+
+
+void
+SpinnerGrid::RemoveRows(int32 index, int32 count)
+{
+	if (index < 0 || count <= 0 || index >= CountRows())
+		return;
+	count = std::min(count, CountRows() - index);
+
+	if (fEditedRow >= index)
+		EndEditing(false);
+	if (fTracking && fArrowRow >= index)
+		_StopTracking();
+	fArrowRow = -1;
+	fArrowPart = HIT_NONE;
+	fArrowPressed = false;
+
+	fRows.erase(fRows.begin() + index, fRows.begin() + index + count);
+	fLabels.erase(fLabels.begin() + index, fLabels.begin() + index + count);
+	fLabelWidth = -1;
+
+	if (fSelected >= index + count)
+		fSelected -= count;
+	else if (fSelected >= index)
+		fSelected = std::min(index, CountRows() - 1);
+
+	ScrollTo(Bounds().LeftTop());
+	Invalidate();
+}
+
+
+void
+SpinnerGrid::MakeEmpty(void)
+{
+	RemoveRows(0, CountRows());
+}
+
+
+void
+SpinnerGrid::SetRowLabel(int32 index, const char *label)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	fLabels[index] = label;
+	fLabelWidth = -1;
+	if (fDivider < 0) {
+		_PlaceEditor();
+		Invalidate();
+	} else
+		_InvalidateRow(index);
+}
+
+
+const char*
+SpinnerGrid::RowLabel(int32 index) const
+{
+	if (index < 0 || index >= CountRows())
+		return NULL;
+	return fLabels[index].String();
+}
+
+
+void
+SpinnerGrid::SetRowValue(int32 index, int32 value)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	const row &entry = fRows[index];
+	if (value >= entry.min && value <= entry.max)
+		_SetRow(index, value, false);
+}
+
+
+int32
+SpinnerGrid::RowValue(int32 index) const
+{
+	if (index < 0 || index >= CountRows())
+		return 0;
+	return fRows[index].value;
+}
+
+
+void
+SpinnerGrid::SetRowRange(int32 index, int32 min, int32 max)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	row &entry = fRows[index];
+	entry.min = min;
+	entry.max = max < min ? min : max;
+
+	// pulls the value into the new range
+	_SetRow(index, entry.value, false);
+}
+
+
+void
+SpinnerGrid::GetRowRange(int32 index, int32 *min, int32 *max) const
+{
+	bool valid = index >= 0 && index < CountRows();
+	if (min != NULL)
+		*min = valid ? fRows[index].min : 0;
+	if (max != NULL)
+		*max = valid ? fRows[index].max : 0;
+}
+
+
+void
+SpinnerGrid::SetRowStep(int32 index, int32 step)
+{
+	if (index >= 0 && index < CountRows() && step > 0)
+		fRows[index].step = step;
+}
+
+
+int32
+SpinnerGrid::RowStep(int32 index) const
+{
+	if (index < 0 || index >= CountRows())
+		return 0;
+	return fRows[index].step;
+}
+
+
+void
+SpinnerGrid::Select(int32 index)
+{
+	if (fRows.empty())
+		return;
+
+	index = std::max((int32)0, std::min(index, CountRows() - 1));
+	if (index != fSelected) {
+		if (fSelected >= 0 && fSelected < CountRows())
+			Invalidate(_ValueFrame(fSelected));
+		fSelected = index;
+		Invalidate(_ValueFrame(fSelected));
+	}
+	ScrollToRow(index);
+}
+
+
+void
+SpinnerGrid::ScrollToRow(int32 index)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	BRect frame = RowFrame(index);
+	BRect bounds = Bounds();
+	if (frame.top < bounds.top)
+		ScrollTo(BPoint(0, frame.top));
+	else if (frame.bottom > bounds.bottom)
+		ScrollTo(BPoint(0, frame.bottom - bounds.Height()));
+}
+
+
+BRect
+SpinnerGrid::RowFrame(int32 index) const
+{
+	float top = index * fRowHeight;
+	return BRect(0, top, Bounds().Width(), top + fRowHeight - 1);
+}
+
+
+int32
+SpinnerGrid::RowAt(BPoint where) const
+{
+	if (where.y < 0)
+		return -1;
+
+	int32 index = (int32)(where.y / fRowHeight);
+	return index < CountRows() ? index : -1;
+}
+
+
+void
+SpinnerGrid::SetDivider(float position)
+{
+	fDivider = position < 0 ? -1 : roundf(position);
+	_PlaceEditor();
+	Invalidate();
+}
+
+
+float
+SpinnerGrid::Divider(void) const
+{
+	if (fDivider >= 0)
+		return fDivider;
+
+	// measured once, and again only after a label changed or went away
+	if (fLabelWidth < 0) {
+		BFont font;
+		GetFont(&font);
+		fLabelWidth = 0;
+		for (size_t i = 0; i < fLabels.size(); i++) {
+			if (!fLabels[i].IsEmpty()) {
+				fLabelWidth = std::max(fLabelWidth,
+					SpinnerWidthCache::StringWidth(font, fLabels[i].String()));
+			}
+		}
+	}
+
+	return fLabelWidth > 0
+		? ceilf(fLabelWidth) + kLabelInset + kLabelSpacing : 0;
+}
+
+
+void
+SpinnerGrid::EditRow(int32 index)
+{
+	if (!IsEnabled() || index < 0 || index >= CountRows())
+		return;
+	if (index == fEditedRow) {
+		fEditor->MakeFocus(true);
+		return;
+	}
+
+	EndEditing(true);
+	Select(index);
+
+	if (fEditor == NULL) {
+		fEditor = new SpinnerGridEditor(this);
+		fEditor->Hide();
+		AddChild(fEditor);
+	}
+
+	fEditedRow = index;
+	_PlaceEditor();
+
+	char text[SPINNER_TEXT_BUFFER_SIZE];
+	SpinnerInt32Traits::Format(fRows[index].value, text, sizeof(text));
+	fEditor->SetText(text);
+	fEditor->SelectAll();
+	fEditor->Show();
+	fEditor->MakeFocus(true);
+
+	Invalidate(_ValueFrame(index));
+}
+
+
+void
+SpinnerGrid::EndEditing(bool commit)
+{
+	if (fEditedRow < 0)
+		return;
+
+	int32 index = fEditedRow;
+	if (commit)
+		_SetRowFromText(index, fEditor->Text(), true);
+
+	// cleared first, the editor calls back here when it loses the focus
+	fEditedRow = -1;
+	bool hadFocus = fEditor->IsFocus();
+	fEditor->Hide();
+	if (hadFocus)
+		MakeFocus(true);
+
+	Invalidate(_ValueFrame(index));
+}
+
+
+BView*
+SpinnerGrid::Editor(void) const
+{
+	return fEditor;
+}
+
+
+void
+SpinnerGrid::SetRepeatCurve(const SpinnerRepeatCurve &curve)
+{
+	fRepeatCurve = curve;
+}
+
+
+void
+SpinnerGrid::_UpdateRowHeight(void)
+{
+	font_height fontHeight;
+	GetFontHeight(&fontHeight);
+	float textHeight = ceilf(fontHeight.ascent + fontHeight.descent
+		+ fontHeight.leading);
+
+	// tall enough for the text in its box and for two arrows
+	float height = std::max(textHeight + 8, B_H_SCROLL_BAR_HEIGHT * 2);
+	fBaseline = floorf((height - textHeight) / 2 + fontHeight.ascent);
+	if (height == fRowHeight)
+		return;
+
+	fRowHeight = height;
+	ScrollTo(Bounds().LeftTop());
+	_PlaceEditor();
+	Invalidate();
+}
+
+
+SpinnerGrid::hit_part
+SpinnerGrid::_HitTest(BPoint where, int32 *_row) const
+{
+	int32 index = RowAt(where);
+	*_row = index;
+	if (index < 0)
+		return HIT_NONE;
+
+	if (_ArrowFrame(index, HIT_UP).Contains(where))
+		return HIT_UP;
+	if (_ArrowFrame(index, HIT_DOWN).Contains(where))
+		return HIT_DOWN;
+	if (where.x >= Divider()
+		&& where.x < RowFrame(index).right - B_V_SCROLL_BAR_WIDTH)
+		return HIT_VALUE;
+	return HIT_LABEL;
+}
+
+
+BRect
+SpinnerGrid::_ValueFrame(int32 index) const
+{
+	BRect frame = RowFrame(index);
+	return BRect(Divider(), frame.top + 2,
+		frame.right - B_V_SCROLL_BAR_WIDTH - 2, frame.bottom - 2);
+}
+
+
+// Both arrows of a row have the same size, so that they share one set of
+// cached bitmaps.
+BRect
+SpinnerGrid::_ArrowFrame(int32 index, hit_part part) const
+{
+	BRect frame = RowFrame(index);
+	float half = floorf((fRowHeight - 2) / 2);
+	float top = frame.top + 1;
+	if (part == HIT_DOWN)
+		top += half;
+	return BRect(frame.right - B_V_SCROLL_BAR_WIDTH, top, frame.right,
+		top + half - 1);
+}
+
+
+void
+SpinnerGrid::_StepRow(int32 index, int32 count, bool notify)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	const row &entry = fRows[index];
+	SpinnerModel model(entry.min, entry.max, entry.step);
+	model.SetValue(entry.value);
+	if (model.StepBy(count))
+		_SetRow(index, model.Value(), notify);
+}
+
+
+// Out of range input is clipped to the nearest end of the range, and
+// text without a number counts as 0, like in a Spinner.
+void
+SpinnerGrid::_SetRowFromText(int32 index, const char *text, bool notify)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	int32 value;
+	if (!SpinnerInt32Traits::Parse(text, &value))
+		value = 0;
+	_SetRow(index, value, notify);
+}
+
+
+void
+SpinnerGrid::_SetRow(int32 index, int32 value, bool notify)
+{
+	if (index < 0 || index >= CountRows())
+		return;
+
+	row &entry = fRows[index];
+	value = std::max(entry.min, std::min(value, entry.max));
+
+	// the editor may still hold what was typed, even if the value stays
+	if (index == fEditedRow) {
+		char text[SPINNER_TEXT_BUFFER_SIZE];
+		SpinnerInt32Traits::Format(value, text, sizeof(text));
+		if (strcmp(text, fEditor->Text()) != 0) {
+			fEditor->SetText(text);
+			fEditor->SelectAll();
+		}
+	}
+
+	if (value == entry.value)
+		return;
+
+	entry.value = value;
+	if (index != fEditedRow)
+		Invalidate(_ValueFrame(index));
+
+	if (notify)
+		_NotifyRow(index);
+}
+
+
+void
+SpinnerGrid::_NotifyRow(int32 index)
+{
+	int32 value = fRows[index].value;
+	SetValueNoUpdate(value);
+	RowValueChanged(index, value);
+	if (Message() != NULL) {
+		BMessage message(*Message());
+		message.AddInt32("index", index);
+		Invoke(&message);
+	}
+}
+
+
+void
+SpinnerGrid::_Repeat(bigtime_t now)
+{
+	// the repeat curve decides whether this tick steps, and how far
+	int32 count = fAutoRepeat.Poll(fRepeatCurve, now);
+	if (count > 0)
+		_StepRow(fArrowRow, fArrowPart == HIT_UP ? count : -count, true);
+}
+
+
+// Each look of an arrow is a cached bitmap, so only the arrows that change
+// to a different one are redrawn.
+void
+SpinnerGrid::_SetArrowState(int32 index, hit_part part, bool pressed)
+{
+	if (index == fArrowRow && part == fArrowPart
+		&& pressed == fArrowPressed)
+		return;
+
+	if (fArrowPart != HIT_NONE && fArrowRow >= 0 && fArrowRow < CountRows())
+		Invalidate(_ArrowFrame(fArrowRow, fArrowPart));
+
+	fArrowRow = index;
+	fArrowPart = part;
+	fArrowPressed = pressed;
+
+	if (fArrowPart != HIT_NONE && fArrowRow >= 0)
+		Invalidate(_ArrowFrame(fArrowRow, fArrowPart));
+}
+
+
+void
+SpinnerGrid::_StopTracking(void)
+{
+	if (fScheduler != NULL)
+		fScheduler->Unschedule(this);
+	fAutoRepeat.Stop();
+	fTracking = false;
+}
+
+
+void
+SpinnerGrid::_InvalidateRow(int32 index)
+{
+	Invalidate(RowFrame(index));
+}
+
+
+void
+SpinnerGrid::_PlaceEditor(void)
+{
+	if (fEditor == NULL || fEditedRow < 0)
+		return;
+
+	BRect frame = _ValueFrame(fEditedRow).InsetByCopy(1, 1);
+	fEditor->MoveTo(frame.LeftTop());
+	fEditor->ResizeTo(frame.Width(), frame.Height());
+}
+
+
+float
+SpinnerGrid::_MaxScroll(void) const
+{
+	float height = CountRows() * fRowHeight;
+	return std::max(0.0f, height - (Bounds().Height() + 1));
+}
@@ -0,0 +1,185 @@
+/*
+	SpinnerGrid.h: A column of number spinners drawn by a single view.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_GRID_H_
+#define SPINNER_GRID_H_
+
+#include <Control.h>
+#include <String.h>
+
+#include <vector>
+
+#include "SpinnerRepeatCurve.h"
+#include "SpinnerRepeatScheduler.h"
+
+class SpinnerGridEditor;
+
+/*
+	A SpinnerGrid shows any number of labelled int32 values, each with a
+	pair of arrow buttons, like a stack of Spinners. Unlike a stack of
+	Spinners it has no child views per row: the values live in one flat
+	array, and Draw() and the mouse handling work out from a row's index
+	where its label, number and arrows are. All rows have the same height,
+	so finding the rows in an update rect or under the mouse is a division,
+	and scrolling costs the same for ten rows as for a hundred thousand.
+
+	A text view only exists for the row being edited. It is created the
+	first time a value is edited and then moves from row to row; while
+	nothing is edited it is hidden.
+
+	Clicking a number, pressing Enter or starting to type edits the
+	selected row. Up and down select rows, left and right step the value.
+	Invoke() sends a copy of the message with the row's "index"; the
+	control's own value is that of the row that changed last.
+*/
+
+class SpinnerGrid : public BControl, public SpinnerRepeatClient
+{
+public:
+							SpinnerGrid(BRect frame, const char *name,
+								BMessage *msg,
+								uint32 resize = B_FOLLOW_LEFT | B_FOLLOW_TOP,
+								uint32 flags = B_WILL_DRAW | B_NAVIGABLE
+									| B_FRAME_EVENTS);
+							SpinnerGrid(BMessage *data);
+	virtual					~SpinnerGrid(void);
+
+	static	BArchivable*	Instantiate(BMessage *data);
+	virtual	status_t		Archive(BMessage *data, bool deep = true) const;
+
+	virtual	void			AttachedToWindow(void);
+	virtual	void			DetachedFromWindow(void);
+	virtual	void			Draw(BRect update);
+	virtual	void			MouseDown(BPoint where);
+	virtual	void			MouseUp(BPoint where);
+	virtual	void			MouseMoved(BPoint where, uint32 transit,
+								const BMessage *msg);
+	virtual	void			KeyDown(const char *bytes, int32 numBytes);
+	virtual	void			MessageReceived(BMessage *msg);
+	virtual	void			MakeFocus(bool focus = true);
+	virtual	void			FrameResized(float width, float height);
+	virtual	void			ScrollTo(BPoint where);
+	virtual	void			SetEnabled(bool enabled);
+	virtual	bool			RepeatTick(bigtime_t now);
+
+	// Called after the value of a row changed, right before Invoke()
+	virtual	void			RowValueChanged(int32 index, int32 value);
+
+			int32			AddRow(const char *label, int32 value,
+								int32 min, int32 max, int32 step = 1);
+			void			RemoveRows(int32 index, int32 count);
+			void			MakeEmpty(void);
+			int32			CountRows(void) const
+								{ return (int32)fRows.size(); }
+
+			void			SetRowLabel(int32 index, const char *label);
+			const char*		RowLabel(int32 index) const;
+	// Like Spinner::SetValue(), a value outside the row's range is ignored
+	// rather than clamped. The step must be greater than 0; SetRowStep()
+	// ignores any other, and AddRow() uses 1 instead.
+			void			SetRowValue(int32 index, int32 value);
+			int32			RowValue(int32 index) const;
+			void			SetRowRange(int32 index, int32 min, int32 max);
+			void			GetRowRange(int32 index, int32 *min,
+								int32 *max) const;
+			void			SetRowStep(int32 index, int32 step);
+			int32			RowStep(int32 index) const;
+
+			void			Select(int32 index);
+			int32			CurrentSelection(void) const
+								{ return fSelected; }
+
+	// Scrolls just far enough for the row to be fully visible
+			void			ScrollToRow(int32 index);
+			float			RowHeight(void) const { return fRowHeight; }
+			BRect			RowFrame(int32 index) const;
+	// The row at a point in view coordinates, or -1
+			int32			RowAt(BPoint where) const;
+
+	// Where the numbers start. A negative divider, the default, places it
+	// after the widest label.
+			void			SetDivider(float position);
+			float			Divider(void) const;
+
+	// Opens the editor on a row, and closes it again, keeping or dropping
+	// what was typed
+			void			EditRow(int32 index);
+			void			EndEditing(bool commit);
+			int32			EditedRow(void) const { return fEditedRow; }
+			BView*			Editor(void) const;
+
+			void			SetRepeatCurve(const SpinnerRepeatCurve &curve);
+			const SpinnerRepeatCurve& RepeatCurve() const
+								{ return fRepeatCurve; }
+
+private:
+	friend	class			SpinnerGridEditor;
+
+	struct row {
+		int32				value;
+		int32				min;
+		int32				max;
+		int32				step;
+	};
+
+	enum hit_part {
+		HIT_NONE = 0,
+		HIT_LABEL,
+		HIT_VALUE,
+		HIT_UP,
+		HIT_DOWN
+	};
+
+			void			_InitObject(void);
+			void			_UpdateRowHeight(void);
+			hit_part		_HitTest(BPoint where, int32 *_row) const;
+			BRect			_ValueFrame(int32 index) const;
+			BRect			_ArrowFrame(int32 index, hit_part part) const;
+			void			_DrawRow(int32 index, BRect update);
+			void			_StepRow(int32 index, int32 count,
+								bool notify);
+			void			_SetRowFromText(int32 index, const char *text,
+								bool notify);
+			void			_SetRow(int32 index, int32 value, bool notify);
+			void			_NotifyRow(int32 index);
+			void			_Repeat(bigtime_t now);
+			void			_SetArrowState(int32 row, hit_part part,
+								bool pressed);
+			void			_StopTracking(void);
+			void			_WheelChanged(BMessage *msg);
+			void			_ScrollWheel(void);
+			void			_InvalidateRow(int32 index);
+			void			_PlaceEditor(void);
+			float			_MaxScroll(void) const;
+
+			std::vector<row> fRows;
+			std::vector<BString> fLabels;
+
+			float			fRowHeight;
+			float			fBaseline;
+			float			fDivider;
+	mutable	float			fLabelWidth;
+			int32			fSelected;
+
+			SpinnerGridEditor* fEditor;
+			int32			fEditedRow;
+
+			// the arrow under the mouse, and whether it is held down
+			int32			fArrowRow;
+			hit_part		fArrowPart;
+			bool			fArrowPressed;
+			bool			fTracking;
+
+			SpinnerRepeatScheduler* fScheduler;
+			SpinnerRepeatCurve fRepeatCurve;
+			SpinnerAutoRepeat fAutoRepeat;
+
+			// the wheel deltas of this frame, when the first of them came
+			// or -1, and whether an M_SCROLL_WHEEL is on its way
+			float			fWheelPending;
+			bigtime_t		fWheelFrameStart;
+			bool			fWheelPosted;
+};
+
+#endif
@@ -0,0 +1,97 @@
+/*
+	SpinnerInputValidator.h: What may be typed or pasted into a spinner.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_INPUT_VALIDATOR_H_
+#define SPINNER_INPUT_VALIDATOR_H_
+
+#include <SupportDefs.h>
+
+/*
+	A spinner's text field takes digits, a minus sign if the range reaches
+	below zero, and a decimal point if the value is fixed point. Editing
+	and navigation keys pass through; everything else, including non-ASCII
+	and other control characters, is refused.
+
+	The class of every byte is looked up in a constant table that all
+	spinners in the process share, instead of each text view being told
+	about each character to refuse one at a time.
+*/
+
+enum spinner_char_class {
+	SPINNER_CHAR_REJECT = 0,
+	SPINNER_CHAR_DIGIT,
+	SPINNER_CHAR_MINUS,
+	SPINNER_CHAR_POINT,
+	// Home, End, Insert, Backspace, Tab, Enter, Page Up/Down, function
+	// keys, Escape, the arrows and Delete
+	SPINNER_CHAR_EDIT
+};
+
+
+static const uint8 kSpinnerCharClass[256] = {
+	0, 4, 0, 0, 4, 4, 0, 0, 4, 4, 4, 4, 4, 0, 0, 0,	// 0x00
+	4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 4,	// 0x10
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 0,	// 0x20
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,	// 0x30
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0x40
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0x50
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0x60
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4,	// 0x70
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0x80
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0x90
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0xa0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0xb0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0xc0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0xd0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,	// 0xe0
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0	// 0xf0
+};
+
+
+inline spinner_char_class
+spinner_char_class_of(char c)
+{
+	return (spinner_char_class)kSpinnerCharClass[(uint8)c];
+}
+
+
+// Checks text that is about to be inserted into a spinner's text field,
+// such as a typed key or the clipboard contents. A minus sign may only
+// lead the text, and only if allowMinus is set; at most one decimal point
+// may appear, and only if allowPoint is set. Text longer than maxLength
+// is refused before it is looked at; otherwise a single pass stops at the
+// first byte that does not belong.
+inline bool
+spinner_validate_insertion(const char *text, int32 length, int32 maxLength,
+	bool allowMinus, bool allowPoint)
+{
+	if (length > maxLength)
+		return false;
+
+	int32 i = 0;
+	if (length > 0 && text[0] == '-') {
+		if (!allowMinus)
+			return false;
+		i = 1;
+	}
+
+	for (; i < length; i++) {
+		switch (kSpinnerCharClass[(uint8)text[i]]) {
+			case SPINNER_CHAR_DIGIT:
+				break;
+
+			case SPINNER_CHAR_POINT:
+				if (!allowPoint)
+					return false;
+				allowPoint = false;
+				break;
+
+			default:
+				return false;
+		}
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*
+	SpinnerModel.h: The value engine behind the Spinner control.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_MODEL_H_
+#define SPINNER_MODEL_H_
+
+#include "SpinnerValueTraits.h"
+
+/*
+	BasicSpinnerModel holds the value, range and step size of a spinner and
+	knows nothing about views, windows or messages, so it can be used and
+	tested on its own. Every mutator clamps to the current range and
+	reports whether the value actually changed, which is what the control
+	uses to decide whether to notify its target.
+
+	The value type comes from a traits class (see SpinnerValueTraits.h);
+	SpinnerModel is the plain int32 flavor.
+*/
+
+template<class Traits>
+class BasicSpinnerModel
+{
+public:
+	typedef typename Traits::value_type		value_type;
+	typedef typename Traits::unsigned_type	unsigned_type;
+
+							BasicSpinnerModel()
+								:
+								fValue(0),
+								fMin(0),
+								fMax(Traits::One() * 100),
+								fStep(Traits::One())
+							{
+							}
+
+							BasicSpinnerModel(value_type min, value_type max,
+								value_type step)
+								:
+								fValue(min),
+								fMin(min),
+								fMax(max < min ? min : max),
+								fStep(step)
+							{
+							}
+
+			value_type		Value(void) const { return fValue; }
+			value_type		Min(void) const { return fMin; }
+			value_type		Max(void) const { return fMax; }
+			value_type		Step(void) const { return fStep; }
+
+			bool			Contains(value_type value) const
+								{ return value >= fMin && value <= fMax; }
+
+	// Sets the value, clamped to the range. Returns true if it changed.
+			bool			SetValue(value_type value)
+								{ return _Assign(Clamp(value)); }
+
+	// Moves the value by count steps (negative counts step down). Large
+	// steps saturate at the ends of the range instead of wrapping around.
+			bool			StepBy(int32 count)
+								{ return _Assign(Advance(count)); }
+
+	// The range setters keep min <= max and pull the value back inside
+	// the range; they return true if that changed the value.
+			bool			SetRange(value_type min, value_type max)
+								{
+									fMin = min;
+									fMax = max < min ? min : max;
+									return _Assign(Clamp(fValue));
+								}
+			bool			SetMin(value_type min)
+								{
+									fMin = min;
+									if (fMax < fMin)
+										fMax = fMin;
+									return _Assign(Clamp(fValue));
+								}
+			bool			SetMax(value_type max)
+								{
+									fMax = max;
+									if (fMin > fMax)
+										fMin = fMax;
+									return _Assign(Clamp(fValue));
+								}
+
+			void			SetStep(value_type step) { fStep = step; }
+
+			value_type		Clamp(value_type value) const
+								{
+									if (value < fMin)
+										return fMin;
+									if (value > fMax)
+										return fMax;
+									return value;
+								}
+
+	// The value count steps away, clamped to the range. The distance to
+	// the end of the range is measured in the unsigned type, where it
+	// cannot overflow, so no intermediate result ever leaves the type.
+			value_type		Advance(int32 count) const
+								{
+									if (count == 0 || fStep == 0)
+										return fValue;
+
+									bool up = (count > 0) == (fStep > 0);
+									unsigned_type times = count < 0
+										? 0 - (unsigned_type)count
+										: (unsigned_type)count;
+									unsigned_type step = fStep < 0
+										? 0 - (unsigned_type)fStep
+										: (unsigned_type)fStep;
+
+									unsigned_type room = up
+										? (unsigned_type)fMax
+											- (unsigned_type)fValue
+										: (unsigned_type)fValue
+											- (unsigned_type)fMin;
+									if (times > room / step)
+										return up ? fMax : fMin;
+
+									return up
+										? (value_type)((unsigned_type)fValue
+											+ times * step)
+										: (value_type)((unsigned_type)fValue
+											- times * step);
+								}
+
+private:
+			bool			_Assign(value_type value)
+								{
+									if (value == fValue)
+										return false;
+									fValue = value;
+									return true;
+								}
+
+			value_type		fValue;
+			value_type		fMin;
+			value_type		fMax;
+			value_type		fStep;
+};
+
+
+typedef BasicSpinnerModel<SpinnerInt32Traits> SpinnerModel;
+
+#endif
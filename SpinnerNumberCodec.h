@@ -0,0 +1,300 @@
+/*
+	SpinnerNumberCodec.h: Decimal formatting and parsing for spinner values.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_NUMBER_CODEC_H_
+#define SPINNER_NUMBER_CODEC_H_
+
+#if defined(__HAIKU__) || defined(__BEOS__)
+#	include <SupportDefs.h>
+#else
+#	include <stdint.h>
+typedef int32_t		int32;
+typedef uint32_t	uint32;
+typedef int64_t		int64;
+typedef uint64_t	uint64;
+#endif
+
+#include <string.h>
+
+/*
+	These replace sprintf() and sscanf() on the spinner's update path. They
+	never allocate, never look at the locale, and handle exactly one
+	notation: an optional sign followed by decimal digits.
+
+	Formatting produces two digits per division by looking them up in a
+	table of all pairs from "00" to "99". Parsing makes a single pass over
+	the digits and detects overflow against a precomputed cutoff instead of
+	dividing for every digit.
+*/
+
+enum {
+	// enough for any 64 bit value, a sign, a decimal point and the NUL
+	SPINNER_NUMBER_BUFFER_SIZE = 24
+};
+
+
+static const char kSpinnerDigitPairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+
+// Writes the digits of value so that they end right before end, and
+// returns where they start. Uses the width of Unsigned for the divisions,
+// so 32 bit values never pay for 64 bit division.
+template<typename Unsigned>
+inline char*
+spinner_write_digits(Unsigned value, char *end)
+{
+	while (value >= 100) {
+		const char *pair = kSpinnerDigitPairs + (value % 100) * 2;
+		value /= 100;
+		*--end = pair[1];
+		*--end = pair[0];
+	}
+
+	if (value < 10)
+		*--end = (char)('0' + value);
+	else {
+		const char *pair = kSpinnerDigitPairs + value * 2;
+		*--end = pair[1];
+		*--end = pair[0];
+	}
+	return end;
+}
+
+
+// Writes exactly count digits of value, padding with leading zeros.
+template<typename Unsigned>
+inline void
+spinner_write_padded_digits(Unsigned value, char *buffer, int32 count)
+{
+	char *end = buffer + count;
+	while (end - buffer >= 2) {
+		const char *pair = kSpinnerDigitPairs + (value % 100) * 2;
+		value /= 100;
+		*--end = pair[1];
+		*--end = pair[0];
+	}
+	if (end > buffer)
+		*--end = (char)('0' + value % 10);
+}
+
+
+// Copies the number built in scratch to buffer, which holds size bytes,
+// and terminates it. Returns the length of the number.
+inline int32
+spinner_copy_number(const char *start, const char *end, char *buffer,
+	int32 size)
+{
+	int32 length = (int32)(end - start);
+	if (size <= 0)
+		return length;
+
+	int32 copy = length < size ? length : size - 1;
+	memcpy(buffer, start, copy);
+	buffer[copy] = '\0';
+	return length;
+}
+
+
+// Formats an integer. Like snprintf(), the return value is the full length
+// even if buffer was too small to hold it.
+template<typename Signed, typename Unsigned>
+inline int32
+spinner_format_signed(Signed value, char *buffer, int32 size)
+{
+	char scratch[SPINNER_NUMBER_BUFFER_SIZE];
+	char *end = scratch + sizeof(scratch);
+
+	Unsigned magnitude = value < 0 ? 0 - (Unsigned)value : (Unsigned)value;
+	char *start = spinner_write_digits(magnitude, end);
+	if (value < 0)
+		*--start = '-';
+
+	return spinner_copy_number(start, end, buffer, size);
+}
+
+
+template<typename Unsigned>
+inline int32
+spinner_format_unsigned(Unsigned value, char *buffer, int32 size)
+{
+	char scratch[SPINNER_NUMBER_BUFFER_SIZE];
+	char *end = scratch + sizeof(scratch);
+	char *start = spinner_write_digits(value, end);
+	return spinner_copy_number(start, end, buffer, size);
+}
+
+
+// Formats magnitude / scale with fractionDigits digits after the decimal
+// point, which must match scale (100 and 2, for example).
+inline int32
+spinner_format_fixed(int64 value, uint64 scale, int32 fractionDigits,
+	char *buffer, int32 size)
+{
+	char scratch[SPINNER_NUMBER_BUFFER_SIZE + 1];
+	char *end = scratch + sizeof(scratch);
+
+	uint64 magnitude = value < 0 ? 0 - (uint64)value : (uint64)value;
+	char *start = end;
+	if (fractionDigits > 0) {
+		start -= fractionDigits;
+		spinner_write_padded_digits(magnitude % scale, start,
+			fractionDigits);
+		*--start = '.';
+	}
+	start = spinner_write_digits(magnitude / scale, start);
+	if (value < 0)
+		*--start = '-';
+
+	return spinner_copy_number(start, end, buffer, size);
+}
+
+
+// Skips blanks and a sign. Only the ASCII blanks count as white space, so
+// the result does not depend on the locale.
+inline const char*
+spinner_parse_sign(const char *text, bool *negative)
+{
+	while (*text == ' ' || *text == '\t' || *text == '\n' || *text == '\r'
+		|| *text == '\v' || *text == '\f') {
+		text++;
+	}
+
+	*negative = *text == '-';
+	if (*text == '-' || *text == '+')
+		text++;
+	return text;
+}
+
+
+// Parses decimal digits into *value in a single pass, stopping at the first
+// non-digit. If the number exceeds limit, *value is set to limit and
+// *overflow to true; the remaining digits are still consumed. Returns the
+// position after the last digit, or text if there was no digit at all.
+template<typename Unsigned>
+inline const char*
+spinner_parse_digits(const char *text, Unsigned limit, Unsigned *value,
+	bool *overflow)
+{
+	const Unsigned cutoff = limit / 10;
+	const Unsigned cutlim = limit % 10;
+
+	Unsigned result = 0;
+	bool overflowed = false;
+	for (;; text++) {
+		Unsigned digit = (Unsigned)(unsigned char)(*text - '0');
+		if (digit > 9)
+			break;
+
+		if (overflowed)
+			continue;
+		if (result > cutoff || (result == cutoff && digit > cutlim)) {
+			overflowed = true;
+			result = limit;
+			continue;
+		}
+		result = result * 10 + digit;
+	}
+
+	*value = result;
+	*overflow = overflowed;
+	return text;
+}
+
+
+// Parses an optionally signed integer and saturates at the limits of
+// Signed. Returns false if there are no digits.
+template<typename Signed, typename Unsigned>
+inline bool
+spinner_parse_signed(const char *text, Signed lowest, Signed highest,
+	Signed *_value)
+{
+	bool negative;
+	text = spinner_parse_sign(text, &negative);
+
+	// the magnitude of the lowest value is one more than that of the highest
+	Unsigned limit = negative ? (Unsigned)highest + 1 : (Unsigned)highest;
+	Unsigned magnitude;
+	bool overflow;
+	if (spinner_parse_digits(text, limit, &magnitude, &overflow) == text)
+		return false;
+
+	if (negative)
+		*_value = magnitude == limit ? lowest : -(Signed)magnitude;
+	else
+		*_value = (Signed)magnitude;
+	return true;
+}
+
+
+// Parses an unsigned integer. Negative numbers saturate at zero.
+template<typename Unsigned>
+inline bool
+spinner_parse_unsigned(const char *text, Unsigned *_value)
+{
+	bool negative;
+	text = spinner_parse_sign(text, &negative);
+
+	Unsigned magnitude;
+	bool overflow;
+	if (spinner_parse_digits(text, (Unsigned)~(Unsigned)0, &magnitude,
+			&overflow) == text) {
+		return false;
+	}
+
+	*_value = negative ? 0 : magnitude;
+	return true;
+}
+
+
+// Parses a decimal number into value * scale, cutting off fraction digits
+// beyond the scale, and saturates at the int64 limits.
+inline bool
+spinner_parse_fixed(const char *text, uint64 scale, int64 *_value)
+{
+	bool negative;
+	text = spinner_parse_sign(text, &negative);
+
+	uint64 limit = negative ? (uint64)INT64_MAX + 1 : (uint64)INT64_MAX;
+	uint64 whole;
+	bool overflow;
+	const char *end = spinner_parse_digits(text, limit, &whole, &overflow);
+	bool hasDigits = end != text;
+	text = end;
+
+	uint64 fraction = 0;
+	if (*text == '.') {
+		text++;
+		for (uint64 place = scale; *text >= '0' && *text <= '9'; text++) {
+			hasDigits = true;
+			if (place > 1) {
+				place /= 10;
+				fraction += (uint64)(*text - '0') * place;
+			}
+		}
+	}
+
+	if (!hasDigits)
+		return false;
+
+	uint64 magnitude;
+	if (overflow || whole > (limit - fraction) / scale)
+		magnitude = limit;
+	else
+		magnitude = whole * scale + fraction;
+
+	*_value = negative ? (int64)(0 - magnitude) : (int64)magnitude;
+	return true;
+}
+
+#endif
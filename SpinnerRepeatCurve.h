@@ -0,0 +1,254 @@
+/*
+	SpinnerRepeatCurve.h: Auto-repeat acceleration for the Spinner control.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_REPEAT_CURVE_H_
+#define SPINNER_REPEAT_CURVE_H_
+
+#include <SupportDefs.h>
+
+#include "SpinnerNumberCodec.h"
+
+/*
+	Holding down an arrow repeats the step, and the longer the arrow is
+	held, the bigger and faster the steps get. A SpinnerRepeatCurve
+	describes how: it is a list of stages, each of which starts after the
+	arrow has been held for a certain time and sets how many steps one tick
+	moves and how long it is until the next tick.
+
+	The first stage starts at the press itself, which always moves exactly
+	one tick's worth, so a short click keeps full precision. Its interval is
+	the delay before repeating starts.
+
+	In text form, as used by the "RepeatCurve" scripting property, a curve
+	is a comma separated list of "held:steps:interval" stages with the times
+	in milliseconds, for example "0:1:300, 300:1:60, 1500:10:50".
+*/
+
+struct spinner_repeat_stage {
+	bigtime_t	held;
+	int32		multiplier;
+	bigtime_t	interval;
+};
+
+enum {
+	SPINNER_MAX_REPEAT_STAGES = 8,
+	SPINNER_REPEAT_CURVE_TEXT_SIZE = SPINNER_MAX_REPEAT_STAGES * 64
+};
+
+
+class SpinnerRepeatCurve
+{
+public:
+							SpinnerRepeatCurve(void)
+								:
+								fCount(0)
+							{
+								SetToDefault();
+							}
+
+	// With the default curve, a sweep across a million steps takes about
+	// ten seconds instead of more than a day at one step per 100 ms.
+			void			SetToDefault(void)
+								{
+									static const spinner_repeat_stage
+										kDefault[] = {
+										{       0,     1, 300000 },
+										{  300000,     1,  60000 },
+										{ 1500000,    10,  50000 },
+										{ 3000000,   100,  40000 },
+										{ 4500000,  1000,  40000 },
+										{ 6000000, 10000,  40000 }
+									};
+									SetStages(kDefault, sizeof(kDefault)
+										/ sizeof(kDefault[0]));
+								}
+
+	// The stages must start at 0, be in increasing order of held time, and
+	// have a positive multiplier and interval.
+			status_t		SetStages(const spinner_repeat_stage *stages,
+								int32 count)
+								{
+									if (count < 1
+										|| count > SPINNER_MAX_REPEAT_STAGES
+										|| stages[0].held != 0)
+										return B_BAD_VALUE;
+									for (int32 i = 0; i < count; i++) {
+										if (stages[i].multiplier < 1
+											|| stages[i].interval <= 0
+											|| (i > 0 && stages[i].held
+												<= stages[i - 1].held))
+											return B_BAD_VALUE;
+									}
+
+									for (int32 i = 0; i < count; i++)
+										fStages[i] = stages[i];
+									fCount = count;
+									return B_OK;
+								}
+
+			int32			CountStages(void) const { return fCount; }
+			const spinner_repeat_stage& StageAt(int32 index) const
+								{ return fStages[index]; }
+
+			const spinner_repeat_stage& StageFor(bigtime_t held) const
+								{
+									int32 i = fCount - 1;
+									while (i > 0 && fStages[i].held > held)
+										i--;
+									return fStages[i];
+								}
+
+			bool			operator==(const SpinnerRepeatCurve &other) const
+								{
+									if (fCount != other.fCount)
+										return false;
+									for (int32 i = 0; i < fCount; i++) {
+										if (fStages[i].held != other.fStages[i].held
+											|| fStages[i].multiplier
+												!= other.fStages[i].multiplier
+											|| fStages[i].interval
+												!= other.fStages[i].interval)
+											return false;
+									}
+									return true;
+								}
+			bool			operator!=(const SpinnerRepeatCurve &other) const
+								{ return !(*this == other); }
+
+	// Writes the text form; SPINNER_REPEAT_CURVE_TEXT_SIZE bytes always fit.
+			int32			Format(char *buffer, int32 size) const
+								{
+									char text[SPINNER_REPEAT_CURVE_TEXT_SIZE];
+									char *out = text;
+									for (int32 i = 0; i < fCount; i++) {
+										if (i > 0) {
+											*out++ = ',';
+											*out++ = ' ';
+										}
+										out += spinner_format_signed<int64,
+											uint64>(fStages[i].held / 1000,
+											out, SPINNER_NUMBER_BUFFER_SIZE);
+										*out++ = ':';
+										out += spinner_format_signed<int32,
+											uint32>(fStages[i].multiplier,
+											out, SPINNER_NUMBER_BUFFER_SIZE);
+										*out++ = ':';
+										out += spinner_format_signed<int64,
+											uint64>(fStages[i].interval / 1000,
+											out, SPINNER_NUMBER_BUFFER_SIZE);
+									}
+									return spinner_copy_number(text, out,
+										buffer, size);
+								}
+
+	// Parses the text form. The curve is left alone if the text is not a
+	// valid curve.
+			status_t		Parse(const char *text)
+								{
+									spinner_repeat_stage
+										stages[SPINNER_MAX_REPEAT_STAGES];
+									int32 count = 0;
+									for (;;) {
+										if (count == SPINNER_MAX_REPEAT_STAGES)
+											return B_BAD_VALUE;
+
+										uint64 held;
+										uint64 multiplier;
+										uint64 interval;
+										if (!_ParseNumber(&text, kMaxMilliseconds,
+												&held)
+											|| *text++ != ':'
+											|| !_ParseNumber(&text, INT32_MAX,
+												&multiplier)
+											|| *text++ != ':'
+											|| !_ParseNumber(&text,
+												kMaxMilliseconds, &interval))
+											return B_BAD_VALUE;
+
+										stages[count].held = held * 1000;
+										stages[count].multiplier
+											= (int32)multiplier;
+										stages[count].interval = interval * 1000;
+										count++;
+
+										while (*text == ' ')
+											text++;
+										if (*text == '\0')
+											break;
+										if (*text++ != ',')
+											return B_BAD_VALUE;
+									}
+									return SetStages(stages, count);
+								}
+
+private:
+	static	const uint64	kMaxMilliseconds = INT64_MAX / 1000;
+
+	static	bool			_ParseNumber(const char **text, uint64 limit,
+								uint64 *value)
+								{
+									const char *start = *text;
+									while (*start == ' ')
+										start++;
+
+									bool overflow;
+									const char *end = spinner_parse_digits(
+										start, limit, value, &overflow);
+									if (end == start)
+										return false;
+									*text = end;
+									return true;
+								}
+
+			spinner_repeat_stage fStages[SPINNER_MAX_REPEAT_STAGES];
+			int32			fCount;
+};
+
+
+// Tracks one press of an arrow against a curve. Poll() returns how many
+// steps are due at a given time, and NextTick() when the next ones are.
+class SpinnerAutoRepeat
+{
+public:
+							SpinnerAutoRepeat(void)
+								:
+								fStart(0),
+								fNext(0),
+								fActive(false)
+							{
+							}
+
+			void			Start(bigtime_t now)
+								{
+									fStart = now;
+									fNext = now;
+									fActive = true;
+								}
+			void			Stop(void) { fActive = false; }
+			bool			IsActive(void) const { return fActive; }
+			bigtime_t		NextTick(void) const { return fNext; }
+
+	// Ticks that were missed because the caller polled late are dropped
+	// rather than delivered in a burst.
+			int32			Poll(const SpinnerRepeatCurve &curve,
+								bigtime_t now)
+								{
+									if (!fActive || now < fNext)
+										return 0;
+
+									const spinner_repeat_stage &stage
+										= curve.StageFor(fNext - fStart);
+									fNext += stage.interval;
+									if (fNext < now)
+										fNext = now;
+									return stage.multiplier;
+								}
+
+private:
+			bigtime_t		fStart;
+			bigtime_t		fNext;
+			bool			fActive;
+};
+
+#endif
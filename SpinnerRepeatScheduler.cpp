@@ -0,0 +1,157 @@
+/*
+	SpinnerRepeatScheduler.cpp: Looper-side timer for spinner auto-repeat.
+	Released under the MIT license.
+*/
+#include "SpinnerRepeatScheduler.h"
+
+#include <Looper.h>
+#include <MessageRunner.h>
+#include <Messenger.h>
+#include <OS.h>
+
+enum {
+	M_REPEAT_TICK = 'srtk'
+};
+
+static const bigtime_t kDefaultPeriod = 20000;
+
+
+SpinnerRepeatScheduler::SpinnerRepeatScheduler(void)
+	:
+	BHandler("SpinnerRepeatScheduler"),
+	fRunner(NULL),
+	fPeriod(kDefaultPeriod),
+	fReferences(0)
+{
+}
+
+
+SpinnerRepeatScheduler::~SpinnerRepeatScheduler(void)
+{
+	delete fRunner;
+}
+
+
+SpinnerRepeatScheduler*
+SpinnerRepeatScheduler::Acquire(BLooper *looper)
+{
+	if (looper == NULL)
+		return NULL;
+
+	SpinnerRepeatScheduler *scheduler = NULL;
+	for (int32 i = 0; i < looper->CountHandlers(); i++) {
+		scheduler = dynamic_cast<SpinnerRepeatScheduler*>(
+			looper->HandlerAt(i));
+		if (scheduler != NULL)
+			break;
+	}
+
+	if (scheduler == NULL) {
+		scheduler = new SpinnerRepeatScheduler;
+		looper->AddHandler(scheduler);
+	}
+
+	scheduler->fReferences++;
+	return scheduler;
+}
+
+
+void
+SpinnerRepeatScheduler::Release(void)
+{
+	if (--fReferences > 0)
+		return;
+
+	if (Looper() != NULL)
+		Looper()->RemoveHandler(this);
+	delete this;
+}
+
+
+void
+SpinnerRepeatScheduler::Schedule(SpinnerRepeatClient *client)
+{
+	if (client == NULL || IsScheduled(client))
+		return;
+
+	fClients.AddItem(client);
+	_UpdateRunner();
+}
+
+
+void
+SpinnerRepeatScheduler::Unschedule(SpinnerRepeatClient *client)
+{
+	if (fClients.RemoveItem(client))
+		_UpdateRunner();
+}
+
+
+bool
+SpinnerRepeatScheduler::IsScheduled(SpinnerRepeatClient *client) const
+{
+	return fClients.HasItem(client);
+}
+
+
+void
+SpinnerRepeatScheduler::SetPeriod(bigtime_t period)
+{
+	if (period <= 0 || period == fPeriod)
+		return;
+
+	fPeriod = period;
+	if (fRunner != NULL)
+		fRunner->SetInterval(fPeriod);
+}
+
+
+void
+SpinnerRepeatScheduler::MessageReceived(BMessage *msg)
+{
+	switch (msg->what) {
+		case M_REPEAT_TICK:
+			_Tick();
+			break;
+
+		default:
+			BHandler::MessageReceived(msg);
+			break;
+	}
+}
+
+
+void
+SpinnerRepeatScheduler::_Tick(void)
+{
+	bigtime_t now = system_time();
+
+	// A tick may unschedule any client, itself or another one, say when
+	// a ValueChanged() hook disables some other spinner. Walk a copy, and
+	// skip the clients that are gone by the time it gets to them.
+	BList clients(fClients);
+	for (int32 i = 0; i < clients.CountItems(); i++) {
+		SpinnerRepeatClient *client
+			= (SpinnerRepeatClient*)clients.ItemAt(i);
+		if (!fClients.HasItem(client))
+			continue;
+
+		if (!client->RepeatTick(now))
+			fClients.RemoveItem(client);
+	}
+
+	_UpdateRunner();
+}
+
+
+void
+SpinnerRepeatScheduler::_UpdateRunner(void)
+{
+	if (fClients.IsEmpty()) {
+		delete fRunner;
+		fRunner = NULL;
+	} else if (fRunner == NULL) {
+		BMessage tick(M_REPEAT_TICK);
+		fRunner = new BMessageRunner(BMessenger(this), &tick, fPeriod);
+	}
+}
@@ -0,0 +1,69 @@
+/*
+	SpinnerRepeatScheduler.h: Looper-side timer for spinner auto-repeat.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_REPEAT_SCHEDULER_H_
+#define SPINNER_REPEAT_SCHEDULER_H_
+
+#include <Handler.h>
+#include <List.h>
+
+class BLooper;
+class BMessageRunner;
+
+/*
+	Anything that needs to do work at regular intervals while a mouse
+	button is held, like a spinner arrow, is a SpinnerRepeatClient. Instead
+	of each press spawning a thread that polls and locks the window, all
+	clients in a looper share one SpinnerRepeatScheduler. It is a BHandler
+	in that looper and gets ticks from a single BMessageRunner. The runner
+	only exists while at least one client is scheduled, so an idle window
+	costs nothing.
+
+	Clients run in the looper's thread with the looper locked.
+*/
+
+class SpinnerRepeatClient
+{
+public:
+	virtual					~SpinnerRepeatClient(void) {}
+
+	// Called on every tick while scheduled. Returning false unschedules
+	// the client.
+	virtual	bool			RepeatTick(bigtime_t now) = 0;
+};
+
+
+class SpinnerRepeatScheduler : public BHandler
+{
+public:
+	// Returns the scheduler of looper, creating it if needed. Every
+	// Acquire() needs a Release(). The looper must be locked for both.
+	static	SpinnerRepeatScheduler* Acquire(BLooper *looper);
+			void			Release(void);
+
+			void			Schedule(SpinnerRepeatClient *client);
+			void			Unschedule(SpinnerRepeatClient *client);
+			bool			IsScheduled(SpinnerRepeatClient *client) const;
+
+	// Time between ticks. Clients that want a slower pace keep their own
+	// deadlines and skip ticks.
+			void			SetPeriod(bigtime_t period);
+			bigtime_t		Period(void) const { return fPeriod; }
+
+	virtual	void			MessageReceived(BMessage *msg);
+
+private:
+							SpinnerRepeatScheduler(void);
+	virtual					~SpinnerRepeatScheduler(void);
+
+			void			_Tick(void);
+			void			_UpdateRunner(void);
+
+			BList			fClients;
+			BMessageRunner*	fRunner;
+			bigtime_t		fPeriod;
+			int32			fReferences;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+	SpinnerStyle.cpp: System metrics shared by all spinners.
+	Released under the MIT license.
+*/
+#include "SpinnerStyle.h"
+
+#include <Autolock.h>
+#include <Locker.h>
+#include <ScrollBar.h>
+
+#include <math.h>
+
+namespace {
+
+// Get() reads whichever block is current while a reload fills the other
+spinner_style sStyles[2];
+int32 sCurrent = 0;
+int32 sStale = 1;
+
+BLocker sLock("spinner style");
+
+
+void
+read_style(spinner_style &style)
+{
+	be_plain_font->GetHeight(&style.plainFontHeight);
+	style.plainLineHeight = ceilf(style.plainFontHeight.ascent
+		+ style.plainFontHeight.descent + style.plainFontHeight.leading);
+
+	// Two buttons twice as wide as they are tall, stacked in a column as
+	// wide as a scroll bar
+	style.arrowHeight = floorf(B_V_SCROLL_BAR_WIDTH / 2) + 1;
+	style.arrowWidth = style.arrowHeight * 2;
+	style.arrowInset = B_V_SCROLL_BAR_WIDTH;
+	style.upArrowTop = B_H_SCROLL_BAR_HEIGHT / 2 - 1;
+	style.downArrowTop = B_H_SCROLL_BAR_HEIGHT + 1;
+}
+
+}	// namespace
+
+
+const spinner_style&
+SpinnerStyle::Get(void)
+{
+	if (atomic_get(&sStale) != 0) {
+		BAutolock locker(sLock);
+		if (atomic_get(&sStale) != 0) {
+			int32 next = 1 - atomic_get(&sCurrent);
+			read_style(sStyles[next]);
+			atomic_set(&sCurrent, next);
+			atomic_set(&sStale, 0);
+		}
+	}
+	return sStyles[atomic_get(&sCurrent)];
+}
+
+
+void
+SpinnerStyle::SettingsChanged(void)
+{
+	atomic_set(&sStale, 1);
+}
@@ -0,0 +1,44 @@
+/*
+	SpinnerStyle.h: System metrics shared by all spinners.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_STYLE_H_
+#define SPINNER_STYLE_H_
+
+#include <Font.h>
+
+/*
+	What every spinner would otherwise ask the system for on its own: the
+	height of the plain font and the size and place of the arrow buttons
+	derived from the scroll bar width. They are read once per process and
+	kept in one block.
+
+	SettingsChanged() marks the block stale, and the next Get() reads the
+	settings again. The spinners call it when they are told that the fonts
+	or colors changed, so a window full of them still only costs one
+	reload. A reference returned by Get() stays valid until the settings
+	change twice; don't hold on to it beyond the current message.
+*/
+
+struct spinner_style {
+	font_height			plainFontHeight;
+	// the line height of a text view in the plain font
+	float				plainLineHeight;
+
+	// the arrow buttons, relative to the right edge and top of a spinner
+	float				arrowWidth;
+	float				arrowHeight;
+	float				arrowInset;
+	float				upArrowTop;
+	float				downArrowTop;
+};
+
+
+class SpinnerStyle
+{
+public:
+	static	const spinner_style& Get(void);
+	static	void			SettingsChanged(void);
+};
+
+#endif
@@ -0,0 +1,52 @@
+/*
+	SpinnerValueCore.cpp: Typed value storage for the Spinner control.
+	Released under the MIT license.
+*/
+#include "SpinnerValueCore.h"
+
+
+SpinnerValueCore*
+SpinnerValueCore::Instantiate(const BMessage *from)
+{
+	int32 type;
+	if (from == NULL || from->FindInt32("_type", &type) != B_OK)
+		type = B_INT32_TYPE;
+
+	int64 scale;
+	if (from == NULL || from->FindInt64("_scale", &scale) != B_OK)
+		scale = 1;
+
+	// Fixed point scales are template arguments, so only the ones listed
+	// here can be restored. Unknown ones fall back to a plain int64 core,
+	// which keeps the stored values intact.
+	SpinnerValueCore *core;
+	if (type == B_INT64_TYPE) {
+		switch (scale) {
+			case 10:
+				core = new TypedSpinnerValueCore<SpinnerFixedTraits<10> >;
+				break;
+			case 100:
+				core = new TypedSpinnerValueCore<SpinnerFixedTraits<100> >;
+				break;
+			case 1000:
+				core = new TypedSpinnerValueCore<SpinnerFixedTraits<1000> >;
+				break;
+			case 10000:
+				core = new TypedSpinnerValueCore<SpinnerFixedTraits<10000> >;
+				break;
+			case 1000000:
+				core = new TypedSpinnerValueCore<SpinnerFixedTraits<1000000> >;
+				break;
+			default:
+				core = new SpinnerInt64Core;
+				break;
+		}
+	} else if (type == B_UINT64_TYPE)
+		core = new SpinnerUInt64Core;
+	else
+		core = new SpinnerInt32Core;
+
+	if (from != NULL)
+		core->Unarchive(from);
+	return core;
+}
@@ -0,0 +1,391 @@
+/*
+	SpinnerValueCore.h: Typed value storage for the Spinner control.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_VALUE_CORE_H_
+#define SPINNER_VALUE_CORE_H_
+
+#include <Message.h>
+
+#include "SpinnerModel.h"
+
+/*
+	A Spinner keeps its value in a SpinnerValueCore, which wraps a
+	BasicSpinnerModel of one particular value type. The control only ever
+	talks to the core through this interface, so it does not care whether
+	it is spinning an int32, an int64, a uint64 or a fixed point number,
+	while each core does its arithmetic, formatting and parsing in its own
+	type.
+
+	The int32 accessors serve the classic Spinner API and BControl::Value().
+	They saturate for wide cores and deal in stored units, so for a fixed
+	point core with a scale of 100, an int32 value of 25 means 0.25.
+*/
+
+enum spinner_field {
+	SPINNER_VALUE = 0,
+	SPINNER_MIN,
+	SPINNER_MAX,
+	SPINNER_STEP
+};
+
+
+class SpinnerValueCore
+{
+public:
+	virtual					~SpinnerValueCore(void) {}
+
+	// B_INT32_TYPE, B_INT64_TYPE or B_UINT64_TYPE; fixed point cores store
+	// B_INT64_TYPE values and have a Scale() above 1
+	virtual	type_code		TypeCode(void) const = 0;
+	virtual	int64			Scale(void) const = 0;
+
+	virtual	bool			StepBy(int32 count) = 0;
+	virtual	bool			SetFromText(const char *text) = 0;
+	virtual	int32			Format(char *buffer, int32 size) const = 0;
+	virtual	int32			FormatField(spinner_field field, char *buffer,
+								int32 size) const = 0;
+
+	virtual	int32			Int32(spinner_field field) const = 0;
+	virtual	bool			SetInt32(spinner_field field, int32 value) = 0;
+	virtual	bool			Contains(int32 value) const = 0;
+
+	// Field access in the native type of the core. SetField() takes any
+	// integer type or a string and clamps it to the native type; *changed
+	// is set if the value moved.
+	virtual	status_t		GetField(spinner_field field, BMessage *into,
+								const char *name) const = 0;
+	virtual	status_t		SetField(spinner_field field, const BMessage *from,
+								const char *name, bool *changed) = 0;
+
+	virtual	status_t		Archive(BMessage *into) const = 0;
+	virtual	status_t		Unarchive(const BMessage *from) = 0;
+
+	// The bytes the core itself takes up
+	virtual	size_t			Footprint(void) const = 0;
+
+	// Creates the core an archive was made with. Archives without type
+	// information get an int32 core.
+	static	SpinnerValueCore* Instantiate(const BMessage *from);
+};
+
+
+// Saturating conversions between the transport types and the value types
+inline void
+spinner_convert(int64 from, int32 *to)
+{
+	*to = from < INT32_MIN ? INT32_MIN : from > INT32_MAX ? INT32_MAX
+		: (int32)from;
+}
+
+inline void
+spinner_convert(uint64 from, int32 *to)
+{
+	*to = from > INT32_MAX ? INT32_MAX : (int32)from;
+}
+
+inline void
+spinner_convert(int64 from, int64 *to)
+{
+	*to = from;
+}
+
+inline void
+spinner_convert(uint64 from, int64 *to)
+{
+	*to = from > INT64_MAX ? INT64_MAX : (int64)from;
+}
+
+inline void
+spinner_convert(int64 from, uint64 *to)
+{
+	*to = from < 0 ? 0 : (uint64)from;
+}
+
+inline void
+spinner_convert(uint64 from, uint64 *to)
+{
+	*to = from;
+}
+
+
+inline int64
+spinner_widen(int32 value)
+{
+	return value;
+}
+
+inline int64
+spinner_widen(int64 value)
+{
+	return value;
+}
+
+inline uint64
+spinner_widen(uint64 value)
+{
+	return value;
+}
+
+
+inline type_code
+spinner_type_code(int32)
+{
+	return B_INT32_TYPE;
+}
+
+inline type_code
+spinner_type_code(int64)
+{
+	return B_INT64_TYPE;
+}
+
+inline type_code
+spinner_type_code(uint64)
+{
+	return B_UINT64_TYPE;
+}
+
+
+inline status_t
+spinner_add_value(BMessage *into, const char *name, int32 value)
+{
+	return into->AddInt32(name, value);
+}
+
+inline status_t
+spinner_add_value(BMessage *into, const char *name, int64 value)
+{
+	return into->AddInt64(name, value);
+}
+
+inline status_t
+spinner_add_value(BMessage *into, const char *name, uint64 value)
+{
+	return into->AddUInt64(name, value);
+}
+
+
+// Finds an integer field of any width and converts it to the value type.
+// Strings are left to the caller, since only the traits can parse them.
+template<typename T>
+status_t
+spinner_find_value(const BMessage *from, const char *name, T *value)
+{
+	type_code type;
+	if (from->GetInfo(name, &type) != B_OK)
+		return B_NAME_NOT_FOUND;
+
+	switch (type) {
+		case B_INT32_TYPE:
+		{
+			int32 found;
+			status_t status = from->FindInt32(name, &found);
+			if (status == B_OK)
+				spinner_convert((int64)found, value);
+			return status;
+		}
+		case B_INT64_TYPE:
+		{
+			int64 found;
+			status_t status = from->FindInt64(name, &found);
+			if (status == B_OK)
+				spinner_convert(found, value);
+			return status;
+		}
+		case B_UINT64_TYPE:
+		{
+			uint64 found;
+			status_t status = from->FindUInt64(name, &found);
+			if (status == B_OK)
+				spinner_convert(found, value);
+			return status;
+		}
+	}
+	return B_BAD_TYPE;
+}
+
+
+template<class Traits>
+class TypedSpinnerValueCore : public SpinnerValueCore
+{
+public:
+	typedef typename Traits::value_type		value_type;
+	typedef BasicSpinnerModel<Traits>		model_type;
+
+							TypedSpinnerValueCore(void)
+							{
+							}
+
+							TypedSpinnerValueCore(value_type min,
+								value_type max, value_type step)
+								:
+								fModel(min, max, step)
+							{
+							}
+
+			model_type&		Model(void) { return fModel; }
+			const model_type& Model(void) const { return fModel; }
+
+	virtual	type_code		TypeCode(void) const
+								{ return spinner_type_code(value_type()); }
+	virtual	int64			Scale(void) const { return Traits::Scale(); }
+
+	virtual	bool			StepBy(int32 count)
+								{ return fModel.StepBy(count); }
+
+	virtual	bool			SetFromText(const char *text)
+								{
+									value_type value = 0;
+									if (!Traits::Parse(text, &value))
+										value = 0;
+									return fModel.SetValue(value);
+								}
+
+	virtual	int32			Format(char *buffer, int32 size) const
+								{
+									return Traits::Format(fModel.Value(),
+										buffer, size);
+								}
+
+	virtual	int32			FormatField(spinner_field field, char *buffer,
+								int32 size) const
+								{
+									return Traits::Format(_Get(field), buffer,
+										size);
+								}
+
+	virtual	int32			Int32(spinner_field field) const
+								{
+									int32 value;
+									spinner_convert(spinner_widen(_Get(field)),
+										&value);
+									return value;
+								}
+
+	virtual	bool			SetInt32(spinner_field field, int32 value)
+								{
+									value_type converted;
+									spinner_convert((int64)value, &converted);
+									return _Set(field, converted);
+								}
+
+	virtual	bool			Contains(int32 value) const
+								{
+									value_type converted;
+									spinner_convert((int64)value, &converted);
+									return (int64)converted == (int64)value
+										&& fModel.Contains(converted);
+								}
+
+	virtual	status_t		GetField(spinner_field field, BMessage *into,
+								const char *name) const
+								{
+									return spinner_add_value(into, name,
+										_Get(field));
+								}
+
+	virtual	status_t		SetField(spinner_field field,
+								const BMessage *from, const char *name,
+								bool *changed)
+								{
+									value_type value;
+									const char *text;
+									if (from->FindString(name, &text) == B_OK) {
+										if (!Traits::Parse(text, &value))
+											return B_BAD_VALUE;
+									} else {
+										status_t status = spinner_find_value(
+											from, name, &value);
+										if (status != B_OK)
+											return status;
+									}
+									*changed = _Set(field, value);
+									return B_OK;
+								}
+
+	virtual	status_t		Archive(BMessage *into) const
+								{
+									status_t status = into->AddInt32("_type",
+										TypeCode());
+									if (status == B_OK && Traits::Scale() > 1)
+										status = into->AddInt64("_scale",
+											Traits::Scale());
+									if (status == B_OK)
+										status = spinner_add_value(into,
+											"_min", fModel.Min());
+									if (status == B_OK)
+										status = spinner_add_value(into,
+											"_max", fModel.Max());
+									if (status == B_OK)
+										status = spinner_add_value(into,
+											"_step", fModel.Step());
+									if (status == B_OK)
+										status = spinner_add_value(into,
+											"_value", fModel.Value());
+									return status;
+								}
+
+	virtual	status_t		Unarchive(const BMessage *from)
+								{
+									value_type min = fModel.Min();
+									value_type max = fModel.Max();
+									value_type step = fModel.Step();
+									value_type value = fModel.Value();
+									spinner_find_value(from, "_min", &min);
+									spinner_find_value(from, "_max", &max);
+									spinner_find_value(from, "_step", &step);
+
+									// BControl archives its own int32 value
+									// as "_val"
+									if (spinner_find_value(from, "_value",
+											&value) != B_OK)
+										spinner_find_value(from, "_val", &value);
+
+									fModel.SetRange(min, max);
+									fModel.SetStep(step);
+									fModel.SetValue(value);
+									return B_OK;
+								}
+
+	virtual	size_t			Footprint(void) const { return sizeof(*this); }
+
+private:
+			value_type		_Get(spinner_field field) const
+								{
+									switch (field) {
+										case SPINNER_MIN:
+											return fModel.Min();
+										case SPINNER_MAX:
+											return fModel.Max();
+										case SPINNER_STEP:
+											return fModel.Step();
+										default:
+											return fModel.Value();
+									}
+								}
+
+			bool			_Set(spinner_field field, value_type value)
+								{
+									switch (field) {
+										case SPINNER_MIN:
+											return fModel.SetMin(value);
+										case SPINNER_MAX:
+											return fModel.SetMax(value);
+										case SPINNER_STEP:
+											fModel.SetStep(value);
+											return false;
+										default:
+											return fModel.SetValue(value);
+									}
+								}
+
+			model_type		fModel;
+};
+
+
+typedef TypedSpinnerValueCore<SpinnerInt32Traits>	SpinnerInt32Core;
+typedef TypedSpinnerValueCore<SpinnerInt64Traits>	SpinnerInt64Core;
+typedef TypedSpinnerValueCore<SpinnerUInt64Traits>	SpinnerUInt64Core;
+
+#endif
@@ -0,0 +1,135 @@
+/*
+	SpinnerValueTraits.h: Value types for the spinner model.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_VALUE_TRAITS_H_
+#define SPINNER_VALUE_TRAITS_H_
+
+#include "SpinnerNumberCodec.h"
+
+/*
+	A traits class describes one value type a spinner can work with: the
+	storage type, its unsigned counterpart for overflow-free arithmetic,
+	its limits, and how to format and parse it. Everything is resolved at
+	compile time, so the model never converts through floating point and
+	never switches on the type at run time.
+
+	Format() writes a NUL terminated string and returns its length; a
+	buffer of SPINNER_TEXT_BUFFER_SIZE bytes always fits. Parse() accepts
+	optional leading white space, an optional sign and digits, ignores
+	anything that follows, and saturates at the limits of the type. It
+	returns false if there is no number at all. Both go through
+	SpinnerNumberCodec.h and neither allocates.
+*/
+
+enum {
+	SPINNER_TEXT_BUFFER_SIZE = 32
+};
+
+
+template<class Signed, class Unsigned, Signed kLowest, Signed kHighest>
+struct SpinnerSignedTraits {
+	typedef Signed		value_type;
+	typedef Unsigned	unsigned_type;
+
+	static	value_type	One() { return 1; }
+	static	value_type	Lowest() { return kLowest; }
+	static	value_type	Highest() { return kHighest; }
+	static	int64		Scale() { return 1; }
+
+	static	int32		Format(value_type value, char *buffer, int32 size)
+		{
+			return spinner_format_signed<Signed, Unsigned>(value, buffer,
+				size);
+		}
+
+	static	bool		Parse(const char *text, value_type *_value)
+		{
+			return spinner_parse_signed<Signed, Unsigned>(text, kLowest,
+				kHighest, _value);
+		}
+};
+
+
+typedef SpinnerSignedTraits<int32, uint32, INT32_MIN, INT32_MAX>
+	SpinnerInt32Traits;
+typedef SpinnerSignedTraits<int64, uint64, INT64_MIN, INT64_MAX>
+	SpinnerInt64Traits;
+
+
+struct SpinnerUInt64Traits {
+	typedef uint64		value_type;
+	typedef uint64		unsigned_type;
+
+	static	value_type	One() { return 1; }
+	static	value_type	Lowest() { return 0; }
+	static	value_type	Highest() { return UINT64_MAX; }
+	static	int64		Scale() { return 1; }
+
+	static	int32		Format(value_type value, char *buffer, int32 size)
+		{
+			return spinner_format_unsigned(value, buffer, size);
+		}
+
+	static	bool		Parse(const char *text, value_type *_value)
+		{
+			// negative input saturates at zero instead of wrapping around
+			return spinner_parse_unsigned(text, _value);
+		}
+};
+
+
+template<int64 kValue>
+struct spinner_is_power_of_ten {
+	enum {
+		value = kValue % 10 == 0 && spinner_is_power_of_ten<kValue / 10>::value
+	};
+};
+
+template<>
+struct spinner_is_power_of_ten<1> { enum { value = 1 }; };
+
+template<>
+struct spinner_is_power_of_ten<0> { enum { value = 0 }; };
+
+
+// Decimal fixed point: the stored value is the number multiplied by kScale,
+// which must be a power of ten. SpinnerFixedTraits<100> holds values with
+// two fractional digits, so a step of 0.25 is stored as 25.
+template<int64 kScale>
+struct SpinnerFixedTraits {
+	typedef int64		value_type;
+	typedef uint64		unsigned_type;
+
+	static	value_type	One() { return kScale; }
+	static	value_type	Lowest() { return INT64_MIN; }
+	static	value_type	Highest() { return INT64_MAX; }
+	static	int64		Scale() { return kScale; }
+
+	static	int32		FractionDigits()
+		{
+			int32 digits = 0;
+			for (int64 scale = kScale; scale > 1; scale /= 10)
+				digits++;
+			return digits;
+		}
+
+	static	int32		Format(value_type value, char *buffer, int32 size)
+		{
+			return spinner_format_fixed(value, kScale, FractionDigits(),
+				buffer, size);
+		}
+
+	// digits beyond the scale are cut off, not rounded
+	static	bool		Parse(const char *text, value_type *_value)
+		{
+			return spinner_parse_fixed(text, kScale, _value);
+		}
+
+private:
+	typedef char		ScaleMustBeAPowerOfTen[
+							spinner_is_power_of_ten<kScale>::value ? 1 : -1];
+};
+
+
+#endif
@@ -0,0 +1,130 @@
+/*
+	SpinnerWidthCache.cpp: Remembers string widths for spinner layout.
+	Released under the MIT license.
+*/
+#include "SpinnerWidthCache.h"
+
+#include <Autolock.h>
+#include <Font.h>
+#include <Locker.h>
+#include <String.h>
+
+#include <map>
+
+#include "SpinnerValueTraits.h"
+
+namespace {
+
+// Only what changes the width of a string goes into the key
+struct width_key {
+	uint32		familyAndStyle;
+	float		size;
+	uint16		face;
+	uint8		spacing;
+	BString		text;
+
+	width_key(const BFont &font, const char *string)
+		:
+		familyAndStyle(font.FamilyAndStyle()),
+		size(font.Size()),
+		face(font.Face()),
+		spacing(font.Spacing()),
+		text(string)
+	{
+	}
+
+	bool operator<(const width_key &other) const
+	{
+		if (familyAndStyle != other.familyAndStyle)
+			return familyAndStyle < other.familyAndStyle;
+		if (size != other.size)
+			return size < other.size;
+		if (face != other.face)
+			return face < other.face;
+		if (spacing != other.spacing)
+			return spacing < other.spacing;
+		return text < other.text;
+	}
+};
+
+typedef std::map<width_key, float> width_map;
+
+// A spinner measures a handful of strings per font, so this only fills up
+// if fonts keep changing; start over rather than grow without bound.
+const size_t kMaxWidths = 1024;
+
+BLocker sLock("spinner width cache");
+width_map sWidths;
+
+}	// namespace
+
+
+float
+SpinnerWidthCache::StringWidth(const BFont &font, const char *string)
+{
+	if (string == NULL || string[0] == '\0')
+		return 0;
+
+	width_key key(font, string);
+
+	BAutolock locker(sLock);
+	width_map::const_iterator found = sWidths.find(key);
+	if (found != sWidths.end())
+		return found->second;
+
+	float width = font.StringWidth(string);
+	if (sWidths.size() >= kMaxWidths)
+		sWidths.clear();
+	sWidths.insert(width_map::value_type(key, width));
+	return width;
+}
+
+
+char
+SpinnerWidthCache::WidestDigit(const BFont &font)
+{
+	char widest = '0';
+	float widestWidth = -1;
+	for (char digit = '0'; digit <= '9'; digit++) {
+		char string[2] = { digit, '\0' };
+		float width = StringWidth(font, string);
+		if (width > widestWidth) {
+			widest = digit;
+			widestWidth = width;
+		}
+	}
+	return widest;
+}
+
+
+float
+SpinnerWidthCache::WidestNumberWidth(const BFont &font, const char *min,
+	const char *max)
+{
+	char widest = WidestDigit(font);
+	float width = 0;
+
+	const char *limits[] = { min, max };
+	for (int32 i = 0; i < 2; i++) {
+		char string[SPINNER_TEXT_BUFFER_SIZE];
+		int32 length = 0;
+		for (const char *c = limits[i]; *c != '\0'
+				&& length < SPINNER_TEXT_BUFFER_SIZE - 1; c++) {
+			string[length++] = *c >= '0' && *c <= '9' ? widest : *c;
+		}
+		string[length] = '\0';
+
+		float limitWidth = StringWidth(font, string);
+		if (limitWidth > width)
+			width = limitWidth;
+	}
+	return width;
+}
+
+
+void
+SpinnerWidthCache::Clear(void)
+{
+	BAutolock locker(sLock);
+	sWidths.clear();
+}
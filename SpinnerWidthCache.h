@@ -0,0 +1,38 @@
+/*
+	SpinnerWidthCache.h: Remembers string widths for spinner layout.
+	Released under the MIT license.
+*/
+#ifndef SPINNER_WIDTH_CACHE_H_
+#define SPINNER_WIDTH_CACHE_H_
+
+#include <SupportDefs.h>
+
+class BFont;
+
+/*
+	Every BFont::StringWidth() is a round trip to the app_server, and
+	spinner layout keeps asking for the widths of the same labels and
+	numbers. SpinnerWidthCache answers repeated questions from a process
+	wide table keyed by the font and the string. A different font is a
+	different key, so changing fonts never returns stale widths.
+*/
+
+class SpinnerWidthCache
+{
+public:
+	static	float			StringWidth(const BFont &font, const char *string);
+
+	// The digit that is widest in font. Replacing every digit of a number
+	// with it gives a string at least as wide as any number with the same
+	// number of digits.
+	static	char			WidestDigit(const BFont &font);
+
+	// The width of the widest text a number between the two formatted
+	// limits can have.
+	static	float			WidestNumberWidth(const BFont &font,
+								const char *min, const char *max);
+
+	static	void			Clear(void);
+};
+
+#endif
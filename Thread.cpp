@@ -36,6 +36,25 @@ All rights reserved.
 #include "Thread.h"
 #include "FunctionObject.h"
 
+#include <Autolock.h>
+#include <Locker.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+
+namespace {
+
+BLocker sDefaultPoolLock("default thread pool");
+ThreadPool* sDefaultPool = NULL;
+
+BLocker sPoolsLock("thread pools");
+std::vector<ThreadPool*> sPools;
+	// every pool there is, for ThreadPool::Current()
+
+}	// namespace
+
 
 SimpleThread::SimpleThread(int32 priority, const char* name)
 	:	fScanThread(-1),
@@ -72,10 +91,386 @@ SimpleThread::RunBinder(void* castToThis)
 }
 
 
+struct ThreadPool::Task {
+	Task()
+		:	functor(NULL),
+			priority(B_LOW_PRIORITY)
+	{
+	}
+
+	void TakeOver(Task& other)
+	{
+		functor = other.functor;
+		priority = other.priority;
+		function.TakeOver(other.function);
+		other.functor = NULL;
+	}
+
+	void Run()
+	{
+		if (functor != NULL) {
+			(*functor)();
+			delete functor;
+			functor = NULL;
+		} else {
+			function();
+			function.Clear();
+		}
+	}
+
+	FunctionObject* functor;
+	InlineFunction function;
+		// used when functor is NULL
+	int32 priority;
+};
+
+
+class ThreadPool::TaskQueue {
+	// A ring of tasks that only allocates when it has to grow; a
+	// std::deque frees and allocates its blocks as tasks come and go
+public:
+	TaskQueue()
+		:	fTasks(NULL),
+			fCapacity(0),
+			fHead(0),
+			fCount(0)
+	{
+	}
+
+	~TaskQueue()
+	{
+		delete[] fTasks;
+	}
+
+	bool IsEmpty() const
+	{
+		return fCount == 0;
+	}
+
+	void PushBack(Task& task)
+	{
+		if (fCount == fCapacity)
+			Grow();
+		At(fCount).TakeOver(task);
+		fCount++;
+	}
+
+	void PopBack(Task* task)
+	{
+		task->TakeOver(At(fCount - 1));
+		fCount--;
+	}
+
+	void PopFront(Task* task)
+	{
+		task->TakeOver(At(0));
+		fHead = (fHead + 1) % fCapacity;
+		fCount--;
+	}
+
+private:
+	Task& At(int32 index)
+	{
+		return fTasks[(fHead + index) % fCapacity];
+	}
+
+	void Grow()
+	{
+		int32 capacity = fCapacity > 0 ? fCapacity * 2 : 16;
+		Task* tasks = new Task[capacity];
+		for (int32 index = 0; index < fCount; index++)
+			tasks[index].TakeOver(At(index));
+
+		delete[] fTasks;
+		fTasks = tasks;
+		fCapacity = capacity;
+		fHead = 0;
+	}
+
+	Task* fTasks;
+	int32 fCapacity;
+	int32 fHead;
+	int32 fCount;
+};
+
+
+struct ThreadPool::Worker {
+	Worker()
+		:	lock("thread pool worker"),
+			thread(-1),
+			priority(-1),
+			pool(NULL)
+	{
+	}
+
+	BLocker lock;
+		// guards tasks, which the worker itself uses from the back and
+		// the others steal from at the front
+	TaskQueue tasks;
+	thread_id thread;
+	int32 priority;
+	ThreadPool* pool;
+};
+
+
+ThreadPool::ThreadPool(int32 workers, const char* name)
+	:	fWorkers(NULL),
+		fWorkerCount(workers),
+		fWorkSem(create_sem(0, "thread pool work")),
+		fNextWorker(0),
+		fQuitting(0)
+{
+	if (fWorkerCount <= 0) {
+		system_info info;
+		get_system_info(&info);
+		fWorkerCount = info.cpu_count > 0 ? (int32)info.cpu_count : 1;
+	}
+
+	fWorkers = new Worker[fWorkerCount];
+	for (int32 index = 0; index < fWorkerCount; index++) {
+		Worker* worker = &fWorkers[index];
+		worker->pool = this;
+		worker->priority = B_NORMAL_PRIORITY;
+		worker->thread = spawn_thread(&ThreadPool::WorkerBinder,
+			name ? name : "pool worker", worker->priority, worker);
+	}
+
+	sPoolsLock.Lock();
+	sPools.push_back(this);
+	sPoolsLock.Unlock();
+
+	// only start once all thread IDs are known, CurrentWorker() needs them
+	for (int32 index = 0; index < fWorkerCount; index++)
+		resume_thread(fWorkers[index].thread);
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	sPoolsLock.Lock();
+	sPools.erase(std::find(sPools.begin(), sPools.end(), this));
+	sPoolsLock.Unlock();
+
+	atomic_set(&fQuitting, 1);
+	release_sem_etc(fWorkSem, fWorkerCount, 0);
+	for (int32 index = 0; index < fWorkerCount; index++) {
+		status_t result;
+		wait_for_thread(fWorkers[index].thread, &result);
+	}
+
+	// a worker that lost a race for the last functors may have quit
+	// before they ran
+	Task task;
+	while (TakeTask(&fWorkers[0], &task))
+		task.Run();
+
+	delete_sem(fWorkSem);
+	delete[] fWorkers;
+}
+
+
+void
+ThreadPool::Submit(FunctionObject* functor, int32 priority)
+{
+	Task task;
+	task.functor = functor;
+	task.priority = priority;
+	Enqueue(task);
+}
+
+
+void
+ThreadPool::Submit(const InlineFunction& function, int32 priority)
+{
+	Task task;
+	task.function = function;
+	task.priority = priority;
+	Enqueue(task);
+}
+
+
+void
+ThreadPool::Submit(InlineFunction&& function, int32 priority)
+{
+	Task task;
+	task.function.TakeOver(function);
+	task.priority = priority;
+	Enqueue(task);
+}
+
+
+int32
+ThreadPool::CountWorkers() const
+{
+	return fWorkerCount;
+}
+
+
+bool
+ThreadPool::RunQueuedTask()
+{
+	Worker* worker = CurrentWorker();
+	if (worker == NULL
+		|| acquire_sem_etc(fWorkSem, 1, B_RELATIVE_TIMEOUT, 0) != B_OK)
+		return false;
+
+	// the count we took stands for a functor, see RunWorker()
+	Task task;
+	while (!TakeTask(worker, &task)) {
+		if (atomic_get(&fQuitting) != 0) {
+			release_sem(fWorkSem);
+			return false;
+		}
+	}
+
+	// the functor we run for has its priority back afterwards
+	int32 priority = worker->priority;
+	if (task.priority != priority)
+		set_thread_priority(worker->thread, task.priority);
+	task.Run();
+	if (task.priority != priority)
+		set_thread_priority(worker->thread, priority);
+	return true;
+}
+
+
+ThreadPool*
+ThreadPool::Default()
+{
+	BAutolock lock(sDefaultPoolLock);
+	if (sDefaultPool == NULL)
+		sDefaultPool = new ThreadPool(0, "default pool worker");
+	return sDefaultPool;
+}
+
+
+ThreadPool*
+ThreadPool::Current()
+{
+	BAutolock lock(sPoolsLock);
+	for (size_t index = 0; index < sPools.size(); index++) {
+		if (sPools[index]->CurrentWorker() != NULL)
+			return sPools[index];
+	}
+	return NULL;
+}
+
+
+status_t
+ThreadPool::WorkerBinder(void* castToWorker)
+{
+	Worker* worker = static_cast<Worker*>(castToWorker);
+	worker->pool->RunWorker(worker);
+	return B_OK;
+}
+
+
 void
-Thread::Launch(FunctionObject* functor, int32 priority, const char* name)
+ThreadPool::RunWorker(Worker* worker)
 {
-	new Thread(functor, priority, name);
+	for (;;) {
+		if (acquire_sem(fWorkSem) != B_OK)
+			return;
+
+		// Every count on the semaphore stands for a queued functor, but
+		// another worker may take the one we were woken for while one
+		// that is queued meanwhile lands in a deque we already looked at
+		Task task;
+		while (!TakeTask(worker, &task)) {
+			if (atomic_get(&fQuitting) != 0)
+				return;
+		}
+
+		if (task.priority != worker->priority) {
+			set_thread_priority(worker->thread, task.priority);
+			worker->priority = task.priority;
+		}
+		task.Run();
+	}
+}
+
+
+void
+ThreadPool::Enqueue(Task& task)
+{
+	// from a worker onto its own deque, from anywhere else round robin
+	Worker* worker = CurrentWorker();
+	if (worker == NULL) {
+		uint32 next = (uint32)atomic_add(&fNextWorker, 1);
+		worker = &fWorkers[next % fWorkerCount];
+	}
+
+	worker->lock.Lock();
+	worker->tasks.PushBack(task);
+	worker->lock.Unlock();
+
+	release_sem(fWorkSem);
+}
+
+
+bool
+ThreadPool::TakeTask(Worker* worker, Task* task)
+{
+	int32 self = worker - fWorkers;
+	for (int32 offset = 0; offset < fWorkerCount; offset++) {
+		Worker* victim = &fWorkers[(self + offset) % fWorkerCount];
+		BAutolock lock(victim->lock);
+		if (victim->tasks.IsEmpty())
+			continue;
+
+		if (victim == worker)
+			victim->tasks.PopBack(task);
+		else
+			victim->tasks.PopFront(task);
+		return true;
+	}
+
+	return false;
+}
+
+
+ThreadPool::Worker*
+ThreadPool::CurrentWorker() const
+{
+	thread_id current = find_thread(NULL);
+	for (int32 index = 0; index < fWorkerCount; index++) {
+		if (fWorkers[index].thread == current)
+			return &fWorkers[index];
+	}
+	return NULL;
+}
+
+
+void
+Thread::Launch(FunctionObject* functor, int32 priority, const char* name,
+	thread_launch_policy policy)
+{
+	if (policy == THREAD_LAUNCH_POOLED)
+		ThreadPool::Default()->Submit(functor, priority);
+	else
+		new Thread(functor, priority, name);
+}
+
+
+void
+Thread::Launch(const InlineFunction& function, int32 priority,
+	const char* name, thread_launch_policy policy)
+{
+	if (policy == THREAD_LAUNCH_POOLED)
+		ThreadPool::Default()->Submit(function, priority);
+	else
+		new Thread(function, priority, name);
+}
+
+
+void
+Thread::Launch(InlineFunction&& function, int32 priority, const char* name,
+	thread_launch_policy policy)
+{
+	if (policy == THREAD_LAUNCH_POOLED)
+		ThreadPool::Default()->Submit(std::move(function), priority);
+	else
+		new Thread(std::move(function), priority, name);
 }
 
 
@@ -87,6 +482,25 @@ Thread::Thread(FunctionObject* functor, int32 priority, const char* name)
 }
 
 
+Thread::Thread(const InlineFunction& function, int32 priority,
+	const char* name)
+	:	SimpleThread(priority, name),
+		fFunctor(NULL),
+		fFunction(function)
+{
+	Go();
+}
+
+
+Thread::Thread(InlineFunction&& function, int32 priority, const char* name)
+	:	SimpleThread(priority, name),
+		fFunctor(NULL)
+{
+	fFunction.TakeOver(function);
+	Go();
+}
+
+
 Thread::~Thread()
 {
 	delete fFunctor;
@@ -96,7 +510,10 @@ Thread::~Thread()
 void
 Thread::Run()
 {
-	(*fFunctor)();
+	if (fFunctor != NULL)
+		(*fFunctor)();
+	else
+		fFunction();
 	delete this;
 		// commit suicide
 }
@@ -114,18 +531,45 @@ ThreadSequence::Launch(BObjectList<FunctionObject>* list, bool async,
 }
 
 
+void
+ThreadSequence::Launch(const InlineFunction* functions, int32 count,
+	bool async, int32 priority)
+{
+	if (!async)
+		Run(functions, count);
+	else
+		new ThreadSequence(functions, count, priority);
+}
+
+
 ThreadSequence::ThreadSequence(BObjectList<FunctionObject>* list,
 	int32 priority)
 	:	SimpleThread(priority),
-		fFunctorList(list)
+		fFunctorList(list),
+		fFunctions(NULL),
+		fFunctionCount(0)
 {
 	Go();
 }
 
 
+ThreadSequence::ThreadSequence(const InlineFunction* functions, int32 count,
+	int32 priority)
+	:	SimpleThread(priority),
+		fFunctorList(NULL),
+		fFunctions(new InlineFunction[count]),
+		fFunctionCount(count)
+{
+	for (int32 index = 0; index < count; index++)
+		fFunctions[index] = functions[index];
+	Go();
+}
+
+
 ThreadSequence::~ThreadSequence()
 {
 	delete fFunctorList;
+	delete[] fFunctions;
 }
 
 
@@ -138,10 +582,302 @@ ThreadSequence::Run(BObjectList<FunctionObject>* list)
 }
 
 
+void
+ThreadSequence::Run(const InlineFunction* functions, int32 count)
+{
+	for (int32 index = 0; index < count; index++)
+		functions[index]();
+}
+
+
 void
 ThreadSequence::Run()
 {
-	Run(fFunctorList);
+	if (fFunctorList != NULL)
+		Run(fFunctorList);
+	else
+		Run(fFunctions, fFunctionCount);
 	delete this;
 		// commit suicide
 }
+
+
+struct ThreadGraph::Node {
+	Node(FunctionObject* functor)
+		:	functor(functor),
+			dependencies(0),
+			waiting(0),
+			runTime(0),
+			pathTime(0),
+			previous(-1)
+	{
+	}
+
+	~Node()
+	{
+		delete functor;
+	}
+
+	FunctionObject* functor;
+	std::vector<int32> dependents;
+	int32 dependencies;
+
+	// the rest is only valid during or after a run
+	int32 waiting;
+	bigtime_t runTime;
+	bigtime_t pathTime;
+		// the longest chain ending here, up to the start of this node
+		// until it ran and including it afterwards
+	int32 previous;
+		// the dependency on that chain
+};
+
+
+struct ThreadGraph::RunState {
+	RunState(ThreadGraph* graph, ThreadPool* pool, int32 priority)
+		:	graph(graph),
+			pool(pool),
+			priority(priority),
+			lock("thread graph run"),
+			remaining(graph->CountTasks()),
+			signal(create_sem(0, "thread graph signal")),
+			references(1)
+	{
+	}
+
+	~RunState()
+	{
+		delete_sem(signal);
+	}
+
+	ThreadGraph* graph;
+	ThreadPool* pool;
+	int32 priority;
+
+	BLocker lock;
+		// guards ready and the run fields of the nodes
+	std::deque<int32> ready;
+	int32 remaining;
+	sem_id signal;
+		// released when a node gets ready and when the last one finished
+	int32 references;
+		// the caller of Run() and every runner submitted to the pool;
+		// runners may still be queued when the graph is gone
+};
+
+
+ThreadGraph::ThreadGraph()
+	:	fNodes(20, true),
+		fCriticalEnd(-1)
+{
+}
+
+
+ThreadGraph::~ThreadGraph()
+{
+}
+
+
+int32
+ThreadGraph::AddTask(FunctionObject* functor)
+{
+	fNodes.AddItem(new Node(functor));
+	return fNodes.CountItems() - 1;
+}
+
+
+status_t
+ThreadGraph::AddDependency(int32 task, int32 dependsOn)
+{
+	if (task < 0 || task >= CountTasks() || dependsOn < 0
+		|| dependsOn >= CountTasks())
+		return B_BAD_INDEX;
+
+	if (task == dependsOn || DependsOn(dependsOn, task))
+		return B_BAD_VALUE;
+
+	fNodes.ItemAt(dependsOn)->dependents.push_back(task);
+	fNodes.ItemAt(task)->dependencies++;
+	return B_OK;
+}
+
+
+int32
+ThreadGraph::CountTasks() const
+{
+	return fNodes.CountItems();
+}
+
+
+void
+ThreadGraph::Run(ThreadPool* pool, int32 priority)
+{
+	int32 count = CountTasks();
+	fCriticalEnd = -1;
+	if (count == 0)
+		return;
+
+	if (pool == NULL)
+		pool = ThreadPool::Default();
+
+	RunState* state = new RunState(this, pool, priority);
+	for (int32 index = 0; index < count; index++) {
+		Node* node = fNodes.ItemAt(index);
+		node->waiting = node->dependencies;
+		node->runTime = 0;
+		node->pathTime = 0;
+		node->previous = -1;
+		if (node->waiting == 0)
+			state->ready.push_back(index);
+	}
+
+	// one runner per ready node at most; the ones that find nothing
+	// left to do just return
+	int32 runners = std::min((int32)state->ready.size(),
+		pool->CountWorkers());
+	atomic_add(&state->references, runners);
+	for (int32 index = 0; index < runners; index++)
+		pool->Submit(InlineFunction(SingleParamFunctionObject<RunState*>(
+			&ThreadGraph::RunReady, state)), priority);
+
+	while (atomic_get(&state->remaining) > 0) {
+		if (!RunOne(state))
+			acquire_sem(state->signal);
+	}
+	ReleaseState(state);
+
+	bigtime_t longest = -1;
+	for (int32 index = 0; index < count; index++) {
+		Node* node = fNodes.ItemAt(index);
+		if (node->pathTime > longest) {
+			longest = node->pathTime;
+			fCriticalEnd = index;
+		}
+	}
+}
+
+
+void
+ThreadGraph::Launch(ThreadGraph* graph, int32 priority)
+{
+	// Run() itself runs the nodes it waits for, so it may block a worker
+	Thread::Launch(InlineFunction(TwoParamFunctionObject<ThreadGraph*, int32>(
+		&ThreadGraph::RunAndDelete, graph, priority)), priority, NULL,
+		THREAD_LAUNCH_POOLED);
+}
+
+
+bigtime_t
+ThreadGraph::CriticalPath(BObjectList<FunctionObject>* path) const
+{
+	if (fCriticalEnd < 0)
+		return 0;
+
+	if (path != NULL) {
+		for (int32 index = fCriticalEnd; index >= 0;
+				index = fNodes.ItemAt(index)->previous)
+			path->AddItem(fNodes.ItemAt(index)->functor, 0);
+	}
+	return fNodes.ItemAt(fCriticalEnd)->pathTime;
+}
+
+
+bool
+ThreadGraph::RunOne(RunState* state)
+{
+	state->lock.Lock();
+	if (state->ready.empty()) {
+		state->lock.Unlock();
+		return false;
+	}
+	int32 index = state->ready.front();
+	state->ready.pop_front();
+	state->lock.Unlock();
+
+	ThreadGraph* graph = state->graph;
+	Node* node = graph->fNodes.ItemAt(index);
+	bigtime_t start = system_time();
+	(*node->functor)();
+	bigtime_t runTime = system_time() - start;
+
+	int32 nowReady = 0;
+	state->lock.Lock();
+	node->runTime = runTime;
+	node->pathTime += runTime;
+	for (size_t i = 0; i < node->dependents.size(); i++) {
+		Node* dependent = graph->fNodes.ItemAt(node->dependents[i]);
+		if (dependent->previous < 0
+			|| node->pathTime > dependent->pathTime) {
+			dependent->pathTime = node->pathTime;
+			dependent->previous = index;
+		}
+		if (--dependent->waiting == 0) {
+			state->ready.push_back(node->dependents[i]);
+			nowReady++;
+		}
+	}
+	state->lock.Unlock();
+
+	// This thread goes on with one of them; the others may run elsewhere.
+	// The graph may be gone as soon as the last node is counted down.
+	ThreadPool* pool = state->pool;
+	if (nowReady > 1) {
+		atomic_add(&state->references, nowReady - 1);
+		for (int32 i = 1; i < nowReady; i++)
+			pool->Submit(InlineFunction(SingleParamFunctionObject<RunState*>(
+				&ThreadGraph::RunReady, state)), state->priority);
+	}
+	if (atomic_add(&state->remaining, -1) == 1)
+		nowReady++;
+	if (nowReady > 0)
+		release_sem_etc(state->signal, nowReady, 0);
+	return true;
+}
+
+
+void
+ThreadGraph::RunReady(RunState* state)
+{
+	while (RunOne(state)) {
+	}
+	ReleaseState(state);
+}
+
+
+void
+ThreadGraph::ReleaseState(RunState* state)
+{
+	if (atomic_add(&state->references, -1) == 1)
+		delete state;
+}
+
+
+void
+ThreadGraph::RunAndDelete(ThreadGraph* graph, int32 priority)
+{
+	graph->Run(NULL, priority);
+	delete graph;
+}
+
+
+bool
+ThreadGraph::DependsOn(int32 task, int32 dependsOn) const
+{
+	// whether task can be reached from dependsOn through its dependents
+	std::vector<bool> seen(CountTasks(), false);
+	std::vector<int32> pending(1, dependsOn);
+	while (!pending.empty()) {
+		int32 index = pending.back();
+		pending.pop_back();
+		if (index == task)
+			return true;
+		if (seen[index])
+			continue;
+
+		seen[index] = true;
+		const std::vector<int32>& dependents
+			= fNodes.ItemAt(index)->dependents;
+		pending.insert(pending.end(), dependents.begin(), dependents.end());
+	}
+	return false;
+}
@@ -35,12 +35,19 @@ All rights reserved.
 #define __THREAD__
 
 
+#include <Autolock.h>
 #include <Debug.h>
+#include <Locker.h>
 #include <Looper.h>
 #include <ObjectList.h>
 #include <OS.h>
+#include <Rect.h>
+#include <String.h>
+
+#include <algorithm>
 
 #include "FunctionObject.h"
+#include "InlineFunction.h"
 
 
 namespace BPrivate {
@@ -105,17 +112,97 @@ protected:
 };
 
 
+enum thread_launch_policy {
+	THREAD_LAUNCH_POOLED = 0,
+		// run on a worker of ThreadPool::Default(); the worker takes on the
+		// priority for the duration of the functor, the name is not used.
+		// Only for functors that don't block: one that waits for another
+		// launched functor, other than through Future::Wait(), may wait
+		// forever once every worker is busy
+	THREAD_LAUNCH_NEW_THREAD
+		// spawn a thread for the functor alone, the default; always makes
+		// progress, whatever the functor waits for
+};
+
+
+class ThreadPool {
+	// A fixed number of worker threads, each with a deque of functors.
+	// A worker runs its own functors newest first and, when it runs out,
+	// steals the oldest ones of the others, so a burst submitted from
+	// outside spreads over all workers and one a functor submits from a
+	// worker stays where its data is likely still cached.
+public:
+	ThreadPool(int32 workers = 0, const char* name = 0);
+		// workers <= 0 gets one per CPU
+	~ThreadPool();
+		// runs what is still queued before it returns; must not be called
+		// from one of the workers
+
+	void Submit(FunctionObject* functor, int32 priority = B_LOW_PRIORITY);
+		// takes over functor and deletes it once it ran
+	void Submit(const InlineFunction& function,
+		int32 priority = B_LOW_PRIORITY);
+		// queues a copy of function; does not allocate once the queue
+		// has grown to the size it needs and function is stored inline
+	void Submit(InlineFunction&& function, int32 priority = B_LOW_PRIORITY);
+		// queues function itself, leaving it empty; never copies it
+	int32 CountWorkers() const;
+
+	bool RunQueuedTask();
+		// from one of the workers: runs a queued functor in place of the
+		// caller and returns true; false if none is queued or the caller
+		// isn't a worker of this pool. Lets a functor that waits for
+		// another one keep the pool going
+
+	static ThreadPool* Default();
+		// one pool for the whole team, created on first use
+	static ThreadPool* Current();
+		// the pool the calling thread is a worker of, or NULL
+
+private:
+	struct Task;
+	class TaskQueue;
+	struct Worker;
+
+	static status_t WorkerBinder(void*);
+	void RunWorker(Worker*);
+	void Enqueue(Task&);
+	bool TakeTask(Worker*, Task*);
+	Worker* CurrentWorker() const;
+
+	Worker* fWorkers;
+	int32 fWorkerCount;
+	sem_id fWorkSem;
+		// counts the queued functors
+	int32 fNextWorker;
+	int32 fQuitting;
+};
+
+
 class Thread : private SimpleThread {
 public:
 	static void Launch(FunctionObject* functor,
-		int32 priority = B_LOW_PRIORITY, const char* name = 0);
+		int32 priority = B_LOW_PRIORITY, const char* name = 0,
+		thread_launch_policy policy = THREAD_LAUNCH_NEW_THREAD);
+	static void Launch(const InlineFunction& function,
+		int32 priority = B_LOW_PRIORITY, const char* name = 0,
+		thread_launch_policy policy = THREAD_LAUNCH_NEW_THREAD);
+	static void Launch(InlineFunction&& function,
+		int32 priority = B_LOW_PRIORITY, const char* name = 0,
+		thread_launch_policy policy = THREAD_LAUNCH_NEW_THREAD);
+		// pooled, a small function is launched without an allocation; a
+		// temporary is taken over rather than copied
 
 private:
 	Thread(FunctionObject*, int32 priority, const char* name);
+	Thread(const InlineFunction&, int32 priority, const char* name);
+	Thread(InlineFunction&&, int32 priority, const char* name);
 	~Thread();
 	virtual void Run();
 
 	FunctionObject* fFunctor;
+	InlineFunction fFunction;
+		// used when fFunctor is NULL
 };
 
 
@@ -123,193 +210,675 @@ class ThreadSequence : private SimpleThread {
 public:
 	static void Launch(BObjectList<FunctionObject>*, bool async = true,
 		int32 priority = B_LOW_PRIORITY);
+	static void Launch(const InlineFunction* functions, int32 count,
+		bool async = true, int32 priority = B_LOW_PRIORITY);
+		// runs copies of the functions if async, the functions themselves
+		// otherwise
 
 private:
 	ThreadSequence(BObjectList<FunctionObject>*, int32 priority);
+	ThreadSequence(const InlineFunction* functions, int32 count,
+		int32 priority);
 	~ThreadSequence();
 
 	virtual void Run();
 	static void Run(BObjectList<FunctionObject>*list);
+	static void Run(const InlineFunction* functions, int32 count);
 
 	BObjectList<FunctionObject>* fFunctorList;
+	InlineFunction* fFunctions;
+	int32 fFunctionCount;
 };
 
 
-// would use SingleParamFunctionObjectWithResult, except mwcc won't handle this
-template <class Param1>
-class SingleParamFunctionObjectWorkaround : public
-	FunctionObjectWithResult<status_t> {
+class ThreadGraph {
+	// Like a ThreadSequence, except that a functor only waits for the ones
+	// it was declared to depend on; everything that is not waiting runs at
+	// the same time on a ThreadPool, so fan-out work is not serialized
+	// behind unrelated steps. Each run records how long every functor took
+	// and which chain of dependencies decided how long the whole graph took.
 public:
-	SingleParamFunctionObjectWorkaround(
-		status_t (*function)(Param1), Param1 param1)
-		:	fFunction(function),
-			fParam1(param1)
-		{
-		}
-
-	virtual void operator()()
-		{ (fFunction)(fParam1); }
-
-	virtual ulong Size() const { return sizeof(*this); }
+	ThreadGraph();
+	~ThreadGraph();
+		// deletes the functors; must not be called while running
+
+	int32 AddTask(FunctionObject* functor);
+		// takes over functor and returns the index that names it
+	status_t AddDependency(int32 task, int32 dependsOn);
+		// task will not start before dependsOn finished; returns
+		// B_BAD_INDEX for an unknown task and B_BAD_VALUE for a dependency
+		// that would close a cycle
+	int32 CountTasks() const;
+
+	void Run(ThreadPool* pool = 0, int32 priority = B_LOW_PRIORITY);
+		// runs every functor once and returns when all of them finished;
+		// the calling thread runs ready functors as well, so this may be
+		// called from a pool worker. The default pool is used if none
+		// is given
+	static void Launch(ThreadGraph*, int32 priority = B_LOW_PRIORITY);
+		// takes over the graph, runs it on the default pool without
+		// waiting for it and deletes it afterwards
+
+	bigtime_t CriticalPath(BObjectList<FunctionObject>* path = 0) const;
+		// after Run(): the time the longest chain of dependent functors
+		// took; path, if given, gets the chain first to last
 
 private:
-	status_t (*fFunction)(Param1);
-	Param1 fParam1;
+	struct Node;
+	struct RunState;
+
+	static bool RunOne(RunState*);
+	static void RunReady(RunState*);
+	static void ReleaseState(RunState*);
+	static void RunAndDelete(ThreadGraph*, int32 priority);
+	bool DependsOn(int32 task, int32 dependsOn) const;
+
+	BObjectList<Node> fNodes;
+	int32 fCriticalEnd;
+		// the last node of the critical path of the last run, or -1
 };
 
 
-template <class T>
-class SimpleMemberFunctionObjectWorkaround : public
-	FunctionObjectWithResult<status_t> {
+// the classes these used to be while mwcc could not handle
+// SingleParamFunctionObjectWithResult
+template<class Param1>
+using SingleParamFunctionObjectWorkaround
+	= BoundFunctionObject<status_t, Param1>;
+
+template<class T>
+using SimpleMemberFunctionObjectWorkaround
+	= BoundMemberFunctionObject<T, status_t>;
+
+template<class Param1, class Param2>
+using TwoParamFunctionObjectWorkaround
+	= BoundFunctionObject<status_t, Param1, Param2>;
+
+template<class Param1, class Param2, class Param3>
+using ThreeParamFunctionObjectWorkaround
+	= BoundFunctionObject<status_t, Param1, Param2, Param3>;
+
+template<class Param1, class Param2, class Param3, class Param4>
+using FourParamFunctionObjectWorkaround
+	= BoundFunctionObject<status_t, Param1, Param2, Param3, Param4>;
+
+
+// These spawn a thread of the given name for the function, unless they
+// are given THREAD_LAUNCH_POOLED, which runs it on ThreadPool::Default()
+// instead. The function and its parameters are bound in an InlineFunction,
+// so pooled launching does not allocate unless they are big; the
+// parameters are moved there when they can be.
+
+template<class... Params, class... Arguments>
+void
+LaunchInNewThread(const char* name, int32 priority,
+	thread_launch_policy policy, status_t (*func)(Params...),
+	Arguments&&... arguments)
+{
+	Thread::Launch(InlineFunction(BoundFunctionObject<status_t, Params...>(
+		func, std::forward<Arguments>(arguments)...)), priority, name,
+		policy);
+}
+
+
+template<class... Params, class... Arguments>
+void
+LaunchInNewThread(const char* name, int32 priority,
+	status_t (*func)(Params...), Arguments&&... arguments)
+{
+	LaunchInNewThread(name, priority, THREAD_LAUNCH_NEW_THREAD, func,
+		std::forward<Arguments>(arguments)...);
+}
+
+
+template<class T>
+void
+LaunchInNewThread(const char* name, int32 priority,
+	thread_launch_policy policy, status_t (T::*function)(), T* onThis)
+{
+	Thread::Launch(InlineFunction(BoundMemberFunctionObject<T, status_t>(
+		function, onThis)), priority, name, policy);
+}
+
+
+template<class T>
+void
+LaunchInNewThread(const char* name, int32 priority, status_t (T::*function)(),
+	T* onThis)
+{
+	LaunchInNewThread(name, priority, THREAD_LAUNCH_NEW_THREAD, function,
+		onThis);
+}
+
+
+// A Promise is the end launched work sets its result on, a Future the end
+// the launcher reads it from: it can wait for the result, with a timeout,
+// poll for it, or have a message sent to a looper once it is there. Both
+// are handles to one shared state and cheap to copy.
+
+// AddFutureResult() puts a result into the message NotifyWhenDone() sends.
+// A Future of a type without an overload here can still be waited for, but
+// calling NotifyWhenDone() on it does not compile; declare an overload for
+// the type next to it to change that.
+
+inline void AddFutureResult(BMessage* message, const char* name, bool value)
+	{ message->AddBool(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, int8 value)
+	{ message->AddInt8(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, uint8 value)
+	{ message->AddUInt8(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, int16 value)
+	{ message->AddInt16(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, uint16 value)
+	{ message->AddUInt16(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, int32 value)
+	{ message->AddInt32(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, uint32 value)
+	{ message->AddUInt32(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, int64 value)
+	{ message->AddInt64(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, uint64 value)
+	{ message->AddUInt64(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, float value)
+	{ message->AddFloat(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, double value)
+	{ message->AddDouble(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name,
+	const char* value)
+	{ message->AddString(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name,
+	const BString& value)
+	{ message->AddString(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, BPoint value)
+	{ message->AddPoint(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name, BRect value)
+	{ message->AddRect(name, value); }
+inline void AddFutureResult(BMessage* message, const char* name,
+	const entry_ref& value)
+	{ message->AddRef(name, &value); }
+inline void AddFutureResult(BMessage* message, const char* name,
+	const BMessage& value)
+	{ message->AddMessage(name, &value); }
+
+
+const bigtime_t kFutureHelpInterval = 1000;
+	// how long a waiting worker blocks before it looks for queued
+	// functors again
+
+
+template<class R>
+class FutureState {
+	// what a Promise and its Futures share
 public:
-	SimpleMemberFunctionObjectWorkaround(status_t (T::*function)(), T* onThis)
-		:	fFunction(function),
-			fOnThis(onThis)
-		{
-		}
+	FutureState();
 
-	virtual void operator()()
-		{ (fOnThis->*fFunction)(); }
+	void Acquire();
+	void Release();
+		// deletes the state along with the last reference
 
-	virtual ulong Size() const { return sizeof(*this); }
+	bool SetResult(const R& result);
+	bool IsReady();
+	status_t Wait(bigtime_t timeout);
+	const R& Result() const;
+	void NotifyWhenDone(const BMessenger& target, const BMessage& message,
+		const char* resultField);
 
 private:
-	status_t (T::*fFunction)();
-	T fOnThis;
+	typedef void (*add_result_func)(BMessage*, const char*, const R&);
+
+	struct Notification {
+		BMessenger target;
+		BMessage message;
+		BString resultField;
+		add_result_func addResult;
+			// only NotifyWhenDone() needs an AddFutureResult() for R
+	};
+
+	~FutureState();
+	void Deliver(Notification*);
+	static void AddResult(BMessage*, const char* name, const R& result);
+
+	int32 fReferences;
+	BLocker fLock;
+		// guards fFinished, fResult before it is set, and fNotifications
+	sem_id fDone;
+		// released once the result is set, and again by every waiter
+		// that got it, so that all of them wake up
+	bool fFinished;
+	R fResult;
+	BObjectList<Notification> fNotifications;
 };
 
 
-template <class Param1, class Param2>
-class TwoParamFunctionObjectWorkaround : public
-	FunctionObjectWithResult<status_t>  {
+template<class R>
+class Future {
 public:
-	TwoParamFunctionObjectWorkaround(status_t (*callThis)(Param1, Param2),
-		Param1 param1, Param2 param2)
-		:	function(callThis),
-			fParam1(param1),
-			fParam2(param2)
-		{
-		}
+	Future();
+	Future(const Future&);
+	~Future();
+	Future& operator=(const Future&);
+
+	bool IsValid() const;
+		// false for a Future that did not come from a Promise
+	bool IsReady() const;
+	status_t Wait(bigtime_t timeout = B_INFINITE_TIMEOUT) const;
+		// B_OK once the result is there, B_TIMED_OUT if it didn't come
+		// in time. On a pool worker, the pool's queued functors run while
+		// it waits, so that a functor waiting for one it launched can't
+		// leave the pool without a worker to run it; one of them may keep
+		// it a little beyond the timeout
+	const R& Result() const;
+		// only once IsReady() or Wait() said so
+
+	void NotifyWhenDone(const BMessenger& target, const BMessage& message,
+		const char* resultField = "result");
+		// sends a copy of message to target once the result is there, or
+		// right away if it already is, with the result added as
+		// resultField; R needs an AddFutureResult() overload
+
+private:
+	template<class> friend class Promise;
+	Future(FutureState<R>*);
+
+	FutureState<R>* fState;
+};
+
 
-	virtual void operator()()
-		{ (function)(fParam1, fParam2); }
+template<class R>
+class Promise {
+public:
+	Promise();
+	Promise(const Promise&);
+	~Promise();
+	Promise& operator=(const Promise&);
 
-	virtual uint32 Size() const { return sizeof(*this); }
+	bool SetResult(const R& result);
+		// false if a result was set already
+	Future<R> GetFuture() const;
 
 private:
-	status_t (*function)(Param1, Param2);
-	Param1 fParam1;
-	Param2 fParam2;
+	FutureState<R>* fState;
 };
 
 
-template <class Param1, class Param2, class Param3>
-class ThreeParamFunctionObjectWorkaround : public
-	FunctionObjectWithResult<status_t>  {
+template<class R>
+class FutureTask {
+	// runs a functor and hands its result to a promise; takes over the
+	// functor and deletes it once it ran, so it may only run once
 public:
-	ThreeParamFunctionObjectWorkaround(
-		status_t (*callThis)(Param1, Param2, Param3),
-		Param1 param1, Param2 param2, Param3 param3)
-		:	function(callThis),
-			fParam1(param1),
-			fParam2(param2),
-			fParam3(param3)
+	FutureTask(FunctionObjectWithResult<R>* functor, const Promise<R>& promise)
+		:	fFunctor(functor),
+			fPromise(promise)
 		{
 		}
 
-	virtual void operator()()
-		{ (function)(fParam1, fParam2, fParam3); }
-
-	virtual uint32 Size() const { return sizeof(*this); }
+	void operator()()
+		{
+			(*fFunctor)();
+			fPromise.SetResult(fFunctor->Result());
+			delete fFunctor;
+		}
 
 private:
-	status_t (*function)(Param1, Param2, Param3);
-	Param1 fParam1;
-	Param2 fParam2;
-	Param3 fParam3;
+	FunctionObjectWithResult<R>* fFunctor;
+	Promise<R> fPromise;
 };
 
 
-template <class Param1, class Param2, class Param3, class Param4>
-class FourParamFunctionObjectWorkaround : public
-	FunctionObjectWithResult<status_t>  {
+template<class R, class... Params>
+class FutureCall {
+	// the same for a function bound by value, which is not allocated
 public:
-	FourParamFunctionObjectWorkaround(
-		status_t (*callThis)(Param1, Param2, Param3, Param4),
-		Param1 param1, Param2 param2, Param3 param3, Param4 param4)
-		:	function(callThis),
-			fParam1(param1),
-			fParam2(param2),
-			fParam3(param3),
-			fParam4(param4)
+	template<class... Arguments>
+	FutureCall(const Promise<R>& promise, R (*function)(Params...),
+		Arguments&&... arguments)
+		:	fFunction(function, std::forward<Arguments>(arguments)...),
+			fPromise(promise)
 		{
 		}
 
-	virtual void operator()()
-		{ (function)(fParam1, fParam2, fParam3, fParam4); }
-
-	virtual uint32 Size() const { return sizeof(*this); }
+	void operator()()
+		{
+			fFunction();
+			fPromise.SetResult(fFunction.Result());
+		}
 
 private:
-	status_t (*function)(Param1, Param2, Param3, Param4);
-	Param1 fParam1;
-	Param2 fParam2;
-	Param3 fParam3;
-	Param4 fParam4;
+	BoundFunctionObject<R, Params...> fFunction;
+	Promise<R> fPromise;
 };
 
 
-template<class Param1>
+template<class R>
+Future<R>
+LaunchWithFuture(FunctionObjectWithResult<R>* functor,
+	int32 priority = B_LOW_PRIORITY, const char* name = 0,
+	thread_launch_policy policy = THREAD_LAUNCH_POOLED)
+{
+	Promise<R> promise;
+	Thread::Launch(InlineFunction(FutureTask<R>(functor, promise)), priority,
+		name, policy);
+	return promise.GetFuture();
+}
+
+
+template<class R, class... Params, class... Arguments>
+Future<R>
+LaunchWithFuture(const char* name, int32 priority,
+	thread_launch_policy policy, R (*function)(Params...),
+	Arguments&&... arguments)
+{
+	Promise<R> promise;
+	Thread::Launch(InlineFunction(FutureCall<R, Params...>(promise, function,
+		std::forward<Arguments>(arguments)...)), priority, name, policy);
+	return promise.GetFuture();
+}
+
+
+template<class R, class... Params, class... Arguments>
+Future<R>
+LaunchWithFuture(const char* name, int32 priority, R (*function)(Params...),
+	Arguments&&... arguments)
+{
+	return LaunchWithFuture(name, priority, THREAD_LAUNCH_POOLED, function,
+		std::forward<Arguments>(arguments)...);
+}
+
+
+template<class R>
+FutureState<R>::FutureState()
+	:	fReferences(1),
+		fLock("future"),
+		fDone(create_sem(0, "future done")),
+		fFinished(false),
+		fResult(),
+		fNotifications(5, true)
+{
+}
+
+
+template<class R>
+FutureState<R>::~FutureState()
+{
+	delete_sem(fDone);
+}
+
+
+template<class R>
 void
-LaunchInNewThread(const char* name, int32 priority, status_t (*func)(Param1),
-	Param1 p1)
+FutureState<R>::Acquire()
 {
-	Thread::Launch(new SingleParamFunctionObjectWorkaround<Param1>(func, p1),
-		priority, name);
+	atomic_add(&fReferences, 1);
 }
 
 
-template<class T>
+template<class R>
 void
-LaunchInNewThread(const char* name, int32 priority, status_t (T::*function)(),
-	T* onThis)
+FutureState<R>::Release()
 {
-	Thread::Launch(new SimpleMemberFunctionObjectWorkaround<T>(function,
-		onThis), priority, name);
+	if (atomic_add(&fReferences, -1) == 1)
+		delete this;
 }
 
 
-template<class Param1, class Param2>
+template<class R>
+bool
+FutureState<R>::SetResult(const R& result)
+{
+	BObjectList<Notification> pending(5, true);
+	{
+		BAutolock lock(fLock);
+		if (fFinished)
+			return false;
+
+		fResult = result;
+		fFinished = true;
+		while (!fNotifications.IsEmpty())
+			pending.AddItem(fNotifications.RemoveItemAt(0));
+	}
+
+	// fResult doesn't change anymore, no need to lock from here on
+	release_sem(fDone);
+	for (int32 index = 0; index < pending.CountItems(); index++)
+		Deliver(pending.ItemAt(index));
+	return true;
+}
+
+
+template<class R>
+bool
+FutureState<R>::IsReady()
+{
+	BAutolock lock(fLock);
+	return fFinished;
+}
+
+
+template<class R>
+status_t
+FutureState<R>::Wait(bigtime_t timeout)
+{
+	if (IsReady())
+		return B_OK;
+
+	// A worker that just blocked could be the one the result needs. It
+	// runs what is queued instead, and only looks for the result in
+	// between while nothing is.
+	ThreadPool* pool = timeout > 0 ? ThreadPool::Current() : NULL;
+	bigtime_t deadline = timeout == B_INFINITE_TIMEOUT
+		? B_INFINITE_TIMEOUT : system_time() + timeout;
+	for (;;) {
+		while (pool != NULL && !IsReady() && pool->RunQueuedTask())
+			;
+
+		bigtime_t wait = timeout;
+		if (pool != NULL) {
+			wait = kFutureHelpInterval;
+			if (deadline != B_INFINITE_TIMEOUT)
+				wait = std::min(wait, std::max(deadline - system_time(),
+					(bigtime_t)0));
+		}
+
+		status_t result = acquire_sem_etc(fDone, 1, B_RELATIVE_TIMEOUT, wait);
+		if (result == B_OK) {
+			release_sem(fDone);
+			return B_OK;
+		}
+		if (result != B_TIMED_OUT && result != B_WOULD_BLOCK)
+			return result;
+		if (pool == NULL || (deadline != B_INFINITE_TIMEOUT
+				&& system_time() >= deadline))
+			return B_TIMED_OUT;
+	}
+}
+
+
+template<class R>
+const R&
+FutureState<R>::Result() const
+{
+	ASSERT(fFinished);
+	return fResult;
+}
+
+
+template<class R>
 void
-LaunchInNewThread(const char* name, int32 priority,
-	status_t (*func)(Param1, Param2),
-	Param1 p1, Param2 p2)
+FutureState<R>::NotifyWhenDone(const BMessenger& target,
+	const BMessage& message, const char* resultField)
 {
-	Thread::Launch(new
-		TwoParamFunctionObjectWorkaround<Param1, Param2>(func, p1, p2),
-			priority, name);
+	Notification* notification = new Notification;
+	notification->target = target;
+	notification->message = message;
+	notification->resultField = resultField;
+	notification->addResult = &FutureState<R>::AddResult;
+
+	{
+		BAutolock lock(fLock);
+		if (!fFinished) {
+			fNotifications.AddItem(notification);
+			return;
+		}
+	}
+
+	Deliver(notification);
+	delete notification;
 }
 
 
-template<class Param1, class Param2, class Param3>
+template<class R>
 void
-LaunchInNewThread(const char* name, int32 priority,
-	status_t (*func)(Param1, Param2, Param3),
-	Param1 p1, Param2 p2, Param3 p3)
+FutureState<R>::Deliver(Notification* notification)
 {
-	Thread::Launch(new ThreeParamFunctionObjectWorkaround<Param1, Param2,
-		Param3>(func, p1, p2, p3), priority, name);
+	notification->addResult(&notification->message,
+		notification->resultField.String(), fResult);
+	notification->target.SendMessage(&notification->message);
 }
 
 
-template<class Param1, class Param2, class Param3, class Param4>
+template<class R>
 void
-LaunchInNewThread(const char* name, int32 priority,
-	status_t (*func)(Param1, Param2, Param3, Param4),
-	Param1 p1, Param2 p2, Param3 p3, Param4 p4)
+FutureState<R>::AddResult(BMessage* message, const char* name,
+	const R& result)
+{
+	AddFutureResult(message, name, result);
+}
+
+
+template<class R>
+Future<R>::Future()
+	:	fState(NULL)
+{
+}
+
+
+template<class R>
+Future<R>::Future(FutureState<R>* state)
+	:	fState(state)
+{
+	fState->Acquire();
+}
+
+
+template<class R>
+Future<R>::Future(const Future& other)
+	:	fState(other.fState)
+{
+	if (fState != NULL)
+		fState->Acquire();
+}
+
+
+template<class R>
+Future<R>::~Future()
+{
+	if (fState != NULL)
+		fState->Release();
+}
+
+
+template<class R>
+Future<R>&
+Future<R>::operator=(const Future& other)
+{
+	if (other.fState != NULL)
+		other.fState->Acquire();
+	if (fState != NULL)
+		fState->Release();
+	fState = other.fState;
+	return *this;
+}
+
+
+template<class R>
+bool
+Future<R>::IsValid() const
+{
+	return fState != NULL;
+}
+
+
+template<class R>
+bool
+Future<R>::IsReady() const
+{
+	return fState != NULL && fState->IsReady();
+}
+
+
+template<class R>
+status_t
+Future<R>::Wait(bigtime_t timeout) const
+{
+	if (fState == NULL)
+		return B_NO_INIT;
+	return fState->Wait(timeout);
+}
+
+
+template<class R>
+const R&
+Future<R>::Result() const
+{
+	return fState->Result();
+}
+
+
+template<class R>
+void
+Future<R>::NotifyWhenDone(const BMessenger& target, const BMessage& message,
+	const char* resultField)
+{
+	if (fState != NULL)
+		fState->NotifyWhenDone(target, message, resultField);
+}
+
+
+template<class R>
+Promise<R>::Promise()
+	:	fState(new FutureState<R>)
+{
+}
+
+
+template<class R>
+Promise<R>::Promise(const Promise& other)
+	:	fState(other.fState)
+{
+	fState->Acquire();
+}
+
+
+template<class R>
+Promise<R>::~Promise()
+{
+	fState->Release();
+}
+
+
+template<class R>
+Promise<R>&
+Promise<R>::operator=(const Promise& other)
+{
+	other.fState->Acquire();
+	fState->Release();
+	fState = other.fState;
+	return *this;
+}
+
+
+template<class R>
+bool
+Promise<R>::SetResult(const R& result)
+{
+	return fState->SetResult(result);
+}
+
+
+template<class R>
+Future<R>
+Promise<R>::GetFuture() const
 {
-	Thread::Launch(new FourParamFunctionObjectWorkaround<Param1, Param2,
-		Param3, Param4>(func, p1, p2, p3, p4), priority, name);
+	return Future<R>(fState);
 }
 
 
@@ -0,0 +1,228 @@
+/*
+	CodecBenchmark.cpp: Compares SpinnerNumberCodec.h with sprintf/sscanf.
+	Released under the MIT license.
+
+	Usage: CodecBenchmark [--full]
+
+	By default every 257th int32 is used, which still spans the whole range;
+	--full runs all 2^32 values. Every formatted string is checked against
+	sprintf() and every parsed value against the original, so a run doubles
+	as a round trip test of the codec.
+*/
+
+#ifndef __STDC_FORMAT_MACROS
+#	define __STDC_FORMAT_MACROS
+#endif
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SpinnerValueTraits.h"
+
+
+static double
+now(void)
+{
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+
+// Keeps the compiler from dropping work whose result is otherwise unused
+static volatile uint32 sSink;
+
+
+struct Result {
+	double	seconds;
+	uint64	count;
+};
+
+
+static void
+report(const char *name, const Result &result, const Result *baseline)
+{
+	double nanoseconds = result.seconds * 1e9 / result.count;
+	printf("  %-22s %8.2f ns/value", name, nanoseconds);
+	if (baseline != NULL && result.seconds > 0)
+		printf("   %5.2fx", baseline->seconds / result.seconds);
+	printf("\n");
+}
+
+
+template<typename Format>
+static Result
+time_format(uint32 stride, Format format)
+{
+	char buffer[SPINNER_TEXT_BUFFER_SIZE];
+	uint32 sum = 0;
+	uint64 count = 0;
+
+	double start = now();
+	uint64 index = 0;
+	for (; index <= UINT32_MAX; index += stride, count++) {
+		int32 value = (int32)(uint32)index;
+		sum += format(value, buffer);
+		sum += buffer[0];
+	}
+
+	Result result = { now() - start, count };
+	sSink = sum;
+	return result;
+}
+
+
+static int32
+format_sprintf(int32 value, char *buffer)
+{
+	return sprintf(buffer, "%" PRId32, value);
+}
+
+
+static int32
+format_codec(int32 value, char *buffer)
+{
+	return SpinnerInt32Traits::Format(value, buffer,
+		SPINNER_TEXT_BUFFER_SIZE);
+}
+
+
+template<typename Parse>
+static Result
+time_parse(uint32 stride, Parse parse)
+{
+	char buffer[SPINNER_TEXT_BUFFER_SIZE];
+	uint32 sum = 0;
+	uint64 count = 0;
+	double elapsed = 0;
+
+	// Formatting happens in blocks outside of the timed region, so only
+	// the parsing is measured
+	enum { kBlock = 4096 };
+	static char texts[kBlock][16];
+
+	uint64 index = 0;
+	while (index <= UINT32_MAX) {
+		int32 filled = 0;
+		for (; filled < kBlock && index <= UINT32_MAX;
+				filled++, index += stride) {
+			SpinnerInt32Traits::Format((int32)(uint32)index, buffer,
+				sizeof(buffer));
+			memcpy(texts[filled], buffer, sizeof(texts[filled]));
+		}
+
+		double start = now();
+		for (int32 i = 0; i < filled; i++)
+			sum += (uint32)parse(texts[i]);
+		elapsed += now() - start;
+		count += filled;
+	}
+
+	Result result = { elapsed, count };
+	sSink = sum;
+	return result;
+}
+
+
+static int32
+parse_sscanf(const char *text)
+{
+	int32 value = 0;
+	sscanf(text, "%" SCNd32, &value);
+	return value;
+}
+
+
+static int32
+parse_strtol(const char *text)
+{
+	return (int32)strtol(text, NULL, 10);
+}
+
+
+static int32
+parse_codec(const char *text)
+{
+	int32 value = 0;
+	SpinnerInt32Traits::Parse(text, &value);
+	return value;
+}
+
+
+static bool
+verify(uint32 stride)
+{
+	char expected[SPINNER_TEXT_BUFFER_SIZE];
+	char buffer[SPINNER_TEXT_BUFFER_SIZE];
+
+	for (uint64 index = 0; index <= UINT32_MAX; index += stride) {
+		int32 value = (int32)(uint32)index;
+		int32 length = sprintf(expected, "%" PRId32, value);
+		if (SpinnerInt32Traits::Format(value, buffer, sizeof(buffer)) != length
+			|| strcmp(buffer, expected) != 0) {
+			fprintf(stderr, "format mismatch for %" PRId32 ": \"%s\"\n", value,
+				buffer);
+			return false;
+		}
+
+		int32 parsed;
+		if (!SpinnerInt32Traits::Parse(buffer, &parsed) || parsed != value) {
+			fprintf(stderr, "parse mismatch for \"%s\"\n", buffer);
+			return false;
+		}
+	}
+
+	// the edges, which a stride can step over
+	static const int32 kEdges[] = { INT32_MIN, INT32_MIN + 1, -1, 0, 1,
+		INT32_MAX - 1, INT32_MAX };
+	for (size_t i = 0; i < sizeof(kEdges) / sizeof(kEdges[0]); i++) {
+		sprintf(expected, "%" PRId32, kEdges[i]);
+		SpinnerInt32Traits::Format(kEdges[i], buffer, sizeof(buffer));
+		int32 parsed;
+		if (strcmp(buffer, expected) != 0
+			|| !SpinnerInt32Traits::Parse(buffer, &parsed)
+			|| parsed != kEdges[i]) {
+			fprintf(stderr, "mismatch at edge %s\n", expected);
+			return false;
+		}
+	}
+
+	// saturation
+	int32 parsed;
+	if (!SpinnerInt32Traits::Parse("99999999999", &parsed)
+		|| parsed != INT32_MAX
+		|| !SpinnerInt32Traits::Parse("-2147483649", &parsed)
+		|| parsed != INT32_MIN) {
+		fprintf(stderr, "out of range input does not saturate\n");
+		return false;
+	}
+	return true;
+}
+
+
+int
+main(int argc, char **argv)
+{
+	uint32 stride = 257;
+	if (argc > 1 && strcmp(argv[1], "--full") == 0)
+		stride = 1;
+
+	if (!verify(stride))
+		return 1;
+
+	printf("int32 values, stride %" PRIu32 "\n\nformat\n", stride);
+	Result sprintfResult = time_format(stride, format_sprintf);
+	report("sprintf", sprintfResult, NULL);
+	report("SpinnerNumberCodec", time_format(stride, format_codec),
+		&sprintfResult);
+
+	printf("\nparse\n");
+	Result sscanfResult = time_parse(stride, parse_sscanf);
+	report("sscanf", sscanfResult, NULL);
+	report("strtol", time_parse(stride, parse_strtol), &sscanfResult);
+	report("SpinnerNumberCodec", time_parse(stride, parse_codec),
+		&sscanfResult);
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*
+	LaunchBenchmark.cpp: Counts the heap allocations a launched job costs.
+	Released under the MIT license.
+
+	Usage: LaunchBenchmark [jobs]
+
+	Launches jobs tiny functions (100000 by default) on the default thread
+	pool in each of the ways Thread.h offers and reports how many times
+	operator new was called, and how long it took, per job. Every way is
+	warmed up first, so that the pool's queues have grown to their size
+	and the block list of InlineFunction is filled. Builds against the
+	stand-ins in headless/.
+*/
+
+#include <OS.h>
+
+#include <algorithm>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "FunctionObject.h"
+#include "InlineFunction.h"
+#include "Thread.h"
+
+
+static int32 sAllocations = 0;
+
+
+void*
+operator new(size_t size)
+{
+	atomic_add(&sAllocations, 1);
+	void *block = malloc(size > 0 ? size : 1);
+	if (block == NULL)
+		throw std::bad_alloc();
+	return block;
+}
+
+
+void
+operator delete(void *block) throw()
+{
+	free(block);
+}
+
+
+void
+operator delete(void *block, size_t) throw()
+{
+	free(block);
+}
+
+
+struct Batch {
+	int32		remaining;
+	sem_id		done;
+};
+
+
+static void
+count_down(Batch *batch)
+{
+	if (atomic_add(&batch->remaining, -1) == 1)
+		release_sem(batch->done);
+}
+
+
+static status_t
+count_down_status(Batch *batch)
+{
+	count_down(batch);
+	return B_OK;
+}
+
+
+// As much state as a job that has more to carry than a few pointers
+struct big_job {
+	Batch	*batch;
+	char	data[120];
+
+	void operator()()
+	{
+		count_down(batch);
+	}
+};
+
+
+static void
+launch_functor(Batch *batch)
+{
+	Thread::Launch(NewFunctionObject(&count_down, batch), B_LOW_PRIORITY, NULL,
+		THREAD_LAUNCH_POOLED);
+}
+
+
+static void
+launch_helper(Batch *batch)
+{
+	LaunchInNewThread("benchmark job", B_LOW_PRIORITY, THREAD_LAUNCH_POOLED,
+		&count_down_status, batch);
+}
+
+
+static void
+launch_inline(Batch *batch)
+{
+	Thread::Launch(InlineFunction(SingleParamFunctionObject<Batch*>(
+		&count_down, batch)), B_LOW_PRIORITY, NULL, THREAD_LAUNCH_POOLED);
+}
+
+
+static void
+launch_big(Batch *batch)
+{
+	big_job job;
+	job.batch = batch;
+	Thread::Launch(InlineFunction(job), B_LOW_PRIORITY, NULL,
+		THREAD_LAUNCH_POOLED);
+}
+
+
+static void
+run(const char *name, void (*launch)(Batch*), int32 jobs)
+{
+	Batch batch = { 0, create_sem(0, "batch done") };
+
+	for (int32 pass = 0; pass < 2; pass++) {
+		// the first pass only warms up
+		int32 count = pass == 0 ? std::min(jobs, (int32)1000) : jobs;
+		batch.remaining = count;
+
+		int32 allocations = atomic_get(&sAllocations);
+		bigtime_t start = system_time();
+		for (int32 i = 0; i < count; i++)
+			launch(&batch);
+		acquire_sem(batch.done);
+		bigtime_t elapsed = system_time() - start;
+		allocations = atomic_get(&sAllocations) - allocations;
+
+		if (pass == 1) {
+			printf("  %-28s %6.2f allocations/job %8.3f us/job\n", name,
+				(double)allocations / count, (double)elapsed / count);
+		}
+	}
+
+	delete_sem(batch.done);
+}
+
+
+int
+main(int argc, char **argv)
+{
+	int32 jobs = 100000;
+	if (argc > 1)
+		jobs = std::max(atoi(argv[1]), 1);
+
+	printf("%ld jobs on %ld pool workers, %d bytes stored inline\n\n",
+		(long)jobs, (long)ThreadPool::Default()->CountWorkers(),
+		(int)InlineFunction::kInlineSize);
+	run("NewFunctionObject", &launch_functor, jobs);
+	run("LaunchInNewThread", &launch_helper, jobs);
+	run("InlineFunction", &launch_inline, jobs);
+	run("InlineFunction, 128 bytes", &launch_big, jobs);
+	return 0;
+}
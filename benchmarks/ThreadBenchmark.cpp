@@ -0,0 +1,112 @@
+/*
+	ThreadBenchmark.cpp: Compares ThreadPool with a thread per functor.
+	Released under the MIT license.
+
+	Usage: ThreadBenchmark [tasks]
+
+	Throughput launches tasks tiny functors (20000 by default) and waits
+	for the last of them; a tenth as many are used for a thread per
+	functor, which is plenty to see the difference. Latency launches one
+	functor at a time and measures from Thread::Launch() to the functor
+	starting to run. Builds against the stand-ins in headless/.
+*/
+
+#include <OS.h>
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "FunctionObject.h"
+#include "Thread.h"
+
+
+struct Batch {
+	int32		remaining;
+	sem_id		done;
+};
+
+
+static void
+count_down(Batch *batch)
+{
+	if (atomic_add(&batch->remaining, -1) == 1)
+		release_sem(batch->done);
+}
+
+
+struct Probe {
+	bigtime_t	started;
+	sem_id		done;
+};
+
+
+static void
+record_start(Probe *probe)
+{
+	probe->started = system_time();
+	release_sem(probe->done);
+}
+
+
+static void
+throughput(const char *name, thread_launch_policy policy, int32 tasks)
+{
+	Batch batch = { tasks, create_sem(0, "batch done") };
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < tasks; i++) {
+		Thread::Launch(NewFunctionObject(&count_down, &batch), B_LOW_PRIORITY,
+			"benchmark task", policy);
+	}
+	acquire_sem(batch.done);
+	bigtime_t elapsed = system_time() - start;
+
+	delete_sem(batch.done);
+	printf("  %-16s %7ld tasks %9.0f tasks/s %8.2f us/task\n", name,
+		(long)tasks, tasks * 1e6 / std::max(elapsed, (bigtime_t)1),
+		(double)elapsed / tasks);
+}
+
+
+static void
+latency(const char *name, thread_launch_policy policy, int32 tasks)
+{
+	Probe probe = { 0, create_sem(0, "probe done") };
+	std::vector<bigtime_t> samples;
+	samples.reserve(tasks);
+
+	for (int32 i = 0; i < tasks; i++) {
+		bigtime_t launched = system_time();
+		Thread::Launch(NewFunctionObject(&record_start, &probe),
+			B_LOW_PRIORITY, "benchmark probe", policy);
+		acquire_sem(probe.done);
+		samples.push_back(probe.started - launched);
+	}
+
+	delete_sem(probe.done);
+	std::sort(samples.begin(), samples.end());
+	printf("  %-16s %7ld tasks   median %6lld us   p99 %6lld us\n", name,
+		(long)tasks, (long long)samples[samples.size() / 2],
+		(long long)samples[samples.size() * 99 / 100]);
+}
+
+
+int
+main(int argc, char **argv)
+{
+	int32 tasks = 20000;
+	if (argc > 1)
+		tasks = std::max(atoi(argv[1]), 10);
+
+	printf("%ld pool workers\n\nthroughput\n",
+		(long)ThreadPool::Default()->CountWorkers());
+	throughput("pool", THREAD_LAUNCH_POOLED, tasks);
+	throughput("thread per task", THREAD_LAUNCH_NEW_THREAD, tasks / 10);
+
+	printf("\nlatency\n");
+	latency("pool", THREAD_LAUNCH_POOLED, tasks / 10);
+	latency("thread per task", THREAD_LAUNCH_NEW_THREAD, tasks / 10);
+	return 0;
+}
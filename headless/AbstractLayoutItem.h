@@ -0,0 +1,40 @@
+/*
+	AbstractLayoutItem.h: Headless stand-in for BAbstractLayoutItem.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_ABSTRACT_LAYOUT_ITEM_H_
+#define HEADLESS_ABSTRACT_LAYOUT_ITEM_H_
+
+#include <LayoutItem.h>
+
+class BAbstractLayoutItem : public BLayoutItem {
+public:
+							BAbstractLayoutItem();
+							BAbstractLayoutItem(BMessage *from);
+	virtual					~BAbstractLayoutItem();
+
+	virtual	BSize			MinSize();
+	virtual	BSize			MaxSize();
+	virtual	BSize			PreferredSize();
+	virtual	BAlignment		Alignment();
+
+	virtual	void			SetExplicitMinSize(BSize size);
+	virtual	void			SetExplicitMaxSize(BSize size);
+	virtual	void			SetExplicitPreferredSize(BSize size);
+	virtual	void			SetExplicitAlignment(BAlignment alignment);
+
+	virtual	BSize			BaseMinSize();
+	virtual	BSize			BaseMaxSize();
+	virtual	BSize			BasePreferredSize();
+	virtual	BAlignment		BaseAlignment();
+
+	virtual	status_t		Archive(BMessage *into, bool deep = true) const;
+
+private:
+			BSize			fMinSize;
+			BSize			fMaxSize;
+			BSize			fPreferredSize;
+			BAlignment		fAlignment;
+};
+
+#endif
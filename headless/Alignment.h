@@ -0,0 +1,22 @@
+/*
+	Alignment.h: Headless stand-in for BAlignment.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_ALIGNMENT_H_
+#define HEADLESS_ALIGNMENT_H_
+
+#include <InterfaceDefs.h>
+
+class BAlignment {
+public:
+	alignment			horizontal;
+	vertical_alignment	vertical;
+
+	BAlignment()
+		: horizontal(B_ALIGN_HORIZONTAL_UNSET),
+		  vertical(B_ALIGN_VERTICAL_UNSET) {}
+	BAlignment(alignment horizontal, vertical_alignment vertical)
+		: horizontal(horizontal), vertical(vertical) {}
+};
+
+#endif
@@ -0,0 +1,43 @@
+/*
+	AppDefs.h: Headless stand-in for the Haiku application kit constants.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_APP_DEFS_H_
+#define HEADLESS_APP_DEFS_H_
+
+enum {
+	B_COLORS_UPDATED			= '_CLU',
+	B_FONTS_UPDATED				= '_FNU',
+	B_KEY_DOWN					= '_KYD',
+	B_KEY_UP					= '_KYU',
+	B_MODIFIERS_CHANGED			= '_MCH',
+	B_MOUSE_DOWN				= '_MDN',
+	B_MOUSE_MOVED				= '_MMV',
+	B_MOUSE_UP					= '_MUP',
+	B_MOUSE_WHEEL_CHANGED		= '_MWC',
+	B_PULSE						= '_PUL',
+	B_QUIT_REQUESTED			= '_QRQ',
+	B_VIEW_MOVED				= '_VMV',
+	B_VIEW_RESIZED				= '_VRS',
+	B_WINDOW_ACTIVATED			= '_ACT'
+};
+
+enum {
+	B_SET_PROPERTY				= 'PSET',
+	B_GET_PROPERTY				= 'PGET',
+	B_CREATE_PROPERTY			= 'PCRT',
+	B_DELETE_PROPERTY			= 'PDEL',
+	B_COUNT_PROPERTIES			= 'PCNT',
+	B_EXECUTE_PROPERTY			= 'PEXE',
+	B_GET_SUPPORTED_SUITES		= 'SUIT',
+	B_CUT						= 'CCUT',
+	B_COPY						= 'COPY',
+	B_PASTE						= 'PSTE',
+	B_SELECT_ALL				= 'SALL',
+	B_MESSAGE_NOT_UNDERSTOOD	= 'MNOT',
+	B_NO_REPLY					= 'NONE',
+	B_REPLY						= 'RPLY',
+	B_SIMPLE_DATA				= 'DATA'
+};
+
+#endif
@@ -0,0 +1,37 @@
+/*
+	Archivable.h: Headless stand-in for BArchivable and BArchiver.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_ARCHIVABLE_H_
+#define HEADLESS_ARCHIVABLE_H_
+
+#include <SupportDefs.h>
+
+class BMessage;
+
+class BArchivable {
+public:
+							BArchivable();
+							BArchivable(BMessage *from);
+	virtual					~BArchivable();
+
+	virtual	status_t		Archive(BMessage *into, bool deep = true) const;
+	static	BArchivable*	Instantiate(BMessage *archive);
+};
+
+class BArchiver {
+public:
+							BArchiver(BMessage *archive);
+							~BArchiver();
+
+			status_t		Finish(status_t err = B_OK);
+			BMessage*		ArchiveMessage() const { return fArchive; }
+
+private:
+			BMessage*		fArchive;
+			bool			fFinished;
+};
+
+bool validate_instantiation(BMessage *from, const char *className);
+
+#endif
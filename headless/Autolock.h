@@ -0,0 +1,61 @@
+/*
+	Autolock.h: Headless stand-in for BAutolock.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_AUTOLOCK_H_
+#define HEADLESS_AUTOLOCK_H_
+
+#include <Locker.h>
+#include <Looper.h>
+
+class BAutolock {
+public:
+	BAutolock(BLocker *locker)
+		:
+		fLocker(locker),
+		fLooper(NULL),
+		fIsLocked(locker->Lock())
+	{
+	}
+
+	BAutolock(BLocker &locker)
+		:
+		fLocker(&locker),
+		fLooper(NULL),
+		fIsLocked(locker.Lock())
+	{
+	}
+
+	BAutolock(BLooper *looper)
+		:
+		fLocker(NULL),
+		fLooper(looper),
+		fIsLocked(looper != NULL && looper->Lock())
+	{
+	}
+
+	~BAutolock()
+	{
+		Unlock();
+	}
+
+	bool IsLocked() const { return fIsLocked; }
+
+	void Unlock()
+	{
+		if (!fIsLocked)
+			return;
+		fIsLocked = false;
+		if (fLooper != NULL)
+			fLooper->Unlock();
+		else
+			fLocker->Unlock();
+	}
+
+private:
+	BLocker*	fLocker;
+	BLooper*	fLooper;
+	bool		fIsLocked;
+};
+
+#endif
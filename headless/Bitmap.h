@@ -0,0 +1,65 @@
+/*
+	Bitmap.h: Headless stand-in for BBitmap.
+
+	Pixels are not kept; views added to a bitmap record their drawing like
+	any other view, so that offscreen rendering can be counted.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_BITMAP_H_
+#define HEADLESS_BITMAP_H_
+
+#include <Archivable.h>
+#include <GraphicsDefs.h>
+#include <Rect.h>
+
+#include <vector>
+
+class BView;
+
+enum {
+	B_BITMAP_CLEAR_TO_WHITE				= 0x00000001,
+	B_BITMAP_ACCEPTS_VIEWS				= 0x00000002,
+	B_BITMAP_IS_AREA					= 0x00000004,
+	B_BITMAP_IS_LOCKED					= 0x00000008 | B_BITMAP_IS_AREA,
+	B_BITMAP_IS_CONTIGUOUS				= 0x00000010 | B_BITMAP_IS_LOCKED,
+	B_BITMAP_IS_OFFSCREEN				= 0x00000020,
+	B_BITMAP_WILL_OVERLAY				= 0x00000040 | B_BITMAP_IS_OFFSCREEN,
+	B_BITMAP_RESERVE_OVERLAY_CHANNEL	= 0x00000080,
+	B_BITMAP_NO_SERVER_LINK				= 0x00000100
+};
+
+class BBitmap : public BArchivable {
+public:
+							BBitmap(BRect bounds, uint32 flags,
+								color_space colorSpace,
+								int32 bytesPerRow = -1);
+							BBitmap(BRect bounds, color_space colorSpace,
+								bool acceptsViews = false,
+								bool needsContiguous = false);
+	virtual					~BBitmap();
+
+			status_t		InitCheck() const { return B_OK; }
+			bool			IsValid() const { return true; }
+
+			BRect			Bounds() const { return fBounds; }
+			color_space		ColorSpace() const { return fColorSpace; }
+			uint32			Flags() const { return fFlags; }
+
+			void			AddChild(BView *view);
+			bool			RemoveChild(BView *view);
+			int32			CountChildren() const
+								{ return (int32)fChildren.size(); }
+			BView*			ChildAt(int32 index) const;
+
+			bool			Lock() { return true; }
+			void			Unlock() {}
+			bool			IsLocked() const { return true; }
+
+private:
+			BRect			fBounds;
+			uint32			fFlags;
+			color_space		fColorSpace;
+			std::vector<BView*> fChildren;
+};
+
+#endif
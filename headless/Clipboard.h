@@ -0,0 +1,34 @@
+/*
+	Clipboard.h: Headless stand-in for BClipboard.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_CLIPBOARD_H_
+#define HEADLESS_CLIPBOARD_H_
+
+#include <Locker.h>
+#include <Message.h>
+
+class BClipboard {
+public:
+							BClipboard(const char *name);
+	virtual					~BClipboard();
+
+			const char*		Name() const { return "system"; }
+
+			bool			Lock();
+			void			Unlock();
+			bool			IsLocked() const;
+
+			status_t		Clear();
+			status_t		Commit();
+			status_t		Revert();
+			BMessage*		Data() const { return fData; }
+
+private:
+			BLocker			fLock;
+			BMessage*		fData;
+};
+
+extern BClipboard *be_clipboard;
+
+#endif
@@ -0,0 +1,379 @@
+/*
+	Control.cpp: Headless BInvoker and BControl.
+	Released under the MIT license.
+*/
+#include <Control.h>
+
+#include <AppDefs.h>
+#include <PropertyInfo.h>
+#include <Window.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static property_info sControlProperties[] = {
+	{ "Enabled", { B_GET_PROPERTY, B_SET_PROPERTY, 0 },
+		{ B_DIRECT_SPECIFIER, 0 }, NULL, 0, { B_BOOL_TYPE } },
+	{ "Label", { B_GET_PROPERTY, B_SET_PROPERTY, 0 },
+		{ B_DIRECT_SPECIFIER, 0 }, NULL, 0, { B_STRING_TYPE } },
+	{ "Value", { B_GET_PROPERTY, B_SET_PROPERTY, 0 },
+		{ B_DIRECT_SPECIFIER, 0 }, NULL, 0, { B_INT32_TYPE } },
+	{ 0 }
+};
+
+
+BInvoker::BInvoker()
+	:
+	fMessage(NULL)
+{
+}
+
+
+BInvoker::BInvoker(BMessage *message, const BHandler *handler,
+	const BLooper *looper)
+	:
+	fMessage(message),
+	fMessenger(handler, looper)
+{
+}
+
+
+BInvoker::BInvoker(BMessage *message, BMessenger target)
+	:
+	fMessage(message),
+	fMessenger(target)
+{
+}
+
+
+BInvoker::~BInvoker()
+{
+	delete fMessage;
+}
+
+
+status_t
+BInvoker::SetMessage(BMessage *message)
+{
+	if (message == fMessage)
+		return B_OK;
+
+	delete fMessage;
+	fMessage = message;
+	return B_OK;
+}
+
+
+uint32
+BInvoker::Command() const
+{
+	return fMessage != NULL ? fMessage->what : 0;
+}
+
+
+status_t
+BInvoker::SetTarget(const BHandler *handler, const BLooper *looper)
+{
+	fMessenger = BMessenger();
+	if (handler == NULL && looper == NULL)
+		return B_OK;
+
+	status_t status;
+	fMessenger = BMessenger(handler, looper, &status);
+	return status;
+}
+
+
+status_t
+BInvoker::SetTarget(BMessenger messenger)
+{
+	fMessenger = messenger;
+	return B_OK;
+}
+
+
+BHandler*
+BInvoker::Target(BLooper **looper) const
+{
+	return fMessenger.Target(looper);
+}
+
+
+status_t
+BInvoker::Invoke(BMessage *message)
+{
+	if (message == NULL)
+		message = fMessage;
+	if (message == NULL)
+		return B_BAD_VALUE;
+
+	return fMessenger.SendMessage(message);
+}
+
+
+status_t
+BInvoker::InvokeNotify(BMessage *message, uint32 kind)
+{
+	return Invoke(message);
+}
+
+
+//	#pragma mark - BControl
+
+
+BControl::BControl(BRect frame, const char *name, const char *label,
+	BMessage *message, uint32 resizingMode, uint32 flags)
+	:
+	BView(frame, name, resizingMode, flags),
+	BInvoker(message, NULL, NULL)
+{
+	_InitData();
+	SetLabel(label);
+}
+
+
+BControl::BControl(const char *name, const char *label, BMessage *message,
+	uint32 flags)
+	:
+	BView(name, flags),
+	BInvoker(message, NULL, NULL)
+{
+	_InitData();
+	SetLabel(label);
+}
+
+
+BControl::BControl(BMessage *data)
+	:
+	BView(data),
+	BInvoker()
+{
+	_InitData();
+
+	BMessage message;
+	if (data->FindMessage("_msg", &message) == B_OK)
+		SetMessage(new BMessage(message));
+
+	const char *label;
+	if (data->FindString("_label", &label) == B_OK)
+		SetLabel(label);
+
+	int32 value;
+	if (data->FindInt32("_val", &value) == B_OK)
+		SetValue(value);
+
+	bool disabled;
+	if (data->FindBool("_disable", &disabled) == B_OK)
+		SetEnabled(!disabled);
+}
+
+
+BControl::~BControl()
+{
+	free(fLabel);
+}
+
+
+BArchivable*
+BControl::Instantiate(BMessage *data)
+{
+	if (!validate_instantiation(data, "BControl"))
+		return NULL;
+	return new BControl(data);
+}
+
+
+status_t
+BControl::Archive(BMessage *data, bool deep) const
+{
+	status_t status = BView::Archive(data, deep);
+	if (status == B_OK && Message() != NULL)
+		status = data->AddMessage("_msg", Message());
+	if (status == B_OK && fLabel != NULL)
+		status = data->AddString("_label", fLabel);
+	if (status == B_OK && fValue != B_CONTROL_OFF)
+		status = data->AddInt32("_val", fValue);
+	if (status == B_OK && !fEnabled)
+		status = data->AddBool("_disable", true);
+	return status;
+}
+
+
+void
+BControl::AttachedToWindow()
+{
+	// controls without a target talk to their window
+	if (!Messenger().IsValid())
+		SetTarget(Window());
+	BView::AttachedToWindow();
+}
+
+
+void
+BControl::MessageReceived(BMessage *message)
+{
+	if (message->what != B_GET_PROPERTY && message->what != B_SET_PROPERTY) {
+		BView::MessageReceived(message);
+		return;
+	}
+
+	int32 index;
+	BMessage specifier;
+	int32 form;
+	const char *property;
+	if (message->GetCurrentSpecifier(&index, &specifier, &form, &property)
+			!= B_OK || form != B_DIRECT_SPECIFIER) {
+		BView::MessageReceived(message);
+		return;
+	}
+
+	BMessage reply(B_REPLY);
+	status_t status = B_BAD_SCRIPT_SYNTAX;
+	bool get = message->what == B_GET_PROPERTY;
+
+	if (strcmp(property, "Label") == 0) {
+		const char *label;
+		if (get)
+			status = reply.AddString("result", fLabel != NULL ? fLabel : "");
+		else if ((status = message->FindString("data", &label)) == B_OK)
+			SetLabel(label);
+	} else if (strcmp(property, "Value") == 0) {
+		int32 value;
+		if (get)
+			status = reply.AddInt32("result", fValue);
+		else if ((status = message->FindInt32("data", &value)) == B_OK)
+			SetValue(value);
+	} else if (strcmp(property, "Enabled") == 0) {
+		bool enabled;
+		if (get)
+			status = reply.AddBool("result", fEnabled);
+		else if ((status = message->FindBool("data", &enabled)) == B_OK)
+			SetEnabled(enabled);
+	} else {
+		BView::MessageReceived(message);
+		return;
+	}
+
+	reply.AddInt32("error", status);
+	message->SendReply(&reply);
+}
+
+
+void
+BControl::MakeFocus(bool focus)
+{
+	if (focus == IsFocus())
+		return;
+
+	BView::MakeFocus(focus);
+	Invalidate();
+}
+
+
+void
+BControl::KeyDown(const char *bytes, int32 numBytes)
+{
+	if (numBytes == 1 && (bytes[0] == B_SPACE || bytes[0] == B_ENTER)) {
+		SetValue(Value() == B_CONTROL_OFF ? B_CONTROL_ON : B_CONTROL_OFF);
+		Invoke();
+		return;
+	}
+
+	BView::KeyDown(bytes, numBytes);
+}
+
+
+void
+BControl::SetLabel(const char *string)
+{
+	if (string != NULL && string[0] == '\0')
+		string = NULL;
+	if (string == fLabel
+		|| (string != NULL && fLabel != NULL && strcmp(string, fLabel) == 0))
+		return;
+
+	free(fLabel);
+	fLabel = string != NULL ? strdup(string) : NULL;
+	InvalidateLayout();
+	Invalidate();
+}
+
+
+void
+BControl::SetValue(int32 value)
+{
+	if (value == fValue)
+		return;
+
+	fValue = value;
+	Invalidate();
+}
+
+
+void
+BControl::SetEnabled(bool enabled)
+{
+	if (enabled == fEnabled)
+		return;
+
+	fEnabled = enabled;
+	Invalidate();
+}
+
+
+status_t
+BControl::Invoke(BMessage *message)
+{
+	if (message == NULL)
+		message = Message();
+	if (message == NULL)
+		return B_BAD_VALUE;
+
+	BMessage clone(*message);
+	clone.AddInt64("when", system_time());
+	clone.AddPointer("source", this);
+	clone.AddInt32("be:value", fValue);
+	return BInvoker::Invoke(&clone);
+}
+
+
+BHandler*
+BControl::ResolveSpecifier(BMessage *message, int32 index,
+	BMessage *specifier, int32 what, const char *property)
+{
+	BPropertyInfo propertyInfo(sControlProperties);
+	if (propertyInfo.FindMatch(message, index, specifier, what, property)
+			>= 0)
+		return this;
+
+	return BView::ResolveSpecifier(message, index, specifier, what,
+		property);
+}
+
+
+status_t
+BControl::GetSupportedSuites(BMessage *message)
+{
+	if (message == NULL)
+		return B_BAD_VALUE;
+
+	status_t status = message->AddString("suites", "suite/vnd.Be-control");
+	if (status != B_OK)
+		return status;
+
+	BPropertyInfo propertyInfo(sControlProperties);
+	status = message->AddFlat("messages", &propertyInfo);
+	if (status != B_OK)
+		return status;
+	return BView::GetSupportedSuites(message);
+}
+
+
+void
+BControl::_InitData()
+{
+	fLabel = NULL;
+	fValue = B_CONTROL_OFF;
+	fEnabled = true;
+	SetFont(be_plain_font);
+}
@@ -0,0 +1,60 @@
+/*
+	Control.h: Headless stand-in for BControl.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_CONTROL_H_
+#define HEADLESS_CONTROL_H_
+
+#include <Invoker.h>
+#include <Message.h>
+#include <View.h>
+
+enum {
+	B_CONTROL_OFF = 0,
+	B_CONTROL_ON = 1
+};
+
+class BControl : public BView, public BInvoker {
+public:
+							BControl(BRect frame, const char *name,
+								const char *label, BMessage *message,
+								uint32 resizingMode, uint32 flags);
+							BControl(const char *name, const char *label,
+								BMessage *message, uint32 flags);
+							BControl(BMessage *data);
+	virtual					~BControl();
+
+	static	BArchivable*	Instantiate(BMessage *data);
+	virtual	status_t		Archive(BMessage *data, bool deep = true) const;
+
+	virtual	void			AttachedToWindow();
+	virtual	void			MessageReceived(BMessage *message);
+	virtual	void			MakeFocus(bool focus = true);
+	virtual	void			KeyDown(const char *bytes, int32 numBytes);
+
+	virtual	void			SetLabel(const char *string);
+			const char*		Label() const { return fLabel; }
+
+	virtual	void			SetValue(int32 value);
+			void			SetValueNoUpdate(int32 value) { fValue = value; }
+			int32			Value() const { return fValue; }
+
+	virtual	void			SetEnabled(bool enabled);
+			bool			IsEnabled() const { return fEnabled; }
+
+	virtual	status_t		Invoke(BMessage *message = NULL);
+
+	virtual	BHandler*		ResolveSpecifier(BMessage *message, int32 index,
+								BMessage *specifier, int32 what,
+								const char *property);
+	virtual	status_t		GetSupportedSuites(BMessage *message);
+
+private:
+			void			_InitData();
+
+			char*			fLabel;
+			int32			fValue;
+			bool			fEnabled;
+};
+
+#endif
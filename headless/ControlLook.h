@@ -0,0 +1,42 @@
+/*
+	ControlLook.h: Headless stand-in for BControlLook.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_CONTROL_LOOK_H_
+#define HEADLESS_CONTROL_LOOK_H_
+
+#include <View.h>
+
+class BControlLook {
+public:
+	enum {
+		B_LEFT_ARROW = 0,
+		B_RIGHT_ARROW,
+		B_UP_ARROW,
+		B_DOWN_ARROW,
+		B_LEFT_UP_ARROW,
+		B_RIGHT_UP_ARROW,
+		B_RIGHT_DOWN_ARROW,
+		B_LEFT_DOWN_ARROW
+	};
+
+	enum {
+		B_DISABLED		= 1 << 0,
+		B_ACTIVATED		= 1 << 1,
+		B_FOCUSED		= 1 << 2,
+		B_HOVER			= 1 << 3
+	};
+
+							BControlLook();
+	virtual					~BControlLook();
+
+	virtual	void			DrawArrowShape(BView *view, BRect &rect,
+								const BRect &updateRect,
+								const rgb_color &base, uint32 direction,
+								uint32 flags = 0,
+								float tint = B_DARKEN_MAX_TINT);
+};
+
+extern BControlLook *be_control_look;
+
+#endif
@@ -0,0 +1,25 @@
+/*
+	Debug.h: Headless stand-in for the Haiku debugging macros.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_DEBUG_H_
+#define HEADLESS_DEBUG_H_
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEBUGGER(message) \
+	do { fprintf(stderr, "DEBUGGER: %s\n", (message)); abort(); } while (0)
+
+#ifdef DEBUG
+#	define ASSERT(expr)	assert(expr)
+#	define TRESPASS()	DEBUGGER("Should not be here")
+#else
+#	define ASSERT(expr)	(void)0
+#	define TRESPASS()	(void)0
+#endif
+
+#define PRINT(ARGS)		(void)0
+
+#endif
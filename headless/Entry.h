@@ -0,0 +1,61 @@
+/*
+	Entry.h: Headless stand-in for entry_ref and BEntry. Only the value
+	semantics FunctionObject.h relies on are provided.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_ENTRY_H_
+#define HEADLESS_ENTRY_H_
+
+#include <Node.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+struct entry_ref {
+	entry_ref() : device(-1), directory(-1), name(NULL) {}
+	entry_ref(dev_t device, ino_t directory, const char *name)
+		: device(device), directory(directory),
+		  name(name != NULL ? strdup(name) : NULL) {}
+	entry_ref(const entry_ref &other)
+		: device(other.device), directory(other.directory),
+		  name(other.name != NULL ? strdup(other.name) : NULL) {}
+	~entry_ref() { free(name); }
+
+	entry_ref &operator=(const entry_ref &other)
+		{
+			if (this != &other) {
+				free(name);
+				device = other.device;
+				directory = other.directory;
+				name = other.name != NULL ? strdup(other.name) : NULL;
+			}
+			return *this;
+		}
+	bool operator==(const entry_ref &other) const
+		{
+			return device == other.device && directory == other.directory
+				&& (name == other.name || (name != NULL && other.name != NULL
+					&& strcmp(name, other.name) == 0));
+		}
+
+	dev_t	device;
+	ino_t	directory;
+	char	*name;
+};
+
+class BEntry {
+public:
+	BEntry() {}
+	BEntry(const entry_ref *ref) { if (ref != NULL) fRef = *ref; }
+	BEntry(const BEntry &other) : fRef(other.fRef) {}
+
+	BEntry &operator=(const BEntry &other)
+		{ fRef = other.fRef; return *this; }
+
+	status_t GetRef(entry_ref *ref) const { *ref = fRef; return B_OK; }
+
+private:
+	entry_ref	fRef;
+};
+
+#endif
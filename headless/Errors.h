@@ -0,0 +1,44 @@
+/*
+	Errors.h: Headless stand-in for the Haiku error codes.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_ERRORS_H_
+#define HEADLESS_ERRORS_H_
+
+#include <limits.h>
+
+#define B_GENERAL_ERROR_BASE	INT_MIN
+#define B_APP_ERROR_BASE		(B_GENERAL_ERROR_BASE + 0x3000)
+
+enum {
+	B_OK = 0,
+	B_NO_ERROR = 0,
+	B_ERROR = -1,
+
+	B_NO_MEMORY = B_GENERAL_ERROR_BASE,
+	B_IO_ERROR,
+	B_PERMISSION_DENIED,
+	B_BAD_INDEX,
+	B_BAD_TYPE,
+	B_BAD_VALUE,
+	B_MISMATCHED_VALUES,
+	B_NAME_NOT_FOUND,
+	B_NAME_IN_USE,
+	B_TIMED_OUT,
+	B_INTERRUPTED,
+	B_WOULD_BLOCK,
+	B_CANCELED,
+	B_NO_INIT,
+	B_NOT_ALLOWED,
+	B_BUSY,
+
+	B_BAD_SEM_ID = B_GENERAL_ERROR_BASE + 0x1000,
+	B_BAD_THREAD_ID,
+
+	B_BAD_REPLY = B_APP_ERROR_BASE,
+	B_BAD_HANDLER,
+	B_BAD_PORT_ID,
+	B_BAD_SCRIPT_SYNTAX
+};
+
+#endif
@@ -0,0 +1,24 @@
+/*
+	Flattenable.h: Headless stand-in for BFlattenable.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_FLATTENABLE_H_
+#define HEADLESS_FLATTENABLE_H_
+
+#include <SupportDefs.h>
+
+class BFlattenable {
+public:
+	virtual					~BFlattenable() {}
+
+	virtual	bool			IsFixedSize() const = 0;
+	virtual	type_code		TypeCode() const = 0;
+	virtual	ssize_t			FlattenedSize() const = 0;
+	virtual	status_t		Flatten(void *buffer, ssize_t size) const = 0;
+	virtual	bool			AllowsTypeCode(type_code code) const
+								{ return code == TypeCode(); }
+	virtual	status_t		Unflatten(type_code code, const void *buffer,
+								ssize_t size) = 0;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*
+	Font.h: Headless stand-in for BFont.
+
+	Metrics come from a simple proportional model instead of real glyph
+	data. Every StringWidth() call is counted by the recorder, since on a
+	real system each one is a round trip to the app_server.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_FONT_H_
+#define HEADLESS_FONT_H_
+
+#include <SupportDefs.h>
+
+#define B_FONT_FAMILY_LENGTH	63
+#define B_FONT_STYLE_LENGTH		63
+
+typedef char font_family[B_FONT_FAMILY_LENGTH + 1];
+typedef char font_style[B_FONT_STYLE_LENGTH + 1];
+
+enum {
+	B_FONT_FAMILY_AND_STYLE	= 0x00000001,
+	B_FONT_SIZE				= 0x00000002,
+	B_FONT_SHEAR			= 0x00000004,
+	B_FONT_ROTATION			= 0x00000008,
+	B_FONT_SPACING			= 0x00000010,
+	B_FONT_ENCODING			= 0x00000020,
+	B_FONT_FACE				= 0x00000040,
+	B_FONT_FLAGS			= 0x00000080,
+	B_FONT_FALSE_BOLD_WIDTH	= 0x00000100,
+	B_FONT_ALL				= 0x000001FF
+};
+
+enum {
+	B_REGULAR_FACE		= 0x0040,
+	B_BOLD_FACE			= 0x0020,
+	B_ITALIC_FACE		= 0x0001
+};
+
+struct font_height {
+	float	ascent;
+	float	descent;
+	float	leading;
+};
+
+class BFont {
+public:
+							BFont();
+							BFont(const BFont &font);
+							BFont(const BFont *font);
+
+			status_t		SetFamilyAndStyle(const font_family family,
+								const font_style style);
+			void			GetFamilyAndStyle(font_family *family,
+								font_style *style) const;
+			uint32			FamilyAndStyle() const;
+			void			SetSize(float size) { fSize = size; }
+			float			Size() const { return fSize; }
+			void			SetFace(uint16 face) { fFace = face; }
+			uint16			Face() const { return fFace; }
+			void			SetSpacing(uint8 spacing) { fSpacing = spacing; }
+			uint8			Spacing() const { return fSpacing; }
+
+			void			GetHeight(font_height *height) const;
+			float			StringWidth(const char *string) const;
+			float			StringWidth(const char *string,
+								int32 length) const;
+
+			BFont&			operator=(const BFont &font);
+			bool			operator==(const BFont &font) const;
+			bool			operator!=(const BFont &font) const
+								{ return !(*this == font); }
+
+private:
+			font_family		fFamily;
+			font_style		fStyle;
+			float			fSize;
+			uint16			fFace;
+			uint8			fSpacing;
+};
+
+extern const BFont *be_plain_font;
+extern const BFont *be_bold_font;
+extern const BFont *be_fixed_font;
+
+#endif
@@ -0,0 +1,473 @@
+/*
+	Graphics.cpp: Headless fonts, colors, bitmaps, BControlLook and the
+	clipboard.
+	Released under the MIT license.
+*/
+#include <Bitmap.h>
+#include <Clipboard.h>
+#include <ControlLook.h>
+#include <Font.h>
+#include <InterfaceDefs.h>
+#include <ScrollBar.h>
+#include <View.h>
+
+#include "HeadlessRecorder.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+namespace {
+
+// Widths in ems for a proportional sans serif, close enough to the system
+// font for layout code to make the same decisions it makes on Haiku.
+float
+char_width(uchar c)
+{
+	if (c >= '0' && c <= '9')
+		return 0.56f;
+	if (c >= 'A' && c <= 'Z')
+		return c == 'I' ? 0.28f : c == 'M' || c == 'W' ? 0.85f : 0.66f;
+	if (c >= 'a' && c <= 'z')
+		return c == 'i' || c == 'l' || c == 'j' ? 0.23f
+			: c == 'm' || c == 'w' ? 0.82f : 0.52f;
+
+	switch (c) {
+		case ' ':
+			return 0.28f;
+		case '.':
+		case ',':
+		case ':':
+		case ';':
+			return 0.27f;
+		case '-':
+			return 0.33f;
+		case '+':
+		case '=':
+			return 0.58f;
+		default:
+			return 0.5f;
+	}
+}
+
+
+BFont sPlainFont;
+BFont sBoldFont;
+BFont sFixedFont;
+
+
+struct default_fonts {
+	default_fonts()
+	{
+		sBoldFont.SetFamilyAndStyle("Noto Sans", "Bold");
+		sBoldFont.SetFace(B_BOLD_FACE);
+		sFixedFont.SetFamilyAndStyle("Noto Sans Mono", "Regular");
+	}
+} sDefaultFonts;
+
+
+rgb_color sUIColors[B_COLOR_WHICH_COUNT] = {
+	{ 0, 0, 0, 255 },				// B_NO_COLOR
+	{ 216, 216, 216, 255 },			// B_PANEL_BACKGROUND_COLOR
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 229, 255 },				// B_NAVIGATION_BASE_COLOR
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 0, 255 },
+	{ 0, 0, 0, 255 },				// B_PANEL_TEXT_COLOR
+	{ 255, 255, 255, 255 },			// B_DOCUMENT_BACKGROUND_COLOR
+	{ 0, 0, 0, 255 },				// B_DOCUMENT_TEXT_COLOR
+	{ 245, 245, 245, 255 },			// B_CONTROL_BACKGROUND_COLOR
+	{ 0, 0, 0, 255 },				// B_CONTROL_TEXT_COLOR
+	{ 172, 172, 172, 255 },			// B_CONTROL_BORDER_COLOR
+	{ 102, 152, 203, 255 }			// B_CONTROL_HIGHLIGHT_COLOR
+};
+
+scroll_bar_info sScrollBarInfo = { true, true, 1, 15 };
+
+}	// namespace
+
+
+const BFont *be_plain_font = &sPlainFont;
+const BFont *be_bold_font = &sBoldFont;
+const BFont *be_fixed_font = &sFixedFont;
+
+
+//	#pragma mark - BFont
+
+
+BFont::BFont()
+	:
+	fSize(12.0f),
+	fFace(B_REGULAR_FACE),
+	fSpacing(0)
+{
+	strcpy(fFamily, "Noto Sans");
+	strcpy(fStyle, "Regular");
+}
+
+
+BFont::BFont(const BFont &font)
+{
+	*this = font;
+}
+
+
+BFont::BFont(const BFont *font)
+{
+	*this = font != NULL ? *font : BFont();
+}
+
+
+status_t
+BFont::SetFamilyAndStyle(const font_family family, const font_style style)
+{
+	if (family != NULL) {
+		strncpy(fFamily, family, B_FONT_FAMILY_LENGTH);
+		fFamily[B_FONT_FAMILY_LENGTH] = '\0';
+	}
+	if (style != NULL) {
+		strncpy(fStyle, style, B_FONT_STYLE_LENGTH);
+		fStyle[B_FONT_STYLE_LENGTH] = '\0';
+	}
+	return B_OK;
+}
+
+
+void
+BFont::GetFamilyAndStyle(font_family *family, font_style *style) const
+{
+	if (family != NULL)
+		strcpy(*family, fFamily);
+	if (style != NULL)
+		strcpy(*style, fStyle);
+}
+
+
+uint32
+BFont::FamilyAndStyle() const
+{
+	// stands in for the server's family and style IDs
+	uint32 hash = 2166136261u;
+	for (const char *c = fFamily; *c != '\0'; c++)
+		hash = (hash ^ (uchar)*c) * 16777619u;
+	hash = (hash ^ '/') * 16777619u;
+	for (const char *c = fStyle; *c != '\0'; c++)
+		hash = (hash ^ (uchar)*c) * 16777619u;
+	return hash;
+}
+
+
+void
+BFont::GetHeight(font_height *height) const
+{
+	if (height == NULL)
+		return;
+
+	height->ascent = fSize * 0.93f;
+	height->descent = fSize * 0.25f;
+	height->leading = 0.0f;
+}
+
+
+float
+BFont::StringWidth(const char *string) const
+{
+	return StringWidth(string, string != NULL ? strlen(string) : 0);
+}
+
+
+float
+BFont::StringWidth(const char *string, int32 length) const
+{
+	HeadlessRecorder::Record(HEADLESS_STRING_WIDTH);
+	if (string == NULL)
+		return 0.0f;
+
+	bool fixed = strstr(fFamily, "Mono") != NULL;
+	float ems = 0.0f;
+	for (int32 i = 0; i < length && string[i] != '\0'; i++)
+		ems += fixed ? 0.6f : char_width((uchar)string[i]);
+	if ((fFace & B_BOLD_FACE) != 0)
+		ems *= 1.06f;
+	return ems * fSize;
+}
+
+
+BFont&
+BFont::operator=(const BFont &font)
+{
+	memcpy(fFamily, font.fFamily, sizeof(fFamily));
+	memcpy(fStyle, font.fStyle, sizeof(fStyle));
+	fSize = font.fSize;
+	fFace = font.fFace;
+	fSpacing = font.fSpacing;
+	return *this;
+}
+
+
+bool
+BFont::operator==(const BFont &font) const
+{
+	return strcmp(fFamily, font.fFamily) == 0
+		&& strcmp(fStyle, font.fStyle) == 0 && fSize == font.fSize
+		&& fFace == font.fFace && fSpacing == font.fSpacing;
+}
+
+
+//	#pragma mark - colors
+
+
+rgb_color
+ui_color(color_which which)
+{
+	if (which < 0 || which >= B_COLOR_WHICH_COUNT)
+		return sUIColors[B_NO_COLOR];
+	return sUIColors[which];
+}
+
+
+void
+set_ui_color(const color_which &which, const rgb_color &color)
+{
+	if (which > B_NO_COLOR && which < B_COLOR_WHICH_COUNT)
+		sUIColors[which] = color;
+}
+
+
+rgb_color
+tint_color(rgb_color color, float tint)
+{
+	rgb_color result;
+	if (tint < 1.0f) {
+		// lighten towards white
+		float amount = 1.0f - tint;
+		result.red = (uint8)(color.red + (255 - color.red) * amount);
+		result.green = (uint8)(color.green + (255 - color.green) * amount);
+		result.blue = (uint8)(color.blue + (255 - color.blue) * amount);
+	} else {
+		float amount = std::max(0.0f, 2.0f - tint);
+		result.red = (uint8)(color.red * amount);
+		result.green = (uint8)(color.green * amount);
+		result.blue = (uint8)(color.blue * amount);
+	}
+	result.alpha = color.alpha;
+	return result;
+}
+
+
+status_t
+get_scroll_bar_info(scroll_bar_info *info)
+{
+	if (info == NULL)
+		return B_BAD_VALUE;
+
+	*info = sScrollBarInfo;
+	return B_OK;
+}
+
+
+status_t
+set_scroll_bar_info(scroll_bar_info *info)
+{
+	if (info == NULL)
+		return B_BAD_VALUE;
+
+	sScrollBarInfo = *info;
+	return B_OK;
+}
+
+
+//	#pragma mark - BBitmap
+
+
+BBitmap::BBitmap(BRect bounds, uint32 flags, color_space colorSpace,
+	int32 bytesPerRow)
+	:
+	fBounds(bounds),
+	fFlags(flags),
+	fColorSpace(colorSpace)
+{
+}
+
+
+BBitmap::BBitmap(BRect bounds, color_space colorSpace, bool acceptsViews,
+	bool needsContiguous)
+	:
+	fBounds(bounds),
+	fFlags(acceptsViews ? B_BITMAP_ACCEPTS_VIEWS : 0),
+	fColorSpace(colorSpace)
+{
+}
+
+
+BBitmap::~BBitmap()
+{
+	while (!fChildren.empty()) {
+		BView *view = fChildren.back();
+		RemoveChild(view);
+		delete view;
+	}
+}
+
+
+void
+BBitmap::AddChild(BView *view)
+{
+	if (view == NULL || (fFlags & B_BITMAP_ACCEPTS_VIEWS) == 0
+		|| view->fBitmap != NULL || view->Parent() != NULL)
+		return;
+
+	fChildren.push_back(view);
+	view->_SetBitmap(this);
+}
+
+
+bool
+BBitmap::RemoveChild(BView *view)
+{
+	std::vector<BView*>::iterator i = std::find(fChildren.begin(),
+		fChildren.end(), view);
+	if (i == fChildren.end())
+		return false;
+
+	fChildren.erase(i);
+	view->_SetBitmap(NULL);
+	return true;
+}
+
+
+BView*
+BBitmap::ChildAt(int32 index) const
+{
+	if (index < 0 || index >= (int32)fChildren.size())
+		return NULL;
+	return fChildren[index];
+}
+
+
+//	#pragma mark - BControlLook
+
+
+static BControlLook sControlLook;
+BControlLook *be_control_look = &sControlLook;
+
+
+BControlLook::BControlLook()
+{
+}
+
+
+BControlLook::~BControlLook()
+{
+}
+
+
+void
+BControlLook::DrawArrowShape(BView *view, BRect &rect,
+	const BRect &updateRect, const rgb_color &base, uint32 direction,
+	uint32 flags, float tint)
+{
+	if (!rect.IsValid() || !rect.Intersects(updateRect))
+		return;
+
+	BPoint tip;
+	BPoint first;
+	BPoint second;
+	float midX = (rect.left + rect.right) / 2;
+	float midY = (rect.top + rect.bottom) / 2;
+	switch (direction) {
+		case B_LEFT_ARROW:
+			tip.Set(rect.left, midY);
+			first = rect.RightTop();
+			second = rect.RightBottom();
+			break;
+		case B_RIGHT_ARROW:
+			tip.Set(rect.right, midY);
+			first = rect.LeftTop();
+			second = rect.LeftBottom();
+			break;
+		case B_UP_ARROW:
+			tip.Set(midX, rect.top);
+			first = rect.LeftBottom();
+			second = rect.RightBottom();
+			break;
+		default:
+			tip.Set(midX, rect.bottom);
+			first = rect.LeftTop();
+			second = rect.RightTop();
+			break;
+	}
+
+	view->PushState();
+	view->SetHighColor(tint_color(base, tint));
+	view->FillTriangle(first, tip, second);
+	view->PopState();
+}
+
+
+//	#pragma mark - BClipboard
+
+
+static BClipboard sClipboard("system");
+BClipboard *be_clipboard = &sClipboard;
+
+
+BClipboard::BClipboard(const char *name)
+	:
+	fLock("clipboard"),
+	fData(new BMessage)
+{
+}
+
+
+BClipboard::~BClipboard()
+{
+	delete fData;
+}
+
+
+bool
+BClipboard::Lock()
+{
+	return fLock.Lock();
+}
+
+
+void
+BClipboard::Unlock()
+{
+	fLock.Unlock();
+}
+
+
+bool
+BClipboard::IsLocked() const
+{
+	return fLock.IsLocked();
+}
+
+
+status_t
+BClipboard::Clear()
+{
+	fData->MakeEmpty();
+	return B_OK;
+}
+
+
+status_t
+BClipboard::Commit()
+{
+	return B_OK;
+}
+
+
+status_t
+BClipboard::Revert()
+{
+	return B_OK;
+}
@@ -0,0 +1,60 @@
+/*
+	GraphicsDefs.h: Headless stand-in for the Haiku graphics definitions.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_GRAPHICS_DEFS_H_
+#define HEADLESS_GRAPHICS_DEFS_H_
+
+#include <SupportDefs.h>
+
+struct rgb_color {
+	uint8	red;
+	uint8	green;
+	uint8	blue;
+	uint8	alpha;
+
+	rgb_color &set_to(uint8 r, uint8 g, uint8 b, uint8 a = 255)
+		{ red = r; green = g; blue = b; alpha = a; return *this; }
+
+	bool operator==(const rgb_color &other) const
+		{
+			return red == other.red && green == other.green
+				&& blue == other.blue && alpha == other.alpha;
+		}
+	bool operator!=(const rgb_color &other) const
+		{ return !(*this == other); }
+};
+
+inline rgb_color
+make_color(uint8 red, uint8 green, uint8 blue, uint8 alpha = 255)
+{
+	rgb_color color = { red, green, blue, alpha };
+	return color;
+}
+
+const rgb_color B_TRANSPARENT_COLOR = { 0x77, 0x74, 0x77, 0x00 };
+#define B_TRANSPARENT_32_BIT B_TRANSPARENT_COLOR
+
+typedef enum {
+	B_NO_COLOR_SPACE	= 0x0000,
+	B_RGB32				= 0x0008,
+	B_RGBA32			= 0x2008,
+	B_CMAP8				= 0x0004,
+	B_GRAY8				= 0x0002
+} color_space;
+
+enum drawing_mode {
+	B_OP_COPY,
+	B_OP_OVER,
+	B_OP_ERASE,
+	B_OP_INVERT,
+	B_OP_ADD,
+	B_OP_SUBTRACT,
+	B_OP_BLEND,
+	B_OP_MIN,
+	B_OP_MAX,
+	B_OP_SELECT,
+	B_OP_ALPHA
+};
+
+#endif
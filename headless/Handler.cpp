@@ -0,0 +1,306 @@
+/*
+	Handler.cpp: Headless BHandler and BMessageFilter.
+	Released under the MIT license.
+*/
+#include <Handler.h>
+
+#include <AppDefs.h>
+#include <Autolock.h>
+#include <List.h>
+#include <Looper.h>
+#include <Message.h>
+#include <MessageFilter.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <set>
+
+namespace {
+
+// Every handler that exists, so that messengers and runners can tell a
+// deleted target from a live one like the real app_server tokens do
+typedef std::set<const BHandler*> handler_set;
+
+BLocker sHandlerLock("handler registry");
+handler_set sHandlers;
+
+
+void
+delete_filters(BList *filters)
+{
+	if (filters == NULL)
+		return;
+
+	for (int32 i = 0; i < filters->CountItems(); i++)
+		delete (BMessageFilter*)filters->ItemAt(i);
+	delete filters;
+}
+
+}	// namespace
+
+
+BHandler::BHandler(const char *name)
+	:
+	fName(name != NULL ? strdup(name) : NULL),
+	fLooper(NULL),
+	fNextHandler(NULL),
+	fFilters(NULL)
+{
+	BAutolock locker(sHandlerLock);
+	sHandlers.insert(this);
+}
+
+
+BHandler::BHandler(BMessage *data)
+	:
+	BArchivable(data),
+	fName(NULL),
+	fLooper(NULL),
+	fNextHandler(NULL),
+	fFilters(NULL)
+{
+	const char *name;
+	if (data != NULL && data->FindString("_name", &name) == B_OK)
+		fName = strdup(name);
+
+	BAutolock locker(sHandlerLock);
+	sHandlers.insert(this);
+}
+
+
+BHandler::~BHandler()
+{
+	{
+		BAutolock locker(sHandlerLock);
+		sHandlers.erase(this);
+	}
+
+	if (fLooper != NULL && fLooper != this)
+		fLooper->RemoveHandler(this);
+
+	delete_filters(fFilters);
+	free(fName);
+}
+
+
+BArchivable*
+BHandler::Instantiate(BMessage *data)
+{
+	if (!validate_instantiation(data, "BHandler"))
+		return NULL;
+	return new BHandler(data);
+}
+
+
+status_t
+BHandler::Archive(BMessage *data, bool deep) const
+{
+	status_t status = BArchivable::Archive(data, deep);
+	if (status == B_OK && fName != NULL)
+		status = data->AddString("_name", fName);
+	return status;
+}
+
+
+void
+BHandler::MessageReceived(BMessage *message)
+{
+	if (message->what == B_GET_SUPPORTED_SUITES) {
+		BMessage reply(B_REPLY);
+		status_t status = GetSupportedSuites(&reply);
+		reply.AddInt32("error", status);
+		message->SendReply(&reply);
+		return;
+	}
+
+	if (fNextHandler != NULL) {
+		fNextHandler->MessageReceived(message);
+		return;
+	}
+
+	// the end of the chain: nobody knew what to do with it
+	if (message->IsSourceWaiting() || message->HasSpecifiers()) {
+		BMessage reply(B_MESSAGE_NOT_UNDERSTOOD);
+		reply.AddInt32("error", B_BAD_SCRIPT_SYNTAX);
+		message->SendReply(&reply);
+	}
+}
+
+
+void
+BHandler::SetName(const char *name)
+{
+	free(fName);
+	fName = name != NULL ? strdup(name) : NULL;
+}
+
+
+const char*
+BHandler::Name() const
+{
+	return fName;
+}
+
+
+void
+BHandler::SetNextHandler(BHandler *handler)
+{
+	if (handler == this)
+		return;
+	fNextHandler = handler;
+}
+
+
+void
+BHandler::AddFilter(BMessageFilter *filter)
+{
+	if (filter == NULL)
+		return;
+
+	if (fFilters == NULL)
+		fFilters = new BList;
+	filter->_SetLooper(fLooper);
+	fFilters->AddItem(filter);
+}
+
+
+bool
+BHandler::RemoveFilter(BMessageFilter *filter)
+{
+	if (fFilters == NULL || !fFilters->RemoveItem(filter))
+		return false;
+
+	filter->_SetLooper(NULL);
+	return true;
+}
+
+
+void
+BHandler::SetFilterList(BList *filters)
+{
+	delete_filters(fFilters);
+	fFilters = filters;
+	for (int32 i = 0; fFilters != NULL && i < fFilters->CountItems(); i++)
+		((BMessageFilter*)fFilters->ItemAt(i))->_SetLooper(fLooper);
+}
+
+
+bool
+BHandler::LockLooper()
+{
+	BLooper *looper = fLooper;
+	if (looper == NULL || !looper->Lock())
+		return false;
+
+	// we might have moved to another looper while waiting
+	if (fLooper != looper) {
+		looper->Unlock();
+		return false;
+	}
+	return true;
+}
+
+
+void
+BHandler::UnlockLooper()
+{
+	if (fLooper != NULL)
+		fLooper->Unlock();
+}
+
+
+BHandler*
+BHandler::ResolveSpecifier(BMessage *message, int32 index,
+	BMessage *specifier, int32 what, const char *property)
+{
+	if (property != NULL && (strcmp(property, "Suites") == 0
+			|| strcmp(property, "Messenger") == 0
+			|| strcmp(property, "InternalName") == 0))
+		return this;
+
+	BMessage reply(B_MESSAGE_NOT_UNDERSTOOD);
+	reply.AddInt32("error", B_BAD_SCRIPT_SYNTAX);
+	reply.AddString("message", "Didn't understand the specifier(s)");
+	message->SendReply(&reply);
+	return NULL;
+}
+
+
+status_t
+BHandler::GetSupportedSuites(BMessage *data)
+{
+	if (data == NULL)
+		return B_BAD_VALUE;
+	return data->AddString("suites", "suite/vnd.Be-handler");
+}
+
+
+bool
+BHandler::IsAlive(const BHandler *handler)
+{
+	BAutolock locker(sHandlerLock);
+	return sHandlers.find(handler) != sHandlers.end();
+}
+
+
+void
+BHandler::_SetLooper(BLooper *looper)
+{
+	fLooper = looper;
+	for (int32 i = 0; fFilters != NULL && i < fFilters->CountItems(); i++)
+		((BMessageFilter*)fFilters->ItemAt(i))->_SetLooper(looper);
+}
+
+
+//	#pragma mark - BMessageFilter
+
+
+BMessageFilter::BMessageFilter(uint32 what, filter_hook func)
+	:
+	fWhat(what),
+	fFiltersAny(false),
+	fDelivery(B_ANY_DELIVERY),
+	fSource(B_ANY_SOURCE),
+	fLooper(NULL),
+	fFilterFunction(func)
+{
+}
+
+
+BMessageFilter::BMessageFilter(message_delivery delivery,
+	message_source source, filter_hook func)
+	:
+	fWhat(0),
+	fFiltersAny(true),
+	fDelivery(delivery),
+	fSource(source),
+	fLooper(NULL),
+	fFilterFunction(func)
+{
+}
+
+
+BMessageFilter::BMessageFilter(message_delivery delivery,
+	message_source source, uint32 what, filter_hook func)
+	:
+	fWhat(what),
+	fFiltersAny(false),
+	fDelivery(delivery),
+	fSource(source),
+	fLooper(NULL),
+	fFilterFunction(func)
+{
+}
+
+
+BMessageFilter::~BMessageFilter()
+{
+}
+
+
+filter_result
+BMessageFilter::Filter(BMessage *message, BHandler **_target)
+{
+	return B_DISPATCH_MESSAGE;
+}
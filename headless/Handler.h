@@ -0,0 +1,59 @@
+/*
+	Handler.h: Headless stand-in for BHandler.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_HANDLER_H_
+#define HEADLESS_HANDLER_H_
+
+#include <Archivable.h>
+
+class BList;
+class BLooper;
+class BMessage;
+class BMessageFilter;
+
+class BHandler : public BArchivable {
+public:
+							BHandler(const char *name = NULL);
+							BHandler(BMessage *data);
+	virtual					~BHandler();
+
+	static	BArchivable*	Instantiate(BMessage *data);
+	virtual	status_t		Archive(BMessage *data, bool deep = true) const;
+
+	virtual	void			MessageReceived(BMessage *message);
+
+			BLooper*		Looper() const { return fLooper; }
+			void			SetName(const char *name);
+			const char*		Name() const;
+	virtual	void			SetNextHandler(BHandler *handler);
+			BHandler*		NextHandler() const { return fNextHandler; }
+
+	virtual	void			AddFilter(BMessageFilter *filter);
+	virtual	bool			RemoveFilter(BMessageFilter *filter);
+	virtual	void			SetFilterList(BList *filters);
+			BList*			FilterList() { return fFilters; }
+
+			bool			LockLooper();
+			void			UnlockLooper();
+
+	virtual	BHandler*		ResolveSpecifier(BMessage *message, int32 index,
+								BMessage *specifier, int32 what,
+								const char *property);
+	virtual	status_t		GetSupportedSuites(BMessage *data);
+
+	// headless: true while the handler has not been deleted
+	static	bool			IsAlive(const BHandler *handler);
+
+private:
+	friend class BLooper;
+
+			void			_SetLooper(BLooper *looper);
+
+			char*			fName;
+			BLooper*		fLooper;
+			BHandler*		fNextHandler;
+			BList*			fFilters;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+	HeadlessRecorder.cpp: Counts what headless views draw.
+	Released under the MIT license.
+*/
+#include "HeadlessRecorder.h"
+
+#include <OS.h>
+
+static int64 sCounts[HEADLESS_OP_COUNT];
+
+static const char *sNames[HEADLESS_OP_COUNT] = {
+	"draw hooks",
+	"invalidations",
+	"updates",
+	"strokes",
+	"fills",
+	"strings",
+	"bitmaps",
+	"state changes",
+	"string widths",
+	"offscreen calls"
+};
+
+
+void
+HeadlessRecorder::Record(headless_op op)
+{
+	if (op >= 0 && op < HEADLESS_OP_COUNT)
+		atomic_add64(&sCounts[op], 1);
+}
+
+
+int64
+HeadlessRecorder::Count(headless_op op)
+{
+	if (op < 0 || op >= HEADLESS_OP_COUNT)
+		return 0;
+	return atomic_get64(&sCounts[op]);
+}
+
+
+int64
+HeadlessRecorder::DrawCalls(void)
+{
+	return Count(HEADLESS_STROKE) + Count(HEADLESS_FILL)
+		+ Count(HEADLESS_STRING) + Count(HEADLESS_BITMAP);
+}
+
+
+void
+HeadlessRecorder::Reset(void)
+{
+	for (int32 i = 0; i < HEADLESS_OP_COUNT; i++)
+		atomic_set64(&sCounts[i], 0);
+}
+
+
+const char*
+HeadlessRecorder::Name(headless_op op)
+{
+	if (op < 0 || op >= HEADLESS_OP_COUNT)
+		return "unknown";
+	return sNames[op];
+}
+
+
+void
+HeadlessRecorder::PrintToStream(FILE *file)
+{
+	for (int32 i = 0; i < HEADLESS_OP_COUNT; i++) {
+		fprintf(file, "%16s: %lld\n", sNames[i],
+			(long long)Count((headless_op)i));
+	}
+	fprintf(file, "%16s: %lld\n", "draw calls", (long long)DrawCalls());
+}
@@ -0,0 +1,48 @@
+/*
+	HeadlessRecorder.h: Counts what headless views draw.
+
+	Every drawing call of a BView, every Draw() hook an update runs, every
+	invalidation and every BFont::StringWidth() is counted here, per kind.
+	A test driver resets the counters, feeds a window some input and then
+	reads how much painting and measuring that input caused.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_RECORDER_H_
+#define HEADLESS_RECORDER_H_
+
+#include <SupportDefs.h>
+
+#include <stdio.h>
+
+enum headless_op {
+	HEADLESS_DRAW_HOOK = 0,		// a Draw() call made by a window update
+	HEADLESS_INVALIDATE,		// an Invalidate() of a view in a window
+	HEADLESS_UPDATE,			// a window update that drew anything
+
+	HEADLESS_STROKE,			// lines and rectangle outlines
+	HEADLESS_FILL,				// filled shapes
+	HEADLESS_STRING,			// DrawString()
+	HEADLESS_BITMAP,			// DrawBitmap()
+	HEADLESS_STATE,				// colors, pen, font, push and pop
+
+	HEADLESS_STRING_WIDTH,		// BFont::StringWidth(), a server round trip
+	HEADLESS_OFFSCREEN,			// any drawing call into a BBitmap
+
+	HEADLESS_OP_COUNT
+};
+
+class HeadlessRecorder {
+public:
+	static	void			Record(headless_op op);
+	static	int64			Count(headless_op op);
+
+	// Everything that actually reaches the screen: strokes, fills, strings
+	// and bitmaps drawn by views in a window.
+	static	int64			DrawCalls(void);
+
+	static	void			Reset(void);
+	static	const char*		Name(headless_op op);
+	static	void			PrintToStream(FILE *file = stdout);
+};
+
+#endif
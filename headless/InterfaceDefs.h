@@ -0,0 +1,115 @@
+/*
+	InterfaceDefs.h: Headless stand-in for the Haiku interface definitions.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_INTERFACE_DEFS_H_
+#define HEADLESS_INTERFACE_DEFS_H_
+
+#include <GraphicsDefs.h>
+#include <AppDefs.h>
+
+enum {
+	B_BACKSPACE			= 0x08,
+	B_RETURN			= 0x0a,
+	B_ENTER				= 0x0a,
+	B_SPACE				= 0x20,
+	B_TAB				= 0x09,
+	B_ESCAPE			= 0x1b,
+	B_SUBSTITUTE		= 0x1a,
+
+	B_LEFT_ARROW		= 0x1c,
+	B_RIGHT_ARROW		= 0x1d,
+	B_UP_ARROW			= 0x1e,
+	B_DOWN_ARROW		= 0x1f,
+
+	B_INSERT			= 0x05,
+	B_DELETE			= 0x7f,
+	B_HOME				= 0x01,
+	B_END				= 0x04,
+	B_PAGE_UP			= 0x0b,
+	B_PAGE_DOWN			= 0x0c,
+
+	B_FUNCTION_KEY		= 0x10
+};
+
+enum {
+	B_SHIFT_KEY			= 0x00000001,
+	B_COMMAND_KEY		= 0x00000002,
+	B_CONTROL_KEY		= 0x00000004,
+	B_CAPS_LOCK			= 0x00000008,
+	B_SCROLL_LOCK		= 0x00000010,
+	B_NUM_LOCK			= 0x00000020,
+	B_OPTION_KEY		= 0x00000040,
+	B_MENU_KEY			= 0x00000080
+};
+
+enum {
+	B_PRIMARY_MOUSE_BUTTON		= 0x01,
+	B_SECONDARY_MOUSE_BUTTON	= 0x02,
+	B_TERTIARY_MOUSE_BUTTON		= 0x04
+};
+
+enum alignment {
+	B_ALIGN_LEFT,
+	B_ALIGN_RIGHT,
+	B_ALIGN_CENTER,
+
+	B_ALIGN_HORIZONTAL_CENTER	= B_ALIGN_CENTER,
+
+	B_ALIGN_HORIZONTAL_UNSET	= -1L,
+	B_ALIGN_USE_FULL_WIDTH		= -2L
+};
+
+enum vertical_alignment {
+	B_ALIGN_TOP					= 0x10L,
+	B_ALIGN_MIDDLE				= 0x20,
+	B_ALIGN_BOTTOM				= 0x30,
+
+	B_ALIGN_VERTICAL_CENTER		= B_ALIGN_MIDDLE,
+
+	B_ALIGN_VERTICAL_UNSET		= -1L,
+	B_ALIGN_NO_VERTICAL			= B_ALIGN_VERTICAL_UNSET,
+	B_ALIGN_USE_FULL_HEIGHT		= -2L
+};
+
+enum orientation {
+	B_HORIZONTAL,
+	B_VERTICAL
+};
+
+enum color_which {
+	B_NO_COLOR = 0,
+	B_PANEL_BACKGROUND_COLOR = 1,
+	B_PANEL_TEXT_COLOR = 10,
+	B_DOCUMENT_BACKGROUND_COLOR = 11,
+	B_DOCUMENT_TEXT_COLOR = 12,
+	B_CONTROL_BACKGROUND_COLOR = 13,
+	B_CONTROL_TEXT_COLOR = 14,
+	B_CONTROL_BORDER_COLOR = 15,
+	B_CONTROL_HIGHLIGHT_COLOR = 16,
+	B_NAVIGATION_BASE_COLOR = 4,
+	B_KEYBOARD_NAVIGATION_COLOR = B_NAVIGATION_BASE_COLOR,
+
+	B_COLOR_WHICH_COUNT = 17
+};
+
+const float B_LIGHTEN_MAX_TINT	= 0.0F;
+const float B_LIGHTEN_2_TINT	= 0.385F;
+const float B_LIGHTEN_1_TINT	= 0.590F;
+const float B_NO_TINT			= 1.0F;
+const float B_DARKEN_1_TINT		= 1.147F;
+const float B_DARKEN_2_TINT		= 1.295F;
+const float B_DARKEN_3_TINT		= 1.407F;
+const float B_DARKEN_4_TINT		= 1.555F;
+const float B_DARKEN_MAX_TINT	= 2.0F;
+const float B_DISABLED_LABEL_TINT	= B_DARKEN_3_TINT;
+const float B_HIGHLIGHT_BACKGROUND_TINT	= B_DARKEN_2_TINT;
+const float B_DISABLED_MARK_TINT	= B_LIGHTEN_2_TINT;
+
+rgb_color	ui_color(color_which which);
+void		set_ui_color(const color_which &which, const rgb_color &color);
+rgb_color	tint_color(rgb_color color, float tint);
+
+uint32		modifiers();
+
+#endif
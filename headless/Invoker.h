@@ -0,0 +1,38 @@
+/*
+	Invoker.h: Headless stand-in for BInvoker.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_INVOKER_H_
+#define HEADLESS_INVOKER_H_
+
+#include <Messenger.h>
+
+class BInvoker {
+public:
+							BInvoker();
+							BInvoker(BMessage *message, const BHandler *handler,
+								const BLooper *looper = NULL);
+							BInvoker(BMessage *message, BMessenger target);
+	virtual					~BInvoker();
+
+	virtual	status_t		SetMessage(BMessage *message);
+			BMessage*		Message() const { return fMessage; }
+			uint32			Command() const;
+
+	virtual	status_t		SetTarget(const BHandler *handler,
+								const BLooper *looper = NULL);
+	virtual	status_t		SetTarget(BMessenger messenger);
+			bool			IsTargetLocal() const { return true; }
+			BHandler*		Target(BLooper **looper = NULL) const;
+			BMessenger		Messenger() const { return fMessenger; }
+
+	virtual	status_t		Invoke(BMessage *message = NULL);
+			status_t		InvokeNotify(BMessage *message,
+								uint32 kind = 0);
+
+private:
+			BMessage*		fMessage;
+			BMessenger		fMessenger;
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+	Layout.cpp: Headless layout items and BLayoutUtils.
+	Released under the MIT license.
+*/
+#include <AbstractLayoutItem.h>
+#include <Layout.h>
+#include <LayoutUtils.h>
+#include <View.h>
+
+#include <algorithm>
+
+namespace {
+
+BSize
+compose_size(BSize explicitSize, BSize baseSize)
+{
+	if (explicitSize.width != B_SIZE_UNSET)
+		baseSize.width = explicitSize.width;
+	if (explicitSize.height != B_SIZE_UNSET)
+		baseSize.height = explicitSize.height;
+	return baseSize;
+}
+
+}	// namespace
+
+
+BLayoutItem::BLayoutItem()
+	:
+	fLayout(NULL)
+{
+}
+
+
+BLayoutItem::BLayoutItem(BMessage *from)
+	:
+	BArchivable(from),
+	fLayout(NULL)
+{
+}
+
+
+BLayoutItem::~BLayoutItem()
+{
+}
+
+
+BView*
+BLayoutItem::View()
+{
+	return NULL;
+}
+
+
+//	#pragma mark - BAbstractLayoutItem
+
+
+BAbstractLayoutItem::BAbstractLayoutItem()
+{
+}
+
+
+BAbstractLayoutItem::BAbstractLayoutItem(BMessage *from)
+	:
+	BLayoutItem(from)
+{
+}
+
+
+BAbstractLayoutItem::~BAbstractLayoutItem()
+{
+}
+
+
+BSize
+BAbstractLayoutItem::MinSize()
+{
+	return compose_size(fMinSize, BaseMinSize());
+}
+
+
+BSize
+BAbstractLayoutItem::MaxSize()
+{
+	return compose_size(fMaxSize, BaseMaxSize());
+}
+
+
+BSize
+BAbstractLayoutItem::PreferredSize()
+{
+	return compose_size(fPreferredSize, BasePreferredSize());
+}
+
+
+BAlignment
+BAbstractLayoutItem::Alignment()
+{
+	BAlignment alignment = BaseAlignment();
+	if (fAlignment.horizontal != B_ALIGN_HORIZONTAL_UNSET)
+		alignment.horizontal = fAlignment.horizontal;
+	if (fAlignment.vertical != B_ALIGN_VERTICAL_UNSET)
+		alignment.vertical = fAlignment.vertical;
+	return alignment;
+}
+
+
+void
+BAbstractLayoutItem::SetExplicitMinSize(BSize size)
+{
+	fMinSize = size;
+}
+
+
+void
+BAbstractLayoutItem::SetExplicitMaxSize(BSize size)
+{
+	fMaxSize = size;
+}
+
+
+void
+BAbstractLayoutItem::SetExplicitPreferredSize(BSize size)
+{
+	fPreferredSize = size;
+}
+
+
+void
+BAbstractLayoutItem::SetExplicitAlignment(BAlignment alignment)
+{
+	fAlignment = alignment;
+}
+
+
+BSize
+BAbstractLayoutItem::BaseMinSize()
+{
+	return BSize(0, 0);
+}
+
+
+BSize
+BAbstractLayoutItem::BaseMaxSize()
+{
+	return BSize(B_SIZE_UNLIMITED, B_SIZE_UNLIMITED);
+}
+
+
+BSize
+BAbstractLayoutItem::BasePreferredSize()
+{
+	return BSize(0, 0);
+}
+
+
+BAlignment
+BAbstractLayoutItem::BaseAlignment()
+{
+	return BAlignment(B_ALIGN_HORIZONTAL_CENTER, B_ALIGN_VERTICAL_CENTER);
+}
+
+
+status_t
+BAbstractLayoutItem::Archive(BMessage *into, bool deep) const
+{
+	return BLayoutItem::Archive(into, deep);
+}
+
+
+//	#pragma mark - BLayout
+
+
+BLayout::BLayout()
+	:
+	fOwner(NULL)
+{
+}
+
+
+BLayout::~BLayout()
+{
+}
+
+
+//	#pragma mark - BLayoutUtils
+
+
+float
+BLayoutUtils::AddSizesFloat(float a, float b)
+{
+	float sum = a + b + 1;
+	return std::min(sum, (float)B_SIZE_UNLIMITED);
+}
+
+
+// Puts the view into frame, no larger than its maximum size and aligned
+// the way it asks for.
+void
+BLayoutUtils::AlignInFrame(BView *view, BRect frame)
+{
+	BSize maxSize = view->MaxSize();
+	BAlignment alignment = view->LayoutAlignment();
+
+	float width = std::min(frame.Width(), maxSize.width);
+	float height = std::min(frame.Height(), maxSize.height);
+
+	float left = frame.left;
+	if (alignment.horizontal == B_ALIGN_RIGHT)
+		left = frame.right - width;
+	else if (alignment.horizontal == B_ALIGN_HORIZONTAL_CENTER)
+		left = frame.left + (frame.Width() - width) / 2;
+
+	float top = frame.top;
+	if (alignment.vertical == B_ALIGN_BOTTOM)
+		top = frame.bottom - height;
+	else if (alignment.vertical == B_ALIGN_VERTICAL_CENTER)
+		top = frame.top + (frame.Height() - height) / 2;
+
+	view->MoveTo(left, top);
+	view->ResizeTo(width, height);
+}
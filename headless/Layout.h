@@ -0,0 +1,23 @@
+/*
+	Layout.h: Headless stand-in for BLayout. Only what the widget touches.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_LAYOUT_H_
+#define HEADLESS_LAYOUT_H_
+
+#include <LayoutItem.h>
+
+class BLayout : public BLayoutItem {
+public:
+							BLayout();
+	virtual					~BLayout();
+
+			BView*			Owner() const { return fOwner; }
+
+private:
+	friend class BView;
+
+			BView*			fOwner;
+};
+
+#endif
@@ -0,0 +1,46 @@
+/*
+	LayoutItem.h: Headless stand-in for BLayoutItem.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_LAYOUT_ITEM_H_
+#define HEADLESS_LAYOUT_ITEM_H_
+
+#include <Alignment.h>
+#include <Archivable.h>
+#include <Rect.h>
+
+class BLayout;
+class BView;
+
+class BLayoutItem : public BArchivable {
+public:
+							BLayoutItem();
+							BLayoutItem(BMessage *from);
+	virtual					~BLayoutItem();
+
+	virtual	BSize			MinSize() = 0;
+	virtual	BSize			MaxSize() = 0;
+	virtual	BSize			PreferredSize() = 0;
+	virtual	BAlignment		Alignment() = 0;
+
+	virtual	void			SetExplicitMinSize(BSize size) = 0;
+	virtual	void			SetExplicitMaxSize(BSize size) = 0;
+	virtual	void			SetExplicitPreferredSize(BSize size) = 0;
+	virtual	void			SetExplicitAlignment(BAlignment alignment) = 0;
+
+	virtual	bool			IsVisible() = 0;
+	virtual	void			SetVisible(bool visible) = 0;
+
+	virtual	BRect			Frame() = 0;
+	virtual	void			SetFrame(BRect frame) = 0;
+
+	virtual	BView*			View();
+
+			void			InvalidateLayout(bool children = false) {}
+			BLayout*		Layout() const { return fLayout; }
+
+private:
+			BLayout*		fLayout;
+};
+
+#endif
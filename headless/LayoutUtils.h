@@ -0,0 +1,19 @@
+/*
+	LayoutUtils.h: Headless stand-in for BLayoutUtils.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_LAYOUT_UTILS_H_
+#define HEADLESS_LAYOUT_UTILS_H_
+
+#include <Alignment.h>
+#include <Rect.h>
+
+class BView;
+
+class BLayoutUtils {
+public:
+	static	float			AddSizesFloat(float a, float b);
+	static	void			AlignInFrame(BView *view, BRect frame);
+};
+
+#endif
@@ -0,0 +1,68 @@
+/*
+	List.h: Headless stand-in for BList.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_LIST_H_
+#define HEADLESS_LIST_H_
+
+#include <SupportDefs.h>
+
+#include <algorithm>
+#include <vector>
+
+class BList {
+public:
+							BList(int32 blockSize = 20) { (void)blockSize; }
+
+			bool			AddItem(void *item)
+								{ fItems.push_back(item); return true; }
+			bool			AddItem(void *item, int32 index)
+								{
+									if (index < 0 || index > CountItems())
+										return false;
+									fItems.insert(fItems.begin() + index, item);
+									return true;
+								}
+			bool			RemoveItem(void *item)
+								{
+									int32 index = IndexOf(item);
+									if (index < 0)
+										return false;
+									fItems.erase(fItems.begin() + index);
+									return true;
+								}
+			void*			RemoveItem(int32 index)
+								{
+									if (index < 0 || index >= CountItems())
+										return NULL;
+									void *item = fItems[index];
+									fItems.erase(fItems.begin() + index);
+									return item;
+								}
+			void			MakeEmpty() { fItems.clear(); }
+
+			void*			ItemAt(int32 index) const
+								{
+									return index >= 0 && index < CountItems()
+										? fItems[index] : NULL;
+								}
+			void*			ItemAtFast(int32 index) const
+								{ return fItems[index]; }
+			int32			IndexOf(void *item) const
+								{
+									std::vector<void*>::const_iterator it
+										= std::find(fItems.begin(),
+											fItems.end(), item);
+									return it == fItems.end()
+										? -1 : (int32)(it - fItems.begin());
+								}
+			bool			HasItem(void *item) const
+								{ return IndexOf(item) >= 0; }
+			int32			CountItems() const { return (int32)fItems.size(); }
+			bool			IsEmpty() const { return fItems.empty(); }
+
+private:
+			std::vector<void*> fItems;
+};
+
+#endif
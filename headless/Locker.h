@@ -0,0 +1,36 @@
+/*
+	Locker.h: Headless stand-in for BLocker, a recursive mutex.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_LOCKER_H_
+#define HEADLESS_LOCKER_H_
+
+#include <OS.h>
+
+#include <pthread.h>
+
+class BLocker {
+public:
+							BLocker();
+							BLocker(const char *name);
+							BLocker(const char *name, bool benaphoreStyle);
+	virtual					~BLocker();
+
+			status_t		InitCheck() const { return B_OK; }
+
+			bool			Lock();
+			status_t		LockWithTimeout(bigtime_t timeout);
+			void			Unlock();
+
+			bool			IsLocked() const;
+			int32			CountLocks() const { return fCount; }
+
+private:
+			void			_Init();
+
+			pthread_mutex_t	fMutex;
+			pthread_t		fOwner;
+			int32			fCount;
+};
+
+#endif
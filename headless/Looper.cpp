@@ -0,0 +1,537 @@
+/*
+	Looper.cpp: Headless BLooper and BMessageQueue.
+	Released under the MIT license.
+*/
+#include <Looper.h>
+
+#include <AppDefs.h>
+#include <Autolock.h>
+#include <MessageFilter.h>
+#include <MessageRunner.h>
+#include <Messenger.h>
+
+// Scripting messages that keep naming other handlers are cut off here
+static const int32 kMaxResolveDepth = 64;
+
+
+BLooper::BLooper(const char *name, int32 priority, int32 portCapacity)
+	:
+	BHandler(name),
+	fQueue(new BMessageQueue),
+	fLocker(name),
+	fCommonFilters(NULL),
+	fPreferred(NULL),
+	fCurrentMessage(NULL),
+	fThread(-1)
+{
+	AddHandler(this);
+}
+
+
+BLooper::~BLooper()
+{
+	while (BMessage *message = fQueue->NextMessage())
+		delete message;
+	delete fQueue;
+	delete fCurrentMessage;
+
+	// the handlers outlive us, but are not ours anymore
+	for (int32 i = CountHandlers() - 1; i >= 0; i--) {
+		BHandler *handler = HandlerAt(i);
+		if (handler != this)
+			RemoveHandler(handler);
+	}
+
+	if (fCommonFilters != NULL) {
+		for (int32 i = 0; i < fCommonFilters->CountItems(); i++)
+			delete (BMessageFilter*)fCommonFilters->ItemAt(i);
+		delete fCommonFilters;
+	}
+
+	// Quit() deletes a locked looper
+	while (fLocker.IsLocked())
+		fLocker.Unlock();
+}
+
+
+status_t
+BLooper::PostMessage(uint32 command)
+{
+	BMessage message(command);
+	return PostMessage(&message, NULL, NULL);
+}
+
+
+status_t
+BLooper::PostMessage(BMessage *message)
+{
+	return PostMessage(message, NULL, NULL);
+}
+
+
+status_t
+BLooper::PostMessage(uint32 command, BHandler *handler, BHandler *replyTo)
+{
+	BMessage message(command);
+	return PostMessage(&message, handler, replyTo);
+}
+
+
+status_t
+BLooper::PostMessage(BMessage *message, BHandler *handler,
+	BHandler *replyTo)
+{
+	if (message == NULL)
+		return B_BAD_VALUE;
+	if (handler != NULL && handler->Looper() != this)
+		return B_MISMATCHED_VALUES;
+
+	BMessage *copy = new BMessage(*message);
+	copy->fTarget = handler;
+	copy->fPreferredTarget = handler == NULL;
+	copy->fReplyHandler = replyTo;
+	fQueue->AddMessage(copy);
+	return B_OK;
+}
+
+
+void
+BLooper::DispatchMessage(BMessage *message, BHandler *handler)
+{
+	if (message->what == B_QUIT_REQUESTED && handler == this) {
+		if (QuitRequested())
+			Quit();
+		return;
+	}
+
+	handler->MessageReceived(message);
+}
+
+
+void
+BLooper::MessageReceived(BMessage *message)
+{
+	BHandler::MessageReceived(message);
+}
+
+
+BMessage*
+BLooper::DetachCurrentMessage()
+{
+	BMessage *message = fCurrentMessage;
+	fCurrentMessage = NULL;
+	return message;
+}
+
+
+bool
+BLooper::IsMessageWaiting() const
+{
+	return !fQueue->IsEmpty();
+}
+
+
+void
+BLooper::AddHandler(BHandler *handler)
+{
+	if (handler == NULL || handler->Looper() != NULL)
+		return;
+
+	fHandlers.AddItem(handler);
+	handler->_SetLooper(this);
+	if (handler != this && handler->NextHandler() == NULL)
+		handler->SetNextHandler(this);
+}
+
+
+bool
+BLooper::RemoveHandler(BHandler *handler)
+{
+	if (handler == NULL || handler == this || handler->Looper() != this)
+		return false;
+
+	fHandlers.RemoveItem(handler);
+	handler->_SetLooper(NULL);
+	handler->SetNextHandler(NULL);
+	if (fPreferred == handler)
+		fPreferred = NULL;
+	return true;
+}
+
+
+int32
+BLooper::CountHandlers() const
+{
+	return fHandlers.CountItems();
+}
+
+
+BHandler*
+BLooper::HandlerAt(int32 index) const
+{
+	return (BHandler*)fHandlers.ItemAt(index);
+}
+
+
+int32
+BLooper::IndexOf(BHandler *handler) const
+{
+	return fHandlers.IndexOf(handler);
+}
+
+
+void
+BLooper::SetPreferredHandler(BHandler *handler)
+{
+	fPreferred = handler != NULL && handler->Looper() == this ? handler : NULL;
+}
+
+
+thread_id
+BLooper::Run()
+{
+	// There is no loop to start; the thread that pumps the looper with
+	// DispatchPendingMessages() counts as the looper thread.
+	fThread = find_thread(NULL);
+	return fThread;
+}
+
+
+void
+BLooper::Quit()
+{
+	delete this;
+}
+
+
+bool
+BLooper::QuitRequested()
+{
+	return true;
+}
+
+
+bool
+BLooper::Lock()
+{
+	return fLocker.Lock();
+}
+
+
+void
+BLooper::Unlock()
+{
+	fLocker.Unlock();
+}
+
+
+bool
+BLooper::IsLocked() const
+{
+	return fLocker.IsLocked();
+}
+
+
+status_t
+BLooper::LockWithTimeout(bigtime_t timeout)
+{
+	return fLocker.LockWithTimeout(timeout);
+}
+
+
+thread_id
+BLooper::LockingThread() const
+{
+	return fLocker.IsLocked() ? find_thread(NULL) : -1;
+}
+
+
+int32
+BLooper::CountLocks() const
+{
+	return fLocker.CountLocks();
+}
+
+
+void
+BLooper::AddCommonFilter(BMessageFilter *filter)
+{
+	if (filter == NULL || filter->Looper() != NULL)
+		return;
+
+	if (fCommonFilters == NULL)
+		fCommonFilters = new BList;
+	filter->_SetLooper(this);
+	fCommonFilters->AddItem(filter);
+}
+
+
+bool
+BLooper::RemoveCommonFilter(BMessageFilter *filter)
+{
+	if (fCommonFilters == NULL || !fCommonFilters->RemoveItem(filter))
+		return false;
+
+	filter->_SetLooper(NULL);
+	return true;
+}
+
+
+void
+BLooper::SetCommonFilterList(BList *filters)
+{
+	if (fCommonFilters != NULL) {
+		for (int32 i = 0; i < fCommonFilters->CountItems(); i++)
+			delete (BMessageFilter*)fCommonFilters->ItemAt(i);
+		delete fCommonFilters;
+	}
+
+	fCommonFilters = filters;
+	for (int32 i = 0; filters != NULL && i < filters->CountItems(); i++)
+		((BMessageFilter*)filters->ItemAt(i))->_SetLooper(this);
+}
+
+
+int32
+BLooper::DispatchPendingMessages()
+{
+	if (!Lock())
+		return 0;
+
+	if (fThread < 0)
+		fThread = find_thread(NULL);
+
+	BMessageRunner::FireDue(this, system_time());
+
+	// What handlers post while we are dispatching waits for the next call,
+	// so a message that keeps reposting itself cannot hang the driver.
+	int32 count = fQueue->CountMessages();
+	for (int32 i = 0; i < count; i++) {
+		BMessage *message = fQueue->NextMessage();
+		if (message == NULL)
+			break;
+		_Dispatch(message);
+	}
+
+	Unlock();
+	return count;
+}
+
+
+BHandler*
+BLooper::_TargetFor(BMessage *message)
+{
+	if (message->fPreferredTarget)
+		return fPreferred != NULL ? fPreferred : this;
+
+	BHandler *target = message->fTarget;
+	if (target == NULL)
+		return this;
+	if (!BHandler::IsAlive(target) || target->Looper() != this)
+		return NULL;
+	return target;
+}
+
+
+void
+BLooper::_Dispatch(BMessage *message)
+{
+	fCurrentMessage = message;
+
+	BHandler *target = _TargetFor(message);
+	if (target != NULL && _Filter(fCommonFilters, message, &target)) {
+		// the filters of the handler that ends up with the message, which
+		// may hand it on to yet another handler
+		for (int32 depth = 0; target != NULL && depth < kMaxResolveDepth;
+				depth++) {
+			BHandler *previous = target;
+			if (!_Filter(target->FilterList(), message, &target))
+				target = NULL;
+			if (target == previous)
+				break;
+		}
+
+		if (target != NULL && message->HasSpecifiers())
+			target = _ResolveSpecifier(target, message);
+		if (target != NULL)
+			DispatchMessage(message, target);
+	}
+
+	// a handler may have detached the message to keep it
+	if (fCurrentMessage == message) {
+		fCurrentMessage = NULL;
+		delete message;
+	}
+}
+
+
+bool
+BLooper::_Filter(BList *filters, BMessage *message, BHandler **target)
+{
+	for (int32 i = 0; filters != NULL && i < filters->CountItems(); i++) {
+		BMessageFilter *filter = (BMessageFilter*)filters->ItemAt(i);
+		if (!filter->FiltersAnyCommand() && filter->Command() != message->what)
+			continue;
+		if (filter->MessageDelivery() == B_DROPPED_DELIVERY
+			&& !message->WasDropped())
+			continue;
+		if (filter->MessageSource() == B_REMOTE_SOURCE)
+			continue;
+
+		filter_result result = filter->fFilterFunction != NULL
+			? filter->fFilterFunction(message, target, filter)
+			: filter->Filter(message, target);
+		if (result == B_SKIP_MESSAGE || *target == NULL)
+			return false;
+	}
+	return true;
+}
+
+
+BHandler*
+BLooper::_ResolveSpecifier(BHandler *target, BMessage *message)
+{
+	for (int32 depth = 0; depth < kMaxResolveDepth; depth++) {
+		int32 index;
+		BMessage specifier;
+		int32 form;
+		const char *property;
+		if (message->GetCurrentSpecifier(&index, &specifier, &form,
+				&property) != B_OK)
+			return target;
+
+		BHandler *next = target->ResolveSpecifier(message, index, &specifier,
+			form, property);
+		if (next == NULL || next == target)
+			return next;
+
+		// resolving on the next handler is not ours to do if it lives in
+		// another looper
+		if (next->Looper() != this) {
+			BMessenger(next).SendMessage(message, message->fReplyHandler);
+			return NULL;
+		}
+		target = next;
+	}
+	return NULL;
+}
+
+
+//	#pragma mark - BMessageQueue
+
+
+BMessageQueue::BMessageQueue()
+	:
+	fLocker("message queue")
+{
+}
+
+
+BMessageQueue::~BMessageQueue()
+{
+}
+
+
+void
+BMessageQueue::AddMessage(BMessage *message)
+{
+	if (message == NULL)
+		return;
+
+	BAutolock locker(fLocker);
+	fMessages.push_back(message);
+}
+
+
+void
+BMessageQueue::RemoveMessage(BMessage *message)
+{
+	BAutolock locker(fLocker);
+	for (std::deque<BMessage*>::iterator i = fMessages.begin();
+			i != fMessages.end(); i++) {
+		if (*i == message) {
+			fMessages.erase(i);
+			return;
+		}
+	}
+}
+
+
+int32
+BMessageQueue::CountMessages() const
+{
+	BAutolock locker(fLocker);
+	return (int32)fMessages.size();
+}
+
+
+bool
+BMessageQueue::IsEmpty() const
+{
+	BAutolock locker(fLocker);
+	return fMessages.empty();
+}
+
+
+BMessage*
+BMessageQueue::FindMessage(int32 index) const
+{
+	BAutolock locker(fLocker);
+	if (index < 0 || index >= (int32)fMessages.size())
+		return NULL;
+	return fMessages[index];
+}
+
+
+BMessage*
+BMessageQueue::FindMessage(uint32 what, int32 index) const
+{
+	BAutolock locker(fLocker);
+	for (size_t i = 0; i < fMessages.size(); i++) {
+		if (fMessages[i]->what == what && index-- == 0)
+			return fMessages[i];
+	}
+	return NULL;
+}
+
+
+bool
+BMessageQueue::Lock()
+{
+	return fLocker.Lock();
+}
+
+
+void
+BMessageQueue::Unlock()
+{
+	fLocker.Unlock();
+}
+
+
+bool
+BMessageQueue::IsLocked() const
+{
+	return fLocker.IsLocked();
+}
+
+
+BMessage*
+BMessageQueue::NextMessage()
+{
+	BAutolock locker(fLocker);
+	if (fMessages.empty())
+		return NULL;
+
+	BMessage *message = fMessages.front();
+	fMessages.pop_front();
+	return message;
+}
+
+
+bool
+BMessageQueue::IsNextMessage(const BMessage *message) const
+{
+	BAutolock locker(fLocker);
+	return !fMessages.empty() && fMessages.front() == message;
+}
@@ -0,0 +1,94 @@
+/*
+	Looper.h: Headless stand-in for BLooper.
+
+	There is no message loop thread: whoever drives the looper calls
+	DispatchPendingMessages() to run queued messages and due message runners.
+	Locking is real, so other threads can lock the looper as usual.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_LOOPER_H_
+#define HEADLESS_LOOPER_H_
+
+#include <Handler.h>
+#include <List.h>
+#include <Locker.h>
+#include <Message.h>
+#include <MessageQueue.h>
+#include <OS.h>
+
+class BMessageFilter;
+
+class BLooper : public BHandler {
+public:
+							BLooper(const char *name = NULL,
+								int32 priority = B_NORMAL_PRIORITY,
+								int32 portCapacity = 200);
+	virtual					~BLooper();
+
+			status_t		PostMessage(uint32 command);
+			status_t		PostMessage(BMessage *message);
+			status_t		PostMessage(uint32 command, BHandler *handler,
+								BHandler *replyTo = NULL);
+			status_t		PostMessage(BMessage *message, BHandler *handler,
+								BHandler *replyTo = NULL);
+
+	virtual	void			DispatchMessage(BMessage *message,
+								BHandler *handler);
+	virtual	void			MessageReceived(BMessage *message);
+			BMessage*		CurrentMessage() const { return fCurrentMessage; }
+			BMessage*		DetachCurrentMessage();
+			BMessageQueue*	MessageQueue() const { return fQueue; }
+			bool			IsMessageWaiting() const;
+
+			void			AddHandler(BHandler *handler);
+			bool			RemoveHandler(BHandler *handler);
+			int32			CountHandlers() const;
+			BHandler*		HandlerAt(int32 index) const;
+			int32			IndexOf(BHandler *handler) const;
+
+			BHandler*		PreferredHandler() const { return fPreferred; }
+			void			SetPreferredHandler(BHandler *handler);
+
+	virtual	thread_id		Run();
+	virtual	void			Quit();
+	virtual	bool			QuitRequested();
+
+			bool			Lock();
+			void			Unlock();
+			bool			IsLocked() const;
+			status_t		LockWithTimeout(bigtime_t timeout);
+			thread_id		LockingThread() const;
+			int32			CountLocks() const;
+			thread_id		Thread() const { return fThread; }
+
+	virtual	void			AddCommonFilter(BMessageFilter *filter);
+	virtual	bool			RemoveCommonFilter(BMessageFilter *filter);
+	virtual	void			SetCommonFilterList(BList *filters);
+			BList*			CommonFilterList() const { return fCommonFilters; }
+
+	// headless: dispatches everything queued so far and fires due message
+	// runners; returns the number of messages dispatched
+			int32			DispatchPendingMessages();
+
+protected:
+	virtual	BHandler*		_TargetFor(BMessage *message);
+
+private:
+	friend class BMessenger;
+
+			void			_Dispatch(BMessage *message);
+			bool			_Filter(BList *filters, BMessage *message,
+								BHandler **target);
+			BHandler*		_ResolveSpecifier(BHandler *target,
+								BMessage *message);
+
+			BMessageQueue*	fQueue;
+			BLocker			fLocker;
+			BList			fHandlers;
+			BList*			fCommonFilters;
+			BHandler*		fPreferred;
+			BMessage*		fCurrentMessage;
+			thread_id		fThread;
+};
+
+#endif
@@ -0,0 +1,11 @@
+/*
+	MenuItem.h: Included by the widget sources but not used by them; the
+	headless build provides nothing beyond the basic view classes.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_MENU_ITEM_H_
+#define HEADLESS_MENU_ITEM_H_
+
+#include <Control.h>
+
+#endif
@@ -0,0 +1,1231 @@
+/*
+	Message.cpp: Headless BMessage.
+	Released under the MIT license.
+*/
+#include <Message.h>
+
+#include <Entry.h>
+#include <Handler.h>
+#include <Looper.h>
+#include <Messenger.h>
+#include <String.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+const uint32 kFlatMagic = 'HMSG';
+
+
+void
+append_raw(std::string &buffer, const void *data, size_t size)
+{
+	buffer.append((const char*)data, size);
+}
+
+
+template<typename T>
+void
+append_value(std::string &buffer, T value)
+{
+	append_raw(buffer, &value, sizeof(value));
+}
+
+
+template<typename T>
+bool
+read_value(const char **cursor, const char *end, T *value)
+{
+	if (end - *cursor < (ssize_t)sizeof(T))
+		return false;
+	memcpy(value, *cursor, sizeof(T));
+	*cursor += sizeof(T);
+	return true;
+}
+
+
+bool
+read_raw(const char **cursor, const char *end, uint32 size,
+	std::string *value)
+{
+	if (end - *cursor < (ssize_t)size)
+		return false;
+	value->assign(*cursor, size);
+	*cursor += size;
+	return true;
+}
+
+}	// namespace
+
+
+BMessage::BMessage()
+	:
+	what(0),
+	fTarget(NULL),
+	fPreferredTarget(false),
+	fReplyHandler(NULL),
+	fReplyMessage(NULL),
+	fIsReply(false),
+	fCurrentSpecifier(-1),
+	fSpecifierCache(NULL)
+{
+}
+
+
+BMessage::BMessage(uint32 command)
+	:
+	what(command),
+	fTarget(NULL),
+	fPreferredTarget(false),
+	fReplyHandler(NULL),
+	fReplyMessage(NULL),
+	fIsReply(false),
+	fCurrentSpecifier(-1),
+	fSpecifierCache(NULL)
+{
+}
+
+
+BMessage::BMessage(const BMessage &other)
+	:
+	what(other.what),
+	fFields(other.fFields),
+	fTarget(NULL),
+	fPreferredTarget(false),
+	fReplyHandler(NULL),
+	fReplyMessage(NULL),
+	fIsReply(other.fIsReply),
+	fCurrentSpecifier(other.fCurrentSpecifier),
+	fSpecifierCache(NULL)
+{
+}
+
+
+BMessage::~BMessage()
+{
+	delete fSpecifierCache;
+}
+
+
+BMessage&
+BMessage::operator=(const BMessage &other)
+{
+	if (this == &other)
+		return *this;
+
+	// like the real thing, delivery information stays with the original
+	what = other.what;
+	fFields = other.fFields;
+	fIsReply = other.fIsReply;
+	fCurrentSpecifier = other.fCurrentSpecifier;
+	return *this;
+}
+
+
+BMessage::Field*
+BMessage::_FindField(const char *name, type_code type, status_t *error) const
+{
+	if (name == NULL) {
+		*error = B_BAD_VALUE;
+		return NULL;
+	}
+
+	for (size_t i = 0; i < fFields.size(); i++) {
+		const Field &field = fFields[i];
+		if (field.name != name)
+			continue;
+
+		if (type != B_ANY_TYPE && field.type != type) {
+			*error = B_BAD_TYPE;
+			return NULL;
+		}
+		*error = B_OK;
+		return const_cast<Field*>(&field);
+	}
+
+	*error = B_NAME_NOT_FOUND;
+	return NULL;
+}
+
+
+status_t
+BMessage::_FindItem(const char *name, type_code type, int32 index,
+	const std::string **item) const
+{
+	status_t error;
+	Field *field = _FindField(name, type, &error);
+	if (field == NULL)
+		return error;
+	if (index < 0 || index >= (int32)field->items.size())
+		return B_BAD_INDEX;
+
+	*item = &field->items[index];
+	return B_OK;
+}
+
+
+status_t
+BMessage::GetInfo(const char *name, type_code *typeFound,
+	int32 *countFound) const
+{
+	status_t error;
+	Field *field = _FindField(name, B_ANY_TYPE, &error);
+	if (field == NULL) {
+		if (typeFound != NULL)
+			*typeFound = 0;
+		if (countFound != NULL)
+			*countFound = 0;
+		return error;
+	}
+
+	if (typeFound != NULL)
+		*typeFound = field->type;
+	if (countFound != NULL)
+		*countFound = (int32)field->items.size();
+	return B_OK;
+}
+
+
+status_t
+BMessage::GetInfo(type_code type, int32 index, char **nameFound,
+	type_code *typeFound, int32 *countFound) const
+{
+	if (index < 0)
+		return B_BAD_INDEX;
+
+	for (size_t i = 0; i < fFields.size(); i++) {
+		const Field &field = fFields[i];
+		if (type != B_ANY_TYPE && field.type != type)
+			continue;
+		if (index-- > 0)
+			continue;
+
+		if (nameFound != NULL)
+			*nameFound = const_cast<char*>(field.name.c_str());
+		if (typeFound != NULL)
+			*typeFound = field.type;
+		if (countFound != NULL)
+			*countFound = (int32)field.items.size();
+		return B_OK;
+	}
+	return B_BAD_INDEX;
+}
+
+
+int32
+BMessage::CountNames(type_code type) const
+{
+	int32 count = 0;
+	for (size_t i = 0; i < fFields.size(); i++) {
+		if (type == B_ANY_TYPE || fFields[i].type == type)
+			count++;
+	}
+	return count;
+}
+
+
+bool
+BMessage::HasSameData(const BMessage &other) const
+{
+	if (what != other.what || fFields.size() != other.fFields.size())
+		return false;
+
+	for (size_t i = 0; i < fFields.size(); i++) {
+		status_t error;
+		Field *field = other._FindField(fFields[i].name.c_str(),
+			fFields[i].type, &error);
+		if (field == NULL || field->items != fFields[i].items)
+			return false;
+	}
+	return true;
+}
+
+
+status_t
+BMessage::MakeEmpty()
+{
+	fFields.clear();
+	fCurrentSpecifier = -1;
+	return B_OK;
+}
+
+
+status_t
+BMessage::RemoveName(const char *name)
+{
+	status_t error;
+	Field *field = _FindField(name, B_ANY_TYPE, &error);
+	if (field == NULL)
+		return error;
+
+	fFields.erase(fFields.begin() + (field - &fFields[0]));
+	return B_OK;
+}
+
+
+status_t
+BMessage::RemoveData(const char *name, int32 index)
+{
+	status_t error;
+	Field *field = _FindField(name, B_ANY_TYPE, &error);
+	if (field == NULL)
+		return error;
+	if (index < 0 || index >= (int32)field->items.size())
+		return B_BAD_INDEX;
+
+	field->items.erase(field->items.begin() + index);
+	if (field->items.empty())
+		fFields.erase(fFields.begin() + (field - &fFields[0]));
+	return B_OK;
+}
+
+
+void
+BMessage::PrintToStream() const
+{
+	char command[5] = {
+		(char)(what >> 24), (char)(what >> 16), (char)(what >> 8), (char)what,
+		'\0'
+	};
+	printf("BMessage('%s') {\n", command);
+
+	for (size_t i = 0; i < fFields.size(); i++) {
+		const Field &field = fFields[i];
+		for (size_t j = 0; j < field.items.size(); j++) {
+			const std::string &item = field.items[j];
+			printf("        %s[%d] = ", field.name.c_str(), (int)j);
+			switch (field.type) {
+				case B_STRING_TYPE:
+					printf("string(\"%s\")\n", item.c_str());
+					break;
+				case B_INT32_TYPE:
+					printf("int32(%d)\n", *(const int32*)item.data());
+					break;
+				case B_INT64_TYPE:
+					printf("int64(%lld)\n",
+						(long long)*(const int64*)item.data());
+					break;
+				case B_BOOL_TYPE:
+					printf("bool(%s)\n", item[0] != 0 ? "true" : "false");
+					break;
+				case B_FLOAT_TYPE:
+					printf("float(%.4f)\n", *(const float*)item.data());
+					break;
+				default:
+					printf("%d bytes\n", (int)item.size());
+					break;
+			}
+		}
+	}
+	printf("}\n");
+}
+
+
+//	#pragma mark - replies
+
+
+status_t
+BMessage::SendReply(uint32 command, BHandler *replyTo)
+{
+	BMessage reply(command);
+	return SendReply(&reply, replyTo);
+}
+
+
+status_t
+BMessage::SendReply(BMessage *reply, BHandler *replyTo, bigtime_t timeout)
+{
+	if (reply == NULL)
+		return B_BAD_VALUE;
+
+	if (fReplyMessage != NULL) {
+		// the sender is blocked in a synchronous SendMessage()
+		*fReplyMessage = *reply;
+		fReplyMessage->fIsReply = true;
+		fReplyMessage = NULL;
+		return B_OK;
+	}
+
+	if (fReplyHandler == NULL || !BHandler::IsAlive(fReplyHandler))
+		return B_BAD_REPLY;
+
+	BMessage copy(*reply);
+	copy.fIsReply = true;
+	return BMessenger(fReplyHandler).SendMessage(&copy, replyTo);
+}
+
+
+bool
+BMessage::IsSourceWaiting() const
+{
+	return fReplyMessage != NULL;
+}
+
+
+//	#pragma mark - scripting
+
+
+status_t
+BMessage::AddSpecifier(const char *property)
+{
+	BMessage specifier(B_DIRECT_SPECIFIER);
+	specifier.AddString("property", property);
+	return AddSpecifier(&specifier);
+}
+
+
+status_t
+BMessage::AddSpecifier(const char *property, int32 index)
+{
+	BMessage specifier(B_INDEX_SPECIFIER);
+	specifier.AddString("property", property);
+	specifier.AddInt32("index", index);
+	return AddSpecifier(&specifier);
+}
+
+
+status_t
+BMessage::AddSpecifier(const char *property, const char *name)
+{
+	BMessage specifier(B_NAME_SPECIFIER);
+	specifier.AddString("property", property);
+	specifier.AddString("name", name);
+	return AddSpecifier(&specifier);
+}
+
+
+status_t
+BMessage::AddSpecifier(const BMessage *specifier)
+{
+	status_t status = AddMessage("specifiers", specifier);
+	if (status != B_OK)
+		return status;
+
+	fCurrentSpecifier++;
+	return B_OK;
+}
+
+
+status_t
+BMessage::SetCurrentSpecifier(int32 index)
+{
+	type_code type;
+	int32 count;
+	if (GetInfo("specifiers", &type, &count) != B_OK)
+		return B_BAD_SCRIPT_SYNTAX;
+	if (index < 0 || index >= count)
+		return B_BAD_INDEX;
+
+	fCurrentSpecifier = index;
+	return B_OK;
+}
+
+
+status_t
+BMessage::GetCurrentSpecifier(int32 *index, BMessage *specifier, int32 *form,
+	const char **property) const
+{
+	if (index != NULL)
+		*index = fCurrentSpecifier;
+	if (fCurrentSpecifier < 0)
+		return B_BAD_SCRIPT_SYNTAX;
+
+	// property points into the specifier, so without one from the caller
+	// we keep our own copy alive
+	if (specifier == NULL) {
+		if (fSpecifierCache == NULL)
+			fSpecifierCache = new BMessage;
+		specifier = fSpecifierCache;
+	}
+
+	status_t status = FindMessage("specifiers", fCurrentSpecifier, specifier);
+	if (status != B_OK)
+		return status;
+
+	if (form != NULL)
+		*form = specifier->what;
+	if (property != NULL
+		&& specifier->FindString("property", property) != B_OK)
+		*property = NULL;
+	return B_OK;
+}
+
+
+bool
+BMessage::HasSpecifiers() const
+{
+	return fCurrentSpecifier >= 0;
+}
+
+
+status_t
+BMessage::PopSpecifier()
+{
+	if (fCurrentSpecifier < 0)
+		return B_BAD_VALUE;
+
+	fCurrentSpecifier--;
+	return B_OK;
+}
+
+
+//	#pragma mark - flattening
+
+
+ssize_t
+BMessage::FlattenedSize() const
+{
+	ssize_t size = 5 * sizeof(uint32);
+	for (size_t i = 0; i < fFields.size(); i++) {
+		const Field &field = fFields[i];
+		size += 3 * sizeof(uint32) + field.name.size();
+		for (size_t j = 0; j < field.items.size(); j++)
+			size += sizeof(uint32) + field.items[j].size();
+	}
+	return size;
+}
+
+
+status_t
+BMessage::Flatten(char *buffer, ssize_t size) const
+{
+	if (buffer == NULL)
+		return B_BAD_VALUE;
+
+	std::string flat;
+	flat.reserve(FlattenedSize());
+	append_value<uint32>(flat, kFlatMagic);
+	append_value<uint32>(flat, (uint32)FlattenedSize());
+	append_value<uint32>(flat, what);
+	append_value<int32>(flat, fCurrentSpecifier);
+	append_value<uint32>(flat, (uint32)fFields.size());
+
+	for (size_t i = 0; i < fFields.size(); i++) {
+		const Field &field = fFields[i];
+		append_value<uint32>(flat, (uint32)field.name.size());
+		append_raw(flat, field.name.data(), field.name.size());
+		append_value<uint32>(flat, field.type);
+		append_value<uint32>(flat, (uint32)field.items.size());
+		for (size_t j = 0; j < field.items.size(); j++) {
+			append_value<uint32>(flat, (uint32)field.items[j].size());
+			append_raw(flat, field.items[j].data(), field.items[j].size());
+		}
+	}
+
+	if ((ssize_t)flat.size() > size)
+		return B_BAD_VALUE;
+	memcpy(buffer, flat.data(), flat.size());
+	return B_OK;
+}
+
+
+status_t
+BMessage::Unflatten(const char *flatBuffer)
+{
+	if (flatBuffer == NULL)
+		return B_BAD_VALUE;
+
+	uint32 magic;
+	uint32 size;
+	const char *cursor = flatBuffer;
+	const char *end = flatBuffer + 2 * sizeof(uint32);
+	if (!read_value(&cursor, end, &magic) || magic != kFlatMagic
+		|| !read_value(&cursor, end, &size))
+		return B_BAD_VALUE;
+
+	end = flatBuffer + size;
+	uint32 fieldCount;
+	BMessage message;
+	if (!read_value(&cursor, end, &message.what)
+		|| !read_value(&cursor, end, &message.fCurrentSpecifier)
+		|| !read_value(&cursor, end, &fieldCount))
+		return B_BAD_VALUE;
+
+	for (uint32 i = 0; i < fieldCount; i++) {
+		Field field;
+		uint32 length;
+		uint32 itemCount;
+		if (!read_value(&cursor, end, &length)
+			|| !read_raw(&cursor, end, length, &field.name)
+			|| !read_value(&cursor, end, &field.type)
+			|| !read_value(&cursor, end, &itemCount))
+			return B_BAD_VALUE;
+
+		field.items.resize(itemCount);
+		for (uint32 j = 0; j < itemCount; j++) {
+			if (!read_value(&cursor, end, &length)
+				|| !read_raw(&cursor, end, length, &field.items[j]))
+				return B_BAD_VALUE;
+		}
+		message.fFields.push_back(field);
+	}
+
+	*this = message;
+	return B_OK;
+}
+
+
+//	#pragma mark - adding data
+
+
+status_t
+BMessage::AddData(const char *name, type_code type, const void *data,
+	ssize_t numBytes, bool isFixedSize, int32 count)
+{
+	if (name == NULL || (data == NULL && numBytes > 0) || numBytes < 0)
+		return B_BAD_VALUE;
+
+	status_t error;
+	Field *field = _FindField(name, type, &error);
+	if (error == B_BAD_TYPE)
+		return error;
+
+	if (field == NULL) {
+		Field newField;
+		newField.name = name;
+		newField.type = type;
+		fFields.push_back(newField);
+		field = &fFields.back();
+	}
+
+	field->items.push_back(std::string((const char*)data, numBytes));
+	return B_OK;
+}
+
+
+status_t
+BMessage::AddRect(const char *name, BRect rect)
+{
+	return AddData(name, B_RECT_TYPE, &rect, sizeof(rect));
+}
+
+
+status_t
+BMessage::AddPoint(const char *name, BPoint point)
+{
+	return AddData(name, B_POINT_TYPE, &point, sizeof(point));
+}
+
+
+status_t
+BMessage::AddString(const char *name, const char *string)
+{
+	if (string == NULL)
+		return B_BAD_VALUE;
+	return AddData(name, B_STRING_TYPE, string, strlen(string) + 1, false);
+}
+
+
+status_t
+BMessage::AddString(const char *name, const BString &string)
+{
+	return AddData(name, B_STRING_TYPE, string.String(), string.Length() + 1,
+		false);
+}
+
+
+status_t
+BMessage::AddInt8(const char *name, int8 value)
+{
+	return AddData(name, B_INT8_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddUInt8(const char *name, uint8 value)
+{
+	return AddData(name, B_UINT8_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddInt16(const char *name, int16 value)
+{
+	return AddData(name, B_INT16_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddUInt16(const char *name, uint16 value)
+{
+	return AddData(name, B_UINT16_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddInt32(const char *name, int32 value)
+{
+	return AddData(name, B_INT32_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddUInt32(const char *name, uint32 value)
+{
+	return AddData(name, B_UINT32_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddInt64(const char *name, int64 value)
+{
+	return AddData(name, B_INT64_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddUInt64(const char *name, uint64 value)
+{
+	return AddData(name, B_UINT64_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddBool(const char *name, bool value)
+{
+	return AddData(name, B_BOOL_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddFloat(const char *name, float value)
+{
+	return AddData(name, B_FLOAT_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddDouble(const char *name, double value)
+{
+	return AddData(name, B_DOUBLE_TYPE, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::AddPointer(const char *name, const void *pointer)
+{
+	return AddData(name, B_POINTER_TYPE, &pointer, sizeof(pointer));
+}
+
+
+status_t
+BMessage::AddMessenger(const char *name, BMessenger messenger)
+{
+	return AddData(name, B_MESSENGER_TYPE, &messenger, sizeof(messenger));
+}
+
+
+// stored as the device, the directory and the name without its NUL
+status_t
+BMessage::AddRef(const char *name, const entry_ref *ref)
+{
+	if (ref == NULL)
+		return B_BAD_VALUE;
+
+	std::string data((const char*)&ref->device, sizeof(ref->device));
+	data.append((const char*)&ref->directory, sizeof(ref->directory));
+	if (ref->name != NULL)
+		data.append(ref->name);
+	return AddData(name, B_REF_TYPE, data.data(), data.size(), false);
+}
+
+
+status_t
+BMessage::AddMessage(const char *name, const BMessage *message)
+{
+	if (message == NULL)
+		return B_BAD_VALUE;
+
+	ssize_t size = message->FlattenedSize();
+	std::string flat(size, '\0');
+	status_t status = message->Flatten(&flat[0], size);
+	if (status != B_OK)
+		return status;
+	return AddData(name, B_MESSAGE_TYPE, flat.data(), size, false);
+}
+
+
+status_t
+BMessage::AddFlat(const char *name, BFlattenable *object, int32 count)
+{
+	if (object == NULL)
+		return B_BAD_VALUE;
+
+	ssize_t size = object->FlattenedSize();
+	std::string flat(size, '\0');
+	status_t status = object->Flatten(&flat[0], size);
+	if (status != B_OK)
+		return status;
+	return AddData(name, object->TypeCode(), flat.data(), size,
+		object->IsFixedSize());
+}
+
+
+//	#pragma mark - finding data
+
+
+status_t
+BMessage::FindData(const char *name, type_code type, int32 index,
+	const void **data, ssize_t *numBytes) const
+{
+	if (data == NULL)
+		return B_BAD_VALUE;
+
+	const std::string *item = NULL;
+	status_t status = _FindItem(name, type, index, &item);
+	if (status != B_OK) {
+		*data = NULL;
+		return status;
+	}
+
+	*data = item->data();
+	if (numBytes != NULL)
+		*numBytes = item->size();
+	return B_OK;
+}
+
+
+status_t
+BMessage::FindData(const char *name, type_code type, const void **data,
+	ssize_t *numBytes) const
+{
+	return FindData(name, type, 0, data, numBytes);
+}
+
+
+namespace {
+
+template<typename T>
+status_t
+find_value(const BMessage *message, const char *name, type_code type,
+	int32 index, T *value)
+{
+	if (value == NULL)
+		return B_BAD_VALUE;
+
+	const void *data;
+	ssize_t size;
+	status_t status = message->FindData(name, type, index, &data, &size);
+	if (status != B_OK)
+		return status;
+	if (size != sizeof(T))
+		return B_BAD_VALUE;
+
+	// plain values only, BMessenger included
+	memcpy((void*)value, data, sizeof(T));
+	return B_OK;
+}
+
+}	// namespace
+
+
+status_t
+BMessage::FindRect(const char *name, BRect *rect) const
+{
+	return find_value(this, name, B_RECT_TYPE, 0, rect);
+}
+
+
+status_t
+BMessage::FindRect(const char *name, int32 index, BRect *rect) const
+{
+	return find_value(this, name, B_RECT_TYPE, index, rect);
+}
+
+
+status_t
+BMessage::FindPoint(const char *name, BPoint *point) const
+{
+	return find_value(this, name, B_POINT_TYPE, 0, point);
+}
+
+
+status_t
+BMessage::FindPoint(const char *name, int32 index, BPoint *point) const
+{
+	return find_value(this, name, B_POINT_TYPE, index, point);
+}
+
+
+status_t
+BMessage::FindRef(const char *name, entry_ref *ref) const
+{
+	return FindRef(name, 0, ref);
+}
+
+
+status_t
+BMessage::FindRef(const char *name, int32 index, entry_ref *ref) const
+{
+	if (ref == NULL)
+		return B_BAD_VALUE;
+
+	const void *data;
+	ssize_t size;
+	status_t status = FindData(name, B_REF_TYPE, index, &data, &size);
+	if (status != B_OK)
+		return status;
+
+	const ssize_t header = sizeof(ref->device) + sizeof(ref->directory);
+	if (size < header)
+		return B_BAD_VALUE;
+
+	dev_t device;
+	ino_t directory;
+	memcpy(&device, data, sizeof(device));
+	memcpy(&directory, (const char*)data + sizeof(device), sizeof(directory));
+	std::string refName((const char*)data + header, size - header);
+	*ref = entry_ref(device, directory,
+		size > header ? refName.c_str() : NULL);
+	return B_OK;
+}
+
+
+status_t
+BMessage::FindString(const char *name, const char **string) const
+{
+	return FindString(name, 0, string);
+}
+
+
+status_t
+BMessage::FindString(const char *name, int32 index,
+	const char **string) const
+{
+	if (string == NULL)
+		return B_BAD_VALUE;
+
+	const void *data;
+	status_t status = FindData(name, B_STRING_TYPE, index, &data, NULL);
+	*string = status == B_OK ? (const char*)data : NULL;
+	return status;
+}
+
+
+status_t
+BMessage::FindString(const char *name, BString *string) const
+{
+	return FindString(name, 0, string);
+}
+
+
+status_t
+BMessage::FindString(const char *name, int32 index, BString *string) const
+{
+	if (string == NULL)
+		return B_BAD_VALUE;
+
+	const char *value;
+	status_t status = FindString(name, index, &value);
+	if (status == B_OK)
+		string->SetTo(value);
+	return status;
+}
+
+
+status_t
+BMessage::FindInt8(const char *name, int8 *value) const
+{
+	return find_value(this, name, B_INT8_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindInt8(const char *name, int32 index, int8 *value) const
+{
+	return find_value(this, name, B_INT8_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindUInt8(const char *name, uint8 *value) const
+{
+	return find_value(this, name, B_UINT8_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindInt16(const char *name, int16 *value) const
+{
+	return find_value(this, name, B_INT16_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindUInt16(const char *name, uint16 *value) const
+{
+	return find_value(this, name, B_UINT16_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindInt32(const char *name, int32 *value) const
+{
+	return find_value(this, name, B_INT32_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindInt32(const char *name, int32 index, int32 *value) const
+{
+	return find_value(this, name, B_INT32_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindUInt32(const char *name, uint32 *value) const
+{
+	return find_value(this, name, B_UINT32_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindUInt32(const char *name, int32 index, uint32 *value) const
+{
+	return find_value(this, name, B_UINT32_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindInt64(const char *name, int64 *value) const
+{
+	return find_value(this, name, B_INT64_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindInt64(const char *name, int32 index, int64 *value) const
+{
+	return find_value(this, name, B_INT64_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindUInt64(const char *name, uint64 *value) const
+{
+	return find_value(this, name, B_UINT64_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindUInt64(const char *name, int32 index, uint64 *value) const
+{
+	return find_value(this, name, B_UINT64_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindBool(const char *name, bool *value) const
+{
+	return find_value(this, name, B_BOOL_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindBool(const char *name, int32 index, bool *value) const
+{
+	return find_value(this, name, B_BOOL_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindFloat(const char *name, float *value) const
+{
+	return find_value(this, name, B_FLOAT_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindFloat(const char *name, int32 index, float *value) const
+{
+	return find_value(this, name, B_FLOAT_TYPE, index, value);
+}
+
+
+status_t
+BMessage::FindDouble(const char *name, double *value) const
+{
+	return find_value(this, name, B_DOUBLE_TYPE, 0, value);
+}
+
+
+status_t
+BMessage::FindPointer(const char *name, void **pointer) const
+{
+	return find_value(this, name, B_POINTER_TYPE, 0, pointer);
+}
+
+
+status_t
+BMessage::FindPointer(const char *name, int32 index, void **pointer) const
+{
+	return find_value(this, name, B_POINTER_TYPE, index, pointer);
+}
+
+
+status_t
+BMessage::FindMessenger(const char *name, BMessenger *messenger) const
+{
+	return find_value(this, name, B_MESSENGER_TYPE, 0, messenger);
+}
+
+
+status_t
+BMessage::FindMessage(const char *name, BMessage *message) const
+{
+	return FindMessage(name, 0, message);
+}
+
+
+status_t
+BMessage::FindMessage(const char *name, int32 index, BMessage *message) const
+{
+	if (message == NULL)
+		return B_BAD_VALUE;
+
+	const void *data;
+	status_t status = FindData(name, B_MESSAGE_TYPE, index, &data, NULL);
+	if (status != B_OK)
+		return status;
+	return message->Unflatten((const char*)data);
+}
+
+
+status_t
+BMessage::FindFlat(const char *name, BFlattenable *object) const
+{
+	return FindFlat(name, 0, object);
+}
+
+
+status_t
+BMessage::FindFlat(const char *name, int32 index, BFlattenable *object) const
+{
+	if (object == NULL)
+		return B_BAD_VALUE;
+
+	type_code type;
+	status_t status = GetInfo(name, &type);
+	if (status != B_OK)
+		return status;
+	if (!object->AllowsTypeCode(type))
+		return B_BAD_TYPE;
+
+	const void *data;
+	ssize_t size;
+	status = FindData(name, type, index, &data, &size);
+	if (status != B_OK)
+		return status;
+	return object->Unflatten(type, data, size);
+}
+
+
+//	#pragma mark - replacing data
+
+
+status_t
+BMessage::ReplaceData(const char *name, type_code type, int32 index,
+	const void *data, ssize_t numBytes)
+{
+	if (data == NULL || numBytes < 0)
+		return B_BAD_VALUE;
+
+	status_t error;
+	Field *field = _FindField(name, type, &error);
+	if (field == NULL)
+		return error;
+	if (index < 0 || index >= (int32)field->items.size())
+		return B_BAD_INDEX;
+
+	field->items[index].assign((const char*)data, numBytes);
+	return B_OK;
+}
+
+
+status_t
+BMessage::ReplaceInt32(const char *name, int32 value)
+{
+	return ReplaceData(name, B_INT32_TYPE, 0, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::ReplaceInt32(const char *name, int32 index, int32 value)
+{
+	return ReplaceData(name, B_INT32_TYPE, index, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::ReplaceInt64(const char *name, int64 value)
+{
+	return ReplaceData(name, B_INT64_TYPE, 0, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::ReplaceFloat(const char *name, float value)
+{
+	return ReplaceData(name, B_FLOAT_TYPE, 0, &value, sizeof(value));
+}
+
+
+status_t
+BMessage::ReplaceString(const char *name, const char *string)
+{
+	if (string == NULL)
+		return B_BAD_VALUE;
+	return ReplaceData(name, B_STRING_TYPE, 0, string, strlen(string) + 1);
+}
+
+
+//	#pragma mark - convenience
+
+
+bool
+BMessage::HasData(const char *name, type_code type, int32 index) const
+{
+	const std::string *item = NULL;
+	return _FindItem(name, type, index, &item) == B_OK;
+}
+
+
+int32
+BMessage::GetInt32(const char *name, int32 defaultValue) const
+{
+	int32 value;
+	return FindInt32(name, &value) == B_OK ? value : defaultValue;
+}
+
+
+int64
+BMessage::GetInt64(const char *name, int64 defaultValue) const
+{
+	int64 value;
+	return FindInt64(name, &value) == B_OK ? value : defaultValue;
+}
+
+
+float
+BMessage::GetFloat(const char *name, float defaultValue) const
+{
+	float value;
+	return FindFloat(name, &value) == B_OK ? value : defaultValue;
+}
+
+
+bool
+BMessage::GetBool(const char *name, bool defaultValue) const
+{
+	bool value;
+	return FindBool(name, &value) == B_OK ? value : defaultValue;
+}
+
+
+const char*
+BMessage::GetString(const char *name, const char *defaultValue) const
+{
+	const char *value;
+	return FindString(name, &value) == B_OK ? value : defaultValue;
+}
@@ -0,0 +1,240 @@
+/*
+	Message.h: Headless stand-in for BMessage.
+
+	Fields are kept as typed byte blobs; nested messages and flattenables
+	are stored in their flattened form, just like the real thing.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_MESSAGE_H_
+#define HEADLESS_MESSAGE_H_
+
+#include <Rect.h>
+#include <Flattenable.h>
+
+#include <string>
+#include <vector>
+
+class BHandler;
+class BLooper;
+class BMessenger;
+class BString;
+struct entry_ref;
+
+enum {
+	B_NO_SPECIFIER = 0,
+	B_DIRECT_SPECIFIER = 1,
+	B_INDEX_SPECIFIER,
+	B_REVERSE_INDEX_SPECIFIER,
+	B_RANGE_SPECIFIER,
+	B_REVERSE_RANGE_SPECIFIER,
+	B_NAME_SPECIFIER,
+	B_ID_SPECIFIER,
+
+	B_SPECIFIERS_END = 128
+};
+
+class BMessage {
+public:
+			uint32			what;
+
+							BMessage();
+							BMessage(uint32 what);
+							BMessage(const BMessage &other);
+	virtual					~BMessage();
+
+			BMessage&		operator=(const BMessage &other);
+
+			status_t		GetInfo(const char *name, type_code *typeFound,
+								int32 *countFound = NULL) const;
+			status_t		GetInfo(type_code type, int32 index,
+								char **nameFound, type_code *typeFound,
+								int32 *countFound = NULL) const;
+			int32			CountNames(type_code type) const;
+			bool			IsEmpty() const { return fFields.empty(); }
+			bool			HasSameData(const BMessage &other) const;
+			status_t		MakeEmpty();
+			status_t		RemoveName(const char *name);
+			status_t		RemoveData(const char *name, int32 index = 0);
+
+			void			PrintToStream() const;
+
+	// replies
+			status_t		SendReply(uint32 command, BHandler *replyTo = NULL);
+			status_t		SendReply(BMessage *reply, BHandler *replyTo = NULL,
+								bigtime_t timeout = B_INFINITE_TIMEOUT);
+			bool			IsSourceWaiting() const;
+			bool			WasDropped() const { return false; }
+			bool			IsReply() const { return fIsReply; }
+
+	// scripting
+			status_t		AddSpecifier(const char *property);
+			status_t		AddSpecifier(const char *property, int32 index);
+			status_t		AddSpecifier(const char *property,
+								const char *name);
+			status_t		AddSpecifier(const BMessage *specifier);
+			status_t		SetCurrentSpecifier(int32 index);
+			status_t		GetCurrentSpecifier(int32 *index,
+								BMessage *specifier = NULL, int32 *what = NULL,
+								const char **property = NULL) const;
+			bool			HasSpecifiers() const;
+			status_t		PopSpecifier();
+
+	// flattening
+			ssize_t			FlattenedSize() const;
+			status_t		Flatten(char *buffer, ssize_t size) const;
+			status_t		Unflatten(const char *flatBuffer);
+
+	// adding data
+			status_t		AddData(const char *name, type_code type,
+								const void *data, ssize_t numBytes,
+								bool isFixedSize = true, int32 count = 1);
+			status_t		AddRect(const char *name, BRect rect);
+			status_t		AddPoint(const char *name, BPoint point);
+			status_t		AddString(const char *name, const char *string);
+			status_t		AddString(const char *name, const BString &string);
+			status_t		AddInt8(const char *name, int8 value);
+			status_t		AddUInt8(const char *name, uint8 value);
+			status_t		AddInt16(const char *name, int16 value);
+			status_t		AddUInt16(const char *name, uint16 value);
+			status_t		AddInt32(const char *name, int32 value);
+			status_t		AddUInt32(const char *name, uint32 value);
+			status_t		AddInt64(const char *name, int64 value);
+			status_t		AddUInt64(const char *name, uint64 value);
+			status_t		AddBool(const char *name, bool value);
+			status_t		AddFloat(const char *name, float value);
+			status_t		AddDouble(const char *name, double value);
+			status_t		AddPointer(const char *name, const void *pointer);
+			status_t		AddMessenger(const char *name,
+								BMessenger messenger);
+			status_t		AddRef(const char *name, const entry_ref *ref);
+			status_t		AddMessage(const char *name,
+								const BMessage *message);
+			status_t		AddFlat(const char *name, BFlattenable *object,
+								int32 count = 1);
+
+	// finding data
+			status_t		FindData(const char *name, type_code type,
+								int32 index, const void **data,
+								ssize_t *numBytes) const;
+			status_t		FindData(const char *name, type_code type,
+								const void **data, ssize_t *numBytes) const;
+			status_t		FindRect(const char *name, BRect *rect) const;
+			status_t		FindRect(const char *name, int32 index,
+								BRect *rect) const;
+			status_t		FindPoint(const char *name, BPoint *point) const;
+			status_t		FindRef(const char *name, entry_ref *ref) const;
+			status_t		FindRef(const char *name, int32 index,
+								entry_ref *ref) const;
+			status_t		FindPoint(const char *name, int32 index,
+								BPoint *point) const;
+			status_t		FindString(const char *name,
+								const char **string) const;
+			status_t		FindString(const char *name, int32 index,
+								const char **string) const;
+			status_t		FindString(const char *name,
+								BString *string) const;
+			status_t		FindString(const char *name, int32 index,
+								BString *string) const;
+			status_t		FindInt8(const char *name, int8 *value) const;
+			status_t		FindInt8(const char *name, int32 index,
+								int8 *value) const;
+			status_t		FindUInt8(const char *name, uint8 *value) const;
+			status_t		FindInt16(const char *name, int16 *value) const;
+			status_t		FindUInt16(const char *name, uint16 *value) const;
+			status_t		FindInt32(const char *name, int32 *value) const;
+			status_t		FindInt32(const char *name, int32 index,
+								int32 *value) const;
+			status_t		FindUInt32(const char *name, uint32 *value) const;
+			status_t		FindUInt32(const char *name, int32 index,
+								uint32 *value) const;
+			status_t		FindInt64(const char *name, int64 *value) const;
+			status_t		FindInt64(const char *name, int32 index,
+								int64 *value) const;
+			status_t		FindUInt64(const char *name, uint64 *value) const;
+			status_t		FindUInt64(const char *name, int32 index,
+								uint64 *value) const;
+			status_t		FindBool(const char *name, bool *value) const;
+			status_t		FindBool(const char *name, int32 index,
+								bool *value) const;
+			status_t		FindFloat(const char *name, float *value) const;
+			status_t		FindFloat(const char *name, int32 index,
+								float *value) const;
+			status_t		FindDouble(const char *name, double *value) const;
+			status_t		FindPointer(const char *name,
+								void **pointer) const;
+			status_t		FindPointer(const char *name, int32 index,
+								void **pointer) const;
+			status_t		FindMessenger(const char *name,
+								BMessenger *messenger) const;
+			status_t		FindMessage(const char *name,
+								BMessage *message) const;
+			status_t		FindMessage(const char *name, int32 index,
+								BMessage *message) const;
+			status_t		FindFlat(const char *name,
+								BFlattenable *object) const;
+			status_t		FindFlat(const char *name, int32 index,
+								BFlattenable *object) const;
+
+	// replacing data
+			status_t		ReplaceData(const char *name, type_code type,
+								int32 index, const void *data,
+								ssize_t numBytes);
+			status_t		ReplaceInt32(const char *name, int32 value);
+			status_t		ReplaceInt32(const char *name, int32 index,
+								int32 value);
+			status_t		ReplaceInt64(const char *name, int64 value);
+			status_t		ReplaceFloat(const char *name, float value);
+			status_t		ReplaceString(const char *name,
+								const char *string);
+
+	// convenience
+			bool			HasData(const char *name, type_code type,
+								int32 index = 0) const;
+			bool			HasInt32(const char *name, int32 index = 0) const
+								{ return HasData(name, B_INT32_TYPE, index); }
+			bool			HasPoint(const char *name, int32 index = 0) const
+								{ return HasData(name, B_POINT_TYPE, index); }
+			bool			HasMessage(const char *name,
+								int32 index = 0) const
+								{ return HasData(name, B_MESSAGE_TYPE, index); }
+
+			int32			GetInt32(const char *name,
+								int32 defaultValue) const;
+			int64			GetInt64(const char *name,
+								int64 defaultValue) const;
+			float			GetFloat(const char *name,
+								float defaultValue) const;
+			bool			GetBool(const char *name,
+								bool defaultValue) const;
+			const char*		GetString(const char *name,
+								const char *defaultValue) const;
+
+private:
+	friend class BLooper;
+	friend class BMessenger;
+	friend class BWindow;
+
+	struct Field {
+		std::string				name;
+		type_code				type;
+		std::vector<std::string> items;
+	};
+
+			Field*			_FindField(const char *name, type_code type,
+								status_t *error) const;
+			status_t		_FindItem(const char *name, type_code type,
+								int32 index, const std::string **item) const;
+
+			std::vector<Field> fFields;
+
+	// delivery information, filled in by the looper and messenger
+			BHandler*		fTarget;
+			bool			fPreferredTarget;
+			BHandler*		fReplyHandler;
+			BMessage*		fReplyMessage;
+			bool			fIsReply;
+			int32			fCurrentSpecifier;
+	mutable	BMessage*		fSpecifierCache;
+};
+
+#endif
@@ -0,0 +1,40 @@
+/*
+	MessageQueue.h: Headless stand-in for BMessageQueue.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_MESSAGE_QUEUE_H_
+#define HEADLESS_MESSAGE_QUEUE_H_
+
+#include <Locker.h>
+
+#include <deque>
+
+class BMessage;
+
+class BMessageQueue {
+public:
+							BMessageQueue();
+	virtual					~BMessageQueue();
+
+			void			AddMessage(BMessage *message);
+			void			RemoveMessage(BMessage *message);
+
+			int32			CountMessages() const;
+			bool			IsEmpty() const;
+
+			BMessage*		FindMessage(int32 index) const;
+			BMessage*		FindMessage(uint32 what, int32 index = 0) const;
+
+			bool			Lock();
+			void			Unlock();
+			bool			IsLocked() const;
+
+			BMessage*		NextMessage();
+			bool			IsNextMessage(const BMessage *message) const;
+
+private:
+	mutable	BLocker			fLocker;
+			std::deque<BMessage*> fMessages;
+};
+
+#endif
@@ -0,0 +1,46 @@
+/*
+	MessageRunner.h: Headless stand-in for BMessageRunner.
+
+	Runners fire from BLooper::DispatchPendingMessages() of the looper
+	they target, so headless loopers need to be pumped.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_MESSAGE_RUNNER_H_
+#define HEADLESS_MESSAGE_RUNNER_H_
+
+#include <Messenger.h>
+
+class BMessageRunner {
+public:
+							BMessageRunner(BMessenger target,
+								const BMessage *message, bigtime_t interval,
+								int32 count = -1);
+							BMessageRunner(BMessenger target,
+								const BMessage &message, bigtime_t interval,
+								int32 count = -1);
+	virtual					~BMessageRunner();
+
+			status_t		InitCheck() const;
+
+			status_t		SetInterval(bigtime_t interval);
+			status_t		SetCount(int32 count);
+			status_t		GetInfo(bigtime_t *interval, int32 *count) const;
+
+	// headless: posts all messages that are due, returns the number posted
+	static	int32			FireDue(BLooper *looper, bigtime_t now);
+	// headless: the earliest time a runner targeting looper is due, or
+	// B_INFINITE_TIMEOUT
+	static	bigtime_t		NextDue(BLooper *looper);
+
+private:
+			void			_Init(BMessenger target, const BMessage &message,
+								bigtime_t interval, int32 count);
+
+			BMessenger		fTarget;
+			BMessage		fMessage;
+			bigtime_t		fInterval;
+			bigtime_t		fNextTime;
+			int32			fCount;
+};
+
+#endif
@@ -0,0 +1,310 @@
+/*
+	Messenger.cpp: Headless BMessenger and BMessageRunner.
+	Released under the MIT license.
+*/
+#include <Messenger.h>
+
+#include <AppDefs.h>
+#include <Autolock.h>
+#include <Handler.h>
+#include <Looper.h>
+#include <MessageRunner.h>
+
+#include <vector>
+
+
+BMessenger::BMessenger()
+	:
+	fHandler(NULL),
+	fLooper(NULL)
+{
+}
+
+
+BMessenger::BMessenger(const BHandler *handler, const BLooper *looper,
+	status_t *result)
+	:
+	fHandler(NULL),
+	fLooper(NULL)
+{
+	status_t status = SetTo(handler, looper);
+	if (result != NULL)
+		*result = status;
+}
+
+
+BMessenger::BMessenger(const BMessenger &other)
+	:
+	fHandler(other.fHandler),
+	fLooper(other.fLooper)
+{
+}
+
+
+BMessenger::~BMessenger()
+{
+}
+
+
+BMessenger&
+BMessenger::operator=(const BMessenger &other)
+{
+	fHandler = other.fHandler;
+	fLooper = other.fLooper;
+	return *this;
+}
+
+
+bool
+BMessenger::operator==(const BMessenger &other) const
+{
+	return fHandler == other.fHandler && fLooper == other.fLooper;
+}
+
+
+status_t
+BMessenger::SetTo(const BHandler *handler, const BLooper *looper)
+{
+	fHandler = NULL;
+	fLooper = NULL;
+
+	if (handler != NULL) {
+		BLooper *handlerLooper = handler->Looper();
+		if (handlerLooper == NULL
+			|| (looper != NULL && looper != handlerLooper))
+			return B_MISMATCHED_VALUES;
+		fHandler = const_cast<BHandler*>(handler);
+		fLooper = handlerLooper;
+		return B_OK;
+	}
+
+	if (looper == NULL)
+		return B_BAD_VALUE;
+
+	// no handler means the looper's preferred handler
+	fLooper = const_cast<BLooper*>(looper);
+	return B_OK;
+}
+
+
+BHandler*
+BMessenger::Target(BLooper **looper) const
+{
+	if (looper != NULL)
+		*looper = fLooper;
+	return fHandler;
+}
+
+
+bool
+BMessenger::LockTarget() const
+{
+	return IsValid() && fLooper->Lock();
+}
+
+
+status_t
+BMessenger::LockTargetWithTimeout(bigtime_t timeout) const
+{
+	if (!IsValid())
+		return B_BAD_PORT_ID;
+	return fLooper->LockWithTimeout(timeout);
+}
+
+
+status_t
+BMessenger::SendMessage(uint32 command, BHandler *replyTo) const
+{
+	BMessage message(command);
+	return SendMessage(&message, replyTo);
+}
+
+
+status_t
+BMessenger::SendMessage(BMessage *message, BHandler *replyTo,
+	bigtime_t timeout) const
+{
+	if (message == NULL)
+		return B_BAD_VALUE;
+	if (!IsValid())
+		return B_BAD_PORT_ID;
+
+	return fLooper->PostMessage(message, fHandler, replyTo);
+}
+
+
+status_t
+BMessenger::SendMessage(BMessage *message, BMessage *reply,
+	bigtime_t deliveryTimeout, bigtime_t replyTimeout) const
+{
+	if (message == NULL || reply == NULL)
+		return B_BAD_VALUE;
+	if (!IsValid())
+		return B_BAD_PORT_ID;
+
+	// Nobody runs the target looper for us, so a synchronous message is
+	// dispatched right here, ahead of whatever is queued, under the lock
+	// of the target looper.
+	if (fLooper->LockWithTimeout(deliveryTimeout) != B_OK)
+		return B_TIMED_OUT;
+
+	reply->MakeEmpty();
+	reply->what = B_NO_REPLY;
+
+	BMessage *copy = new BMessage(*message);
+	copy->fTarget = fHandler;
+	copy->fPreferredTarget = fHandler == NULL;
+	copy->fReplyMessage = reply;
+	fLooper->_Dispatch(copy);
+
+	fLooper->Unlock();
+	return B_OK;
+}
+
+
+bool
+BMessenger::IsValid() const
+{
+	if (fLooper == NULL || !BHandler::IsAlive(fLooper))
+		return false;
+	return fHandler == NULL
+		|| (BHandler::IsAlive(fHandler) && fHandler->Looper() == fLooper);
+}
+
+
+//	#pragma mark - BMessageRunner
+
+
+namespace {
+
+typedef std::vector<BMessageRunner*> runner_list;
+
+BLocker sRunnerLock("message runners");
+runner_list sRunners;
+
+}	// namespace
+
+
+BMessageRunner::BMessageRunner(BMessenger target, const BMessage *message,
+	bigtime_t interval, int32 count)
+{
+	_Init(target, message != NULL ? *message : BMessage(), interval, count);
+}
+
+
+BMessageRunner::BMessageRunner(BMessenger target, const BMessage &message,
+	bigtime_t interval, int32 count)
+{
+	_Init(target, message, interval, count);
+}
+
+
+BMessageRunner::~BMessageRunner()
+{
+	BAutolock locker(sRunnerLock);
+	for (runner_list::iterator i = sRunners.begin(); i != sRunners.end(); i++) {
+		if (*i == this) {
+			sRunners.erase(i);
+			break;
+		}
+	}
+}
+
+
+void
+BMessageRunner::_Init(BMessenger target, const BMessage &message,
+	bigtime_t interval, int32 count)
+{
+	fTarget = target;
+	fMessage = message;
+	fInterval = interval;
+	fNextTime = system_time() + interval;
+	fCount = count;
+
+	BAutolock locker(sRunnerLock);
+	sRunners.push_back(this);
+}
+
+
+status_t
+BMessageRunner::InitCheck() const
+{
+	return fTarget.IsValid() && fInterval > 0 ? B_OK : B_BAD_VALUE;
+}
+
+
+status_t
+BMessageRunner::SetInterval(bigtime_t interval)
+{
+	BAutolock locker(sRunnerLock);
+	fInterval = interval;
+	fNextTime = system_time() + interval;
+	return B_OK;
+}
+
+
+status_t
+BMessageRunner::SetCount(int32 count)
+{
+	BAutolock locker(sRunnerLock);
+	fCount = count;
+	return B_OK;
+}
+
+
+status_t
+BMessageRunner::GetInfo(bigtime_t *interval, int32 *count) const
+{
+	if (interval != NULL)
+		*interval = fInterval;
+	if (count != NULL)
+		*count = fCount;
+	return B_OK;
+}
+
+
+int32
+BMessageRunner::FireDue(BLooper *looper, bigtime_t now)
+{
+	BAutolock locker(sRunnerLock);
+
+	int32 posted = 0;
+	for (size_t i = 0; i < sRunners.size(); i++) {
+		BMessageRunner *runner = sRunners[i];
+		BLooper *target;
+		runner->fTarget.Target(&target);
+		if (target != looper || runner->fCount == 0 || runner->fInterval <= 0
+			|| runner->fNextTime > now)
+			continue;
+
+		// A late runner delivers once and picks up its rhythm from now on,
+		// the way the registrar drops ticks nobody was there to receive.
+		runner->fTarget.SendMessage(&runner->fMessage);
+		posted++;
+
+		if (runner->fCount > 0)
+			runner->fCount--;
+		runner->fNextTime += runner->fInterval;
+		if (runner->fNextTime <= now)
+			runner->fNextTime = now + runner->fInterval;
+	}
+	return posted;
+}
+
+
+bigtime_t
+BMessageRunner::NextDue(BLooper *looper)
+{
+	BAutolock locker(sRunnerLock);
+
+	bigtime_t next = B_INFINITE_TIMEOUT;
+	for (size_t i = 0; i < sRunners.size(); i++) {
+		BMessageRunner *runner = sRunners[i];
+		BLooper *target;
+		runner->fTarget.Target(&target);
+		if (target == looper && runner->fCount != 0 && runner->fInterval > 0
+			&& runner->fNextTime < next)
+			next = runner->fNextTime;
+	}
+	return next;
+}
@@ -0,0 +1,50 @@
+/*
+	Messenger.h: Headless stand-in for BMessenger.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_MESSENGER_H_
+#define HEADLESS_MESSENGER_H_
+
+#include <Message.h>
+
+class BHandler;
+class BLooper;
+
+class BMessenger {
+public:
+							BMessenger();
+							BMessenger(const BHandler *handler,
+								const BLooper *looper = NULL,
+								status_t *result = NULL);
+							BMessenger(const BMessenger &other);
+							~BMessenger();
+
+			BMessenger&		operator=(const BMessenger &other);
+			bool			operator==(const BMessenger &other) const;
+
+			bool			IsTargetLocal() const { return true; }
+			BHandler*		Target(BLooper **looper) const;
+			bool			LockTarget() const;
+			status_t		LockTargetWithTimeout(bigtime_t timeout) const;
+
+			status_t		SendMessage(uint32 command,
+								BHandler *replyTo = NULL) const;
+			status_t		SendMessage(BMessage *message,
+								BHandler *replyTo = NULL,
+								bigtime_t timeout = B_INFINITE_TIMEOUT) const;
+			status_t		SendMessage(BMessage *message,
+								BMessage *reply,
+								bigtime_t deliveryTimeout = B_INFINITE_TIMEOUT,
+								bigtime_t replyTimeout = B_INFINITE_TIMEOUT)
+								const;
+
+			status_t		SetTo(const BHandler *handler,
+								const BLooper *looper = NULL);
+			bool			IsValid() const;
+
+private:
+			BHandler*		fHandler;
+			BLooper*		fLooper;
+};
+
+#endif
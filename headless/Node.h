@@ -0,0 +1,23 @@
+/*
+	Node.h: Headless stand-in for node_ref.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_NODE_H_
+#define HEADLESS_NODE_H_
+
+#include <SupportDefs.h>
+
+struct node_ref {
+	node_ref() : device(-1), node(-1) {}
+	node_ref(dev_t device, ino_t node) : device(device), node(node) {}
+
+	bool operator==(const node_ref &other) const
+		{ return device == other.device && node == other.node; }
+	bool operator!=(const node_ref &other) const
+		{ return !(*this == other); }
+
+	dev_t	device;
+	ino_t	node;
+};
+
+#endif
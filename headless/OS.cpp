@@ -0,0 +1,534 @@
+/*
+	OS.cpp: Headless kernel kit: threads, semaphores and time on pthreads.
+	Released under the MIT license.
+*/
+#include <OS.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+
+namespace {
+
+/*
+	Haiku threads are created suspended and only start running once they
+	are resumed, so spawn_thread() just files the function away and
+	resume_thread() starts the pthread. Threads run detached; whoever waits
+	for one blocks on its entry until the thread function returns, exits
+	or is killed.
+*/
+struct thread_entry {
+	thread_id		id;
+	std::string		name;
+	thread_func		function;
+	void			*data;
+	int32			priority;
+	pthread_t		thread;
+	bool			started;
+	bool			exited;
+	status_t		result;
+	int32			waiters;
+	pthread_cond_t	exitCondition;
+};
+
+typedef std::map<thread_id, thread_entry*> thread_map;
+
+pthread_mutex_t sThreadLock = PTHREAD_MUTEX_INITIALIZER;
+thread_map sThreads;
+thread_id sNextThreadID = 1;
+
+__thread thread_id sCurrentThread = 0;
+__thread thread_entry *sCurrentEntry = NULL;
+
+
+// Marks the entry of the running thread as exited when the thread function
+// returns, and also when the thread unwinds from exit_thread() or a
+// kill_thread() cancellation.
+class thread_exit_marker {
+public:
+	thread_exit_marker(thread_entry *entry)
+		:
+		fEntry(entry)
+	{
+	}
+
+	~thread_exit_marker()
+	{
+		pthread_mutex_lock(&sThreadLock);
+		fEntry->exited = true;
+		sThreads.erase(fEntry->id);
+		if (fEntry->waiters > 0)
+			pthread_cond_broadcast(&fEntry->exitCondition);
+		else {
+			pthread_cond_destroy(&fEntry->exitCondition);
+			delete fEntry;
+		}
+		pthread_mutex_unlock(&sThreadLock);
+	}
+
+private:
+	thread_entry	*fEntry;
+};
+
+
+void*
+thread_trampoline(void *data)
+{
+	thread_entry *entry = (thread_entry*)data;
+	sCurrentThread = entry->id;
+	sCurrentEntry = entry;
+
+	thread_exit_marker marker(entry);
+	entry->result = entry->function(entry->data);
+	return NULL;
+}
+
+
+struct semaphore {
+	pthread_cond_t	condition;
+	int32			count;
+	int32			waiters;
+	bool			deleted;
+	std::string		name;
+};
+
+typedef std::map<sem_id, semaphore*> sem_map;
+
+pthread_mutex_t sSemLock = PTHREAD_MUTEX_INITIALIZER;
+sem_map sSemaphores;
+sem_id sNextSemID = 1;
+
+
+void
+absolute_timespec(bigtime_t timeout, struct timespec *spec)
+{
+	clock_gettime(CLOCK_MONOTONIC, spec);
+	bigtime_t nanos = spec->tv_nsec + (timeout % 1000000) * 1000;
+	spec->tv_sec += timeout / 1000000 + nanos / 1000000000;
+	spec->tv_nsec = nanos % 1000000000;
+}
+
+
+void
+init_monotonic_condition(pthread_cond_t *condition)
+{
+	pthread_condattr_t attributes;
+	pthread_condattr_init(&attributes);
+	pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+	pthread_cond_init(condition, &attributes);
+	pthread_condattr_destroy(&attributes);
+}
+
+}	// namespace
+
+
+thread_id
+spawn_thread(thread_func function, const char *name, int32 priority,
+	void *data)
+{
+	if (function == NULL)
+		return B_BAD_VALUE;
+
+	thread_entry *entry = new thread_entry;
+	entry->name = name != NULL ? name : "unnamed thread";
+	entry->function = function;
+	entry->data = data;
+	entry->priority = priority;
+	entry->started = false;
+	entry->exited = false;
+	entry->result = B_OK;
+	entry->waiters = 0;
+	pthread_cond_init(&entry->exitCondition, NULL);
+
+	pthread_mutex_lock(&sThreadLock);
+	entry->id = sNextThreadID++;
+	sThreads[entry->id] = entry;
+	pthread_mutex_unlock(&sThreadLock);
+
+	return entry->id;
+}
+
+
+status_t
+resume_thread(thread_id thread)
+{
+	pthread_mutex_lock(&sThreadLock);
+	thread_map::iterator found = sThreads.find(thread);
+	if (found == sThreads.end()) {
+		pthread_mutex_unlock(&sThreadLock);
+		return B_BAD_THREAD_ID;
+	}
+
+	thread_entry *entry = found->second;
+	status_t status = B_OK;
+	if (!entry->started) {
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+		pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+		if (pthread_create(&entry->thread, &attributes, thread_trampoline,
+				entry) == 0)
+			entry->started = true;
+		else
+			status = B_NO_MEMORY;
+		pthread_attr_destroy(&attributes);
+	}
+	pthread_mutex_unlock(&sThreadLock);
+	return status;
+}
+
+
+status_t
+kill_thread(thread_id thread)
+{
+	pthread_mutex_lock(&sThreadLock);
+	thread_map::iterator found = sThreads.find(thread);
+	if (found == sThreads.end()) {
+		pthread_mutex_unlock(&sThreadLock);
+		return B_BAD_THREAD_ID;
+	}
+
+	thread_entry *entry = found->second;
+	if (!entry->started) {
+		// never ran, so there is nothing to unwind
+		sThreads.erase(found);
+		pthread_cond_destroy(&entry->exitCondition);
+		delete entry;
+	} else if (pthread_equal(entry->thread, pthread_self())) {
+		pthread_mutex_unlock(&sThreadLock);
+		exit_thread(B_OK);
+	} else {
+		// The thread goes away the next time it snoozes. Waiting for a
+		// semaphore or a lock is not a cancellation point here, so a
+		// killed thread never leaves one of those locked.
+		entry->result = B_INTERRUPTED;
+		pthread_cancel(entry->thread);
+	}
+	pthread_mutex_unlock(&sThreadLock);
+	return B_OK;
+}
+
+
+status_t
+wait_for_thread(thread_id thread, status_t *returnValue)
+{
+	pthread_mutex_lock(&sThreadLock);
+	thread_map::iterator found = sThreads.find(thread);
+	if (found == sThreads.end()) {
+		pthread_mutex_unlock(&sThreadLock);
+		return B_BAD_THREAD_ID;
+	}
+
+	thread_entry *entry = found->second;
+	if (!entry->started) {
+		pthread_mutex_unlock(&sThreadLock);
+		resume_thread(thread);
+		pthread_mutex_lock(&sThreadLock);
+	}
+
+	entry->waiters++;
+	while (!entry->exited)
+		pthread_cond_wait(&entry->exitCondition, &sThreadLock);
+
+	status_t result = entry->result;
+	if (--entry->waiters == 0) {
+		pthread_cond_destroy(&entry->exitCondition);
+		delete entry;
+	}
+	pthread_mutex_unlock(&sThreadLock);
+
+	if (returnValue != NULL)
+		*returnValue = result;
+	return B_OK;
+}
+
+
+thread_id
+find_thread(const char *name)
+{
+	if (name == NULL) {
+		if (sCurrentThread == 0) {
+			// threads we did not spawn, like main(), get an ID when they
+			// first ask for it
+			pthread_mutex_lock(&sThreadLock);
+			sCurrentThread = sNextThreadID++;
+			pthread_mutex_unlock(&sThreadLock);
+		}
+		return sCurrentThread;
+	}
+
+	thread_id thread = B_NAME_NOT_FOUND;
+	pthread_mutex_lock(&sThreadLock);
+	for (thread_map::iterator i = sThreads.begin(); i != sThreads.end(); i++) {
+		if (i->second->name == name) {
+			thread = i->first;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&sThreadLock);
+	return thread;
+}
+
+
+// Only remembered: all pthreads run at the same priority here. Returns the
+// previous priority, like the real one.
+status_t
+set_thread_priority(thread_id thread, int32 newPriority)
+{
+	pthread_mutex_lock(&sThreadLock);
+	thread_map::iterator found = sThreads.find(thread);
+	if (found == sThreads.end()) {
+		pthread_mutex_unlock(&sThreadLock);
+		return B_BAD_THREAD_ID;
+	}
+
+	int32 previous = found->second->priority;
+	found->second->priority = newPriority;
+	pthread_mutex_unlock(&sThreadLock);
+	return previous;
+}
+
+
+void
+exit_thread(status_t status)
+{
+	if (sCurrentEntry != NULL)
+		sCurrentEntry->result = status;
+	pthread_exit(NULL);
+}
+
+
+status_t
+snooze(bigtime_t amount)
+{
+	if (amount <= 0)
+		return B_OK;
+
+	struct timespec spec;
+	spec.tv_sec = amount / 1000000;
+	spec.tv_nsec = (amount % 1000000) * 1000;
+	while (nanosleep(&spec, &spec) != 0 && errno == EINTR)
+		;
+	return B_OK;
+}
+
+
+status_t
+snooze_until(bigtime_t time, int timeBase)
+{
+	return snooze(time - system_time());
+}
+
+
+bigtime_t
+system_time(void)
+{
+	struct timespec spec;
+	clock_gettime(CLOCK_MONOTONIC, &spec);
+	return (bigtime_t)spec.tv_sec * 1000000 + spec.tv_nsec / 1000;
+}
+
+
+status_t
+get_system_info(system_info *info)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	info->cpu_count = count > 0 ? (uint32)count : 1;
+	return B_OK;
+}
+
+
+void
+debugger(const char *message)
+{
+	fprintf(stderr, "debugger: %s\n", message);
+	abort();
+}
+
+
+sem_id
+create_sem(int32 count, const char *name)
+{
+	if (count < 0)
+		return B_BAD_VALUE;
+
+	semaphore *sem = new semaphore;
+	init_monotonic_condition(&sem->condition);
+	sem->count = count;
+	sem->waiters = 0;
+	sem->deleted = false;
+	sem->name = name != NULL ? name : "unnamed semaphore";
+
+	pthread_mutex_lock(&sSemLock);
+	sem_id id = sNextSemID++;
+	sSemaphores[id] = sem;
+	pthread_mutex_unlock(&sSemLock);
+	return id;
+}
+
+
+status_t
+delete_sem(sem_id id)
+{
+	pthread_mutex_lock(&sSemLock);
+	sem_map::iterator found = sSemaphores.find(id);
+	if (found == sSemaphores.end()) {
+		pthread_mutex_unlock(&sSemLock);
+		return B_BAD_SEM_ID;
+	}
+
+	semaphore *sem = found->second;
+	sSemaphores.erase(found);
+	if (sem->waiters > 0) {
+		// the last waiter to wake up frees it
+		sem->deleted = true;
+		pthread_cond_broadcast(&sem->condition);
+	} else {
+		pthread_cond_destroy(&sem->condition);
+		delete sem;
+	}
+	pthread_mutex_unlock(&sSemLock);
+	return B_OK;
+}
+
+
+status_t
+acquire_sem(sem_id id)
+{
+	return acquire_sem_etc(id, 1, 0, B_INFINITE_TIMEOUT);
+}
+
+
+status_t
+acquire_sem_etc(sem_id id, int32 count, uint32 flags, bigtime_t timeout)
+{
+	if (count <= 0)
+		return B_BAD_VALUE;
+
+	int cancelState;
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+	pthread_mutex_lock(&sSemLock);
+	sem_map::iterator found = sSemaphores.find(id);
+	if (found == sSemaphores.end()) {
+		pthread_mutex_unlock(&sSemLock);
+		pthread_setcancelstate(cancelState, NULL);
+		return B_BAD_SEM_ID;
+	}
+
+	semaphore *sem = found->second;
+	bool timed = (flags & (B_RELATIVE_TIMEOUT | B_ABSOLUTE_TIMEOUT)) != 0
+		&& timeout != B_INFINITE_TIMEOUT;
+	if (timed && timeout <= 0 && (flags & B_RELATIVE_TIMEOUT) != 0
+		&& sem->count < count) {
+		pthread_mutex_unlock(&sSemLock);
+		pthread_setcancelstate(cancelState, NULL);
+		return B_WOULD_BLOCK;
+	}
+
+	struct timespec deadline;
+	if (timed) {
+		absolute_timespec((flags & B_ABSOLUTE_TIMEOUT) != 0
+			? timeout - system_time() : timeout, &deadline);
+	}
+
+	status_t status = B_OK;
+	sem->waiters++;
+	while (sem->count < count && !sem->deleted) {
+		if (!timed)
+			pthread_cond_wait(&sem->condition, &sSemLock);
+		else if (pthread_cond_timedwait(&sem->condition, &sSemLock,
+				&deadline) == ETIMEDOUT) {
+			status = B_TIMED_OUT;
+			break;
+		}
+	}
+	sem->waiters--;
+
+	if (sem->deleted) {
+		status = B_BAD_SEM_ID;
+		if (sem->waiters == 0) {
+			pthread_cond_destroy(&sem->condition);
+			delete sem;
+		}
+	} else if (status == B_OK)
+		sem->count -= count;
+
+	pthread_mutex_unlock(&sSemLock);
+	pthread_setcancelstate(cancelState, NULL);
+	return status;
+}
+
+
+status_t
+release_sem(sem_id id)
+{
+	return release_sem_etc(id, 1, 0);
+}
+
+
+status_t
+release_sem_etc(sem_id id, int32 count, uint32 flags)
+{
+	if (count <= 0)
+		return B_BAD_VALUE;
+
+	pthread_mutex_lock(&sSemLock);
+	sem_map::iterator found = sSemaphores.find(id);
+	if (found == sSemaphores.end()) {
+		pthread_mutex_unlock(&sSemLock);
+		return B_BAD_SEM_ID;
+	}
+
+	semaphore *sem = found->second;
+	sem->count += count;
+	if (sem->waiters > 0)
+		pthread_cond_broadcast(&sem->condition);
+	pthread_mutex_unlock(&sSemLock);
+	return B_OK;
+}
+
+
+int32
+atomic_add(int32 *value, int32 addValue)
+{
+	return __sync_fetch_and_add(value, addValue);
+}
+
+
+int32
+atomic_get(int32 *value)
+{
+	return __sync_fetch_and_add(value, 0);
+}
+
+
+int32
+atomic_set(int32 *value, int32 newValue)
+{
+	return __sync_lock_test_and_set(value, newValue);
+}
+
+
+int64
+atomic_add64(int64 *value, int64 addValue)
+{
+	return __sync_fetch_and_add(value, addValue);
+}
+
+
+int64
+atomic_get64(int64 *value)
+{
+	return __sync_fetch_and_add(value, 0);
+}
+
+
+int64
+atomic_set64(int64 *value, int64 newValue)
+{
+	return __sync_lock_test_and_set(value, newValue);
+}
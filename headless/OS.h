@@ -0,0 +1,61 @@
+/*
+	OS.h: Headless stand-in for the Haiku kernel kit, backed by pthreads.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_OS_H_
+#define HEADLESS_OS_H_
+
+#include <SupportDefs.h>
+
+typedef int32		thread_id;
+typedef int32		sem_id;
+
+typedef status_t	(*thread_func)(void *);
+
+enum {
+	B_LOW_PRIORITY					= 5,
+	B_NORMAL_PRIORITY				= 10,
+	B_DISPLAY_PRIORITY				= 15,
+	B_URGENT_DISPLAY_PRIORITY		= 20,
+	B_REAL_TIME_DISPLAY_PRIORITY	= 100,
+	B_URGENT_PRIORITY				= 110,
+	B_REAL_TIME_PRIORITY			= 120
+};
+
+enum {
+	B_RELATIVE_TIMEOUT	= 0x8,
+	B_ABSOLUTE_TIMEOUT	= 0x10
+};
+
+#define B_OS_NAME_LENGTH	32
+
+// only what the spinner code asks for
+typedef struct {
+	uint32		cpu_count;
+} system_info;
+
+thread_id	spawn_thread(thread_func function, const char *name,
+				int32 priority, void *data);
+status_t	resume_thread(thread_id thread);
+status_t	kill_thread(thread_id thread);
+status_t	wait_for_thread(thread_id thread, status_t *returnValue);
+thread_id	find_thread(const char *name);
+status_t	set_thread_priority(thread_id thread, int32 newPriority);
+void		exit_thread(status_t status);
+status_t	snooze(bigtime_t amount);
+status_t	snooze_until(bigtime_t time, int timeBase);
+bigtime_t	system_time(void);
+status_t	get_system_info(system_info *info);
+void		debugger(const char *message);
+
+sem_id		create_sem(int32 count, const char *name);
+status_t	delete_sem(sem_id id);
+status_t	acquire_sem(sem_id id);
+status_t	acquire_sem_etc(sem_id id, int32 count, uint32 flags,
+				bigtime_t timeout);
+status_t	release_sem(sem_id id);
+status_t	release_sem_etc(sem_id id, int32 count, uint32 flags);
+
+#define B_SYSTEM_TIMEBASE	0
+
+#endif
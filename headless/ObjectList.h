@@ -0,0 +1,69 @@
+/*
+	ObjectList.h: Headless stand-in for the typed BObjectList.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_OBJECT_LIST_H_
+#define HEADLESS_OBJECT_LIST_H_
+
+#include <List.h>
+
+template<class T>
+class BObjectList {
+public:
+							BObjectList(int32 itemsPerBlock = 20,
+								bool owning = false)
+								:
+								fList(itemsPerBlock),
+								fOwning(owning)
+							{
+							}
+
+							~BObjectList()
+							{
+								if (fOwning)
+									MakeEmpty();
+							}
+
+			bool			AddItem(T *item) { return fList.AddItem(item); }
+			bool			AddItem(T *item, int32 index)
+								{ return fList.AddItem(item, index); }
+			bool			RemoveItem(T *item, bool deleteIfOwning = true)
+								{
+									bool removed = fList.RemoveItem(item);
+									if (removed && fOwning && deleteIfOwning)
+										delete item;
+									return removed;
+								}
+			T*				RemoveItemAt(int32 index)
+								{ return (T*)fList.RemoveItem(index); }
+			void			MakeEmpty(bool deleteIfOwning = true)
+								{
+									if (fOwning && deleteIfOwning) {
+										for (int32 i = 0; i < CountItems(); i++)
+											delete ItemAt(i);
+									}
+									fList.MakeEmpty();
+								}
+
+			T*				ItemAt(int32 index) const
+								{ return (T*)fList.ItemAt(index); }
+			T*				FirstItem() const { return ItemAt(0); }
+			T*				LastItem() const
+								{ return ItemAt(CountItems() - 1); }
+			int32			IndexOf(const T *item) const
+								{ return fList.IndexOf((void*)item); }
+			bool			HasItem(const T *item) const
+								{ return IndexOf(item) >= 0; }
+			int32			CountItems() const { return fList.CountItems(); }
+			bool			IsEmpty() const { return fList.IsEmpty(); }
+			bool			Owning() const { return fOwning; }
+
+private:
+							BObjectList(const BObjectList &);
+			BObjectList&	operator=(const BObjectList &);
+
+			BList			fList;
+			bool			fOwning;
+};
+
+#endif
@@ -0,0 +1,36 @@
+/*
+	Point.h: Headless stand-in for BPoint.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_POINT_H_
+#define HEADLESS_POINT_H_
+
+#include <SupportDefs.h>
+
+class BPoint {
+public:
+	float x;
+	float y;
+
+	BPoint() : x(0), y(0) {}
+	BPoint(float x, float y) : x(x), y(y) {}
+
+	void Set(float newX, float newY) { x = newX; y = newY; }
+
+	BPoint operator+(const BPoint &other) const
+		{ return BPoint(x + other.x, y + other.y); }
+	BPoint operator-(const BPoint &other) const
+		{ return BPoint(x - other.x, y - other.y); }
+	BPoint &operator+=(const BPoint &other)
+		{ x += other.x; y += other.y; return *this; }
+	BPoint &operator-=(const BPoint &other)
+		{ x -= other.x; y -= other.y; return *this; }
+	bool operator==(const BPoint &other) const
+		{ return x == other.x && y == other.y; }
+	bool operator!=(const BPoint &other) const
+		{ return !(*this == other); }
+};
+
+extern const BPoint B_ORIGIN;
+
+#endif
@@ -0,0 +1,127 @@
+/*
+	PropertyInfo.cpp: Headless BPropertyInfo.
+	Released under the MIT license.
+*/
+#include <PropertyInfo.h>
+
+#include <Message.h>
+
+#include <string.h>
+
+namespace {
+
+bool
+list_contains(const uint32 *list, int32 count, uint32 value)
+{
+	// an empty list matches anything
+	if (list[0] == 0)
+		return true;
+
+	for (int32 i = 0; i < count && list[i] != 0; i++) {
+		if (list[i] == value)
+			return true;
+	}
+	return false;
+}
+
+}	// namespace
+
+
+BPropertyInfo::BPropertyInfo(property_info *properties, value_info *values,
+	bool freeOnDelete)
+	:
+	fProperties(properties),
+	fValues(values)
+{
+}
+
+
+BPropertyInfo::~BPropertyInfo()
+{
+}
+
+
+int32
+BPropertyInfo::CountProperties() const
+{
+	int32 count = 0;
+	while (fProperties != NULL && fProperties[count].name != NULL)
+		count++;
+	return count;
+}
+
+
+// Like the real kit, the command only has to match for the first
+// specifier; the ones below it are being resolved, not acted upon.
+int32
+BPropertyInfo::FindMatch(BMessage *message, int32 index, BMessage *specifier,
+	int32 form, const char *property, void *data) const
+{
+	if (property == NULL)
+		return -1;
+
+	for (int32 i = 0; fProperties != NULL && fProperties[i].name != NULL;
+			i++) {
+		const property_info &info = fProperties[i];
+		if (strcmp(info.name, property) != 0)
+			continue;
+
+		if (index == 0 && !list_contains(info.commands, 10, message->what))
+			continue;
+		if (!list_contains(info.specifiers, 10, form))
+			continue;
+
+		if (data != NULL)
+			*(uint32*)data = info.extra_data;
+		return i;
+	}
+	return -1;
+}
+
+
+ssize_t
+BPropertyInfo::FlattenedSize() const
+{
+	ssize_t size = sizeof(int32);
+	for (int32 i = 0; i < CountProperties(); i++) {
+		size += strlen(fProperties[i].name) + 1;
+		size += sizeof(fProperties[i].commands)
+			+ sizeof(fProperties[i].specifiers);
+	}
+	return size;
+}
+
+
+// Only names, commands and specifiers are kept; enough for a scripting
+// client to list what a handler supports.
+status_t
+BPropertyInfo::Flatten(void *buffer, ssize_t size) const
+{
+	if (buffer == NULL || size < FlattenedSize())
+		return B_BAD_VALUE;
+
+	char *out = (char*)buffer;
+	int32 count = CountProperties();
+	memcpy(out, &count, sizeof(count));
+	out += sizeof(count);
+
+	for (int32 i = 0; i < count; i++) {
+		const property_info &info = fProperties[i];
+		size_t nameLength = strlen(info.name) + 1;
+		memcpy(out, info.name, nameLength);
+		out += nameLength;
+		memcpy(out, info.commands, sizeof(info.commands));
+		out += sizeof(info.commands);
+		memcpy(out, info.specifiers, sizeof(info.specifiers));
+		out += sizeof(info.specifiers);
+	}
+	return B_OK;
+}
+
+
+status_t
+BPropertyInfo::Unflatten(type_code code, const void *buffer, ssize_t size)
+{
+	// the property tables handed to us are never ours to replace
+	return B_NOT_ALLOWED;
+}
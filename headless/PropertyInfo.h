@@ -0,0 +1,66 @@
+/*
+	PropertyInfo.h: Headless stand-in for BPropertyInfo.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_PROPERTY_INFO_H_
+#define HEADLESS_PROPERTY_INFO_H_
+
+#include <Flattenable.h>
+
+class BMessage;
+
+struct compound_type {
+	struct field_pair {
+		const char	*name;
+		type_code	type;
+	};
+	field_pair	pairs[5];
+};
+
+struct property_info {
+	const char		*name;
+	uint32			commands[10];
+	uint32			specifiers[10];
+	const char		*usage;
+	uint32			extra_data;
+	uint32			types[10];
+	compound_type	ctypes[3];
+	uint32			_reserved[10];
+};
+
+struct value_info {
+	const char		*name;
+	uint32			value;
+	int32			kind;
+	const char		*usage;
+	uint32			extra_data;
+	uint32			_reserved[10];
+};
+
+class BPropertyInfo : public BFlattenable {
+public:
+							BPropertyInfo(property_info *properties = NULL,
+								value_info *values = NULL,
+								bool freeOnDelete = false);
+	virtual					~BPropertyInfo();
+
+	virtual	int32			FindMatch(BMessage *message, int32 index,
+								BMessage *specifier, int32 form,
+								const char *property, void *data = NULL) const;
+
+	virtual	bool			IsFixedSize() const { return false; }
+	virtual	type_code		TypeCode() const { return B_PROPERTY_INFO_TYPE; }
+	virtual	ssize_t			FlattenedSize() const;
+	virtual	status_t		Flatten(void *buffer, ssize_t size) const;
+	virtual	status_t		Unflatten(type_code code, const void *buffer,
+								ssize_t size);
+
+			const property_info* Properties() const { return fProperties; }
+			int32			CountProperties() const;
+
+private:
+			property_info*	fProperties;
+			value_info*		fValues;
+};
+
+#endif
@@ -0,0 +1,103 @@
+/*
+	Rect.h: Headless stand-in for BRect.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_RECT_H_
+#define HEADLESS_RECT_H_
+
+#include <Point.h>
+#include <Size.h>
+
+#include <algorithm>
+
+class BRect {
+public:
+	float left;
+	float top;
+	float right;
+	float bottom;
+
+	BRect() : left(0), top(0), right(-1), bottom(-1) {}
+	BRect(float l, float t, float r, float b)
+		: left(l), top(t), right(r), bottom(b) {}
+	BRect(BPoint leftTop, BPoint rightBottom)
+		: left(leftTop.x), top(leftTop.y), right(rightBottom.x),
+		  bottom(rightBottom.y) {}
+
+	void Set(float l, float t, float r, float b)
+		{ left = l; top = t; right = r; bottom = b; }
+
+	float Width() const { return right - left; }
+	float Height() const { return bottom - top; }
+	int32 IntegerWidth() const { return (int32)(right - left); }
+	int32 IntegerHeight() const { return (int32)(bottom - top); }
+	BSize Size() const { return BSize(Width(), Height()); }
+
+	BPoint LeftTop() const { return BPoint(left, top); }
+	BPoint RightBottom() const { return BPoint(right, bottom); }
+	BPoint LeftBottom() const { return BPoint(left, bottom); }
+	BPoint RightTop() const { return BPoint(right, top); }
+
+	bool IsValid() const { return left <= right && top <= bottom; }
+
+	bool Contains(BPoint point) const
+		{
+			return point.x >= left && point.x <= right
+				&& point.y >= top && point.y <= bottom;
+		}
+	bool Contains(BRect rect) const
+		{
+			return rect.left >= left && rect.right <= right
+				&& rect.top >= top && rect.bottom <= bottom;
+		}
+	bool Intersects(BRect rect) const
+		{
+			return IsValid() && rect.IsValid()
+				&& std::max(left, rect.left) <= std::min(right, rect.right)
+				&& std::max(top, rect.top) <= std::min(bottom, rect.bottom);
+		}
+
+	BRect &OffsetBy(float dx, float dy)
+		{ left += dx; right += dx; top += dy; bottom += dy; return *this; }
+	BRect &OffsetBy(BPoint delta) { return OffsetBy(delta.x, delta.y); }
+	BRect &OffsetTo(float x, float y)
+		{ return OffsetBy(x - left, y - top); }
+	BRect &OffsetTo(BPoint point) { return OffsetTo(point.x, point.y); }
+	BRect OffsetByCopy(float dx, float dy) const
+		{ BRect copy(*this); return copy.OffsetBy(dx, dy); }
+	BRect OffsetByCopy(BPoint delta) const
+		{ return OffsetByCopy(delta.x, delta.y); }
+	BRect OffsetToCopy(float x, float y) const
+		{ BRect copy(*this); return copy.OffsetTo(x, y); }
+	BRect OffsetToCopy(BPoint point) const
+		{ return OffsetToCopy(point.x, point.y); }
+
+	BRect &InsetBy(float dx, float dy)
+		{ left += dx; right -= dx; top += dy; bottom -= dy; return *this; }
+	BRect InsetByCopy(float dx, float dy) const
+		{ BRect copy(*this); return copy.InsetBy(dx, dy); }
+
+	BRect operator|(BRect other) const
+		{
+			if (!IsValid())
+				return other;
+			if (!other.IsValid())
+				return *this;
+			return BRect(std::min(left, other.left), std::min(top, other.top),
+				std::max(right, other.right), std::max(bottom, other.bottom));
+		}
+	BRect operator&(BRect other) const
+		{
+			return BRect(std::max(left, other.left), std::max(top, other.top),
+				std::min(right, other.right), std::min(bottom, other.bottom));
+		}
+
+	bool operator==(BRect other) const
+		{
+			return left == other.left && top == other.top
+				&& right == other.right && bottom == other.bottom;
+		}
+	bool operator!=(BRect other) const { return !(*this == other); }
+};
+
+#endif
@@ -0,0 +1,23 @@
+/*
+	ScrollBar.h: Headless stand-in for the scroll bar metrics.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_SCROLL_BAR_H_
+#define HEADLESS_SCROLL_BAR_H_
+
+#include <View.h>
+
+#define B_V_SCROLL_BAR_WIDTH	14.0f
+#define B_H_SCROLL_BAR_HEIGHT	14.0f
+
+struct scroll_bar_info {
+	bool	proportional;
+	bool	double_arrows;
+	int32	knob;
+	int32	min_knob_size;
+};
+
+status_t	get_scroll_bar_info(scroll_bar_info *info);
+status_t	set_scroll_bar_info(scroll_bar_info *info);
+
+#endif
@@ -0,0 +1,34 @@
+/*
+	Size.h: Headless stand-in for BSize.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_SIZE_H_
+#define HEADLESS_SIZE_H_
+
+#include <SupportDefs.h>
+
+enum {
+	B_SIZE_UNSET		= -2,
+	B_SIZE_UNLIMITED	= 1024 * 1024 * 1024
+};
+
+class BSize {
+public:
+	float width;
+	float height;
+
+	BSize() : width(B_SIZE_UNSET), height(B_SIZE_UNSET) {}
+	BSize(float width, float height) : width(width), height(height) {}
+
+	float Width() const { return width; }
+	float Height() const { return height; }
+	void Set(float newWidth, float newHeight)
+		{ width = newWidth; height = newHeight; }
+
+	bool operator==(const BSize &other) const
+		{ return width == other.width && height == other.height; }
+	bool operator!=(const BSize &other) const
+		{ return !(*this == other); }
+};
+
+#endif
@@ -0,0 +1,1596 @@
+/*
+	SpinnerDriver.cpp: Drives a Spinner in a headless window.
+	Released under the MIT license.
+
+	Usage: SpinnerDriver [iterations]
+
+	Feeds the spinner the input a user would: arrow keys, held keys whose
+	repeats pile up, page and end keys, typed text, clicks and held buttons
+	on the arrows in both tracking modes, repeat clients that unschedule
+	each other, bursts of wheel events, drags on the arrows and the label,
+	pastes and scripting messages, plus a worker thread that changes the
+	value under the window lock, a thread pool that has to run everything it
+	was given, a graph of dependent functors and futures that deliver their
+	results as messages. Spinners with lazy child views are built, drawn and
+	brought to life by hovering, clicking and focusing, and the bytes an
+	eager and a lazy spinner cost are listed. A SpinnerGrid with a hundred
+	thousand rows is scrolled, clicked and edited in a window of its own.
+	Every scenario checks the resulting value and the messages the target
+	received, so a run doubles as a test. The key and click scenarios also
+	report the time from input to Invoke() and how much the windows drew for
+	it, from HeadlessRecorder.h.
+*/
+
+#include <AppDefs.h>
+#include <Clipboard.h>
+#include <InterfaceDefs.h>
+#include <Messenger.h>
+#include <OS.h>
+#include <Window.h>
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "HeadlessRecorder.h"
+#include "Spinner.h"
+#include "SpinnerGrid.h"
+#include "SpinnerRepeatScheduler.h"
+#include "Thread.h"
+
+enum {
+	M_SPINNER_INVOKED = 'spiv'
+};
+
+static int32 sFailures = 0;
+
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, \
+				__LINE__, #condition); \
+			sFailures++; \
+		} \
+	} while (0)
+
+
+// Counts the messages the spinner sends and remembers the last value
+class InvokeCounter : public BHandler {
+public:
+	InvokeCounter()
+		:
+		BHandler("invoke counter"),
+		fCount(0),
+		fLastValue(0),
+		fLastIndex(-1),
+		fWheelCount(0)
+	{
+	}
+
+	virtual void MessageReceived(BMessage *message)
+	{
+		if (message->what == B_MOUSE_WHEEL_CHANGED)
+			fWheelCount++;
+		if (message->what != M_SPINNER_INVOKED) {
+			BHandler::MessageReceived(message);
+			return;
+		}
+
+		fCount++;
+		fLastValue = message->GetInt32("be:value", fLastValue);
+		fLastIndex = message->GetInt32("index", -1);
+	}
+
+	int32	fCount;
+	int32	fLastValue;
+	int32	fLastIndex;
+	int32	fWheelCount;
+};
+
+
+struct Fixture {
+	BWindow			*window;
+	Spinner			*spinner;
+	InvokeCounter	*counter;
+
+	// Runs the window until nothing is left to dispatch, then updates it
+	void Pump()
+	{
+		while (window->DispatchPendingMessages() > 0)
+			;
+		window->UpdateIfNeeded();
+	}
+
+	BPoint ArrowCenter(const char *name)
+	{
+		BView *arrow = spinner->FindView(name);
+		BRect frame = arrow->ConvertToWindow(arrow->Bounds());
+		return BPoint((frame.left + frame.right) / 2,
+			(frame.top + frame.bottom) / 2);
+	}
+};
+
+
+static void
+post_key(BWindow *window, uint32 key, const char *bytes = NULL,
+	uint32 modifiers = 0)
+{
+	char buffer[2] = { (char)key, '\0' };
+	BMessage message(B_KEY_DOWN);
+	message.AddInt64("when", system_time());
+	message.AddString("bytes", bytes != NULL ? bytes : buffer);
+	message.AddInt32("raw_char", key);
+	message.AddInt32("modifiers", modifiers);
+	window->PostMessage(&message);
+}
+
+
+// The repeats of a held key, as the input server sends them
+static void
+post_key_repeats(BWindow *window, uint32 key, int32 count)
+{
+	char bytes[2] = { (char)key, '\0' };
+	for (int32 i = 1; i <= count; i++) {
+		BMessage message(B_KEY_DOWN);
+		message.AddInt64("when", system_time());
+		message.AddString("bytes", bytes);
+		message.AddInt32("raw_char", key);
+		message.AddInt32("modifiers", 0);
+		message.AddInt32("be:key_repeat", i);
+		window->PostMessage(&message);
+	}
+}
+
+
+static void
+post_mouse(BWindow *window, uint32 what, BPoint where, uint32 buttons)
+{
+	BMessage message(what);
+	message.AddInt64("when", system_time());
+	message.AddPoint("where", where);
+	message.AddInt32("buttons", buttons);
+	if (what == B_MOUSE_DOWN)
+		message.AddInt32("clicks", 1);
+	window->PostMessage(&message);
+}
+
+
+static void
+post_wheel(BWindow *window, BHandler *target, float delta, bigtime_t when)
+{
+	BMessage message(B_MOUSE_WHEEL_CHANGED);
+	message.AddInt64("when", when);
+	message.AddFloat("be:wheel_delta_x", 0);
+	message.AddFloat("be:wheel_delta_y", delta);
+	window->PostMessage(&message, target);
+}
+
+
+// The window keeps the modifiers of the last key event
+static void
+set_modifiers(BWindow *window, uint32 modifiers)
+{
+	BMessage message(B_KEY_UP);
+	message.AddInt64("when", system_time());
+	message.AddString("bytes", "");
+	message.AddInt32("modifiers", modifiers);
+	window->PostMessage(&message);
+}
+
+
+static void
+type_text(Fixture &fixture, const char *text)
+{
+	for (const char *c = text; *c != '\0'; c++)
+		post_key(fixture.window, (uchar)*c);
+	fixture.Pump();
+}
+
+
+static void
+report(const char *name, bigtime_t elapsed, int32 count)
+{
+	printf("%-24s %8.2f us/input %7.2f draw calls %6.2f hooks"
+		" %6.2f widths\n", name, count > 0 ? (double)elapsed / count : 0.0,
+		(double)HeadlessRecorder::DrawCalls() / count,
+		(double)HeadlessRecorder::Count(HEADLESS_DRAW_HOOK) / count,
+		(double)HeadlessRecorder::Count(HEADLESS_STRING_WIDTH) / count);
+}
+
+
+//	#pragma mark - scenarios
+
+
+static void
+test_arrow_keys(Fixture &fixture, int32 iterations)
+{
+	fixture.spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	HeadlessRecorder::Reset();
+
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		post_key(fixture.window, i % 4 == 3 ? B_DOWN_ARROW : B_UP_ARROW);
+		fixture.Pump();
+	}
+	bigtime_t elapsed = system_time() - start;
+
+	int32 expected = iterations / 4 * 2 + (iterations % 4 == 3 ? 1
+		: iterations % 4);
+	CHECK(fixture.spinner->Value() == expected);
+	CHECK(fixture.counter->fCount == iterations);
+	CHECK(fixture.counter->fLastValue == expected);
+	CHECK(atoi(fixture.spinner->TextControl()->Text()) == expected);
+	report("arrow key -> Invoke", elapsed, iterations);
+}
+
+
+// A held key whose repeats pile up moves the value as far as they all
+// would have, in one step, and stops with the key.
+static void
+test_key_repeats(Fixture &fixture, int32 iterations)
+{
+	const int32 kRepeatsPerBurst = 32;
+	Spinner *spinner = fixture.spinner;
+	spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	HeadlessRecorder::Reset();
+
+	int32 bursts = iterations / kRepeatsPerBurst;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < bursts; i++) {
+		post_key(fixture.window, B_UP_ARROW);
+		post_key_repeats(fixture.window, B_UP_ARROW, kRepeatsPerBurst - 1);
+		fixture.Pump();
+	}
+	bigtime_t elapsed = system_time() - start;
+
+	CHECK(spinner->Value() == bursts * kRepeatsPerBurst);
+	CHECK(fixture.counter->fCount == bursts);
+	CHECK(atoi(spinner->TextControl()->Text()) == bursts * kRepeatsPerBurst);
+	report("key burst -> Invoke", elapsed, bursts);
+
+	// a new press, or another key, ends the run
+	spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	post_key(fixture.window, B_UP_ARROW);
+	post_key_repeats(fixture.window, B_UP_ARROW, 3);
+	BMessage keyUp(B_KEY_UP);
+	keyUp.AddString("bytes", "");
+	keyUp.AddInt32("raw_char", B_UP_ARROW);
+	fixture.window->PostMessage(&keyUp);
+	post_key(fixture.window, B_UP_ARROW);
+	post_key_repeats(fixture.window, B_UP_ARROW, 2);
+	post_key_repeats(fixture.window, B_DOWN_ARROW, 1);
+	fixture.Pump();
+	CHECK(spinner->Value() == 6);
+	CHECK(fixture.counter->fCount == 3);
+
+	spinner->SetPageSteps(100);
+	post_key(fixture.window, B_PAGE_UP);
+	fixture.Pump();
+	CHECK(spinner->Value() == 106);
+	post_key(fixture.window, B_PAGE_DOWN);
+	post_key_repeats(fixture.window, B_PAGE_DOWN, 2);
+	fixture.Pump();
+	CHECK(spinner->Value() == -194);
+	spinner->SetPageSteps(10);
+
+	post_key(fixture.window, B_END);
+	fixture.Pump();
+	CHECK(spinner->Value() == spinner->GetMax());
+	post_key(fixture.window, B_HOME);
+	post_key_repeats(fixture.window, B_HOME, 4);
+	fixture.Pump();
+	CHECK(spinner->Value() == spinner->GetMin());
+	CHECK(fixture.counter->fLastValue == spinner->GetMin());
+	CHECK(fixture.counter->fCount == 7);
+}
+
+
+static void
+test_typing(Fixture &fixture)
+{
+	fixture.spinner->SetValue(5);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+
+	fixture.spinner->TextControl()->TextView()->SelectAll();
+	type_text(fixture, "42");
+	CHECK(strcmp(fixture.spinner->TextControl()->Text(), "42") == 0);
+
+	// nothing but a number gets in
+	type_text(fixture, "x");
+	CHECK(strcmp(fixture.spinner->TextControl()->Text(), "42") == 0);
+
+	post_key(fixture.window, B_ENTER);
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == 42);
+	CHECK(fixture.counter->fCount >= 1);
+	CHECK(fixture.counter->fLastValue == 42);
+}
+
+
+static void
+test_clicks(Fixture &fixture, spinner_tracking_mode mode, int32 iterations)
+{
+	fixture.spinner->SetTrackingMode(mode);
+	fixture.spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	HeadlessRecorder::Reset();
+
+	BPoint up = fixture.ArrowCenter("up");
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		post_mouse(fixture.window, B_MOUSE_DOWN, up, B_PRIMARY_MOUSE_BUTTON);
+		post_mouse(fixture.window, B_MOUSE_UP, up, 0);
+		fixture.Pump();
+	}
+	bigtime_t elapsed = system_time() - start;
+
+	CHECK(fixture.spinner->Value() == iterations);
+	CHECK(fixture.counter->fLastValue == iterations);
+	report(mode == SPINNER_TRACK_EVENTS ? "click (events) -> Invoke"
+		: "click (polling) -> Invoke", elapsed, iterations);
+}
+
+
+// Holds the down arrow long enough for the repeat to kick in, moves off it
+// to pause, and releases it somewhere else.
+static void
+test_hold(Fixture &fixture, spinner_tracking_mode mode)
+{
+	fixture.spinner->SetTrackingMode(mode);
+	fixture.spinner->SetValue(0);
+	fixture.Pump();
+
+	BPoint down = fixture.ArrowCenter("down");
+	post_mouse(fixture.window, B_MOUSE_DOWN, down, B_PRIMARY_MOUSE_BUTTON);
+	bigtime_t until = system_time() + 600000;
+	while (system_time() < until) {
+		fixture.Pump();
+		snooze(5000);
+	}
+	int32 held = fixture.spinner->Value();
+	CHECK(held < -1);
+
+	BPoint outside(down.x - 100, down.y);
+	post_mouse(fixture.window, B_MOUSE_MOVED, outside, B_PRIMARY_MOUSE_BUTTON);
+	fixture.Pump();
+	int32 paused = fixture.spinner->Value();
+	until = system_time() + 200000;
+	while (system_time() < until) {
+		fixture.Pump();
+		snooze(5000);
+	}
+	CHECK(fixture.spinner->Value() == paused);
+
+	post_mouse(fixture.window, B_MOUSE_UP, outside, 0);
+	fixture.Pump();
+	int32 released = fixture.spinner->Value();
+	snooze(100000);
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == released);
+	CHECK(fixture.counter->fLastValue == released);
+}
+
+
+struct TickCounter : public SpinnerRepeatClient {
+	TickCounter(SpinnerRepeatScheduler *scheduler,
+			SpinnerRepeatClient *victim = NULL)
+		:
+		ticks(0),
+		scheduler(scheduler),
+		victim(victim)
+	{
+	}
+
+	virtual bool RepeatTick(bigtime_t now)
+	{
+		ticks++;
+		if (victim != NULL)
+			scheduler->Unschedule(victim);
+		return true;
+	}
+
+	int32					ticks;
+	SpinnerRepeatScheduler	*scheduler;
+	SpinnerRepeatClient		*victim;
+};
+
+
+// A client that unschedules one ticked before it doesn't get ticked twice
+// in its place, and the one it unscheduled isn't ticked again.
+static void
+test_repeat_scheduler(Fixture &fixture)
+{
+	SpinnerRepeatScheduler *scheduler
+		= SpinnerRepeatScheduler::Acquire(fixture.window);
+	TickCounter first(scheduler);
+	TickCounter victim(scheduler);
+	TickCounter killer(scheduler, &victim);
+	scheduler->Schedule(&first);
+	scheduler->Schedule(&victim);
+	scheduler->Schedule(&killer);
+
+	bigtime_t until = system_time() + scheduler->Period() * 3;
+	while (system_time() < until || first.ticks == 0) {
+		fixture.Pump();
+		snooze(5000);
+	}
+	scheduler->Unschedule(&first);
+	scheduler->Unschedule(&killer);
+	scheduler->Release();
+
+	CHECK(first.ticks > 0);
+	CHECK(killer.ticks == first.ticks);
+	CHECK(victim.ticks <= 1);
+}
+
+
+// A high resolution wheel sends many small deltas per frame; each frame
+// should change the value and notify only once.
+static void
+test_wheel(Fixture &fixture, int32 iterations)
+{
+	const int32 kEventsPerFrame = 8;
+	BView *textView = fixture.spinner->TextControl()->TextView();
+
+	fixture.spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	HeadlessRecorder::Reset();
+
+	int32 frames = iterations / kEventsPerFrame;
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < frames; i++) {
+		bigtime_t when = system_time();
+		for (int32 j = 0; j < kEventsPerFrame; j++)
+			post_wheel(fixture.window, textView, -0.5f, when);
+		fixture.Pump();
+	}
+	bigtime_t elapsed = system_time() - start;
+
+	CHECK(fixture.spinner->Value() == frames * kEventsPerFrame / 2);
+	CHECK(fixture.counter->fCount == frames);
+	CHECK(atoi(fixture.spinner->TextControl()->Text())
+		== frames * kEventsPerFrame / 2);
+	report("wheel frame -> Invoke", elapsed, frames);
+
+	// frames apart, or with another event in between, they stay apart
+	fixture.spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	bigtime_t when = system_time();
+	post_wheel(fixture.window, textView, -1, when);
+	post_wheel(fixture.window, textView, -1, when + 100000);
+	post_key(fixture.window, B_UP_ARROW);
+	post_wheel(fixture.window, textView, 1, when + 100000);
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == 2);
+	CHECK(fixture.counter->fCount == 4);
+
+	// one meant for another handler in between still gets there
+	fixture.counter->fCount = 0;
+	fixture.counter->fWheelCount = 0;
+	when = system_time();
+	post_wheel(fixture.window, textView, -1, when);
+	post_wheel(fixture.window, fixture.counter, -1, when);
+	post_wheel(fixture.window, textView, -1, when);
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == 4);
+	CHECK(fixture.counter->fCount == 1);
+	CHECK(fixture.counter->fWheelCount == 1);
+	fixture.spinner->SetValue(2);
+	fixture.Pump();
+
+	fixture.spinner->SetWheelMultiplier(B_SHIFT_KEY, 10);
+	set_modifiers(fixture.window, B_SHIFT_KEY);
+	post_wheel(fixture.window, textView, -1, system_time());
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == 12);
+	set_modifiers(fixture.window, 0);
+	post_wheel(fixture.window, textView, 1, system_time());
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == 11);
+	fixture.spinner->SetWheelMultiplier(0, 1);
+}
+
+
+// Presses at start, moves up by distance in moves equal steps without
+// dispatching in between, and dispatches them all at once.
+static void
+drag(Fixture &fixture, BPoint start, float distance, int32 moves)
+{
+	for (int32 i = 1; i <= moves; i++) {
+		post_mouse(fixture.window, B_MOUSE_MOVED,
+			BPoint(start.x, start.y - distance * i / moves),
+			B_PRIMARY_MOUSE_BUTTON);
+	}
+	fixture.Pump();
+}
+
+
+// Dragging on an arrow or the label changes the value by the pixel, and
+// the moves that pile up between two passes of the looper cost a single
+// change.
+static void
+test_scrub(Fixture &fixture, int32 iterations)
+{
+	Spinner *spinner = fixture.spinner;
+	spinner->SetTrackingMode(SPINNER_TRACK_EVENTS);
+	spinner->SetScrubRatio(4);
+	spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+
+	// the press itself steps, then the value follows the pointer only
+	BPoint up = fixture.ArrowCenter("up");
+	post_mouse(fixture.window, B_MOUSE_DOWN, up, B_PRIMARY_MOUSE_BUTTON);
+	fixture.Pump();
+	CHECK(spinner->Value() == 1);
+	drag(fixture, up, 40, 20);
+	CHECK(spinner->Value() == 11);
+	CHECK(fixture.counter->fCount == 2);
+	snooze(400000);
+	fixture.Pump();
+	CHECK(spinner->Value() == 11);
+	drag(fixture, BPoint(up.x, up.y - 40), -60, 3);
+	post_mouse(fixture.window, B_MOUSE_UP, BPoint(up.x, up.y + 20), 0);
+	fixture.Pump();
+	CHECK(spinner->Value() == -4);
+	CHECK(fixture.counter->fCount == 3 && fixture.counter->fLastValue == -4);
+
+	BPoint label = spinner->ConvertToWindow(BPoint(2,
+		spinner->Bounds().Height() / 2));
+	spinner->SetValue(0);
+	fixture.Pump();
+	fixture.counter->fCount = 0;
+	HeadlessRecorder::Reset();
+
+	const int32 kMovesPerPass = 8;
+	int32 passes = iterations / kMovesPerPass;
+	post_mouse(fixture.window, B_MOUSE_DOWN, label, B_PRIMARY_MOUSE_BUTTON);
+	fixture.Pump();
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < passes; i++)
+		drag(fixture, BPoint(label.x, label.y - 4 * i), 4, kMovesPerPass);
+	bigtime_t elapsed = system_time() - start;
+	post_mouse(fixture.window, B_MOUSE_UP, label, 0);
+	fixture.Pump();
+
+	CHECK(spinner->Value() == passes);
+	CHECK(fixture.counter->fCount == passes);
+	CHECK(atoi(spinner->TextControl()->Text()) == passes);
+	report("label drag pass -> Invoke", elapsed, passes);
+
+	// a click on the label without a drag focuses the value
+	spinner->TextControl()->TextView()->MakeFocus(false);
+	post_mouse(fixture.window, B_MOUSE_DOWN, label, B_PRIMARY_MOUSE_BUTTON);
+	post_mouse(fixture.window, B_MOUSE_MOVED, BPoint(label.x + 1, label.y),
+		B_PRIMARY_MOUSE_BUTTON);
+	post_mouse(fixture.window, B_MOUSE_UP, label, 0);
+	fixture.Pump();
+	CHECK(spinner->Value() == passes);
+	CHECK(spinner->TextControl()->TextView()->IsFocus());
+}
+
+
+static void
+set_clipboard(const char *text)
+{
+	be_clipboard->Lock();
+	be_clipboard->Clear();
+	be_clipboard->Data()->AddData("text/plain", B_MIME_TYPE, text,
+		strlen(text));
+	be_clipboard->Commit();
+	be_clipboard->Unlock();
+}
+
+
+static void
+test_paste(Fixture &fixture)
+{
+	fixture.spinner->SetValue(1);
+	fixture.spinner->MakeFocus(true);
+	fixture.Pump();
+
+	fixture.spinner->TextControl()->TextView()->SelectAll();
+	set_clipboard("123");
+	fixture.window->PostMessage(B_PASTE);
+	fixture.Pump();
+	CHECK(strcmp(fixture.spinner->TextControl()->Text(), "123") == 0);
+
+	fixture.spinner->TextControl()->TextView()->SelectAll();
+	set_clipboard("12a");
+	fixture.window->PostMessage(B_PASTE);
+	fixture.Pump();
+	CHECK(strcmp(fixture.spinner->TextControl()->Text(), "123") == 0);
+}
+
+
+static void
+test_scripting(Fixture &fixture)
+{
+	BMessenger messenger(fixture.spinner);
+	BMessage reply;
+
+	BMessage set(B_SET_PROPERTY);
+	set.AddSpecifier("Value");
+	set.AddInt32("data", 77);
+	CHECK(messenger.SendMessage(&set, &reply) == B_OK);
+	CHECK(reply.GetInt32("error", B_ERROR) == B_OK);
+	CHECK(fixture.spinner->Value() == 77);
+
+	BMessage get(B_GET_PROPERTY);
+	get.AddSpecifier("Value");
+	CHECK(messenger.SendMessage(&get, &reply) == B_OK);
+	CHECK(reply.GetInt32("result", -1) == 77);
+
+	BMessage bogus(B_GET_PROPERTY);
+	bogus.AddSpecifier("NoSuchThing");
+	CHECK(messenger.SendMessage(&bogus, &reply) == B_OK);
+	CHECK(reply.what == B_MESSAGE_NOT_UNDERSTOOD);
+	fixture.Pump();
+}
+
+
+struct WorkerArgs {
+	Spinner		*spinner;
+	int32		steps;
+	sem_id		done;
+	bool		ownThread;
+};
+
+
+static status_t
+step_from_worker(WorkerArgs *args)
+{
+	args->ownThread = find_thread("spinner stepper") == find_thread(NULL);
+	for (int32 i = 0; i < args->steps; i++) {
+		if (args->spinner->LockLooper()) {
+			args->spinner->SetValue(args->spinner->Value() + 1);
+			args->spinner->UnlockLooper();
+		}
+		snooze(100);
+	}
+	release_sem(args->done);
+	return B_OK;
+}
+
+
+static status_t
+sleep_forever(void *)
+{
+	for (;;)
+		snooze(1000000);
+	return B_OK;
+}
+
+
+struct PoolArgs {
+	ThreadPool	*pool;
+	int32		ran;
+	sem_id		done;
+};
+
+
+static void
+count_task(PoolArgs *args)
+{
+	atomic_add(&args->ran, 1);
+}
+
+
+// Submits from a worker, which queues on the worker's own deque and has
+// the others steal
+static void
+fan_out_task(PoolArgs *args)
+{
+	atomic_add(&args->ran, 1);
+	for (int32 i = 0; i < 4; i++)
+		args->pool->Submit(NewFunctionObject(&count_task, args));
+}
+
+
+static void
+release_task(PoolArgs *args)
+{
+	release_sem(args->done);
+}
+
+
+struct BlockerArgs {
+	sem_id		gate;
+	sem_id		done;
+	int32		passed;
+};
+
+
+static status_t
+wait_for_gate(BlockerArgs *args)
+{
+	if (acquire_sem_etc(args->gate, 1, B_RELATIVE_TIMEOUT, 2000000) == B_OK)
+		atomic_add(&args->passed, 1);
+	release_sem(args->done);
+	return B_OK;
+}
+
+
+static status_t
+open_gate(BlockerArgs *args, int32 count)
+{
+	release_sem_etc(args->gate, count, 0);
+	return B_OK;
+}
+
+
+static void
+test_pool(void)
+{
+	ThreadPool *pool = new ThreadPool(4);
+	CHECK(pool->CountWorkers() == 4);
+	PoolArgs args = { pool, 0, -1 };
+	for (int32 i = 0; i < 250; i++)
+		pool->Submit(NewFunctionObject(&fan_out_task, &args));
+	// runs whatever is still queued
+	delete pool;
+	CHECK(args.ran == 250 * 5);
+
+	// thread per functor by default, the default pool when asked for
+	args.done = create_sem(0, "own thread done");
+	Thread::Launch(NewFunctionObject(&release_task, &args));
+	CHECK(acquire_sem_etc(args.done, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	Thread::Launch(NewFunctionObject(&release_task, &args), B_NORMAL_PRIORITY,
+		"pooled", THREAD_LAUNCH_POOLED);
+	CHECK(acquire_sem_etc(args.done, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	delete_sem(args.done);
+
+	// functors that wait for one launched after them all get there, how
+	// ever many more of them there are than the pool has workers
+	int32 blockers = ThreadPool::Default()->CountWorkers() + 2;
+	BlockerArgs blocked = { create_sem(0, "blocker gate"),
+		create_sem(0, "blockers done"), 0 };
+	for (int32 i = 0; i < blockers; i++) {
+		LaunchInNewThread("blocker", B_NORMAL_PRIORITY, &wait_for_gate,
+			&blocked);
+	}
+	LaunchInNewThread("gate opener", B_NORMAL_PRIORITY, &open_gate, &blocked,
+		blockers);
+	CHECK(acquire_sem_etc(blocked.done, blockers, B_RELATIVE_TIMEOUT,
+		3000000) == B_OK);
+	CHECK(blocked.passed == blockers);
+	delete_sem(blocked.gate);
+	delete_sem(blocked.done);
+}
+
+
+// Adds to a counter; the padding makes it too big to be stored inline
+template<size_t kPadding>
+struct counting_call {
+	int32	*counter;
+	char	padding[kPadding];
+
+	void operator()()
+	{
+		atomic_add(counter, 1);
+	}
+};
+
+
+static void
+test_inline_function(void)
+{
+	int32 counter = 0;
+	counting_call<8> small = { &counter };
+	counting_call<100> big = { &counter };
+
+	InlineFunction function(small);
+	CHECK(function.IsInline());
+	InlineFunction copy(function);
+	copy();
+	function();
+	CHECK(counter == 2);
+
+	InlineFunction heap(big);
+	CHECK(!heap.IsEmpty() && !heap.IsInline());
+	function = heap;
+	copy.TakeOver(heap);
+	CHECK(heap.IsEmpty() && !copy.IsInline());
+	copy();
+	function();
+	heap();
+	CHECK(counter == 4);
+
+	InlineFunction sequence[3] = { small, big, small };
+	ThreadSequence::Launch(sequence, 3, false);
+	CHECK(counter == 7);
+
+	sem_id done = create_sem(0, "inline function done");
+	PoolArgs args = { NULL, 0, done };
+	Thread::Launch(InlineFunction(SingleParamFunctionObject<PoolArgs*>(
+		&release_task, &args)), B_NORMAL_PRIORITY, "pooled",
+		THREAD_LAUNCH_POOLED);
+	CHECK(acquire_sem_etc(done, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	Thread::Launch(InlineFunction(SingleParamFunctionObject<PoolArgs*>(
+		&release_task, &args)), B_NORMAL_PRIORITY, "own thread");
+	CHECK(acquire_sem_etc(done, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	delete_sem(done);
+}
+
+
+// Counts how often it is copied on its way into and out of a functor
+struct copy_counter {
+	static int32 sCopies;
+
+	copy_counter() {}
+	copy_counter(const copy_counter&) { sCopies++; }
+	copy_counter(copy_counter&&) {}
+};
+
+int32 copy_counter::sCopies = 0;
+
+
+struct counted_release {
+	copy_counter	counter;
+	sem_id			done;
+
+	void operator()()
+	{
+		release_sem(done);
+	}
+};
+
+
+static void
+take_counter(copy_counter counter, int32 *calls)
+{
+	(*calls)++;
+}
+
+
+static void
+take_unique(std::unique_ptr<int32> value, int32 *out)
+{
+	*out = *value;
+}
+
+
+static status_t
+launched_unique(std::unique_ptr<int32> value, int32 *out, sem_id done)
+{
+	*out = *value;
+	release_sem(done);
+	return B_OK;
+}
+
+
+static status_t
+sum_five(int32 a, int32 b, int32 c, int32 d, int32 *sum)
+{
+	*sum = a + b + c + d;
+	return *sum > 0 ? B_OK : B_ERROR;
+}
+
+
+static void
+test_function_objects(void)
+{
+	// a temporary is moved into the functor, and copied once per call
+	int32 calls = 0;
+	FunctionObject *functor = NewFunctionObject(&take_counter, copy_counter(),
+		&calls);
+	CHECK(copy_counter::sCopies == 0);
+	(*functor)();
+	CHECK(calls == 1 && copy_counter::sCopies == 1);
+	delete functor;
+
+	// a value that can only be moved is moved on into the function
+	int32 out = 0;
+	functor = NewFunctionObject(&take_unique,
+		std::unique_ptr<int32>(new int32(7)), &out);
+	(*functor)();
+	CHECK(out == 7);
+	delete functor;
+
+	// and launched without ever being copied
+	sem_id launched = create_sem(0, "unique launched");
+	LaunchInNewThread("unique", B_NORMAL_PRIORITY, THREAD_LAUNCH_POOLED,
+		&launched_unique, std::unique_ptr<int32>(new int32(8)), &out,
+		launched);
+	CHECK(acquire_sem_etc(launched, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	CHECK(out == 8);
+	LaunchInNewThread("unique", B_NORMAL_PRIORITY, &launched_unique,
+		std::unique_ptr<int32>(new int32(9)), &out, launched);
+	CHECK(acquire_sem_etc(launched, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	CHECK(out == 9);
+	delete_sem(launched);
+
+	// any number of parameters, and a result
+	int32 sum = 0;
+	FunctionObjectWithResult<status_t> *withResult
+		= NewFunctionObject(&sum_five, 1, 2, 3, 4, &sum);
+	(*withResult)();
+	CHECK(sum == 10 && withResult->Result() == B_OK);
+	delete withResult;
+
+	// a launched temporary is moved all the way to where it runs
+	copy_counter::sCopies = 0;
+	sem_id done = create_sem(0, "launched");
+	counted_release release = { copy_counter(), done };
+	Thread::Launch(InlineFunction(std::move(release)), B_NORMAL_PRIORITY,
+		"pooled", THREAD_LAUNCH_POOLED);
+	CHECK(acquire_sem_etc(done, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	release.done = done;
+	Thread::Launch(InlineFunction(std::move(release)), B_NORMAL_PRIORITY,
+		"own thread");
+	CHECK(acquire_sem_etc(done, 1, B_RELATIVE_TIMEOUT, 1000000) == B_OK);
+	CHECK(copy_counter::sCopies == 0);
+	delete_sem(done);
+}
+
+
+static void
+record_message(const BMessage *message, const BMessage **seen)
+{
+	*seen = message;
+}
+
+
+static void
+test_shared_message(void)
+{
+	BMessage original('shrd');
+	original.AddInt32("value", 42);
+
+	// one copy for all the functors it is fanned out to
+	SharedMessage shared(&original);
+	const BMessage *seen[10];
+	FunctionObject *functors[10];
+	for (int32 i = 0; i < 10; i++)
+		functors[i] = NewFunctionObject(&record_message, shared, &seen[i]);
+	CHECK(shared.IsShared());
+	for (int32 i = 0; i < 10; i++) {
+		(*functors[i])();
+		CHECK(seen[i] == shared.Message());
+		delete functors[i];
+	}
+	CHECK(!shared.IsShared());
+	CHECK(shared.Message() != &original
+		&& shared.Message()->GetInt32("value", 0) == 42);
+
+	// changing one handle leaves the others alone
+	SharedMessage other(shared);
+	other.EditMessage()->ReplaceInt32("value", 7);
+	CHECK(other.Message() != shared.Message() && !shared.IsShared());
+	CHECK(shared.Message()->GetInt32("value", 0) == 42
+		&& other.Message()->GetInt32("value", 0) == 7);
+
+	// a binder made from a plain pointer copies it, copies of it share
+	const BMessage *seenByCall = NULL;
+	InlineFunction call(BoundFunctionObject<void, const BMessage*,
+		const BMessage**>(&record_message, &original, &seenByCall));
+	InlineFunction copy(call);
+	call();
+	const BMessage *first = seenByCall;
+	copy();
+	CHECK(first != &original && seenByCall == first);
+}
+
+
+struct GraphArgs {
+	int32		order[4];
+	int32		finished;
+};
+
+
+static void
+graph_step(GraphArgs *args, int32 step, bigtime_t duration)
+{
+	snooze(duration);
+	args->order[step] = atomic_add(&args->finished, 1);
+}
+
+
+static void
+test_graph(void)
+{
+	// a fans out to b and c, which d joins again; b takes longest
+	GraphArgs args;
+	memset(&args, 0, sizeof(args));
+	FunctionObject *steps[4];
+	const bigtime_t kDurations[4] = { 1000, 20000, 1000, 1000 };
+	ThreadGraph *graph = new ThreadGraph;
+	for (int32 i = 0; i < 4; i++) {
+		steps[i] = NewFunctionObject(&graph_step, &args, i, kDurations[i]);
+		CHECK(graph->AddTask(steps[i]) == i);
+	}
+	CHECK(graph->AddDependency(1, 0) == B_OK);
+	CHECK(graph->AddDependency(2, 0) == B_OK);
+	CHECK(graph->AddDependency(3, 1) == B_OK);
+	CHECK(graph->AddDependency(3, 2) == B_OK);
+	CHECK(graph->AddDependency(0, 3) == B_BAD_VALUE);
+	CHECK(graph->AddDependency(4, 0) == B_BAD_INDEX);
+
+	ThreadPool pool(2);
+	graph->Run(&pool);
+	CHECK(args.finished == 4);
+	CHECK(args.order[0] == 0 && args.order[3] == 3);
+
+	BObjectList<FunctionObject> path;
+	CHECK(graph->CriticalPath(&path) >= 22000);
+	CHECK(path.CountItems() == 3 && path.ItemAt(0) == steps[0]
+		&& path.ItemAt(1) == steps[1] && path.ItemAt(2) == steps[3]);
+
+	// again, without waiting for it; the pool deletes the graph
+	args.finished = 0;
+	ThreadGraph::Launch(graph);
+	bigtime_t deadline = system_time() + 1000000;
+	while (atomic_get(&args.finished) < 4 && system_time() < deadline)
+		snooze(1000);
+	CHECK(args.finished == 4);
+}
+
+
+static int32
+slow_square(int32 value, bigtime_t delay)
+{
+	snooze(delay);
+	return value * value;
+}
+
+
+static int32
+unique_square(std::unique_ptr<int32> value)
+{
+	return *value * *value;
+}
+
+
+static void
+set_nested(Promise<int32> promise)
+{
+	promise.SetResult(5);
+}
+
+
+static void
+wait_nested(ThreadPool *pool, Promise<int32> result)
+{
+	// with its only worker waiting, the pool can't get to set_nested()
+	// unless the wait runs it
+	Promise<int32> nested;
+	Future<int32> future = nested.GetFuture();
+	pool->Submit(NewFunctionObject(&set_nested, nested));
+	result.SetResult(future.Wait(1000000) == B_OK ? future.Result() : -1);
+}
+
+
+static void
+test_futures(Fixture &fixture)
+{
+	Future<int32> future = LaunchWithFuture("square", B_NORMAL_PRIORITY,
+		&slow_square, 7, (bigtime_t)1000);
+	CHECK(future.IsValid());
+	CHECK(future.Wait(1000000) == B_OK);
+	CHECK(future.IsReady() && future.Result() == 49);
+
+	// parameters that can only be moved
+	future = LaunchWithFuture("square", B_NORMAL_PRIORITY, &unique_square,
+		std::unique_ptr<int32>(new int32(6)));
+	CHECK(future.Wait(1000000) == B_OK && future.Result() == 36);
+
+	// on a thread of its own
+	future = LaunchWithFuture("square", B_NORMAL_PRIORITY,
+		THREAD_LAUNCH_NEW_THREAD, &slow_square, 8, (bigtime_t)1000);
+	CHECK(future.Wait(1000000) == B_OK && future.Result() == 64);
+
+	// waiting from a worker for a functor queued behind it
+	{
+		ThreadPool pool(1);
+		Promise<int32> outer;
+		Future<int32> waited = outer.GetFuture();
+		pool.Submit(NewFunctionObject(&wait_nested, &pool, outer));
+		CHECK(waited.Wait(2000000) == B_OK && waited.Result() == 5);
+		CHECK(ThreadPool::Current() == NULL);
+	}
+
+	// results keep their type in the message
+	BMessage results;
+	int16 shortResult = 0;
+	BPoint pointResult;
+	entry_ref refResult;
+	AddFutureResult(&results, "short", (int16)-3);
+	AddFutureResult(&results, "point", BPoint(2, 3));
+	AddFutureResult(&results, "ref", entry_ref(1, 2, "file"));
+	CHECK(results.FindInt16("short", &shortResult) == B_OK
+		&& shortResult == -3);
+	CHECK(results.FindPoint("point", &pointResult) == B_OK
+		&& pointResult == BPoint(2, 3));
+	CHECK(results.FindRef("ref", &refResult) == B_OK
+		&& refResult == entry_ref(1, 2, "file"));
+
+	// a functor that was allocated
+	int32 sum = 0;
+	Future<status_t> summed = LaunchWithFuture(NewFunctionObject(&sum_five,
+		1, 2, 3, 4, &sum));
+	CHECK(summed.Wait(1000000) == B_OK && summed.Result() == B_OK
+		&& sum == 10);
+
+	// a look before it is done
+	Promise<int32> gate;
+	Future<int32> gated = gate.GetFuture();
+	CHECK(!gated.IsReady() && gated.Wait(0) == B_TIMED_OUT);
+	CHECK(gated.Wait(1000) == B_TIMED_OUT);
+
+	// the result goes to the window as a message once it is there
+	int32 invoked = fixture.counter->fCount;
+	BMessage notification(M_SPINNER_INVOKED);
+	gated.NotifyWhenDone(BMessenger(fixture.counter, fixture.window),
+		notification, "be:value");
+	fixture.Pump();
+	CHECK(fixture.counter->fCount == invoked);
+	CHECK(gate.SetResult(12));
+	CHECK(!gate.SetResult(13));
+	fixture.Pump();
+	CHECK(fixture.counter->fCount == invoked + 1
+		&& fixture.counter->fLastValue == 12);
+
+	// once it is done, right away
+	gated.NotifyWhenDone(BMessenger(fixture.counter, fixture.window),
+		notification, "be:value");
+	fixture.Pump();
+	CHECK(fixture.counter->fCount == invoked + 2);
+	CHECK(gated.Wait() == B_OK && gated.Result() == 12);
+}
+
+
+static void
+test_threads(Fixture &fixture)
+{
+	fixture.spinner->SetValue(0);
+	fixture.Pump();
+
+	WorkerArgs args = { fixture.spinner, 200, create_sem(0, "worker done"),
+		false };
+	LaunchInNewThread("spinner stepper", B_NORMAL_PRIORITY,
+		&step_from_worker, &args);
+	while (acquire_sem_etc(args.done, 1, B_RELATIVE_TIMEOUT, 1000)
+			== B_TIMED_OUT)
+		fixture.Pump();
+	fixture.Pump();
+	CHECK(fixture.spinner->Value() == 200);
+	CHECK(args.ownThread);
+
+	// the same on the default pool
+	args.steps = 100;
+	LaunchInNewThread("spinner stepper", B_NORMAL_PRIORITY,
+		THREAD_LAUNCH_POOLED, &step_from_worker, &args);
+	while (acquire_sem_etc(args.done, 1, B_RELATIVE_TIMEOUT, 1000)
+			== B_TIMED_OUT)
+		fixture.Pump();
+	fixture.Pump();
+	delete_sem(args.done);
+	CHECK(fixture.spinner->Value() == 300);
+	CHECK(!args.ownThread);
+
+	thread_id sleeper = spawn_thread(sleep_forever, "sleeper",
+		B_LOW_PRIORITY, NULL);
+	CHECK(resume_thread(sleeper) == B_OK);
+	snooze(1000);
+	CHECK(kill_thread(sleeper) == B_OK);
+	status_t result;
+	CHECK(wait_for_thread(sleeper, &result) == B_OK);
+}
+
+
+static bigtime_t
+construct_spinners(int32 count, bool lazy)
+{
+	Spinner **spinners = new Spinner*[count];
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < count; i++) {
+		spinners[i] = new Spinner(BRect(0, 0, 200, 30), "spinner", "Value:",
+			new BMessage(M_SPINNER_INVOKED), B_FOLLOW_LEFT | B_FOLLOW_TOP,
+			B_WILL_DRAW | B_NAVIGABLE, lazy);
+	}
+	bigtime_t elapsed = system_time() - start;
+	for (int32 i = 0; i < count; i++)
+		delete spinners[i];
+	delete[] spinners;
+	return elapsed;
+}
+
+
+static bool
+same_frame(BView *a, BView *b)
+{
+	return a != NULL && b != NULL && a->Frame() == b->Frame();
+}
+
+
+// A lazy spinner draws itself until it is needed, and then gets the same
+// child views in the same places as one that had them all along.
+static void
+test_lazy(int32 iterations)
+{
+	bigtime_t eager = construct_spinners(iterations, false);
+	bigtime_t lazy = construct_spinners(iterations, true);
+	printf("%-24s %8.2f us/spinner eager %8.2f us/spinner lazy\n",
+		"construction", (double)eager / iterations,
+		(double)lazy / iterations);
+
+	BWindow *window = new BWindow(BRect(100, 300, 400, 400), "Lazy driver",
+		B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS);
+	InvokeCounter *counter = new InvokeCounter;
+	Spinner *hovered = new Spinner(BRect(10, 10, 250, 40), "hovered",
+		"Value:", new BMessage(M_SPINNER_INVOKED),
+		B_FOLLOW_LEFT | B_FOLLOW_TOP, B_WILL_DRAW | B_NAVIGABLE, true);
+	Spinner *clicked = new Spinner(BRect(10, 50, 250, 80), "clicked",
+		"Value:", new BMessage(M_SPINNER_INVOKED),
+		B_FOLLOW_LEFT | B_FOLLOW_TOP, B_WILL_DRAW | B_NAVIGABLE, true);
+	Spinner *reference = new Spinner(BRect(10, 10, 250, 40), "reference",
+		"Value:", new BMessage(M_SPINNER_INVOKED));
+	Fixture fixture = { window, hovered, counter };
+
+	window->Lock();
+	window->AddHandler(counter);
+	window->AddChild(hovered);
+	window->AddChild(clicked);
+	hovered->SetTarget(counter);
+	clicked->SetTarget(counter);
+	clicked->SetRange(-10, 10);
+	HeadlessRecorder::Reset();
+	window->Show();
+	fixture.Pump();
+	CHECK(!hovered->IsMaterialized() && hovered->CountChildren() == 0);
+	CHECK(hovered->LazyChildViews() && !reference->LazyChildViews());
+	CHECK(static_cast<const Spinner*>(hovered)->TextControl() == NULL);
+	CHECK(!hovered->IsMaterialized());
+	CHECK(HeadlessRecorder::Count(HEADLESS_STRING) >= 4);
+	CHECK(HeadlessRecorder::Count(HEADLESS_BITMAP) >= 4);
+
+	// a new value only redraws the number
+	HeadlessRecorder::Reset();
+	hovered->SetValue(7);
+	fixture.Pump();
+	CHECK(!hovered->IsMaterialized());
+	CHECK(HeadlessRecorder::Count(HEADLESS_STRING) == 1);
+	CHECK(HeadlessRecorder::Count(HEADLESS_BITMAP) == 0);
+
+	// and the same one draws nothing at all
+	HeadlessRecorder::Reset();
+	hovered->SetValue(7);
+	fixture.Pump();
+	CHECK(HeadlessRecorder::DrawCalls() == 0);
+	CHECK(HeadlessRecorder::Count(HEADLESS_INVALIDATE) == 0);
+
+	BRect frame = hovered->ConvertToWindow(hovered->Bounds());
+	post_mouse(window, B_MOUSE_MOVED, BPoint(frame.left + 20,
+		frame.top + 10), 0);
+	fixture.Pump();
+	CHECK(hovered->IsMaterialized() && hovered->CountChildren() == 3);
+	CHECK(strcmp(hovered->TextControl()->Text(), "7") == 0);
+	CHECK(!clicked->IsMaterialized());
+
+	window->AddChild(reference);
+	const char *names[] = { "textcontrol", "up", "down" };
+	for (int32 i = 0; i < 3; i++) {
+		CHECK(same_frame(hovered->FindView(names[i]),
+			reference->FindView(names[i])));
+	}
+	CHECK(same_frame(hovered->TextControl()->TextView(),
+		reference->TextControl()->TextView()));
+	window->RemoveChild(reference);
+	delete reference;
+
+	// the first click on an arrow already steps
+	BRect arrow = clicked->ConvertToWindow(hovered->FindView("down")->Frame());
+	BPoint down((arrow.left + arrow.right) / 2, (arrow.top + arrow.bottom) / 2);
+	post_mouse(window, B_MOUSE_DOWN, down, B_PRIMARY_MOUSE_BUTTON);
+	post_mouse(window, B_MOUSE_UP, down, 0);
+	fixture.Pump();
+	CHECK(clicked->IsMaterialized());
+	CHECK(clicked->Value() == -1);
+	CHECK(counter->fCount == 1 && counter->fLastValue == -1);
+
+	// an archive keeps the spinner lazy
+	BMessage archive;
+	CHECK(clicked->Archive(&archive) == B_OK);
+	Spinner *copy = dynamic_cast<Spinner*>(Spinner::Instantiate(&archive));
+	CHECK(copy != NULL && copy->LazyChildViews() && !copy->IsMaterialized());
+	delete copy;
+
+	// the keys work from the first focus on
+	Spinner *focused = new Spinner(BRect(10, 90, 250, 120), "focused",
+		"Value:", new BMessage(M_SPINNER_INVOKED),
+		B_FOLLOW_LEFT | B_FOLLOW_TOP, B_WILL_DRAW | B_NAVIGABLE, true);
+	window->AddChild(focused);
+	focused->SetTarget(counter);
+	fixture.Pump();
+	CHECK(!focused->IsMaterialized());
+	focused->MakeFocus(true);
+	post_key(window, B_UP_ARROW);
+	fixture.Pump();
+	CHECK(focused->IsMaterialized());
+	CHECK(focused->Value() == 1 && counter->fLastValue == 1);
+
+	window->Quit();
+	delete counter;
+}
+
+
+static void
+print_footprint(const char *name, const spinner_footprint &footprint)
+{
+	printf("%-24s %6d total: control %d, private %d, layout %d, core %d, "
+		"curve %d, child views %d\n", name, (int)footprint.total,
+		(int)footprint.control, (int)footprint.privateData,
+		(int)footprint.layoutData, (int)footprint.valueCore,
+		(int)footprint.repeatCurve, (int)footprint.childViews);
+}
+
+
+// What a spinner costs, and that the parts most spinners don't need are
+// only allocated by those that do.
+static void
+test_footprint(void)
+{
+	Spinner *eager = new Spinner(BRect(10, 10, 250, 40), "eager", "Value:",
+		new BMessage(M_SPINNER_INVOKED));
+	Spinner *lazy = new Spinner(BRect(10, 10, 250, 40), "lazy", "Value:",
+		new BMessage(M_SPINNER_INVOKED), B_FOLLOW_LEFT | B_FOLLOW_TOP,
+		B_WILL_DRAW | B_NAVIGABLE, true);
+
+	spinner_footprint eagerFootprint;
+	spinner_footprint lazyFootprint;
+	eager->GetFootprint(&eagerFootprint);
+	lazy->GetFootprint(&lazyFootprint);
+	print_footprint("footprint eager", eagerFootprint);
+	print_footprint("footprint lazy", lazyFootprint);
+	CHECK(eagerFootprint.childViews > 0);
+	CHECK(lazyFootprint.childViews == 0);
+	CHECK(lazyFootprint.layoutData == 0 && lazyFootprint.repeatCurve == 0);
+	CHECK(lazyFootprint.total < eagerFootprint.total);
+
+	// only a curve of its own takes up room, and it survives an archive
+	spinner_repeat_stage stages[] = {
+		{ 0, 1, 200000 },
+		{ 200000, 5, 20000 }
+	};
+	SpinnerRepeatCurve curve;
+	curve.SetStages(stages, 2);
+	lazy->SetRepeatCurve(curve);
+	lazy->GetFootprint(&lazyFootprint);
+	CHECK(lazyFootprint.repeatCurve > 0);
+
+	BMessage archive;
+	CHECK(lazy->Archive(&archive) == B_OK);
+	Spinner *restored = new Spinner(&archive);
+	CHECK(restored->RepeatCurve() == curve);
+	delete restored;
+
+	lazy->SetRepeatCurve(SpinnerRepeatCurve());
+	lazy->GetFootprint(&lazyFootprint);
+	CHECK(lazyFootprint.repeatCurve == 0);
+	CHECK(lazy->RepeatCurve() == SpinnerRepeatCurve());
+
+	delete eager;
+	delete lazy;
+}
+
+
+static BPoint
+grid_point(SpinnerGrid *grid, int32 row, float x, float y)
+{
+	BRect frame = grid->RowFrame(row);
+	return grid->ConvertToWindow(BPoint(frame.left + x, frame.top + y));
+}
+
+
+// Only one row is ever backed by a view, and scrolling draws what is
+// visible no matter how many rows there are.
+static void
+test_grid(int32 iterations)
+{
+	const int32 kRows = 100000;
+
+	BWindow *window = new BWindow(BRect(100, 300, 400, 500), "Grid driver",
+		B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS);
+	SpinnerGrid *grid = new SpinnerGrid(BRect(10, 10, 290, 190), "grid",
+		new BMessage(M_SPINNER_INVOKED));
+	InvokeCounter *counter = new InvokeCounter;
+	Fixture fixture = { window, NULL, counter };
+
+	window->Lock();
+	window->AddHandler(counter);
+	window->AddChild(grid);
+	grid->SetTarget(counter);
+	char label[32];
+	for (int32 i = 0; i < kRows; i++) {
+		snprintf(label, sizeof(label), "Row %d", (int)i);
+		grid->AddRow(label, i % 100, -1000, 1000);
+	}
+	window->Show();
+	fixture.Pump();
+	CHECK(grid->CountChildren() == 0);
+
+	float rowHeight = grid->RowHeight();
+	int32 visible = (int32)(grid->Bounds().Height() / rowHeight) + 2;
+
+	HeadlessRecorder::Reset();
+	BMessage wheel(B_MOUSE_WHEEL_CHANGED);
+	wheel.AddFloat("be:wheel_delta_x", 0);
+	wheel.AddFloat("be:wheel_delta_y", 1);
+	bigtime_t start = system_time();
+	for (int32 i = 0; i < iterations; i++) {
+		window->PostMessage(&wheel, grid);
+		fixture.Pump();
+	}
+	bigtime_t elapsed = system_time() - start;
+	CHECK(grid->Bounds().top == iterations * rowHeight);
+	CHECK(HeadlessRecorder::DrawCalls() <= (int64)iterations * visible * 6);
+	report("grid wheel scroll", elapsed, iterations);
+
+	// the far end costs the same as the top
+	HeadlessRecorder::Reset();
+	grid->ScrollToRow(kRows - 1);
+	fixture.Pump();
+	CHECK(grid->Bounds().bottom == kRows * rowHeight - 1);
+	CHECK(HeadlessRecorder::DrawCalls() <= visible * 6);
+
+	int32 row = grid->RowAt(grid->Bounds().LeftTop()) + 1;
+	int32 before = grid->RowValue(row);
+	BRect frame = grid->RowFrame(row);
+	BPoint up = grid_point(grid, row, frame.Width() - 4, rowHeight / 4);
+	counter->fCount = 0;
+	post_mouse(window, B_MOUSE_DOWN, up, B_PRIMARY_MOUSE_BUTTON);
+	post_mouse(window, B_MOUSE_UP, up, 0);
+	fixture.Pump();
+	CHECK(grid->RowValue(row) == before + 1);
+	CHECK(counter->fCount == 1);
+	CHECK(counter->fLastIndex == row);
+	CHECK(counter->fLastValue == before + 1);
+	CHECK(grid->CountChildren() == 0);
+
+	// clicking the number opens the one editor on that row
+	BPoint number = grid_point(grid, row, grid->Divider() + 10,
+		rowHeight / 2);
+	post_mouse(window, B_MOUSE_DOWN, number, B_PRIMARY_MOUSE_BUTTON);
+	post_mouse(window, B_MOUSE_UP, number, 0);
+	fixture.Pump();
+	CHECK(grid->EditedRow() == row);
+	CHECK(grid->CountChildren() == 1);
+	CHECK(grid->Editor() != NULL && grid->Editor()->IsFocus());
+	post_key(window, '4');
+	post_key(window, 'x');
+	post_key(window, '2');
+	post_key(window, B_ENTER);
+	fixture.Pump();
+	CHECK(grid->EditedRow() == -1);
+	CHECK(grid->RowValue(row) == 42);
+	CHECK(counter->fLastIndex == row);
+	CHECK(grid->IsFocus());
+
+	// typing on the selected row edits it, Escape drops the edit
+	post_key(window, B_UP_ARROW);
+	post_key(window, '7');
+	fixture.Pump();
+	CHECK(grid->EditedRow() == row - 1);
+	post_key(window, B_ESCAPE);
+	fixture.Pump();
+	CHECK(grid->EditedRow() == -1);
+	CHECK(grid->RowValue(row - 1) == (row - 1) % 100);
+
+	// the same editor moves to the next row edited; stepping from what
+	// was typed is one change
+	post_key(window, B_HOME);
+	post_key(window, B_ENTER);
+	post_key(window, '5');
+	fixture.Pump();
+	counter->fCount = 0;
+	post_key(window, B_DOWN_ARROW);
+	fixture.Pump();
+	CHECK(counter->fCount == 1);
+	CHECK(counter->fLastValue == 4);
+	post_key(window, B_TAB);
+	fixture.Pump();
+	CHECK(counter->fCount == 1);
+	CHECK(grid->Bounds().top == 0);
+	CHECK(grid->RowValue(0) == 4);
+	CHECK(grid->CountChildren() == 1);
+
+	// out of range values are ignored, like by a Spinner
+	grid->SetRowValue(0, 5000);
+	CHECK(grid->RowValue(0) == 4);
+
+	BMessage archive;
+	CHECK(grid->Archive(&archive) == B_OK);
+	SpinnerGrid *copy = dynamic_cast<SpinnerGrid*>(
+		SpinnerGrid::Instantiate(&archive));
+	CHECK(copy != NULL && copy->CountRows() == kRows
+		&& copy->RowValue(row) == 42
+		&& strcmp(copy->RowLabel(kRows - 1), "Row 99999") == 0);
+	delete copy;
+
+	// rows with an empty range or no step are not restored
+	archive.ReplaceInt32("_max", 1, -2000);
+	archive.ReplaceInt32("_step", 2, 0);
+	copy = dynamic_cast<SpinnerGrid*>(SpinnerGrid::Instantiate(&archive));
+	CHECK(copy != NULL && copy->CountRows() == kRows - 2
+		&& strcmp(copy->RowLabel(1), "Row 3") == 0);
+	delete copy;
+
+	window->Quit();
+	delete counter;
+}
+
+
+int
+main(int argc, char **argv)
+{
+	int32 iterations = argc > 1 ? atoi(argv[1]) : 2000;
+	if (iterations < 4)
+		iterations = 4;
+
+	Fixture fixture;
+	fixture.window = new BWindow(BRect(100, 100, 400, 200), "Spinner driver",
+		B_TITLED_WINDOW, B_ASYNCHRONOUS_CONTROLS);
+	fixture.spinner = new Spinner(BRect(10, 10, 250, 40), "spinner",
+		"Value:", new BMessage(M_SPINNER_INVOKED));
+	fixture.counter = new InvokeCounter;
+
+	fixture.window->Lock();
+	fixture.window->AddHandler(fixture.counter);
+	fixture.window->AddChild(fixture.spinner);
+	fixture.spinner->SetTarget(fixture.counter);
+	fixture.spinner->SetRange(-100000, 100000);
+	fixture.window->Show();
+	fixture.Pump();
+	fixture.spinner->MakeFocus(true);
+	fixture.Pump();
+
+	test_arrow_keys(fixture, iterations);
+	test_key_repeats(fixture, iterations);
+	test_typing(fixture);
+	test_clicks(fixture, SPINNER_TRACK_EVENTS, iterations / 4);
+	test_clicks(fixture, SPINNER_TRACK_POLLING, iterations / 4);
+	test_hold(fixture, SPINNER_TRACK_EVENTS);
+	test_hold(fixture, SPINNER_TRACK_POLLING);
+	test_repeat_scheduler(fixture);
+	test_wheel(fixture, iterations);
+	test_scrub(fixture, iterations);
+	test_paste(fixture);
+	test_scripting(fixture);
+
+	fixture.window->Unlock();
+	test_threads(fixture);
+	test_pool();
+	test_inline_function();
+	test_function_objects();
+	test_shared_message();
+	test_futures(fixture);
+	test_graph();
+	fixture.window->Lock();
+
+	test_lazy(iterations);
+	test_footprint();
+	test_grid(iterations / 4);
+
+	HeadlessRecorder::Reset();
+	fixture.window->Quit();
+	delete fixture.counter;
+
+	if (sFailures > 0) {
+		fprintf(stderr, "%d checks failed\n", (int)sFailures);
+		return 1;
+	}
+	printf("all checks passed\n");
+	return 0;
+}
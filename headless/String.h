@@ -0,0 +1,108 @@
+/*
+	String.h: Headless stand-in for BString.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_STRING_H_
+#define HEADLESS_STRING_H_
+
+#include <SupportDefs.h>
+
+#include <string>
+
+class BString {
+public:
+							BString() {}
+							BString(const char *string)
+								: fString(string != NULL ? string : "") {}
+							BString(const char *string, int32 maxLength)
+								: fString(string != NULL ? string : "",
+									string != NULL ? maxLength : 0) {}
+							BString(const BString &other)
+								: fString(other.fString) {}
+
+			const char*		String() const { return fString.c_str(); }
+			int32			Length() const { return (int32)fString.size(); }
+			int32			CountChars() const;
+			char			ByteAt(int32 index) const
+								{
+									return index >= 0 && index < Length()
+										? fString[index] : 0;
+								}
+			bool			IsEmpty() const { return fString.empty(); }
+
+			BString&		SetTo(const char *string)
+								{
+									fString = string != NULL ? string : "";
+									return *this;
+								}
+			BString&		SetTo(const char *string, int32 maxLength)
+								{
+									fString.assign(string != NULL ? string : "",
+										string != NULL ? maxLength : 0);
+									return *this;
+								}
+			BString&		Append(const char *string)
+								{
+									if (string != NULL)
+										fString += string;
+									return *this;
+								}
+			BString&		Append(const char *string, int32 length)
+								{
+									fString.append(string, length);
+									return *this;
+								}
+			BString&		Truncate(int32 newLength)
+								{
+									if (newLength < Length())
+										fString.resize(newLength);
+									return *this;
+								}
+
+			int32			FindFirst(const char *string) const
+								{
+									std::string::size_type index
+										= fString.find(string);
+									return index == std::string::npos
+										? -1 : (int32)index;
+								}
+
+			BString&		operator=(const BString &other)
+								{ fString = other.fString; return *this; }
+			BString&		operator=(const char *string)
+								{ return SetTo(string); }
+			BString&		operator+=(const char *string)
+								{ return Append(string); }
+			BString&		operator+=(const BString &other)
+								{ fString += other.fString; return *this; }
+			BString&		operator+=(char c)
+								{ fString += c; return *this; }
+
+			bool			operator==(const BString &other) const
+								{ return fString == other.fString; }
+			bool			operator!=(const BString &other) const
+								{ return fString != other.fString; }
+			bool			operator==(const char *string) const
+								{ return fString == (string != NULL ? string : ""); }
+			bool			operator!=(const char *string) const
+								{ return !(*this == string); }
+			bool			operator<(const BString &other) const
+								{ return fString < other.fString; }
+
+private:
+			std::string		fString;
+};
+
+inline int32
+BString::CountChars() const
+{
+	int32 count = 0;
+	for (std::string::size_type i = 0; i < fString.size(); i++) {
+		// count UTF-8 lead bytes only
+		if ((fString[i] & 0xc0) != 0x80)
+			count++;
+	}
+	return count;
+}
+
+#endif
@@ -0,0 +1,190 @@
+/*
+	Support.cpp: Headless support kit: BLocker and archiving.
+	Released under the MIT license.
+*/
+#include <Archivable.h>
+#include <Locker.h>
+#include <Message.h>
+#include <Point.h>
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+const BPoint B_ORIGIN(0, 0);
+
+
+BLocker::BLocker()
+{
+	_Init();
+}
+
+
+BLocker::BLocker(const char *name)
+{
+	_Init();
+}
+
+
+BLocker::BLocker(const char *name, bool benaphoreStyle)
+{
+	_Init();
+}
+
+
+BLocker::~BLocker()
+{
+	pthread_mutex_destroy(&fMutex);
+}
+
+
+void
+BLocker::_Init()
+{
+	pthread_mutex_init(&fMutex, NULL);
+	fCount = 0;
+}
+
+
+bool
+BLocker::Lock()
+{
+	return LockWithTimeout(B_INFINITE_TIMEOUT) == B_OK;
+}
+
+
+status_t
+BLocker::LockWithTimeout(bigtime_t timeout)
+{
+	if (IsLocked()) {
+		fCount++;
+		return B_OK;
+	}
+
+	// like acquire_sem(), waiting for a lock is no cancellation point
+	int cancelState;
+	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+
+	int error;
+	if (timeout == B_INFINITE_TIMEOUT)
+		error = pthread_mutex_lock(&fMutex);
+	else if (timeout <= 0)
+		error = pthread_mutex_trylock(&fMutex);
+	else {
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		int64 nanos = deadline.tv_nsec + (timeout % 1000000) * 1000;
+		deadline.tv_sec += timeout / 1000000 + nanos / 1000000000;
+		deadline.tv_nsec = nanos % 1000000000;
+		error = pthread_mutex_timedlock(&fMutex, &deadline);
+	}
+
+	pthread_setcancelstate(cancelState, NULL);
+
+	if (error != 0)
+		return error == EBUSY ? B_WOULD_BLOCK : B_TIMED_OUT;
+
+	fOwner = pthread_self();
+	fCount = 1;
+	return B_OK;
+}
+
+
+void
+BLocker::Unlock()
+{
+	if (!IsLocked())
+		return;
+
+	if (--fCount == 0)
+		pthread_mutex_unlock(&fMutex);
+}
+
+
+bool
+BLocker::IsLocked() const
+{
+	return fCount > 0 && pthread_equal(fOwner, pthread_self());
+}
+
+
+//	#pragma mark - archiving
+
+
+BArchivable::BArchivable()
+{
+}
+
+
+BArchivable::BArchivable(BMessage *from)
+{
+}
+
+
+BArchivable::~BArchivable()
+{
+}
+
+
+status_t
+BArchivable::Archive(BMessage *into, bool deep) const
+{
+	if (into == NULL)
+		return B_BAD_VALUE;
+
+	// There is no RTTI name to store like the real thing does; subclasses
+	// add their "class" field themselves.
+	return B_OK;
+}
+
+
+BArchivable*
+BArchivable::Instantiate(BMessage *archive)
+{
+	return NULL;
+}
+
+
+BArchiver::BArchiver(BMessage *archive)
+	:
+	fArchive(archive),
+	fFinished(false)
+{
+}
+
+
+BArchiver::~BArchiver()
+{
+	if (!fFinished)
+		Finish();
+}
+
+
+status_t
+BArchiver::Finish(status_t err)
+{
+	fFinished = true;
+	return err;
+}
+
+
+bool
+validate_instantiation(BMessage *from, const char *className)
+{
+	if (from == NULL || className == NULL)
+		return false;
+
+	// the most derived class is archived last
+	type_code type;
+	int32 count;
+	if (from->GetInfo("class", &type, &count) != B_OK)
+		return false;
+
+	for (int32 i = count - 1; i >= 0; i--) {
+		const char *name;
+		if (from->FindString("class", i, &name) == B_OK
+			&& strcmp(name, className) == 0)
+			return true;
+	}
+	return false;
+}
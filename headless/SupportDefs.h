@@ -0,0 +1,55 @@
+/*
+	SupportDefs.h: Headless stand-in for the Haiku support kit basics.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_SUPPORT_DEFS_H_
+#define HEADLESS_SUPPORT_DEFS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+typedef int8_t				int8;
+typedef uint8_t				uint8;
+typedef int16_t				int16;
+typedef uint16_t			uint16;
+typedef int32_t				int32;
+typedef uint32_t			uint32;
+typedef int64_t				int64;
+typedef uint64_t			uint64;
+
+typedef unsigned char		uchar;
+typedef unsigned long		ulong;
+
+typedef int32				status_t;
+typedef int64				bigtime_t;
+typedef uint32				type_code;
+typedef uint32				perform_code;
+
+#include <Errors.h>
+#include <TypeConstants.h>
+
+#define B_INFINITE_TIMEOUT	((bigtime_t)INT64_MAX)
+
+#define min_c(a,b)			((a)>(b)?(b):(a))
+#define max_c(a,b)			((a)>(b)?(a):(b))
+
+#ifndef MIN
+#	define MIN(a,b)			(((a)<(b))?(a):(b))
+#endif
+#ifndef MAX
+#	define MAX(a,b)			(((a)>(b))?(a):(b))
+#endif
+
+#ifndef NULL
+#	define NULL				0
+#endif
+
+extern "C" int32 atomic_add(int32 *value, int32 addValue);
+extern "C" int32 atomic_get(int32 *value);
+extern "C" int32 atomic_set(int32 *value, int32 newValue);
+extern "C" int64 atomic_add64(int64 *value, int64 addValue);
+extern "C" int64 atomic_get64(int64 *value);
+extern "C" int64 atomic_set64(int64 *value, int64 newValue);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+	TextControl.h: Headless stand-in for BTextControl.
+
+	Like the real control, the message is sent when editing is committed
+	(Enter or losing focus with changed text) and the modification message,
+	if any, on every edit.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_TEXT_CONTROL_H_
+#define HEADLESS_TEXT_CONTROL_H_
+
+#include <Control.h>
+#include <TextView.h>
+
+class BLayoutItem;
+
+class BTextControl : public BControl {
+public:
+							BTextControl(BRect frame, const char *name,
+								const char *label, const char *initialText,
+								BMessage *message,
+								uint32 resizingMode
+									= B_FOLLOW_LEFT | B_FOLLOW_TOP,
+								uint32 flags = B_WILL_DRAW | B_NAVIGABLE);
+							BTextControl(const char *name, const char *label,
+								const char *initialText, BMessage *message,
+								uint32 flags = B_WILL_DRAW | B_NAVIGABLE);
+	virtual					~BTextControl();
+
+	virtual	void			SetText(const char *text);
+			const char*		Text() const;
+			BTextView*		TextView() const { return fText; }
+
+	virtual	void			SetModificationMessage(BMessage *message);
+			BMessage*		ModificationMessage() const
+								{ return fModificationMessage; }
+
+	virtual	void			SetAlignment(alignment label, alignment text);
+	virtual	void			SetDivider(float position);
+			float			Divider() const { return fDivider; }
+
+	virtual	void			Draw(BRect updateRect);
+	virtual	void			MakeFocus(bool focus = true);
+	virtual	void			SetEnabled(bool enabled);
+	virtual	void			SetLabel(const char *label);
+	virtual	void			FrameResized(float width, float height);
+
+	virtual	void			GetPreferredSize(float *width, float *height);
+	virtual	BSize			MinSize();
+
+private:
+	friend class _BTextInput_;
+
+			void			_LayoutTextView();
+			void			_TextModified();
+			void			_TextCommitted();
+
+			BTextView*		fText;
+			BMessage*		fModificationMessage;
+			float			fDivider;
+			bool			fTextChanged;
+};
+
+#endif
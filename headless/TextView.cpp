@@ -0,0 +1,691 @@
+/*
+	TextView.cpp: Headless BTextView and BTextControl.
+	Released under the MIT license.
+*/
+#include <TextView.h>
+
+#include <AppDefs.h>
+#include <Clipboard.h>
+#include <TextControl.h>
+#include <TypeConstants.h>
+#include <Window.h>
+
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+
+BTextView::BTextView(BRect frame, const char *name, BRect textRect,
+	uint32 resizingMode, uint32 flags)
+	:
+	BView(frame, name, resizingMode, flags | B_FRAME_EVENTS)
+{
+	_Init(textRect);
+}
+
+
+BTextView::BTextView(const char *name, uint32 flags)
+	:
+	BView(name, flags | B_FRAME_EVENTS)
+{
+	_Init(Bounds());
+}
+
+
+BTextView::~BTextView()
+{
+}
+
+
+void
+BTextView::Draw(BRect updateRect)
+{
+	FillRect(updateRect);
+	if (fSelStart != fSelEnd)
+		FillRect(Bounds());
+	DrawString(fText.c_str(), fTextRect.LeftBottom());
+	if (IsFocus() && fSelStart == fSelEnd && fEditable)
+		StrokeLine(fTextRect.LeftTop(), fTextRect.LeftBottom());
+}
+
+
+void
+BTextView::MouseDown(BPoint where)
+{
+	if (!fSelectable && !fEditable)
+		return;
+
+	MakeFocus(true);
+	Select(TextLength(), TextLength());
+}
+
+
+void
+BTextView::KeyDown(const char *bytes, int32 numBytes)
+{
+	if (numBytes <= 0 || !fEditable) {
+		BView::KeyDown(bytes, numBytes);
+		return;
+	}
+
+	uchar key = (uchar)bytes[0];
+	switch (key) {
+		case B_BACKSPACE:
+			if (fSelStart != fSelEnd)
+				Delete();
+			else if (fSelStart > 0)
+				Delete(fSelStart - 1, fSelStart);
+			break;
+
+		case B_DELETE:
+			if (fSelStart != fSelEnd)
+				Delete();
+			else if (fSelEnd < TextLength())
+				Delete(fSelEnd, fSelEnd + 1);
+			break;
+
+		case B_LEFT_ARROW:
+			if (fSelStart != fSelEnd)
+				Select(fSelStart, fSelStart);
+			else if (fSelStart > 0)
+				Select(fSelStart - 1, fSelStart - 1);
+			break;
+
+		case B_RIGHT_ARROW:
+			if (fSelStart != fSelEnd)
+				Select(fSelEnd, fSelEnd);
+			else if (fSelEnd < TextLength())
+				Select(fSelEnd + 1, fSelEnd + 1);
+			break;
+
+		case B_HOME:
+			Select(0, 0);
+			break;
+
+		case B_END:
+			Select(TextLength(), TextLength());
+			break;
+
+		default:
+			if (key < B_SPACE || !IsCharAllowed(key)) {
+				BView::KeyDown(bytes, numBytes);
+				break;
+			}
+			Insert(bytes, numBytes);
+			break;
+	}
+}
+
+
+void
+BTextView::MakeFocus(bool focus)
+{
+	if (focus == IsFocus())
+		return;
+
+	BView::MakeFocus(focus);
+	Invalidate();
+}
+
+
+void
+BTextView::MessageReceived(BMessage *message)
+{
+	switch (message->what) {
+		case B_CUT:
+			Cut(be_clipboard);
+			break;
+
+		case B_COPY:
+			Copy(be_clipboard);
+			break;
+
+		case B_PASTE:
+			Paste(be_clipboard);
+			break;
+
+		case B_SELECT_ALL:
+			SelectAll();
+			break;
+
+		default:
+			BView::MessageReceived(message);
+			break;
+	}
+}
+
+
+void
+BTextView::SetText(const char *text)
+{
+	SetText(text, text != NULL ? strlen(text) : 0);
+}
+
+
+void
+BTextView::SetText(const char *text, int32 length)
+{
+	if (!fText.empty())
+		DeleteText(0, TextLength());
+	if (text != NULL && length > 0)
+		InsertText(text, length, 0, NULL);
+
+	fSelStart = fSelEnd = TextLength();
+	Invalidate();
+}
+
+
+void
+BTextView::Insert(const char *text)
+{
+	Insert(text, text != NULL ? strlen(text) : 0);
+}
+
+
+void
+BTextView::Insert(const char *text, int32 length)
+{
+	if (text == NULL || length <= 0)
+		return;
+
+	if (fSelStart != fSelEnd)
+		Delete();
+
+	if (TextLength() + length > fMaxBytes)
+		length = fMaxBytes - TextLength();
+	if (length <= 0)
+		return;
+
+	InsertText(text, length, fSelStart, NULL);
+	fSelStart += length;
+	fSelEnd = fSelStart;
+}
+
+
+void
+BTextView::Delete()
+{
+	Delete(fSelStart, fSelEnd);
+}
+
+
+void
+BTextView::Delete(int32 startOffset, int32 endOffset)
+{
+	if (startOffset < 0)
+		startOffset = 0;
+	if (endOffset > TextLength())
+		endOffset = TextLength();
+	if (startOffset >= endOffset)
+		return;
+
+	DeleteText(startOffset, endOffset);
+	fSelStart = fSelEnd = startOffset;
+}
+
+
+void
+BTextView::GetText(int32 offset, int32 length, char *buffer) const
+{
+	if (buffer == NULL)
+		return;
+
+	if (offset < 0 || offset > TextLength())
+		offset = TextLength();
+	if (length > TextLength() - offset)
+		length = TextLength() - offset;
+	if (length < 0)
+		length = 0;
+
+	memcpy(buffer, fText.data() + offset, length);
+	buffer[length] = '\0';
+}
+
+
+uchar
+BTextView::ByteAt(int32 offset) const
+{
+	if (offset < 0 || offset >= TextLength())
+		return '\0';
+	return (uchar)fText[offset];
+}
+
+
+void
+BTextView::Cut(BClipboard *clipboard)
+{
+	Copy(clipboard);
+	if (fEditable)
+		Delete();
+}
+
+
+void
+BTextView::Copy(BClipboard *clipboard)
+{
+	if (clipboard == NULL || fSelStart == fSelEnd || !clipboard->Lock())
+		return;
+
+	clipboard->Clear();
+	clipboard->Data()->AddData("text/plain", B_MIME_TYPE,
+		fText.data() + fSelStart, fSelEnd - fSelStart);
+	clipboard->Commit();
+	clipboard->Unlock();
+}
+
+
+void
+BTextView::Paste(BClipboard *clipboard)
+{
+	if (!AcceptsPaste(clipboard) || !clipboard->Lock())
+		return;
+
+	const char *text;
+	ssize_t length;
+	if (clipboard->Data()->FindData("text/plain", B_MIME_TYPE,
+			(const void**)&text, &length) == B_OK)
+		Insert(text, length);
+	clipboard->Unlock();
+}
+
+
+void
+BTextView::Clear()
+{
+	Delete();
+}
+
+
+bool
+BTextView::AcceptsPaste(BClipboard *clipboard)
+{
+	return fEditable && clipboard != NULL;
+}
+
+
+void
+BTextView::Select(int32 startOffset, int32 endOffset)
+{
+	if (!fSelectable)
+		return;
+
+	if (startOffset < 0)
+		startOffset = 0;
+	if (endOffset > TextLength())
+		endOffset = TextLength();
+	if (startOffset > endOffset)
+		startOffset = endOffset;
+	if (startOffset == fSelStart && endOffset == fSelEnd)
+		return;
+
+	fSelStart = startOffset;
+	fSelEnd = endOffset;
+	Invalidate();
+}
+
+
+void
+BTextView::SelectAll()
+{
+	Select(0, TextLength());
+}
+
+
+void
+BTextView::GetSelection(int32 *startOffset, int32 *endOffset) const
+{
+	if (startOffset != NULL)
+		*startOffset = fSelStart;
+	if (endOffset != NULL)
+		*endOffset = fSelEnd;
+}
+
+
+void
+BTextView::DisallowChar(uint32 character)
+{
+	if (character < 256)
+		fDisallowed[character / 8] |= 1 << (character % 8);
+}
+
+
+void
+BTextView::AllowChar(uint32 character)
+{
+	if (character < 256)
+		fDisallowed[character / 8] &= ~(1 << (character % 8));
+}
+
+
+bool
+BTextView::IsCharAllowed(uint32 character) const
+{
+	if (character >= 256)
+		return true;
+	return (fDisallowed[character / 8] & (1 << (character % 8))) == 0;
+}
+
+
+float
+BTextView::LineHeight(int32 lineNumber) const
+{
+	font_height height;
+	GetFontHeight(&height);
+	return ceilf(height.ascent + height.descent + height.leading);
+}
+
+
+float
+BTextView::TextHeight(int32 startLine, int32 endLine) const
+{
+	// everything is on one line
+	return LineHeight(0);
+}
+
+
+void
+BTextView::InsertText(const char *text, int32 length, int32 offset,
+	const void *runs)
+{
+	fText.insert(offset, text, length);
+	Invalidate();
+}
+
+
+void
+BTextView::DeleteText(int32 fromOffset, int32 toOffset)
+{
+	fText.erase(fromOffset, toOffset - fromOffset);
+	Invalidate();
+}
+
+
+void
+BTextView::_Init(BRect textRect)
+{
+	fTextRect = textRect;
+	fSelStart = 0;
+	fSelEnd = 0;
+	fMaxBytes = INT32_MAX;
+	fAlignment = B_ALIGN_LEFT;
+	fEditable = true;
+	fSelectable = true;
+	fWordWrap = true;
+	memset(fDisallowed, 0, sizeof(fDisallowed));
+}
+
+
+//	#pragma mark - _BTextInput_
+
+
+// The text view of a BTextControl, which tells the control about edits
+// and commits its text on Enter or when it loses the focus.
+class _BTextInput_ : public BTextView {
+public:
+							_BTextInput_(BRect frame, BRect textRect,
+								BTextControl *control);
+
+	virtual	void			KeyDown(const char *bytes, int32 numBytes);
+	virtual	void			MakeFocus(bool focus = true);
+
+protected:
+	virtual	void			InsertText(const char *text, int32 length,
+								int32 offset, const void *runs);
+	virtual	void			DeleteText(int32 fromOffset, int32 toOffset);
+
+private:
+			BTextControl*	fControl;
+};
+
+
+_BTextInput_::_BTextInput_(BRect frame, BRect textRect, BTextControl *control)
+	:
+	BTextView(frame, "_input_", textRect, B_FOLLOW_LEFT_RIGHT | B_FOLLOW_TOP,
+		B_WILL_DRAW | B_NAVIGABLE),
+	fControl(control)
+{
+	SetWordWrap(false);
+}
+
+
+void
+_BTextInput_::KeyDown(const char *bytes, int32 numBytes)
+{
+	if (numBytes == 1 && bytes[0] == B_ENTER) {
+		fControl->_TextCommitted();
+		SelectAll();
+		return;
+	}
+
+	BTextView::KeyDown(bytes, numBytes);
+}
+
+
+void
+_BTextInput_::MakeFocus(bool focus)
+{
+	if (focus == IsFocus())
+		return;
+
+	BTextView::MakeFocus(focus);
+	if (focus)
+		SelectAll();
+	else
+		fControl->_TextCommitted();
+	fControl->Invalidate();
+}
+
+
+void
+_BTextInput_::InsertText(const char *text, int32 length, int32 offset,
+	const void *runs)
+{
+	BTextView::InsertText(text, length, offset, runs);
+	fControl->_TextModified();
+}
+
+
+void
+_BTextInput_::DeleteText(int32 fromOffset, int32 toOffset)
+{
+	BTextView::DeleteText(fromOffset, toOffset);
+	fControl->_TextModified();
+}
+
+
+//	#pragma mark - BTextControl
+
+
+BTextControl::BTextControl(BRect frame, const char *name, const char *label,
+	const char *initialText, BMessage *message, uint32 resizingMode,
+	uint32 flags)
+	:
+	BControl(frame, name, label, message, resizingMode,
+		flags | B_FRAME_EVENTS),
+	fModificationMessage(NULL),
+	fDivider(0),
+	fTextChanged(false)
+{
+	// keyboard navigation stops at the text view instead
+	SetFlags(Flags() & ~B_NAVIGABLE);
+	if (label != NULL)
+		fDivider = floorf(StringWidth(label) + 5);
+
+	fText = new _BTextInput_(BRect(0, 0, 10, 10), BRect(0, 0, 10, 10), this);
+	AddChild(fText);
+	_LayoutTextView();
+	SetText(initialText);
+}
+
+
+BTextControl::BTextControl(const char *name, const char *label,
+	const char *initialText, BMessage *message, uint32 flags)
+	:
+	BControl(name, label, message, flags | B_FRAME_EVENTS),
+	fModificationMessage(NULL),
+	fDivider(0),
+	fTextChanged(false)
+{
+	// keyboard navigation stops at the text view instead
+	SetFlags(Flags() & ~B_NAVIGABLE);
+	if (label != NULL)
+		fDivider = floorf(StringWidth(label) + 5);
+
+	fText = new _BTextInput_(BRect(0, 0, 10, 10), BRect(0, 0, 10, 10), this);
+	AddChild(fText);
+	SetText(initialText);
+}
+
+
+BTextControl::~BTextControl()
+{
+	delete fModificationMessage;
+}
+
+
+void
+BTextControl::SetText(const char *text)
+{
+	fText->SetText(text);
+	fTextChanged = false;
+}
+
+
+const char*
+BTextControl::Text() const
+{
+	return fText->Text();
+}
+
+
+void
+BTextControl::SetModificationMessage(BMessage *message)
+{
+	delete fModificationMessage;
+	fModificationMessage = message;
+}
+
+
+void
+BTextControl::SetAlignment(alignment label, alignment text)
+{
+	fText->SetAlignment(text);
+	Invalidate();
+}
+
+
+void
+BTextControl::SetDivider(float position)
+{
+	fDivider = floorf(position + 0.5);
+	_LayoutTextView();
+	Invalidate();
+}
+
+
+void
+BTextControl::Draw(BRect updateRect)
+{
+	BRect frame = fText->Frame().InsetByCopy(-2, -2);
+	StrokeRect(frame);
+	if (Label() != NULL)
+		DrawString(Label(), BPoint(0, frame.bottom - 3));
+}
+
+
+void
+BTextControl::MakeFocus(bool focus)
+{
+	// the text view takes the focus for us
+	fText->MakeFocus(focus);
+}
+
+
+void
+BTextControl::SetEnabled(bool enabled)
+{
+	if (enabled == IsEnabled())
+		return;
+
+	fText->MakeEditable(enabled);
+	fText->MakeSelectable(enabled);
+	BControl::SetEnabled(enabled);
+	fText->Invalidate();
+}
+
+
+void
+BTextControl::SetLabel(const char *label)
+{
+	BControl::SetLabel(label);
+}
+
+
+void
+BTextControl::FrameResized(float width, float height)
+{
+	_LayoutTextView();
+	BControl::FrameResized(width, height);
+}
+
+
+void
+BTextControl::GetPreferredSize(float *width, float *height)
+{
+	float textHeight = fText->LineHeight(0) + 4;
+	if (width != NULL)
+		*width = fDivider + fText->StringWidth("0000000000") + 4;
+	if (height != NULL)
+		*height = textHeight + 2;
+}
+
+
+BSize
+BTextControl::MinSize()
+{
+	BSize size;
+	GetPreferredSize(&size.width, &size.height);
+	size.width = fDivider + 20;
+
+	BSize explicitSize = ExplicitMinSize();
+	if (explicitSize.width != B_SIZE_UNSET)
+		size.width = explicitSize.width;
+	if (explicitSize.height != B_SIZE_UNSET)
+		size.height = explicitSize.height;
+	return size;
+}
+
+
+void
+BTextControl::_LayoutTextView()
+{
+	BRect frame = Bounds();
+	frame.left = fDivider;
+	frame.InsetBy(2, 2);
+	if (!frame.IsValid())
+		return;
+
+	fText->MoveTo(frame.LeftTop());
+	fText->ResizeTo(frame.Width(), frame.Height());
+	fText->SetTextRect(fText->Bounds().InsetByCopy(1, 1));
+}
+
+
+void
+BTextControl::_TextModified()
+{
+	fTextChanged = true;
+	if (fModificationMessage != NULL)
+		Invoke(fModificationMessage);
+}
+
+
+void
+BTextControl::_TextCommitted()
+{
+	if (!fTextChanged)
+		return;
+
+	fTextChanged = false;
+	Invoke();
+}
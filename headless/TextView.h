@@ -0,0 +1,99 @@
+/*
+	TextView.h: Headless stand-in for BTextView.
+
+	Single style, no undo, and the caret always sits at the end of the
+	selection; enough for a one-line numeric field.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_TEXT_VIEW_H_
+#define HEADLESS_TEXT_VIEW_H_
+
+#include <View.h>
+
+#include <string>
+
+class BClipboard;
+
+class BTextView : public BView {
+public:
+							BTextView(BRect frame, const char *name,
+								BRect textRect, uint32 resizingMode,
+								uint32 flags);
+							BTextView(const char *name,
+								uint32 flags = B_WILL_DRAW | B_PULSE_NEEDED);
+	virtual					~BTextView();
+
+	virtual	void			Draw(BRect updateRect);
+	virtual	void			MouseDown(BPoint where);
+	virtual	void			KeyDown(const char *bytes, int32 numBytes);
+	virtual	void			MakeFocus(bool focus = true);
+	virtual	void			MessageReceived(BMessage *message);
+
+			void			SetText(const char *text);
+			void			SetText(const char *text, int32 length);
+			void			Insert(const char *text);
+			void			Insert(const char *text, int32 length);
+			void			Delete();
+			void			Delete(int32 startOffset, int32 endOffset);
+
+			const char*		Text() const { return fText.c_str(); }
+			int32			TextLength() const { return (int32)fText.size(); }
+			void			GetText(int32 offset, int32 length,
+								char *buffer) const;
+			uchar			ByteAt(int32 offset) const;
+
+	virtual	void			Cut(BClipboard *clipboard);
+	virtual	void			Copy(BClipboard *clipboard);
+	virtual	void			Paste(BClipboard *clipboard);
+			void			Clear();
+	virtual	bool			AcceptsPaste(BClipboard *clipboard);
+
+	virtual	void			Select(int32 startOffset, int32 endOffset);
+			void			SelectAll();
+			void			GetSelection(int32 *startOffset,
+								int32 *endOffset) const;
+
+			void			SetTextRect(BRect rect) { fTextRect = rect; }
+			BRect			TextRect() const { return fTextRect; }
+
+			void			MakeEditable(bool editable = true)
+								{ fEditable = editable; }
+			bool			IsEditable() const { return fEditable; }
+			void			MakeSelectable(bool selectable = true)
+								{ fSelectable = selectable; }
+			bool			IsSelectable() const { return fSelectable; }
+			void			SetWordWrap(bool wrap) { fWordWrap = wrap; }
+			bool			DoesWordWrap() const { return fWordWrap; }
+			void			SetMaxBytes(int32 max) { fMaxBytes = max; }
+			int32			MaxBytes() const { return fMaxBytes; }
+			void			SetAlignment(alignment flag) { fAlignment = flag; }
+			alignment		Alignment() const { return fAlignment; }
+
+			void			DisallowChar(uint32 character);
+			void			AllowChar(uint32 character);
+			bool			IsCharAllowed(uint32 character) const;
+
+			float			LineHeight(int32 lineNumber = 0) const;
+			float			TextHeight(int32 startLine, int32 endLine) const;
+
+protected:
+	virtual	void			InsertText(const char *text, int32 length,
+								int32 offset, const void *runs);
+	virtual	void			DeleteText(int32 fromOffset, int32 toOffset);
+
+private:
+			void			_Init(BRect textRect);
+
+			std::string		fText;
+			BRect			fTextRect;
+			int32			fSelStart;
+			int32			fSelEnd;
+			int32			fMaxBytes;
+			alignment		fAlignment;
+			bool			fEditable;
+			bool			fSelectable;
+			bool			fWordWrap;
+			uint8			fDisallowed[256 / 8];
+};
+
+#endif
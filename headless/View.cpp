@@ -0,0 +1,1323 @@
+/*
+	View.cpp: Headless BView with a recording drawing backend.
+	Released under the MIT license.
+*/
+#include <View.h>
+
+#include <AppDefs.h>
+#include <Bitmap.h>
+#include <Layout.h>
+#include <Message.h>
+#include <Window.h>
+
+#include "HeadlessRecorder.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+namespace {
+
+BSize
+compose_size(BSize explicitSize, BSize layoutSize)
+{
+	if (explicitSize.width != B_SIZE_UNSET)
+		layoutSize.width = explicitSize.width;
+	if (explicitSize.height != B_SIZE_UNSET)
+		layoutSize.height = explicitSize.height;
+	return layoutSize;
+}
+
+}	// namespace
+
+
+BView::BView(BRect frame, const char *name, uint32 resizingMode,
+	uint32 flags)
+	:
+	BHandler(name),
+	fWindow(NULL),
+	fBitmap(NULL),
+	fParent(NULL),
+	fFrame(frame),
+	fResizingMode(resizingMode),
+	fFlags(flags),
+	fHideLevel(0),
+	fEventMask(0),
+	fEventOptions(0),
+	fLayout(NULL),
+	fLayoutValid(false)
+{
+	fViewColor = make_color(255, 255, 255);
+	fState.high = make_color(0, 0, 0);
+	fState.low = make_color(255, 255, 255);
+	fState.mode = B_OP_COPY;
+	fState.penSize = 1;
+	fState.font = *be_plain_font;
+}
+
+
+BView::BView(const char *name, uint32 flags, BLayout *layout)
+	:
+	BHandler(name),
+	fWindow(NULL),
+	fBitmap(NULL),
+	fParent(NULL),
+	fFrame(0, 0, 0, 0),
+	fResizingMode(B_FOLLOW_NONE),
+	fFlags(flags | B_SUPPORTS_LAYOUT),
+	fHideLevel(0),
+	fEventMask(0),
+	fEventOptions(0),
+	fLayout(NULL),
+	fLayoutValid(false)
+{
+	fViewColor = make_color(255, 255, 255);
+	fState.high = make_color(0, 0, 0);
+	fState.low = make_color(255, 255, 255);
+	fState.mode = B_OP_COPY;
+	fState.penSize = 1;
+	fState.font = *be_plain_font;
+	SetLayout(layout);
+}
+
+
+BView::BView(BMessage *archive)
+	:
+	BHandler(archive),
+	fWindow(NULL),
+	fBitmap(NULL),
+	fParent(NULL),
+	fFrame(0, 0, 0, 0),
+	fResizingMode(B_FOLLOW_NONE),
+	fFlags(0),
+	fHideLevel(0),
+	fEventMask(0),
+	fEventOptions(0),
+	fLayout(NULL),
+	fLayoutValid(false)
+{
+	fViewColor = make_color(255, 255, 255);
+	fState.high = make_color(0, 0, 0);
+	fState.low = make_color(255, 255, 255);
+	fState.mode = B_OP_COPY;
+	fState.penSize = 1;
+	fState.font = *be_plain_font;
+
+	int32 value;
+	archive->FindRect("_frame", &fFrame);
+	if (archive->FindInt32("_resize_mode", &value) == B_OK)
+		fResizingMode = value;
+	if (archive->FindInt32("_flags", &value) == B_OK)
+		fFlags = value;
+}
+
+
+BView::~BView()
+{
+	if (fParent != NULL)
+		fParent->RemoveChild(this);
+
+	while (!fChildren.empty()) {
+		BView *child = fChildren.back();
+		RemoveChild(child);
+		delete child;
+	}
+
+	delete fLayout;
+}
+
+
+BArchivable*
+BView::Instantiate(BMessage *archive)
+{
+	if (!validate_instantiation(archive, "BView"))
+		return NULL;
+	return new BView(archive);
+}
+
+
+status_t
+BView::Archive(BMessage *archive, bool deep) const
+{
+	// Child views are not archived: there is no class registry to bring
+	// them back with.
+	status_t status = BHandler::Archive(archive, deep);
+	if (status == B_OK)
+		status = archive->AddRect("_frame", fFrame);
+	if (status == B_OK)
+		status = archive->AddInt32("_resize_mode", fResizingMode);
+	if (status == B_OK)
+		status = archive->AddInt32("_flags", fFlags);
+	return status;
+}
+
+
+//	#pragma mark - hooks
+
+
+void
+BView::AttachedToWindow()
+{
+}
+
+
+void
+BView::AllAttached()
+{
+}
+
+
+void
+BView::DetachedFromWindow()
+{
+}
+
+
+void
+BView::AllDetached()
+{
+}
+
+
+void
+BView::MessageReceived(BMessage *message)
+{
+	switch (message->what) {
+		case B_COLORS_UPDATED:
+		case B_FONTS_UPDATED:
+			// the window hands these to every view; they stop here
+			break;
+
+		default:
+			BHandler::MessageReceived(message);
+			break;
+	}
+}
+
+
+void
+BView::Draw(BRect updateRect)
+{
+}
+
+
+void
+BView::DrawAfterChildren(BRect updateRect)
+{
+}
+
+
+void
+BView::MouseDown(BPoint where)
+{
+}
+
+
+void
+BView::MouseUp(BPoint where)
+{
+}
+
+
+void
+BView::MouseMoved(BPoint where, uint32 transit, const BMessage *dragMessage)
+{
+}
+
+
+void
+BView::KeyDown(const char *bytes, int32 numBytes)
+{
+	// unhandled keys go to the parent, like in the real kit
+	if (fParent != NULL)
+		fParent->KeyDown(bytes, numBytes);
+}
+
+
+void
+BView::KeyUp(const char *bytes, int32 numBytes)
+{
+	if (fParent != NULL)
+		fParent->KeyUp(bytes, numBytes);
+}
+
+
+void
+BView::Pulse()
+{
+}
+
+
+void
+BView::FrameMoved(BPoint newPosition)
+{
+}
+
+
+void
+BView::FrameResized(float newWidth, float newHeight)
+{
+}
+
+
+void
+BView::WindowActivated(bool active)
+{
+}
+
+
+void
+BView::MakeFocus(bool focus)
+{
+	if (fWindow != NULL)
+		fWindow->_SetFocus(this, focus);
+}
+
+
+bool
+BView::IsFocus() const
+{
+	return fWindow != NULL && fWindow->CurrentFocus() == this;
+}
+
+
+//	#pragma mark - hierarchy
+
+
+void
+BView::AddChild(BView *child, BView *before)
+{
+	if (child == NULL || child->fParent != NULL || child == this)
+		return;
+
+	std::vector<BView*>::iterator position = std::find(fChildren.begin(),
+		fChildren.end(), before);
+	fChildren.insert(position, child);
+	child->fParent = this;
+
+	if (fBitmap != NULL)
+		child->_SetBitmap(fBitmap);
+	if (fWindow != NULL) {
+		child->_Attach(fWindow);
+		child->Invalidate();
+	}
+	InvalidateLayout();
+}
+
+
+bool
+BView::AddChild(BLayoutItem *child)
+{
+	// only views can be added to a headless view
+	return false;
+}
+
+
+bool
+BView::RemoveChild(BView *child)
+{
+	if (child == NULL || child->fParent != this)
+		return false;
+
+	if (fWindow != NULL) {
+		_InvalidateInParent(child->fFrame);
+		child->_Detach();
+	}
+	if (child->fBitmap != NULL)
+		child->_SetBitmap(NULL);
+
+	fChildren.erase(std::find(fChildren.begin(), fChildren.end(), child));
+	child->fParent = NULL;
+	InvalidateLayout();
+	return true;
+}
+
+
+int32
+BView::CountChildren() const
+{
+	return (int32)fChildren.size();
+}
+
+
+BView*
+BView::ChildAt(int32 index) const
+{
+	if (index < 0 || index >= (int32)fChildren.size())
+		return NULL;
+	return fChildren[index];
+}
+
+
+BView*
+BView::NextSibling() const
+{
+	if (fParent == NULL)
+		return NULL;
+
+	const std::vector<BView*> &siblings = fParent->fChildren;
+	std::vector<BView*>::const_iterator i = std::find(siblings.begin(),
+		siblings.end(), this);
+	return i + 1 < siblings.end() ? *(i + 1) : NULL;
+}
+
+
+BView*
+BView::PreviousSibling() const
+{
+	if (fParent == NULL)
+		return NULL;
+
+	const std::vector<BView*> &siblings = fParent->fChildren;
+	std::vector<BView*>::const_iterator i = std::find(siblings.begin(),
+		siblings.end(), this);
+	return i != siblings.begin() ? *(i - 1) : NULL;
+}
+
+
+bool
+BView::RemoveSelf()
+{
+	if (fParent != NULL)
+		return fParent->RemoveChild(this);
+	if (fWindow != NULL)
+		return fWindow->RemoveChild(this);
+	return false;
+}
+
+
+BView*
+BView::FindView(const char *name) const
+{
+	if (name == NULL)
+		return NULL;
+
+	for (size_t i = 0; i < fChildren.size(); i++) {
+		BView *child = fChildren[i];
+		if (child->Name() != NULL && strcmp(child->Name(), name) == 0)
+			return child;
+		BView *found = child->FindView(name);
+		if (found != NULL)
+			return found;
+	}
+	return NULL;
+}
+
+
+//	#pragma mark - geometry
+
+
+BRect
+BView::Bounds() const
+{
+	return BRect(fScrollOffset.x, fScrollOffset.y,
+		fScrollOffset.x + fFrame.Width(), fScrollOffset.y + fFrame.Height());
+}
+
+
+BRect
+BView::Frame() const
+{
+	return fFrame;
+}
+
+
+void
+BView::MoveBy(float dh, float dv)
+{
+	if (dh == 0 && dv == 0)
+		return;
+
+	BRect oldFrame = fFrame;
+	fFrame.OffsetBy(dh, dv);
+	_FrameChanged(oldFrame);
+}
+
+
+void
+BView::MoveTo(BPoint where)
+{
+	MoveBy(where.x - fFrame.left, where.y - fFrame.top);
+}
+
+
+void
+BView::MoveTo(float x, float y)
+{
+	MoveTo(BPoint(x, y));
+}
+
+
+void
+BView::ResizeBy(float dh, float dv)
+{
+	if (dh == 0 && dv == 0)
+		return;
+
+	BRect oldFrame = fFrame;
+	fFrame.right += dh;
+	fFrame.bottom += dv;
+	_ResizeChildren(dh, dv);
+	_FrameChanged(oldFrame);
+}
+
+
+void
+BView::ResizeTo(float width, float height)
+{
+	ResizeBy(width - fFrame.Width(), height - fFrame.Height());
+}
+
+
+void
+BView::ResizeTo(BSize size)
+{
+	ResizeTo(size.width, size.height);
+}
+
+
+void
+BView::ScrollBy(float dh, float dv)
+{
+	ScrollTo(BPoint(fScrollOffset.x + dh, fScrollOffset.y + dv));
+}
+
+
+void
+BView::ScrollTo(float x, float y)
+{
+	ScrollTo(BPoint(x, y));
+}
+
+
+void
+BView::ScrollTo(BPoint where)
+{
+	if (where == fScrollOffset)
+		return;
+
+	fScrollOffset = where;
+	Invalidate();
+}
+
+
+BPoint
+BView::ConvertToParent(BPoint point) const
+{
+	return point - fScrollOffset + fFrame.LeftTop();
+}
+
+
+BRect
+BView::ConvertToParent(BRect rect) const
+{
+	BPoint offset = fFrame.LeftTop() - fScrollOffset;
+	return rect.OffsetByCopy(offset.x, offset.y);
+}
+
+
+BPoint
+BView::ConvertFromParent(BPoint point) const
+{
+	return point + fScrollOffset - fFrame.LeftTop();
+}
+
+
+BRect
+BView::ConvertFromParent(BRect rect) const
+{
+	BPoint offset = fScrollOffset - fFrame.LeftTop();
+	return rect.OffsetByCopy(offset.x, offset.y);
+}
+
+
+BPoint
+BView::ConvertToWindow(BPoint point) const
+{
+	for (const BView *view = this; view != NULL; view = view->fParent)
+		point = view->ConvertToParent(point);
+	return point;
+}
+
+
+BRect
+BView::ConvertToWindow(BRect rect) const
+{
+	for (const BView *view = this; view != NULL; view = view->fParent)
+		rect = view->ConvertToParent(rect);
+	return rect;
+}
+
+
+BPoint
+BView::ConvertFromWindow(BPoint point) const
+{
+	BPoint origin = ConvertToWindow(BPoint(0, 0));
+	return point - origin;
+}
+
+
+BRect
+BView::ConvertFromWindow(BRect rect) const
+{
+	BPoint origin = ConvertToWindow(BPoint(0, 0));
+	return rect.OffsetByCopy(-origin.x, -origin.y);
+}
+
+
+void
+BView::SetResizingMode(uint32 mode)
+{
+	fResizingMode = mode;
+}
+
+
+void
+BView::SetFlags(uint32 flags)
+{
+	fFlags = flags;
+}
+
+
+void
+BView::Show()
+{
+	if (fHideLevel == 0)
+		return;
+
+	if (--fHideLevel == 0)
+		Invalidate();
+}
+
+
+void
+BView::Hide()
+{
+	if (fHideLevel++ == 0 && fParent != NULL && fWindow != NULL)
+		_InvalidateInParent(fFrame);
+}
+
+
+bool
+BView::IsHidden() const
+{
+	return IsHidden(NULL);
+}
+
+
+bool
+BView::IsHidden(const BView *lookingFrom) const
+{
+	for (const BView *view = this; view != NULL && view != lookingFrom;
+			view = view->fParent) {
+		if (view->fHideLevel > 0)
+			return true;
+	}
+	return lookingFrom == NULL && fWindow != NULL && fWindow->IsHidden();
+}
+
+
+//	#pragma mark - input
+
+
+void
+BView::GetMouse(BPoint *location, uint32 *buttons, bool checkMessageQueue)
+{
+	if (fWindow == NULL) {
+		if (location != NULL)
+			*location = BPoint(-1, -1);
+		if (buttons != NULL)
+			*buttons = 0;
+		return;
+	}
+
+	if (location != NULL)
+		*location = ConvertFromWindow(fWindow->HeadlessMouseLocation());
+	if (buttons != NULL)
+		*buttons = fWindow->HeadlessMouseButtons();
+}
+
+
+status_t
+BView::SetMouseEventMask(uint32 mask, uint32 options)
+{
+	if (fWindow == NULL)
+		return B_ERROR;
+
+	// lasts until the mouse button is released
+	if ((mask & B_POINTER_EVENTS) != 0)
+		fWindow->_SetMouseTarget(this, options);
+	return B_OK;
+}
+
+
+status_t
+BView::SetEventMask(uint32 mask, uint32 options)
+{
+	fEventMask = mask;
+	fEventOptions = options;
+	return B_OK;
+}
+
+
+//	#pragma mark - drawing
+
+
+void
+BView::Invalidate(BRect invalRect)
+{
+	if (fWindow == NULL || IsHidden())
+		return;
+
+	invalRect = invalRect & Bounds();
+	if (!invalRect.IsValid())
+		return;
+
+	HeadlessRecorder::Record(HEADLESS_INVALIDATE);
+	BRect windowRect = ConvertToWindow(invalRect);
+	fDirty = fDirty | windowRect;
+	fWindow->_Invalidate(windowRect);
+}
+
+
+void
+BView::Invalidate()
+{
+	Invalidate(Bounds());
+}
+
+
+void
+BView::SetViewColor(rgb_color color)
+{
+	fViewColor = color;
+}
+
+
+void
+BView::SetViewColor(uchar r, uchar g, uchar b, uchar a)
+{
+	SetViewColor(make_color(r, g, b, a));
+}
+
+
+void
+BView::SetHighColor(rgb_color color)
+{
+	fState.high = color;
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::SetHighColor(uchar r, uchar g, uchar b, uchar a)
+{
+	SetHighColor(make_color(r, g, b, a));
+}
+
+
+void
+BView::SetLowColor(rgb_color color)
+{
+	fState.low = color;
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::SetLowColor(uchar r, uchar g, uchar b, uchar a)
+{
+	SetLowColor(make_color(r, g, b, a));
+}
+
+
+void
+BView::SetDrawingMode(drawing_mode mode)
+{
+	fState.mode = mode;
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::SetPenSize(float size)
+{
+	fState.penSize = size;
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::PushState()
+{
+	fStateStack.push_back(fState);
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::PopState()
+{
+	if (fStateStack.empty())
+		return;
+
+	fState = fStateStack.back();
+	fStateStack.pop_back();
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::MovePenTo(BPoint point)
+{
+	fState.pen = point;
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::MovePenTo(float x, float y)
+{
+	MovePenTo(BPoint(x, y));
+}
+
+
+void
+BView::StrokeLine(BPoint toPoint)
+{
+	StrokeLine(fState.pen, toPoint);
+}
+
+
+void
+BView::StrokeLine(BPoint start, BPoint end)
+{
+	fState.pen = end;
+	_RecordOp(HEADLESS_STROKE);
+}
+
+
+void
+BView::StrokeRect(BRect rect)
+{
+	_RecordOp(HEADLESS_STROKE);
+}
+
+
+void
+BView::FillRect(BRect rect)
+{
+	_RecordOp(HEADLESS_FILL);
+}
+
+
+void
+BView::FillRoundRect(BRect rect, float xRadius, float yRadius)
+{
+	_RecordOp(HEADLESS_FILL);
+}
+
+
+void
+BView::FillTriangle(BPoint p1, BPoint p2, BPoint p3)
+{
+	_RecordOp(HEADLESS_FILL);
+}
+
+
+void
+BView::DrawString(const char *string)
+{
+	DrawString(string, fState.pen);
+}
+
+
+void
+BView::DrawString(const char *string, BPoint location)
+{
+	_RecordOp(HEADLESS_STRING);
+}
+
+
+void
+BView::DrawString(const char *string, int32 length, BPoint location)
+{
+	_RecordOp(HEADLESS_STRING);
+}
+
+
+void
+BView::DrawBitmap(const BBitmap *bitmap)
+{
+	_RecordOp(HEADLESS_BITMAP);
+}
+
+
+void
+BView::DrawBitmap(const BBitmap *bitmap, BPoint where)
+{
+	_RecordOp(HEADLESS_BITMAP);
+}
+
+
+void
+BView::DrawBitmap(const BBitmap *bitmap, BRect bitmapRect, BRect viewRect)
+{
+	_RecordOp(HEADLESS_BITMAP);
+}
+
+
+void
+BView::SetFont(const BFont *font, uint32 mask)
+{
+	if (font == NULL)
+		return;
+
+	if (mask == B_FONT_ALL)
+		fState.font = *font;
+	else {
+		if ((mask & B_FONT_FAMILY_AND_STYLE) != 0) {
+			font_family family;
+			font_style style;
+			font->GetFamilyAndStyle(&family, &style);
+			fState.font.SetFamilyAndStyle(family, style);
+		}
+		if ((mask & B_FONT_SIZE) != 0)
+			fState.font.SetSize(font->Size());
+		if ((mask & B_FONT_FACE) != 0)
+			fState.font.SetFace(font->Face());
+		if ((mask & B_FONT_SPACING) != 0)
+			fState.font.SetSpacing(font->Spacing());
+	}
+	_RecordOp(HEADLESS_STATE);
+}
+
+
+void
+BView::GetFont(BFont *font) const
+{
+	*font = fState.font;
+}
+
+
+void
+BView::GetFontHeight(font_height *height) const
+{
+	fState.font.GetHeight(height);
+}
+
+
+void
+BView::SetFontSize(float size)
+{
+	BFont font;
+	font.SetSize(size);
+	SetFont(&font, B_FONT_SIZE);
+}
+
+
+float
+BView::StringWidth(const char *string) const
+{
+	return fState.font.StringWidth(string);
+}
+
+
+float
+BView::StringWidth(const char *string, int32 length) const
+{
+	return fState.font.StringWidth(string, length);
+}
+
+
+//	#pragma mark - layout
+
+
+void
+BView::SetExplicitMinSize(BSize size)
+{
+	fExplicitMin = size;
+	InvalidateLayout();
+}
+
+
+void
+BView::SetExplicitMaxSize(BSize size)
+{
+	fExplicitMax = size;
+	InvalidateLayout();
+}
+
+
+void
+BView::SetExplicitPreferredSize(BSize size)
+{
+	fExplicitPreferred = size;
+	InvalidateLayout();
+}
+
+
+void
+BView::SetExplicitAlignment(BAlignment alignment)
+{
+	fExplicitAlignment = alignment;
+	InvalidateLayout();
+}
+
+
+BSize
+BView::MinSize()
+{
+	return compose_size(fExplicitMin,
+		fLayout != NULL ? fLayout->MinSize() : BSize(0, 0));
+}
+
+
+BSize
+BView::MaxSize()
+{
+	return compose_size(fExplicitMax, fLayout != NULL ? fLayout->MaxSize()
+		: BSize(B_SIZE_UNLIMITED, B_SIZE_UNLIMITED));
+}
+
+
+BSize
+BView::PreferredSize()
+{
+	BSize size;
+	if (fLayout != NULL)
+		size = fLayout->PreferredSize();
+	else
+		GetPreferredSize(&size.width, &size.height);
+	return compose_size(fExplicitPreferred, size);
+}
+
+
+BAlignment
+BView::LayoutAlignment()
+{
+	BAlignment alignment = fExplicitAlignment;
+	if (alignment.horizontal == B_ALIGN_HORIZONTAL_UNSET)
+		alignment.horizontal = B_ALIGN_HORIZONTAL_CENTER;
+	if (alignment.vertical == B_ALIGN_VERTICAL_UNSET)
+		alignment.vertical = B_ALIGN_VERTICAL_CENTER;
+	return alignment;
+}
+
+
+void
+BView::GetPreferredSize(float *width, float *height)
+{
+	if (width != NULL)
+		*width = fFrame.Width();
+	if (height != NULL)
+		*height = fFrame.Height();
+}
+
+
+void
+BView::ResizeToPreferred()
+{
+	float width;
+	float height;
+	GetPreferredSize(&width, &height);
+	ResizeTo(width, height);
+}
+
+
+void
+BView::SetLayout(BLayout *layout)
+{
+	if (layout == fLayout)
+		return;
+
+	delete fLayout;
+	fLayout = layout;
+	if (fLayout != NULL) {
+		fLayout->fOwner = this;
+		fFlags |= B_SUPPORTS_LAYOUT;
+	}
+	InvalidateLayout();
+}
+
+
+void
+BView::InvalidateLayout(bool descendants)
+{
+	if (descendants) {
+		for (size_t i = 0; i < fChildren.size(); i++)
+			fChildren[i]->InvalidateLayout(true);
+	}
+
+	if (!fLayoutValid && !descendants)
+		return;
+
+	fLayoutValid = false;
+	LayoutInvalidated(descendants);
+	if (fParent != NULL && (fParent->fFlags & B_SUPPORTS_LAYOUT) != 0)
+		fParent->InvalidateLayout();
+}
+
+
+void
+BView::Relayout()
+{
+	InvalidateLayout();
+	Layout(false);
+}
+
+
+void
+BView::Layout(bool force)
+{
+	if (!fLayoutValid || force) {
+		fLayoutValid = true;
+		DoLayout();
+	}
+
+	for (size_t i = 0; i < fChildren.size(); i++)
+		fChildren[i]->Layout(false);
+}
+
+
+void
+BView::ResetLayoutInvalidation()
+{
+	fLayoutValid = true;
+}
+
+
+void
+BView::DoLayout()
+{
+}
+
+
+void
+BView::LayoutInvalidated(bool descendants)
+{
+}
+
+
+BHandler*
+BView::ResolveSpecifier(BMessage *message, int32 index, BMessage *specifier,
+	int32 form, const char *property)
+{
+	if (property != NULL && strcmp(property, "View") == 0) {
+		BView *child = NULL;
+		int32 childIndex;
+		const char *name;
+		if (form == B_INDEX_SPECIFIER
+			&& specifier->FindInt32("index", &childIndex) == B_OK)
+			child = ChildAt(childIndex);
+		else if (form == B_NAME_SPECIFIER
+			&& specifier->FindString("name", &name) == B_OK)
+			child = FindView(name);
+
+		if (child != NULL) {
+			message->PopSpecifier();
+			return child;
+		}
+	}
+
+	return BHandler::ResolveSpecifier(message, index, specifier, form,
+		property);
+}
+
+
+status_t
+BView::GetSupportedSuites(BMessage *data)
+{
+	if (data == NULL)
+		return B_BAD_VALUE;
+
+	status_t status = data->AddString("suites", "suite/vnd.Be-view");
+	if (status != B_OK)
+		return status;
+	return BHandler::GetSupportedSuites(data);
+}
+
+
+//	#pragma mark - private
+
+
+void
+BView::_Attach(BWindow *window)
+{
+	fWindow = window;
+	window->AddHandler(this);
+	SetNextHandler(fParent != NULL ? (BHandler*)fParent : (BHandler*)window);
+
+	AttachedToWindow();
+	for (size_t i = 0; i < fChildren.size(); i++)
+		fChildren[i]->_Attach(window);
+	AllAttached();
+}
+
+
+void
+BView::_Detach()
+{
+	DetachedFromWindow();
+	for (size_t i = 0; i < fChildren.size(); i++)
+		fChildren[i]->_Detach();
+	AllDetached();
+
+	fWindow->_ViewDetached(this);
+	fWindow->RemoveHandler(this);
+	fWindow = NULL;
+	fDirty = BRect();
+}
+
+
+void
+BView::_SetBitmap(BBitmap *bitmap)
+{
+	fBitmap = bitmap;
+	for (size_t i = 0; i < fChildren.size(); i++)
+		fChildren[i]->_SetBitmap(bitmap);
+}
+
+
+// Runs the Draw() hooks of this view and its children for the parts of the
+// dirty area they cover, the way the app_server clips an update: a view
+// whose dirty parts all lie under one of its children is not asked to draw.
+void
+BView::_Draw(const std::vector<BRect> &dirty)
+{
+	if (fHideLevel > 0)
+		return;
+
+	BRect visible = ConvertToWindow(Bounds());
+	BRect update;
+	bool covered = true;
+	for (size_t i = 0; i < dirty.size(); i++) {
+		BRect part = visible & dirty[i];
+		if (!part.IsValid())
+			continue;
+
+		update = update | part;
+		if (covered && (fFlags & B_DRAW_ON_CHILDREN) == 0) {
+			bool underChild = false;
+			for (size_t j = 0; j < fChildren.size() && !underChild; j++) {
+				BView *child = fChildren[j];
+				underChild = child->fHideLevel == 0
+					&& child->ConvertToWindow(child->Bounds()).Contains(part);
+			}
+			covered = underChild;
+		} else
+			covered = false;
+	}
+	fDirty = BRect();
+	if (!update.IsValid())
+		return;
+
+	update = ConvertFromWindow(update);
+	bool willDraw = (fFlags & B_WILL_DRAW) != 0 && !covered;
+	if (willDraw) {
+		HeadlessRecorder::Record(HEADLESS_DRAW_HOOK);
+		Draw(update);
+	}
+
+	for (size_t i = 0; i < fChildren.size(); i++)
+		fChildren[i]->_Draw(dirty);
+
+	if (willDraw && (fFlags & B_DRAW_ON_CHILDREN) != 0)
+		DrawAfterChildren(update);
+}
+
+
+BView*
+BView::_ViewAt(BPoint windowPoint)
+{
+	if (fHideLevel > 0 || !ConvertToWindow(Bounds()).Contains(windowPoint))
+		return NULL;
+
+	// later children are on top
+	for (size_t i = fChildren.size(); i-- > 0;) {
+		BView *view = fChildren[i]->_ViewAt(windowPoint);
+		if (view != NULL)
+			return view;
+	}
+	return this;
+}
+
+
+void
+BView::_RecordOp(int32 op)
+{
+	if (fBitmap != NULL)
+		HeadlessRecorder::Record(HEADLESS_OFFSCREEN);
+	else if (fWindow != NULL)
+		HeadlessRecorder::Record((headless_op)op);
+}
+
+
+void
+BView::_InvalidateInParent(BRect frame)
+{
+	if (fParent != NULL)
+		fParent->Invalidate(fParent->ConvertFromParent(frame));
+	else if (fWindow != NULL)
+		fWindow->_Invalidate(frame);
+}
+
+
+// Moves and sizes the children that follow the sides of this view.
+void
+BView::_ResizeChildren(float dh, float dv)
+{
+	for (size_t i = 0; i < fChildren.size(); i++) {
+		BView *child = fChildren[i];
+		uint32 mode = child->fResizingMode;
+
+		float moveH = 0;
+		float growH = 0;
+		switch (mode & B_FOLLOW_LEFT_RIGHT) {
+			case B_FOLLOW_RIGHT:
+				moveH = dh;
+				break;
+			case B_FOLLOW_LEFT_RIGHT:
+				growH = dh;
+				break;
+		}
+		if ((mode & B_FOLLOW_H_CENTER) != 0)
+			moveH = dh / 2;
+
+		float moveV = 0;
+		float growV = 0;
+		switch (mode & B_FOLLOW_TOP_BOTTOM) {
+			case B_FOLLOW_BOTTOM:
+				moveV = dv;
+				break;
+			case B_FOLLOW_TOP_BOTTOM:
+				growV = dv;
+				break;
+		}
+		if ((mode & B_FOLLOW_V_CENTER) != 0)
+			moveV = dv / 2;
+
+		child->MoveBy(moveH, moveV);
+		child->ResizeBy(growH, growV);
+	}
+}
+
+
+void
+BView::_FrameChanged(BRect oldFrame)
+{
+	if (fWindow != NULL) {
+		_InvalidateInParent(oldFrame);
+		_InvalidateInParent(fFrame);
+	}
+
+	if (oldFrame.LeftTop() != fFrame.LeftTop()
+		&& (fFlags & B_FRAME_EVENTS) != 0)
+		FrameMoved(fFrame.LeftTop());
+	if ((oldFrame.Width() != fFrame.Width()
+			|| oldFrame.Height() != fFrame.Height())) {
+		if ((fFlags & B_FRAME_EVENTS) != 0)
+			FrameResized(fFrame.Width(), fFrame.Height());
+		InvalidateLayout();
+	}
+}
@@ -0,0 +1,293 @@
+/*
+	View.h: Headless stand-in for BView.
+
+	Views keep their geometry and hierarchy like the real thing. Drawing
+	calls do not rasterize anything; they are counted by the recorder in
+	HeadlessRecorder.h so tests can see what a control paints and how often.
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_VIEW_H_
+#define HEADLESS_VIEW_H_
+
+#include <Alignment.h>
+#include <Font.h>
+#include <Handler.h>
+#include <InterfaceDefs.h>
+#include <Rect.h>
+
+#include <vector>
+
+class BBitmap;
+class BLayout;
+class BLayoutItem;
+class BWindow;
+
+enum {
+	B_ENTERED_VIEW = 0,
+	B_INSIDE_VIEW,
+	B_EXITED_VIEW,
+	B_OUTSIDE_VIEW
+};
+
+enum {
+	B_POINTER_EVENTS	= 0x00000001,
+	B_KEYBOARD_EVENTS	= 0x00000002
+};
+
+enum {
+	B_LOCK_WINDOW_FOCUS		= 0x00000001,
+	B_SUSPEND_VIEW_FOCUS	= 0x00000002,
+	B_NO_POINTER_HISTORY	= 0x00000004,
+	B_FULL_POINTER_HISTORY	= 0x00000010
+};
+
+enum {
+	B_FOLLOW_NONE			= 0,
+	B_FOLLOW_LEFT			= 0x0001,
+	B_FOLLOW_RIGHT			= 0x0002,
+	B_FOLLOW_LEFT_RIGHT		= 0x0003,
+	B_FOLLOW_H_CENTER		= 0x0004,
+	B_FOLLOW_TOP			= 0x0010,
+	B_FOLLOW_BOTTOM			= 0x0020,
+	B_FOLLOW_TOP_BOTTOM		= 0x0030,
+	B_FOLLOW_V_CENTER		= 0x0040,
+	B_FOLLOW_ALL_SIDES		= 0x0033,
+	B_FOLLOW_ALL			= B_FOLLOW_ALL_SIDES
+};
+
+const uint32 B_FULL_UPDATE_ON_RESIZE	= 0x80000000UL;
+const uint32 _B_RESERVED1_				= 0x40000000UL;
+const uint32 B_WILL_DRAW				= 0x20000000UL;
+const uint32 B_PULSE_NEEDED				= 0x10000000UL;
+const uint32 B_NAVIGABLE_JUMP			= 0x08000000UL;
+const uint32 B_FRAME_EVENTS				= 0x04000000UL;
+const uint32 B_NAVIGABLE				= 0x02000000UL;
+const uint32 B_SUBPIXEL_PRECISE			= 0x01000000UL;
+const uint32 B_DRAW_ON_CHILDREN			= 0x00800000UL;
+const uint32 B_INPUT_METHOD_AWARE		= 0x00400000UL;
+const uint32 B_SUPPORTS_LAYOUT			= 0x00100000UL;
+const uint32 B_INVALIDATE_AFTER_LAYOUT	= 0x00080000UL;
+
+class BView : public BHandler {
+public:
+							BView(BRect frame, const char *name,
+								uint32 resizingMode, uint32 flags);
+							BView(const char *name, uint32 flags,
+								BLayout *layout = NULL);
+							BView(BMessage *archive);
+	virtual					~BView();
+
+	static	BArchivable*	Instantiate(BMessage *archive);
+	virtual	status_t		Archive(BMessage *archive, bool deep = true) const;
+
+	// hooks
+	virtual	void			AttachedToWindow();
+	virtual	void			AllAttached();
+	virtual	void			DetachedFromWindow();
+	virtual	void			AllDetached();
+
+	virtual	void			MessageReceived(BMessage *message);
+
+	virtual	void			Draw(BRect updateRect);
+	virtual	void			DrawAfterChildren(BRect updateRect);
+	virtual	void			MouseDown(BPoint where);
+	virtual	void			MouseUp(BPoint where);
+	virtual	void			MouseMoved(BPoint where, uint32 transit,
+								const BMessage *dragMessage);
+	virtual	void			KeyDown(const char *bytes, int32 numBytes);
+	virtual	void			KeyUp(const char *bytes, int32 numBytes);
+	virtual	void			Pulse();
+	virtual	void			FrameMoved(BPoint newPosition);
+	virtual	void			FrameResized(float newWidth, float newHeight);
+	virtual	void			WindowActivated(bool active);
+	virtual	void			MakeFocus(bool focus = true);
+			bool			IsFocus() const;
+
+	// hierarchy
+			BWindow*		Window() const { return fWindow; }
+			BView*			Parent() const { return fParent; }
+			void			AddChild(BView *child, BView *before = NULL);
+			bool			AddChild(BLayoutItem *child);
+			bool			RemoveChild(BView *child);
+			int32			CountChildren() const;
+			BView*			ChildAt(int32 index) const;
+			BView*			NextSibling() const;
+			BView*			PreviousSibling() const;
+			bool			RemoveSelf();
+			BView*			FindView(const char *name) const;
+
+	// geometry
+			BRect			Bounds() const;
+			BRect			Frame() const;
+			void			MoveBy(float dh, float dv);
+			void			MoveTo(BPoint where);
+			void			MoveTo(float x, float y);
+			void			ResizeBy(float dh, float dv);
+			void			ResizeTo(float width, float height);
+			void			ResizeTo(BSize size);
+			void			ScrollBy(float dh, float dv);
+			void			ScrollTo(float x, float y);
+	virtual	void			ScrollTo(BPoint where);
+			BPoint			LeftTop() const { return Bounds().LeftTop(); }
+
+			BPoint			ConvertToParent(BPoint point) const;
+			BRect			ConvertToParent(BRect rect) const;
+			BPoint			ConvertFromParent(BPoint point) const;
+			BRect			ConvertFromParent(BRect rect) const;
+			BPoint			ConvertToWindow(BPoint point) const;
+			BRect			ConvertToWindow(BRect rect) const;
+			BPoint			ConvertFromWindow(BPoint point) const;
+			BRect			ConvertFromWindow(BRect rect) const;
+
+			uint32			ResizingMode() const { return fResizingMode; }
+	virtual	void			SetResizingMode(uint32 mode);
+			uint32			Flags() const { return fFlags; }
+	virtual	void			SetFlags(uint32 flags);
+
+	virtual	void			Show();
+	virtual	void			Hide();
+			bool			IsHidden() const;
+			bool			IsHidden(const BView *lookingFrom) const;
+
+	// input
+			void			GetMouse(BPoint *location, uint32 *buttons,
+								bool checkMessageQueue = true);
+			status_t		SetMouseEventMask(uint32 mask, uint32 options = 0);
+			status_t		SetEventMask(uint32 mask, uint32 options = 0);
+			uint32			EventMask() { return fEventMask; }
+
+	// drawing
+			void			Invalidate(BRect invalRect);
+			void			Invalidate();
+			void			Sync() const {}
+			void			Flush() const {}
+
+	virtual	void			SetViewColor(rgb_color color);
+			void			SetViewColor(uchar r, uchar g, uchar b,
+								uchar a = 255);
+			rgb_color		ViewColor() const { return fViewColor; }
+	virtual	void			SetHighColor(rgb_color color);
+			void			SetHighColor(uchar r, uchar g, uchar b,
+								uchar a = 255);
+			rgb_color		HighColor() const { return fState.high; }
+	virtual	void			SetLowColor(rgb_color color);
+			void			SetLowColor(uchar r, uchar g, uchar b,
+								uchar a = 255);
+			rgb_color		LowColor() const { return fState.low; }
+	virtual	void			SetDrawingMode(drawing_mode mode);
+			drawing_mode	DrawingMode() const { return fState.mode; }
+	virtual	void			SetPenSize(float size);
+			float			PenSize() const { return fState.penSize; }
+
+			void			PushState();
+			void			PopState();
+
+			void			MovePenTo(BPoint point);
+			void			MovePenTo(float x, float y);
+			BPoint			PenLocation() const { return fState.pen; }
+
+			void			StrokeLine(BPoint toPoint);
+			void			StrokeLine(BPoint start, BPoint end);
+			void			StrokeRect(BRect rect);
+			void			FillRect(BRect rect);
+			void			FillRoundRect(BRect rect, float xRadius,
+								float yRadius);
+			void			FillTriangle(BPoint p1, BPoint p2, BPoint p3);
+			void			DrawString(const char *string);
+			void			DrawString(const char *string, BPoint location);
+			void			DrawString(const char *string, int32 length,
+								BPoint location);
+			void			DrawBitmap(const BBitmap *bitmap);
+			void			DrawBitmap(const BBitmap *bitmap, BPoint where);
+			void			DrawBitmap(const BBitmap *bitmap, BRect bitmapRect,
+								BRect viewRect);
+
+	virtual	void			SetFont(const BFont *font,
+								uint32 mask = B_FONT_ALL);
+			void			GetFont(BFont *font) const;
+			void			GetFontHeight(font_height *height) const;
+			void			SetFontSize(float size);
+			float			StringWidth(const char *string) const;
+			float			StringWidth(const char *string,
+								int32 length) const;
+
+	// layout
+			void			SetExplicitMinSize(BSize size);
+			void			SetExplicitMaxSize(BSize size);
+			void			SetExplicitPreferredSize(BSize size);
+			void			SetExplicitAlignment(BAlignment alignment);
+			BSize			ExplicitMinSize() const { return fExplicitMin; }
+	virtual	BSize			MinSize();
+	virtual	BSize			MaxSize();
+	virtual	BSize			PreferredSize();
+	virtual	BAlignment		LayoutAlignment();
+	virtual	void			GetPreferredSize(float *width, float *height);
+	virtual	void			ResizeToPreferred();
+
+	virtual	void			SetLayout(BLayout *layout);
+			BLayout*		GetLayout() const { return fLayout; }
+			void			InvalidateLayout(bool descendants = false);
+			void			Relayout();
+			void			Layout(bool force);
+			bool			IsLayoutValid() const { return fLayoutValid; }
+			void			ResetLayoutInvalidation();
+
+	virtual	BHandler*		ResolveSpecifier(BMessage *message, int32 index,
+								BMessage *specifier, int32 form,
+								const char *property);
+	virtual	status_t		GetSupportedSuites(BMessage *data);
+
+	// headless: window-relative dirty area waiting for the next update
+			BRect			HeadlessDirtyRect() const { return fDirty; }
+
+protected:
+	virtual	void			DoLayout();
+	virtual	void			LayoutInvalidated(bool descendants);
+
+private:
+	friend class BWindow;
+	friend class BBitmap;
+
+	struct State {
+		rgb_color		high;
+		rgb_color		low;
+		drawing_mode	mode;
+		float			penSize;
+		BPoint			pen;
+		BFont			font;
+	};
+
+			void			_Attach(BWindow *window);
+			void			_Detach();
+			void			_SetBitmap(BBitmap *bitmap);
+			void			_Draw(const std::vector<BRect> &dirty);
+			BView*			_ViewAt(BPoint windowPoint);
+			void			_RecordOp(int32 op);
+			void			_InvalidateInParent(BRect frame);
+			void			_ResizeChildren(float dh, float dv);
+			void			_FrameChanged(BRect oldFrame);
+
+			BWindow*		fWindow;
+			BBitmap*		fBitmap;
+			BView*			fParent;
+			std::vector<BView*> fChildren;
+			BRect			fFrame;
+			BPoint			fScrollOffset;
+			uint32			fResizingMode;
+			uint32			fFlags;
+			int32			fHideLevel;
+			uint32			fEventMask;
+			uint32			fEventOptions;
+			rgb_color		fViewColor;
+			State			fState;
+			std::vector<State> fStateStack;
+			BRect			fDirty;
+			BLayout*		fLayout;
+			bool			fLayoutValid;
+			BSize			fExplicitMin;
+			BSize			fExplicitMax;
+			BSize			fExplicitPreferred;
+			BAlignment		fExplicitAlignment;
+};
+
+#endif
@@ -0,0 +1,411 @@
+/*
+	Window.cpp: Headless BWindow.
+	Released under the MIT license.
+*/
+#include <Window.h>
+
+#include <AppDefs.h>
+#include <Autolock.h>
+#include <InterfaceDefs.h>
+
+#include "HeadlessRecorder.h"
+
+#include <string.h>
+
+namespace {
+
+// the keyboard state as of the last key message any window dispatched
+uint32 sModifiers = 0;
+
+
+void
+collect_navigable(BView *view, std::vector<BView*> &views)
+{
+	if (view->IsHidden(NULL))
+		return;
+
+	if ((view->Flags() & (B_NAVIGABLE | B_NAVIGABLE_JUMP)) != 0)
+		views.push_back(view);
+	for (int32 i = 0; i < view->CountChildren(); i++)
+		collect_navigable(view->ChildAt(i), views);
+}
+
+
+void
+broadcast(BView *view, BMessage *message)
+{
+	view->MessageReceived(message);
+	for (int32 i = 0; i < view->CountChildren(); i++)
+		broadcast(view->ChildAt(i), message);
+}
+
+}	// namespace
+
+
+uint32
+modifiers()
+{
+	return sModifiers;
+}
+
+
+BWindow::BWindow(BRect frame, const char *title, window_type type,
+	uint32 flags, uint32 workspace)
+	:
+	BLooper(title),
+	fTopView(NULL),
+	fFocus(NULL),
+	fMouseTarget(NULL),
+	fLastMouseView(NULL),
+	fMouseTargetOptions(0),
+	fFrame(frame),
+	fHidden(true),
+	fMouseButtons(0)
+{
+	fTopView = new BView(frame.OffsetToCopy(0, 0), "top view", B_FOLLOW_ALL,
+		B_FRAME_EVENTS);
+	fTopView->_Attach(this);
+}
+
+
+BWindow::~BWindow()
+{
+	fTopView->_Detach();
+	delete fTopView;
+}
+
+
+void
+BWindow::DispatchMessage(BMessage *message, BHandler *handler)
+{
+	BView *view = dynamic_cast<BView*>(handler);
+
+	switch (message->what) {
+		case B_KEY_DOWN:
+		case B_KEY_UP:
+		{
+			sModifiers = (uint32)message->GetInt32("modifiers", 0);
+
+			const char *bytes;
+			if (message->FindString("bytes", &bytes) != B_OK)
+				bytes = "";
+
+			if (view != NULL) {
+				if (message->what == B_KEY_DOWN)
+					view->KeyDown(bytes, strlen(bytes));
+				else
+					view->KeyUp(bytes, strlen(bytes));
+			} else if (handler == this && message->what == B_KEY_DOWN
+				&& bytes[0] == B_TAB)
+				_NavigateFocus((sModifiers & B_SHIFT_KEY) != 0);
+			break;
+		}
+
+		case B_MOUSE_DOWN:
+		case B_MOUSE_UP:
+		case B_MOUSE_MOVED:
+			_DispatchMouse(message, view);
+			break;
+
+		case B_COLORS_UPDATED:
+		case B_FONTS_UPDATED:
+			if (handler == this) {
+				broadcast(fTopView, message);
+				break;
+			}
+			BLooper::DispatchMessage(message, handler);
+			break;
+
+		default:
+			BLooper::DispatchMessage(message, handler);
+			break;
+	}
+}
+
+
+void
+BWindow::MessageReceived(BMessage *message)
+{
+	switch (message->what) {
+		case B_COLORS_UPDATED:
+		case B_FONTS_UPDATED:
+			break;
+
+		default:
+			BLooper::MessageReceived(message);
+			break;
+	}
+}
+
+
+void
+BWindow::AddChild(BView *child, BView *before)
+{
+	fTopView->AddChild(child, before);
+}
+
+
+bool
+BWindow::RemoveChild(BView *child)
+{
+	return fTopView->RemoveChild(child);
+}
+
+
+int32
+BWindow::CountChildren() const
+{
+	return fTopView->CountChildren();
+}
+
+
+BView*
+BWindow::ChildAt(int32 index) const
+{
+	return fTopView->ChildAt(index);
+}
+
+
+BView*
+BWindow::FindView(const char *name) const
+{
+	return fTopView->FindView(name);
+}
+
+
+BRect
+BWindow::Bounds() const
+{
+	return fFrame.OffsetToCopy(0, 0);
+}
+
+
+void
+BWindow::Show()
+{
+	if (!fHidden)
+		return;
+
+	if (Thread() < 0)
+		Run();
+	fHidden = false;
+	fTopView->Invalidate();
+}
+
+
+void
+BWindow::Hide()
+{
+	fHidden = true;
+	fDirty.clear();
+}
+
+
+// Lays out what needs it and runs the Draw() hooks of every view that
+// intersects an invalidated area, once per view.
+void
+BWindow::UpdateIfNeeded()
+{
+	BAutolock locker(this);
+	if (fHidden)
+		return;
+
+	fTopView->Layout(false);
+	if (fDirty.empty())
+		return;
+
+	std::vector<BRect> dirty;
+	dirty.swap(fDirty);
+	HeadlessRecorder::Record(HEADLESS_UPDATE);
+	fTopView->_Draw(dirty);
+}
+
+
+bool
+BWindow::NeedsUpdate() const
+{
+	return !fDirty.empty();
+}
+
+
+void
+BWindow::Quit()
+{
+	Hide();
+	BLooper::Quit();
+}
+
+
+BHandler*
+BWindow::_TargetFor(BMessage *message)
+{
+	if (!message->fPreferredTarget)
+		return BLooper::_TargetFor(message);
+
+	switch (message->what) {
+		case B_MOUSE_DOWN:
+		case B_MOUSE_UP:
+		case B_MOUSE_MOVED:
+		{
+			if (fMouseTarget != NULL)
+				return fMouseTarget;
+
+			BPoint where;
+			message->FindPoint("where", &where);
+			BView *view = fTopView->_ViewAt(where);
+			return view != NULL ? view : fTopView;
+		}
+
+		default:
+			// like the real window, the focus view is the preferred handler
+			if (fFocus != NULL)
+				return fFocus;
+			return BLooper::_TargetFor(message);
+	}
+}
+
+
+void
+BWindow::_SetFocus(BView *view, bool focus)
+{
+	if (focus) {
+		if (fFocus == view)
+			return;
+
+		BView *previous = fFocus;
+		fFocus = view;
+		if (previous != NULL)
+			previous->MakeFocus(false);
+	} else if (fFocus == view)
+		fFocus = NULL;
+}
+
+
+void
+BWindow::_ViewDetached(BView *view)
+{
+	if (fFocus == view)
+		fFocus = NULL;
+	if (fMouseTarget == view)
+		fMouseTarget = NULL;
+	if (fLastMouseView == view)
+		fLastMouseView = NULL;
+}
+
+
+void
+BWindow::_NavigateFocus(bool backwards)
+{
+	std::vector<BView*> views;
+	collect_navigable(fTopView, views);
+	if (views.empty())
+		return;
+
+	// a focused text view inside a navigable control counts as the control
+	int32 current = -1;
+	for (BView *view = fFocus; view != NULL && current < 0;
+			view = view->Parent()) {
+		for (size_t i = 0; i < views.size(); i++) {
+			if (views[i] == view) {
+				current = (int32)i;
+				break;
+			}
+		}
+	}
+
+	int32 count = (int32)views.size();
+	int32 next;
+	if (current < 0)
+		next = backwards ? count - 1 : 0;
+	else
+		next = (current + (backwards ? count - 1 : 1)) % count;
+	views[next]->MakeFocus(true);
+}
+
+
+void
+BWindow::_Invalidate(BRect windowRect)
+{
+	if (fHidden || !windowRect.IsValid())
+		return;
+
+	for (size_t i = 0; i < fDirty.size(); i++) {
+		if (fDirty[i].Contains(windowRect))
+			return;
+	}
+	fDirty.push_back(windowRect);
+}
+
+
+void
+BWindow::_SetMouseTarget(BView *view, uint32 options)
+{
+	fMouseTarget = view;
+	fMouseTargetOptions = options;
+}
+
+
+// Hands a mouse message to the view it is meant for, with the transit a
+// real window computes from where the pointer was before.
+void
+BWindow::_DispatchMouse(BMessage *message, BView *view)
+{
+	BPoint where;
+	if (message->FindPoint("where", &where) != B_OK)
+		where = fMouseLocation;
+	fMouseLocation = where;
+
+	int32 buttons;
+	if (message->FindInt32("buttons", &buttons) == B_OK)
+		fMouseButtons = (uint32)buttons;
+	else if (message->what == B_MOUSE_UP)
+		fMouseButtons = 0;
+
+	BView *under = fTopView->_ViewAt(where);
+
+	switch (message->what) {
+		case B_MOUSE_DOWN:
+			if (view != NULL)
+				view->MouseDown(view->ConvertFromWindow(where));
+			break;
+
+		case B_MOUSE_UP:
+		{
+			BView *target = fMouseTarget != NULL ? fMouseTarget : view;
+			fMouseTarget = NULL;
+			if (target != NULL)
+				target->MouseUp(target->ConvertFromWindow(where));
+			break;
+		}
+
+		case B_MOUSE_MOVED:
+		{
+			if (fMouseTarget != NULL) {
+				BView *target = fMouseTarget;
+				uint32 transit;
+				if (under == target) {
+					transit = fLastMouseView == target
+						? B_INSIDE_VIEW : B_ENTERED_VIEW;
+				} else {
+					transit = fLastMouseView == target
+						? B_EXITED_VIEW : B_OUTSIDE_VIEW;
+				}
+				fLastMouseView = under;
+				target->MouseMoved(target->ConvertFromWindow(where), transit,
+					NULL);
+				break;
+			}
+
+			BView *last = fLastMouseView;
+			fLastMouseView = under;
+			if (last != under && last != NULL)
+				last->MouseMoved(last->ConvertFromWindow(where), B_EXITED_VIEW,
+					NULL);
+			if (under != NULL) {
+				under->MouseMoved(under->ConvertFromWindow(where),
+					last != under ? B_ENTERED_VIEW : B_INSIDE_VIEW, NULL);
+			}
+			break;
+		}
+	}
+}
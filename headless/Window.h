@@ -0,0 +1,103 @@
+/*
+	Window.h: Headless stand-in for BWindow.
+
+	A window is a looper with a view tree. Input arrives as ordinary
+	B_KEY_DOWN/B_MOUSE_* messages posted by the driver, and drawing happens
+	when UpdateIfNeeded() is called. Key messages carry "bytes", "raw_char"
+	and "modifiers"; mouse messages carry "where" in window coordinates and
+	"buttons".
+	Released under the MIT license.
+*/
+#ifndef HEADLESS_WINDOW_H_
+#define HEADLESS_WINDOW_H_
+
+#include <Looper.h>
+#include <View.h>
+
+enum window_type {
+	B_UNTYPED_WINDOW	= 0,
+	B_TITLED_WINDOW		= 1,
+	B_MODAL_WINDOW		= 3,
+	B_DOCUMENT_WINDOW	= 11,
+	B_BORDERED_WINDOW	= 20,
+	B_FLOATING_WINDOW	= 21
+};
+
+enum {
+	B_NOT_MOVABLE				= 0x00000001,
+	B_NOT_CLOSABLE				= 0x00000020,
+	B_NOT_ZOOMABLE				= 0x00000040,
+	B_NOT_MINIMIZABLE			= 0x00004000,
+	B_NOT_RESIZABLE				= 0x00000002,
+	B_ASYNCHRONOUS_CONTROLS		= 0x00080000,
+	B_QUIT_ON_WINDOW_CLOSE		= 0x00100000,
+	B_AUTO_UPDATE_SIZE_LIMITS	= 0x01000000
+};
+
+#define B_CURRENT_WORKSPACE	0
+
+class BWindow : public BLooper {
+public:
+							BWindow(BRect frame, const char *title,
+								window_type type, uint32 flags,
+								uint32 workspace = B_CURRENT_WORKSPACE);
+	virtual					~BWindow();
+
+	virtual	void			DispatchMessage(BMessage *message,
+								BHandler *handler);
+	virtual	void			MessageReceived(BMessage *message);
+
+			void			AddChild(BView *child, BView *before = NULL);
+			bool			RemoveChild(BView *child);
+			int32			CountChildren() const;
+			BView*			ChildAt(int32 index) const;
+			BView*			FindView(const char *name) const;
+			BView*			CurrentFocus() const { return fFocus; }
+
+			BRect			Bounds() const;
+			BRect			Frame() const { return fFrame; }
+			const char*		Title() const { return Name(); }
+
+	virtual	void			Show();
+	virtual	void			Hide();
+			bool			IsHidden() const { return fHidden; }
+			bool			IsActive() const { return true; }
+
+			void			UpdateIfNeeded();
+			bool			NeedsUpdate() const;
+
+	virtual	void			Quit();
+
+	// headless: the pointer state GetMouse() reports, maintained from the
+	// mouse messages the window dispatches
+			BPoint			HeadlessMouseLocation() const
+								{ return fMouseLocation; }
+			uint32			HeadlessMouseButtons() const
+								{ return fMouseButtons; }
+
+protected:
+	virtual	BHandler*		_TargetFor(BMessage *message);
+
+private:
+	friend class BView;
+
+			void			_SetFocus(BView *view, bool focus);
+			void			_ViewDetached(BView *view);
+			void			_NavigateFocus(bool backwards);
+			void			_Invalidate(BRect windowRect);
+			void			_SetMouseTarget(BView *view, uint32 options);
+			void			_DispatchMouse(BMessage *message, BView *view);
+
+			BView*			fTopView;
+			BView*			fFocus;
+			BView*			fMouseTarget;
+			BView*			fLastMouseView;
+			uint32			fMouseTargetOptions;
+			BRect			fFrame;
+			std::vector<BRect> fDirty;
+			bool			fHidden;
+			BPoint			fMouseLocation;
+			uint32			fMouseButtons;
+};
+
+#endif